@@ -25,5 +25,6 @@
                                (overloaded for dynamic text start) */
 #define AT_ENTRY        9   /* Entry point of the executable */
 #define AT_SYSINFO      32  /* System call entry point */
+#define AT_NACL_CLOCK_PAGE 0x4e43  /* Read-only clock page (NaCl-specific) */
 
 #endif
@@ -4,6 +4,7 @@
  * found in the LICENSE file.
  */
 
+#include <fcntl.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,6 +12,7 @@
 #include <unistd.h>
 
 #include "native_client/src/include/elf.h"
+#include "native_client/src/include/nacl_compiler_annotations.h"
 #include "native_client/src/public/nonsfi/elf_loader.h"
 #include "native_client/src/shared/platform/nacl_log.h"
 #include "native_client/src/trusted/service_runtime/nacl_config.h"
@@ -26,6 +28,20 @@
 #define NONSFI_PAGE_MASK (NONSFI_PAGE_SIZE - 1)
 #define MAX_PHNUM 128
 
+/*
+ * File sealing (Linux 3.17) may be newer than the headers we are built
+ * against.  When the loader is itself built as a Non-SFI NaCl program,
+ * fcntl() does not pass F_GET_SEALS through, so sealing is not detected.
+ */
+#if defined(__linux__) && !defined(__native_client__)
+# define NONSFI_CHECK_SEALS 1
+# if !defined(F_GET_SEALS)
+#  define F_GET_SEALS 1034
+#  define F_SEAL_SHRINK 0x0002
+#  define F_SEAL_WRITE 0x0008
+# endif
+#endif
+
 static uintptr_t PageSizeRoundDown(uintptr_t addr) {
   return addr & ~NONSFI_PAGE_MASK;
 }
@@ -40,6 +56,148 @@ static int ElfFlagsToMmapFlags(int pflags) {
          ((pflags & PF_W) != 0 ? PROT_WRITE : 0);
 }
 
+void NaClElfLoadOptionsInit(struct NaClElfLoadOptions *options) {
+  options->text = NACL_ELF_PREFAULT_NONE;
+  options->data = NACL_ELF_PREFAULT_NONE;
+  options->bss = NACL_ELF_PREFAULT_NONE;
+  options->populate_sealed = 0;
+}
+
+static int ParsePrefault(const char *value, size_t len,
+                         enum NaClElfPrefault *policy) {
+  static const struct {
+    const char *name;
+    enum NaClElfPrefault policy;
+  } kPolicies[] = {
+    { "none", NACL_ELF_PREFAULT_NONE },
+    { "willneed", NACL_ELF_PREFAULT_WILLNEED },
+    { "populate", NACL_ELF_PREFAULT_POPULATE },
+  };
+  size_t i;
+  for (i = 0; i < sizeof(kPolicies) / sizeof(kPolicies[0]); ++i) {
+    if (strlen(kPolicies[i].name) == len &&
+        memcmp(kPolicies[i].name, value, len) == 0) {
+      *policy = kPolicies[i].policy;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void NaClElfLoadOptionsFromEnv(struct NaClElfLoadOptions *options) {
+  NaClElfLoadOptionsInit(options);
+  const char *env = getenv("NACL_NONSFI_PREFAULT");
+  if (env == NULL)
+    return;
+
+  enum NaClElfPrefault policy;
+  if (ParsePrefault(env, strlen(env), &policy)) {
+    options->text = policy;
+    options->data = policy;
+    options->bss = policy;
+    return;
+  }
+  const char *item = env;
+  while (*item != '\0') {
+    const char *comma = strchr(item, ',');
+    size_t len = comma != NULL ? (size_t) (comma - item) : strlen(item);
+    const char *equals = memchr(item, '=', len);
+    int ok = 0;
+    if (equals == NULL) {
+      if (len == 6 && memcmp(item, "sealed", 6) == 0) {
+        options->populate_sealed = 1;
+        ok = 1;
+      }
+    } else {
+      size_t key_len = equals - item;
+      const char *value = equals + 1;
+      size_t value_len = len - key_len - 1;
+      if (key_len == 4 && memcmp(item, "text", 4) == 0) {
+        ok = ParsePrefault(value, value_len, &options->text);
+      } else if (key_len == 4 && memcmp(item, "data", 4) == 0) {
+        ok = ParsePrefault(value, value_len, &options->data);
+      } else if (key_len == 3 && memcmp(item, "bss", 3) == 0) {
+        ok = ParsePrefault(value, value_len, &options->bss);
+      }
+    }
+    if (!ok) {
+      NaClLog(LOG_WARNING, "Ignoring unknown NACL_NONSFI_PREFAULT item "
+              "\"%.*s\"\n", (int) len, item);
+    }
+    item += len;
+    if (*item == ',')
+      ++item;
+  }
+}
+
+/*
+ * Returns whether the file's contents are immutable: it is sealed
+ * against writes and against being truncated under our mappings.
+ */
+static int IsSealedFile(int fd) {
+#if defined(NONSFI_CHECK_SEALS)
+  int seals = fcntl(fd, F_GET_SEALS);
+  return seals >= 0 &&
+         (seals & (F_SEAL_WRITE | F_SEAL_SHRINK)) ==
+         (F_SEAL_WRITE | F_SEAL_SHRINK);
+#else
+  UNREFERENCED_PARAMETER(fd);
+  return 0;
+#endif
+}
+
+#if !defined(MAP_POPULATE)
+/*
+ * Touches each page of the range so that it is faulted in now rather
+ * than on first use.  Writable pages are written so that private copies
+ * (and, for anonymous memory, fresh zero pages) are made up front.
+ */
+static void TouchPages(uintptr_t start, uintptr_t end, int prot) {
+  if ((prot & PROT_READ) == 0)
+    return;
+  volatile char *page;
+  for (page = (volatile char *) start; (uintptr_t) page < end;
+       page += NONSFI_PAGE_SIZE) {
+    if ((prot & PROT_WRITE) != 0) {
+      *page = *page;
+    } else {
+      (void) *page;
+    }
+  }
+}
+#endif
+
+/*
+ * Maps [start, end) with the given policy.  fd is -1 for anonymous
+ * memory.  MAP_POPULATE is used where the headers provide it; otherwise
+ * (e.g. when the loader is a Non-SFI NaCl program) the pages are
+ * touched instead, and MADV_WILLNEED is skipped.
+ */
+static void MapRange(uintptr_t start, uintptr_t end, int prot, int fd,
+                     off_t offset, enum NaClElfPrefault policy) {
+  int flags = MAP_PRIVATE | MAP_FIXED | (fd == -1 ? MAP_ANON : 0);
+#if defined(MAP_POPULATE)
+  if (policy == NACL_ELF_PREFAULT_POPULATE)
+    flags |= MAP_POPULATE;
+#endif
+  void *map_result = mmap((void *) start, end - start, prot, flags, fd,
+                          offset);
+  if (map_result != (void *) start) {
+    NaClLog(LOG_FATAL, "Failed to map ELF segment\n");
+  }
+  if (policy == NACL_ELF_PREFAULT_WILLNEED && fd != -1) {
+#if defined(MADV_WILLNEED)
+    if (madvise((void *) start, end - start, MADV_WILLNEED) != 0) {
+      NaClLog(1, "madvise(MADV_WILLNEED) failed for ELF segment\n");
+    }
+#endif
+  }
+#if !defined(MAP_POPULATE)
+  if (policy == NACL_ELF_PREFAULT_POPULATE)
+    TouchPages(start, end, prot);
+#endif
+}
+
 static void CheckElfHeaders(ElfW(Ehdr) *ehdr) {
   if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0) {
     NaClLog(LOG_FATAL, "Not an ELF file: no ELF header\n");
@@ -68,6 +226,18 @@ static void CheckElfHeaders(ElfW(Ehdr) *ehdr) {
 }
 
 uintptr_t NaClLoadElfFile(int fd) {
+  return NaClLoadElfFileWithOptions(fd, NULL);
+}
+
+uintptr_t NaClLoadElfFileWithOptions(int fd,
+                                     const struct NaClElfLoadOptions *options) {
+  struct NaClElfLoadOptions default_options;
+  if (options == NULL) {
+    NaClElfLoadOptionsInit(&default_options);
+    options = &default_options;
+  }
+  int populate_file = options->populate_sealed && IsSealedFile(fd);
+
   /* Read ELF file headers. */
   ElfW(Ehdr) ehdr;
   ssize_t bytes_read = pread(fd, &ehdr, sizeof(ehdr), 0);
@@ -130,14 +300,6 @@ uintptr_t NaClLoadElfFile(int fd) {
       NaClLog(LOG_FATAL, "PT_LOAD segments overlap or are not sorted\n");
     }
     prev_segment_end = segment_end;
-    void *segment_addr = (void *) (load_bias + segment_start);
-    void *map_result = mmap((void *) segment_addr,
-                            segment_end - segment_start,
-                            prot, MAP_PRIVATE | MAP_FIXED, fd,
-                            PageSizeRoundDown(ph->p_offset));
-    if (map_result != segment_addr) {
-      NaClLog(LOG_FATAL, "Failed to map ELF segment\n");
-    }
 
     if ((ph->p_flags & PF_X) != 0 &&
         ph->p_vaddr <= ehdr.e_entry &&
@@ -145,18 +307,30 @@ uintptr_t NaClLoadElfFile(int fd) {
       entry_point_is_valid = 1;
     }
 
-    /* Handle the BSS. */
     if (ph->p_memsz < ph->p_filesz) {
       NaClLog(LOG_FATAL, "Bad ELF segment: p_memsz < p_filesz\n");
     }
-    if (ph->p_memsz > ph->p_filesz) {
-      if ((ph->p_flags & PF_W) == 0) {
-        NaClLog(LOG_FATAL,
-                "Bad ELF segment: non-writable segment with BSS\n");
-      }
+    if (ph->p_memsz > ph->p_filesz && (ph->p_flags & PF_W) == 0) {
+      NaClLog(LOG_FATAL, "Bad ELF segment: non-writable segment with BSS\n");
+    }
+
+    /*
+     * Map the pages holding file contents from the file, and any whole
+     * pages of BSS beyond them as anonymous memory.
+     */
+    uintptr_t bss_start = ph->p_vaddr + ph->p_filesz;
+    uintptr_t bss_map_start = PageSizeRoundUp(bss_start);
+    enum NaClElfPrefault file_policy =
+        (ph->p_flags & PF_X) != 0 ? options->text : options->data;
+    if (populate_file)
+      file_policy = NACL_ELF_PREFAULT_POPULATE;
+    if (segment_start < bss_map_start) {
+      MapRange(load_bias + segment_start, load_bias + bss_map_start, prot,
+               fd, PageSizeRoundDown(ph->p_offset), file_policy);
+    }
 
-      uintptr_t bss_start = ph->p_vaddr + ph->p_filesz;
-      uintptr_t bss_map_start = PageSizeRoundUp(bss_start);
+    /* Handle the BSS. */
+    if (ph->p_memsz > ph->p_filesz) {
       /*
        * Zero the BSS to the end of the page.
        *
@@ -171,13 +345,8 @@ uintptr_t NaClLoadElfFile(int fd) {
       memset((void *) (load_bias + bss_start), 0, bss_map_start - bss_start);
 
       if (bss_map_start < segment_end) {
-        void *map_addr = (void *) (load_bias + bss_map_start);
-        map_result = mmap(map_addr, segment_end - bss_map_start,
-                          prot, MAP_PRIVATE | MAP_ANON | MAP_FIXED,
-                          -1, 0);
-        if (map_result != map_addr) {
-          NaClLog(LOG_FATAL, "Failed to map BSS for ELF segment\n");
-        }
+        MapRange(load_bias + bss_map_start, load_bias + segment_end, prot,
+                 -1, 0, options->bss);
       }
     }
   }
@@ -25,7 +25,9 @@ int main(int argc, char **argv, char **environ) {
     fprintf(stderr, "Failed to open %s: %s\n", nexe_filename, strerror(errno));
     return 1;
   }
-  uintptr_t entry = NaClLoadElfFile(fd);
+  struct NaClElfLoadOptions options;
+  NaClElfLoadOptionsFromEnv(&options);
+  uintptr_t entry = NaClLoadElfFileWithOptions(fd, &options);
   return nacl_irt_nonsfi_entry(argc - 1, argv + 1, environ,
                                (nacl_entry_func_t) entry, nacl_irt_query_core);
 }
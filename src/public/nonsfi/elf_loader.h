@@ -11,6 +11,49 @@
 
 EXTERN_C_BEGIN
 
+/* How the pages of a loaded segment are faulted in. */
+enum NaClElfPrefault {
+  /* Demand paging only: pages are faulted in as they are first touched. */
+  NACL_ELF_PREFAULT_NONE,
+  /* Start readahead of the file pages with madvise(MADV_WILLNEED). */
+  NACL_ELF_PREFAULT_WILLNEED,
+  /* Fault every page in before NaClLoadElfFile() returns. */
+  NACL_ELF_PREFAULT_POPULATE
+};
+
+struct NaClElfLoadOptions {
+  /* Policy for executable PT_LOAD segments. */
+  enum NaClElfPrefault text;
+  /* Policy for the file-backed part of other PT_LOAD segments. */
+  enum NaClElfPrefault data;
+  /*
+   * Policy for the anonymous zero-filled pages of the BSS.  These have
+   * no backing file, so NACL_ELF_PREFAULT_WILLNEED is the same as
+   * NACL_ELF_PREFAULT_NONE.
+   */
+  enum NaClElfPrefault bss;
+  /*
+   * If non-zero and the file is sealed against writing and shrinking
+   * (e.g. a sealed memfd), populate all file-backed segments whatever
+   * the text and data policies say.  The pages of such a file are
+   * already in memory and cannot change, so prefaulting them costs no
+   * I/O and removes the page faults from startup.
+   */
+  int populate_sealed;
+};
+
+/* Sets OPTIONS to the defaults, which are demand paging throughout. */
+void NaClElfLoadOptionsInit(struct NaClElfLoadOptions *options);
+
+/*
+ * Sets OPTIONS from the NACL_NONSFI_PREFAULT environment variable, or to
+ * the defaults if it is unset.  The variable is either a single policy
+ * ("none", "willneed" or "populate") applied to every segment type, or
+ * a comma-separated list of "text=", "data=" and "bss=" settings and the
+ * word "sealed", e.g. "text=populate,data=willneed,sealed".
+ */
+void NaClElfLoadOptionsFromEnv(struct NaClElfLoadOptions *options);
+
 /*
  * Loads the ELF binary from the given file descriptor.
  * This takes the ownership of the given fd, so a caller does not need to
@@ -19,6 +62,10 @@ EXTERN_C_BEGIN
  */
 uintptr_t NaClLoadElfFile(int fd);
 
+/* Like NaClLoadElfFile(), but applies the given prefault policies. */
+uintptr_t NaClLoadElfFileWithOptions(int fd,
+                                     const struct NaClElfLoadOptions *options);
+
 EXTERN_C_END
 
 #endif
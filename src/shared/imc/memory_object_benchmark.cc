@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Measures how fast NaClCreateMemoryObject() creates shared memory
+// objects, on their own and including mapping and filling each one, as
+// NaClSysImcMemObjCreate() callers would.
+//
+//   memory_object_benchmark [count]
+//
+// Run it with NACL_DISABLE_MEMFD=1 to compare with shm_open().
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "native_client/src/shared/imc/nacl_imc_c.h"
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/trusted/service_runtime/include/bits/mman.h"
+#include "native_client/src/trusted/service_runtime/nacl_config.h"
+
+namespace {
+
+double NowUs() {
+  struct timespec ts;
+  CHECK(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+void Run(size_t size, int executable, int count) {
+  double start = NowUs();
+  for (int i = 0; i < count; i++) {
+    NaClHandle handle = NaClCreateMemoryObject(size, executable);
+    CHECK(handle != NACL_INVALID_HANDLE);
+    CHECK(NaClClose(handle) == 0);
+  }
+  double create_us = (NowUs() - start) / count;
+
+  start = NowUs();
+  for (int i = 0; i < count; i++) {
+    NaClHandle handle = NaClCreateMemoryObject(size, executable);
+    CHECK(handle != NACL_INVALID_HANDLE);
+    void *addr = NaClMap(NULL, NULL, size,
+                         NACL_ABI_PROT_READ | NACL_ABI_PROT_WRITE,
+                         NACL_ABI_MAP_SHARED, handle, 0);
+    CHECK(addr != NACL_ABI_MAP_FAILED);
+    memset(addr, 1, size);
+    CHECK(munmap(addr, size) == 0);
+    CHECK(NaClClose(handle) == 0);
+  }
+  double use_us = (NowUs() - start) / count;
+
+  printf("%8u bytes%-13s: create %6.1f us, create and fill %8.1f us\n",
+         (unsigned) size, executable ? " (executable)" : "",
+         create_us, use_us);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 1000;
+  CHECK(count > 0);
+
+  NaClHandle handle = NaClCreateMemoryObject(NACL_MAP_PAGESIZE, 0);
+  CHECK(handle != NACL_INVALID_HANDLE);
+  // Memory objects created with memfd_create() can not be resized.
+  printf("memory objects are %s\n",
+         ftruncate(handle, 2 * NACL_MAP_PAGESIZE) == 0 ? "resizable"
+                                                       : "sealed");
+  CHECK(NaClClose(handle) == 0);
+
+  Run(NACL_MAP_PAGESIZE, 0, count);
+  Run(NACL_MAP_PAGESIZE, 1, count);
+  Run(16 * NACL_MAP_PAGESIZE, 0, count);
+  return 0;
+}
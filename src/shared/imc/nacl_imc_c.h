@@ -247,7 +247,12 @@ void NaClSetCreateMemoryObjectFunc(NaClCreateMemoryObjectFunc func);
  * NACL_MAP_PAGESIZE in nacl_config.h.
  *
  * executable: Whether the memory object needs to be mappable as
- * executable.  (This is significant only on Mac OS X.)
+ * executable.  (This is significant on Mac OS X, and on Linux kernels
+ * which make memfds non-executable by default.)
+ *
+ * On Linux, memory objects are created with memfd_create() when the
+ * kernel supports it, and their size is sealed.  Setting
+ * NACL_DISABLE_MEMFD in the environment disables this.
  */
 
 NaClHandle NaClCreateMemoryObject(size_t length, int executable);
@@ -28,6 +28,10 @@
 #include <linux/ashmem.h>
 #endif
 
+#if NACL_LINUX
+#include <sys/syscall.h>
+#endif
+
 #include <algorithm>
 
 #include "native_client/src/include/atomic_ops.h"
@@ -143,6 +147,72 @@ static int TryShmOrTempOpen(size_t length, bool use_temp) {
 }
 
 #if NACL_LINUX
+/*
+ * memfd_create() (Linux 3.17) creates an anonymous memory object with one
+ * system call, without a name in a filesystem and regardless of how /dev/shm
+ * is mounted.  Older C libraries have neither a wrapper nor these flags.
+ */
+# if !defined(MFD_CLOEXEC)
+#  define MFD_CLOEXEC 0x0001U
+#  define MFD_ALLOW_SEALING 0x0002U
+# endif
+# if !defined(MFD_NOEXEC_SEAL)
+#  define MFD_NOEXEC_SEAL 0x0008U
+#  define MFD_EXEC 0x0010U
+# endif
+# if !defined(F_ADD_SEALS)
+#  define F_ADD_SEALS (1024 + 9)
+#  define F_SEAL_SEAL 0x0001
+#  define F_SEAL_SHRINK 0x0002
+#  define F_SEAL_GROW 0x0004
+# endif
+
+/* Set once memfd_create() turns out to be missing or blocked by a sandbox. */
+static Atomic32 g_memfd_unusable = 0;
+
+static int MemfdCreate(size_t length, bool executable) {
+#if defined(__NR_memfd_create)
+  /* This shows up as "/memfd:nacl-shm" in /proc/self/maps. */
+  static const char kMemfdName[] = "nacl-shm";
+  static bool s_memfd_disabled = getenv("NACL_DISABLE_MEMFD") != NULL;
+  unsigned int flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+  int fd;
+
+  if (s_memfd_disabled || g_memfd_unusable)
+    return -1;
+
+  /*
+   * Kernels with vm.memfd_noexec want to be told whether the object will be
+   * mapped with PROT_EXEC.  Older kernels reject these flags with EINVAL,
+   * and there memfds are always executable.
+   */
+  fd = syscall(__NR_memfd_create, kMemfdName,
+               flags | (executable ? MFD_EXEC : MFD_NOEXEC_SEAL));
+  if (fd < 0 && errno == EINVAL)
+    fd = syscall(__NR_memfd_create, kMemfdName, flags);
+  if (fd < 0) {
+    if (errno == ENOSYS || errno == EPERM)
+      AtomicExchange(&g_memfd_unusable, 1);
+    return -1;
+  }
+
+  /*
+   * Seal the size, so that a process we share the object with can not
+   * truncate it under our mappings.
+   */
+  if (ftruncate(fd, length) == -1 ||
+      fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  UNREFERENCED_PARAMETER(length);
+  UNREFERENCED_PARAMETER(executable);
+  return -1;
+#endif
+}
+
 /*
  * Attempt to set PROT_EXEC on memory mapped from a shm_open fd, and return
  * true if this is successful, false otherwise.  On many linux installations
@@ -183,6 +253,12 @@ NaClHandle NaClCreateMemoryObject(size_t length, int executable) {
 #if NACL_ANDROID
   return AshmemCreateRegion(length);
 #else
+#if NACL_LINUX
+  fd = MemfdCreate(length, executable != 0);
+  if (fd >= 0)
+    return fd;
+#endif
+
   bool use_shm_open = true;
   if (executable) {
     /*
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -39,31 +40,26 @@
 #include "native_client/src/trusted/service_runtime/include/sys/dirent.h"
 #include "native_client/src/trusted/service_runtime/include/sys/errno.h"
 #include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_dirent_plus.h"
 #include "native_client/src/trusted/service_runtime/include/sys/stat.h"
 
-#ifdef _syscall3
-_syscall3(int, getdents, uint, fd, struct dirent *, dirp, uint, count)
-
-int getdents(unsigned int fd, struct dirent* dirp, unsigned int count);
-#else
-# include <sys/syscall.h>
-int getdents(unsigned int fd, struct dirent* dirp, unsigned int count) {
-  return syscall(__NR_getdents, fd, dirp, count);
+static int NaClGetdents64(int fd, void *dirp, size_t count) {
+  return syscall(__NR_getdents64, fd, dirp, count);
 }
-#endif
-
-struct linux_dirent {  /* offsets, ILP32 and LP64 */
-  unsigned long  d_ino;             /*  0,  0 */
-  unsigned long  d_off;             /*  4,  8 */
-  unsigned short d_reclen;          /*  8, 16 */
-  char           d_name[1];         /* 10, 18 */
-  /* actual length is d_reclen - 2 - offsetof(struct linux_dirent, d_name) */
-  /*
-   * char pad;    / Zero padding byte
-   * char d_type; / File type (only since Linux 2.6.4; offset is d_reclen - 1)
-   */
-};
 
+/*
+ * Same layout as glibc's struct dirent64, which not all C libraries
+ * we build against define.  d_ino and d_off are 64 bits on ILP32
+ * hosts too, so inode numbers are not truncated there.
+ */
+struct linux_dirent64 {      /* offsets */
+  uint64_t       d_ino;      /*  0 */
+  int64_t        d_off;      /*  8 */
+  unsigned short d_reclen;   /* 16 */
+  unsigned char  d_type;     /* 18 */
+  char           d_name[1];  /* 19 */
+  /* actual length is d_reclen - offsetof(struct linux_dirent64, d_name) */
+};
 
 /*
  * from native_client/src/trusted/service_runtime/include/sys/dirent.h:
@@ -75,56 +71,19 @@ struct nacl_abi_dirent {                                 offsets, NaCl
   char           nacl_abi_d_name[NACL_ABI_MAXNAMLEN + 1];      18
 };
 
- * It would be nice if we didn't have to buffer dirent data.  Is it
- * possible, when the untrusted NaCl module invokes getdent, to
- * determine a (different) buffer size value to use with the host OS
- * (Linux)?
- *
- * Since the actual length is d_reclen, do we know if d_reclen is
- * padded out to a multiple of the alignment restriction for longs?
- * Best to assume that either may hold. On x86 where unaligned
- * accesses are okay, this might be fine; on other architectures where
- * it isn't, then presumably d_reclen will include the padding, and
- * d_type (which we don't use) is on the far end of the padding.
- *
- * Given a user-supplied buffer of N bytes to hold nacl_abi_dirent
- * entries, what is the size of the buffer that should be supplied to
- * the Linux kernel so that we will never end up with more information
- * than we can copy / return back to the user?
- *
- * For LP64, the answer is relatively simple: everything is the same
- * size, except that the kernel is going to use one more byte for the
- * d_type entry.  Since copying to the nacl_abi_dirent omits that, the
- * transfer shrinks the space needed.
+ * It would be nice if we didn't have to buffer dirent data, but there
+ * is no host buffer size that is guaranteed to produce no more
+ * entries than fit in the user's buffer while still accepting every
+ * entry that would: a nacl_abi_dirent is 1 byte shorter than the
+ * linux_dirent64 for the same name before padding, and a
+ * nacl_abi_dirent_plus is 27 bytes longer.  If the host buffer is too
+ * small for the next entry, getdents64 fails with EINVAL, and if it
+ * is too large we may read entries that we cannot return.
  *
- * For ILP32, the answer is a little harder.  The linux_dirent use 8
- * fewer bytes for the entries before d_name, but one more at the end
- * for d_type.  So, when does the worst case expansion occur?  The
- * number of dirent entries is multiplied by the expansion, so we need
- * to determine the smallest dirent entry.  Assuming single character
- * file names, a user's buffer of size N can hold int(N/20) dirents.
- * The linux_dirent, with no alignment pads, but with d_type (we
- * assume newer kernels only), will take 13 bytes per entry, so we had
- * better not claim to have more than 13*int(N/20) bytes of space
- * available to the Linux kernel.  (We don't need to check in our
- * platform qualification check since "older" kernels are pre 2.6.4,
- * and all reasonable Linux distributions use newer kernels.)
- *
- * Suppose the user gave us a buffer of 40 bytes.  This is enough for
- * two dirent structures containing information about files each with
- * a single character name.  So, we invoke Linux's getdents with a 26
- * byte buffer.  What happens if the next actual directory entry's
- * name is 40-18-1=21 bytes long?  It would have fit in the user's
- * buffer, but the linux_dirent buffer required for that entry is
- * 10+21+2 bytes in length, or 33 bytes.  We supplied linux with a 26
- * byte buffer, so it should respond with EINVAL since the buffer
- * space is too small.
- *
- * This argues against a simple scheme that avoids buffering.
- *
- * We could, when we encounter EINVAL, increase the buffer size used
- * with the host OS.  How do we expand and could that might result in
- * too much being read in?
+ * So we read into a buffer in the NaClHostDir and return entries from
+ * it.  The buffer is large enough that a big directory is read in a
+ * few system calls, and each call translates all the buffered entries
+ * that fit in one pass.
  */
 
 int NaClHostDirCtor(struct NaClHostDir  *d,
@@ -173,123 +132,201 @@ int NaClHostDirOpen(struct NaClHostDir  *d,
   return rv;
 }
 
+/* Size of a translated record for a name of namelen bytes. */
+static size_t NaClDirentRecordSize(size_t name_offset, size_t namelen) {
+  return (name_offset + namelen + 1 + (sizeof(uint64_t) - 1))
+      & ~(sizeof(uint64_t) - 1);
+}
+
 /*
- * Copy and translate a single linux_dirent to nacl_abi_dirent.
- * Returns number of bytes consumed (includes alignment adjustment for
- * next entry).
+ * Copy and translate the buffered linux_dirent64 entries that fit in
+ * [buf, buf + len) to nacl_abi_dirent.  Returns the number of bytes
+ * written; entries that did not fit are left in the buffer.
  *
  * TODO(bsy): add filesystem info argument to specify which
  * directories are "root" inodes, to rewrite the inode number of '..'
  * as appropriate.
  */
-static ssize_t NaClCopyDirent(struct NaClHostDir *d,
-                              void               *buf,
+static size_t NaClCopyDirents(struct NaClHostDir *d,
+                              char               *buf,
                               size_t             len) {
-  struct linux_dirent             *ldp = (struct linux_dirent *) (
-      d->dirent_buf
-      + d->cur_byte);
-  struct nacl_abi_dirent volatile *nadp;
-  size_t                          adjusted_size;
+  size_t                  xferred = 0;
+  struct linux_dirent64   *ldp;
+  struct nacl_abi_dirent  *nadp;
+  size_t                  namelen;
+  size_t                  adjusted_size;
+
+  while (d->cur_byte < d->nbytes) {
+    ldp = (struct linux_dirent64 *) (d->dirent_buf + d->cur_byte);
+    /* assume Linux is sane, so no overflow.  (NAME_MAX is small.) */
+    namelen = strlen(ldp->d_name);
+    adjusted_size = NaClDirentRecordSize(
+        offsetof(struct nacl_abi_dirent, nacl_abi_d_name), namelen);
+    if (len - xferred < adjusted_size) {
+      break;
+    }
+    nadp = (struct nacl_abi_dirent *) (buf + xferred);
+    nadp->nacl_abi_d_ino = ldp->d_ino;
+    nadp->nacl_abi_d_off = ldp->d_off;
+    nadp->nacl_abi_d_reclen = (uint16_t) adjusted_size;
+    memcpy(nadp->nacl_abi_d_name, ldp->d_name, namelen + 1);
+    /* NB: some padding bytes may not get overwritten */
+
+    xferred += adjusted_size;
+    d->cur_byte += ldp->d_reclen;
+  }
+  return xferred;
+}
 
-  /* make sure the buffer is aligned */
-  CHECK(0 == ((sizeof(nacl_abi_ino_t) - 1) & (uintptr_t) buf));
+static uint32_t NaClDirentTypeXlate(unsigned char d_type) {
+  switch (d_type) {
+    case DT_REG:
+      return NACL_ABI_S_IFREG;
+    case DT_DIR:
+      return NACL_ABI_S_IFDIR;
+    case DT_LNK:
+      return NACL_ABI_S_IFLNK;
+    case DT_FIFO:
+      return NACL_ABI_S_IFIFO;
+    case DT_CHR:
+      return NACL_ABI_S_IFCHR;
+    default:
+      return NACL_ABI_S_UNSUP;
+  }
+}
 
-  if (d->cur_byte == d->nbytes) {
-    return 0;  /* none available */
+/* Same mapping as NaClAbiStatHostDescStatXlateCtor. */
+static uint32_t NaClDirentModeXlate(mode_t mode) {
+  uint32_t m;
+
+  switch (mode & S_IFMT) {
+    case S_IFREG:
+      m = NACL_ABI_S_IFREG;
+      break;
+    case S_IFDIR:
+      m = NACL_ABI_S_IFDIR;
+      break;
+    case S_IFLNK:
+      m = NACL_ABI_S_IFLNK;
+      break;
+    case S_IFIFO:
+      m = NACL_ABI_S_IFIFO;
+      break;
+    case S_IFCHR:
+      m = NACL_ABI_S_IFCHR;
+      break;
+    default:
+      m = NACL_ABI_S_UNSUP;
   }
-  CHECK(d->cur_byte < d->nbytes);
-  CHECK(ldp->d_reclen <= d->nbytes - d->cur_byte);
-  /* no partial record transferred. */
-
-  nadp = (struct nacl_abi_dirent volatile *) buf;
-
-  /*
-   * is there enough space? assume Linux is sane, so no ssize_t
-   * overflow in the adjusted_size computation.  (NAME_MAX is small.)
-   */
-  CHECK(NAME_MAX < 256);
-  adjusted_size = offsetof(struct nacl_abi_dirent, nacl_abi_d_name)
-      + strlen(ldp->d_name) + 1;  /* NUL termination */
-  /* pad for alignment for access to d_ino */
-  adjusted_size = (adjusted_size + (sizeof(nacl_abi_ino_t) - 1))
-      & ~(sizeof(nacl_abi_ino_t) - 1);
-  if (len < adjusted_size) {
-    return -NACL_ABI_EINVAL;  /* result buffer is too small */
+  if (0 != (mode & S_IRUSR)) {
+    m |= NACL_ABI_S_IRUSR;
   }
+  if (0 != (mode & S_IWUSR)) {
+    m |= NACL_ABI_S_IWUSR;
+  }
+  if (0 != (mode & S_IXUSR)) {
+    m |= NACL_ABI_S_IXUSR;
+  }
+  return m;
+}
 
-  nadp->nacl_abi_d_ino = ldp->d_ino;
-  nadp->nacl_abi_d_off = ldp->d_off;
-  nadp->nacl_abi_d_reclen = adjusted_size;
-  NaClLog(4, "NaClCopyDirent: %s\n", ldp->d_name);
-  strcpy((char *) nadp->nacl_abi_d_name, ldp->d_name);
-  /* NB: some padding bytes may not get overwritten */
-
-  d->cur_byte += ldp->d_reclen;
+/*
+ * As NaClCopyDirents, but to nacl_abi_dirent_plus, with the attributes
+ * of each entry from fstatat().  ".." is not looked at, since it may
+ * be outside the directory tree that the program was given.
+ */
+static size_t NaClCopyDirentsPlus(struct NaClHostDir *d,
+                                  char               *buf,
+                                  size_t             len) {
+  size_t                      xferred = 0;
+  struct linux_dirent64       *ldp;
+  struct nacl_abi_dirent_plus *nadp;
+  size_t                      namelen;
+  size_t                      adjusted_size;
+  struct stat64               stbuf;
+
+  while (d->cur_byte < d->nbytes) {
+    ldp = (struct linux_dirent64 *) (d->dirent_buf + d->cur_byte);
+    namelen = strlen(ldp->d_name);
+    adjusted_size = NaClDirentRecordSize(
+        offsetof(struct nacl_abi_dirent_plus, nacl_abi_d_name), namelen);
+    if (len - xferred < adjusted_size) {
+      break;
+    }
+    nadp = (struct nacl_abi_dirent_plus *) (buf + xferred);
+    nadp->nacl_abi_d_ino = ldp->d_ino;
+    nadp->nacl_abi_d_off = ldp->d_off;
+    if (0 != strcmp(ldp->d_name, "..") &&
+        0 == fstatat64(d->fd, ldp->d_name, &stbuf, AT_SYMLINK_NOFOLLOW)) {
+      nadp->nacl_abi_d_size = stbuf.st_size;
+      nadp->nacl_abi_d_mtime = stbuf.st_mtim.tv_sec;
+      nadp->nacl_abi_d_mtimensec = stbuf.st_mtim.tv_nsec;
+      nadp->nacl_abi_d_mode = NaClDirentModeXlate(stbuf.st_mode);
+    } else {
+      nadp->nacl_abi_d_size = 0;
+      nadp->nacl_abi_d_mtime = 0;
+      nadp->nacl_abi_d_mtimensec = 0;
+      nadp->nacl_abi_d_mode = NaClDirentTypeXlate(ldp->d_type);
+    }
+    nadp->nacl_abi_d_reclen = (uint16_t) adjusted_size;
+    memcpy(nadp->nacl_abi_d_name, ldp->d_name, namelen + 1);
 
-  NaClLog(4, "NaClCopyDirent: returning %"NACL_PRIuS"\n", adjusted_size);
-  return (ssize_t) adjusted_size;
+    xferred += adjusted_size;
+    d->cur_byte += ldp->d_reclen;
+  }
+  return xferred;
 }
 
+typedef size_t (*NaClCopyDirentsFn)(struct NaClHostDir *d,
+                                    char               *buf,
+                                    size_t             len);
+
 static ssize_t NaClStreamDirents(struct NaClHostDir *d,
-                                 void               *buf,
-                                 size_t             len) {
+                                 char               *buf,
+                                 size_t             len,
+                                 NaClCopyDirentsFn  copy) {
   ssize_t retval;
   size_t  xferred = 0;
-  ssize_t entry_size;
 
   NaClXMutexLock(&d->mu);
-  while (len > 0) {
-    NaClLog(4, "NaClStreamDirents: loop, xferred = %"NACL_PRIuS"\n", xferred);
-    entry_size = NaClCopyDirent(d, buf, len);
-    if (0 == entry_size) {
-      CHECK(d->cur_byte == d->nbytes);
-      retval = getdents(d->fd,
-                        (struct dirent *) d->dirent_buf,
-                        sizeof d->dirent_buf);
-      if (-1 == retval) {
-        if (xferred > 0) {
-          /* next time through, we'll pick up the error again */
-          goto cleanup;
-        } else {
-          xferred = -NaClXlateErrno(errno);
-          goto cleanup;
-        }
-      } else if (0 == retval) {
-        goto cleanup;
-      }
-      d->cur_byte = 0;
-      d->nbytes = retval;
-    } else if (entry_size < 0) {
+  for (;;) {
+    xferred += (*copy)(d, buf + xferred, len - xferred);
+    if (d->cur_byte < d->nbytes) {
       /*
-       * The only error return from NaClCopyDirent is NACL_ABI_EINVAL
-       * due to destinaton buffer too small for the current entry.  If
-       * we had copied some entries before, we were successful;
-       * otherwise report that the buffer is too small for the next
-       * directory entry.
+       * The next entry does not fit.  If we had copied some entries
+       * before, we were successful; otherwise report that the buffer
+       * is too small for the next directory entry.
        */
-      if (xferred > 0) {
-        goto cleanup;
-      } else {
-        xferred = entry_size;
+      if (0 == xferred) {
+        retval = -NACL_ABI_EINVAL;
         goto cleanup;
       }
+      break;
+    }
+    retval = NaClGetdents64(d->fd, d->dirent_buf, sizeof d->dirent_buf);
+    if (-1 == retval) {
+      if (xferred > 0) {
+        /* next time through, we'll pick up the error again */
+        break;
+      }
+      retval = -NaClXlateErrno(errno);
+      goto cleanup;
+    } else if (0 == retval) {
+      break;
     }
-    /* entry_size > 0, maybe copy another */
-    buf = (void *) ((char *) buf + entry_size);
-    CHECK(len >= (size_t) entry_size);
-    len -= entry_size;
-    xferred += entry_size;
+    d->cur_byte = 0;
+    d->nbytes = retval;
   }
-  /* perfect fit! */
+  retval = (ssize_t) xferred;
  cleanup:
   NaClXMutexUnlock(&d->mu);
-  return xferred;
+  return retval;
 }
 
 ssize_t NaClHostDirGetdents(struct NaClHostDir  *d,
                             void                *buf,
                             size_t              len) {
-  int retval;
+  ssize_t retval;
 
   if (NULL == d) {
     NaClLog(LOG_FATAL, "NaClHostDirGetdents: 'this' is NULL\n");
@@ -302,17 +339,48 @@ ssize_t NaClHostDirGetdents(struct NaClHostDir  *d,
     goto cleanup;
   }
 
-  retval = NaClStreamDirents(d, buf, len);
+  retval = NaClStreamDirents(d, (char *) buf, len, NaClCopyDirents);
  cleanup:
-  NaClLog(3, "NaClHostDirGetdents: returned %d\n", retval);
+  NaClLog(3, "NaClHostDirGetdents: returned %"NACL_PRIdS"\n", retval);
+  return retval;
+}
+
+ssize_t NaClHostDirGetdentsPlus(struct NaClHostDir  *d,
+                                void                *buf,
+                                size_t              len) {
+  ssize_t retval;
+
+  if (NULL == d) {
+    NaClLog(LOG_FATAL, "NaClHostDirGetdentsPlus: 'this' is NULL\n");
+  }
+  NaClLog(3,
+          "NaClHostDirGetdentsPlus(0x%08"NACL_PRIxPTR", %"NACL_PRIuS"):\n",
+          (uintptr_t) buf, len);
+
+  if (0 != ((sizeof(uint64_t) - 1) & (uintptr_t) buf)) {
+    retval = -NACL_ABI_EINVAL;
+    goto cleanup;
+  }
+
+  retval = NaClStreamDirents(d, (char *) buf, len, NaClCopyDirentsPlus);
+ cleanup:
+  NaClLog(3, "NaClHostDirGetdentsPlus: returned %"NACL_PRIdS"\n", retval);
   return retval;
 }
 
 int NaClHostDirRewind(struct NaClHostDir *d) {
+  int retval;
+
   if (NULL == d) {
     NaClLog(LOG_FATAL, "NaClHostDirRewind: 'this' is NULL\n");
   }
-  return -NaClXlateErrno(lseek64(d->fd, 0, SEEK_SET));
+  /* Drop entries buffered from before the rewind. */
+  NaClXMutexLock(&d->mu);
+  d->cur_byte = 0;
+  d->nbytes = 0;
+  retval = -NaClXlateErrno(lseek64(d->fd, 0, SEEK_SET));
+  NaClXMutexUnlock(&d->mu);
+  return retval;
 }
 
 int NaClHostDirClose(struct NaClHostDir *d) {
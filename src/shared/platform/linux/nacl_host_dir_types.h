@@ -17,7 +17,11 @@
 #include "native_client/src/include/nacl_base.h"
 #include "native_client/src/shared/platform/nacl_sync.h"
 
-#define NACL_DIRENT_BUF_BYTES 4096
+/*
+ * Large enough for a few hundred typical entries per getdents64 call,
+ * which matches what the C library's readdir uses.
+ */
+#define NACL_DIRENT_BUF_BYTES 32768
 
 EXTERN_C_BEGIN
 
@@ -17,6 +17,7 @@
 #include "native_client/src/include/build_config.h"
 #include "native_client/src/include/nacl_compiler_annotations.h"
 #include "native_client/src/include/portability.h"
+#include "native_client/src/public/imc_types.h"
 #include "native_client/src/shared/platform/nacl_sync.h"
 #include "native_client/src/trusted/service_runtime/include/sys/time.h"
 
@@ -263,6 +264,25 @@ extern ssize_t NaClHostDescWrite(struct NaClHostDesc  *d,
                                  void const           *buf,
                                  size_t               count) NACL_WUR;
 
+/*
+ * Scatter/gather versions of NaClHostDescRead and NaClHostDescWrite.
+ * Like readv/writev, the transfer stops at the first short read or
+ * write, and the return value is the total number of bytes
+ * transferred.  iovcnt must not exceed NACL_ABI_IOV_MAX, and the total
+ * length should not exceed SSIZE_T_MAX.
+ *
+ * iov and the buffers it points to are not validated.
+ *
+ * Underlying host-OS functions: readv, writev / FileRead, FileWrite
+ */
+extern ssize_t NaClHostDescReadv(struct NaClHostDesc           *d,
+                                 struct NaClImcMsgIoVec const  *iov,
+                                 size_t                        iovcnt) NACL_WUR;
+
+extern ssize_t NaClHostDescWritev(struct NaClHostDesc          *d,
+                                  struct NaClImcMsgIoVec const *iov,
+                                  size_t                       iovcnt) NACL_WUR;
+
 /*
  * Read data from an opened file into a memory buffer from specified
  * offset into file.
@@ -391,6 +411,18 @@ extern int NaClHostDescFdatasync(struct NaClHostDesc *d) NACL_WUR;
 extern int NaClHostDescFtruncate(struct NaClHostDesc *d,
                                  nacl_off64_t length) NACL_WUR;
 
+/*
+ * Hints that [offset, offset + length) of the file will be read soon,
+ * so the host can start reading it into its page cache.  This is only
+ * advice: it does not block and there is nothing to undo if it fails.
+ *
+ * Underlying host-OS functions: posix_fadvise(POSIX_FADV_WILLNEED) /
+ * fcntl(F_RDADVISE) / none
+ */
+extern int NaClHostDescPrefetch(struct NaClHostDesc *d,
+                                nacl_off64_t        offset,
+                                nacl_off64_t        length);
+
 /*
  * Maps NACI_ABI_ versions of the mmap prot argument to host ABI versions
  * of the bit values
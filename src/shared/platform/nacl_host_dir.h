@@ -60,6 +60,17 @@ extern ssize_t NaClHostDirGetdents(struct NaClHostDir *d,
                                    void               *buf,
                                    size_t             len);
 
+/*
+ * Like NaClHostDirGetdents, but returns struct nacl_abi_dirent_plus
+ * records, which also hold the type, size and modification time of
+ * each entry.  buf must be 8-byte aligned.
+ *
+ * Underlying function: getdents64 and fstatat(Linux) / none
+ */
+extern ssize_t NaClHostDirGetdentsPlus(struct NaClHostDir *d,
+                                       void               *buf,
+                                       size_t             len);
+
 /*
  * Rewind the NaClHostDir object such that future calls
  * to NaClHostDirGetdents read from the beginning of the
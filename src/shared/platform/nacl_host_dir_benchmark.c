@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Measures a directory walk: names only with NaClHostDirGetdents, names
+ * and attributes with NaClHostDirGetdents and a NaClHostDescLstat per
+ * entry, and the same with NaClHostDirGetdentsPlus.
+ *
+ *   nacl_host_dir_benchmark <temp_dir> [file_count] [buffer_size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/build_config.h"
+#include "native_client/src/include/portability_io.h"
+
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_host_desc.h"
+#include "native_client/src/shared/platform/nacl_host_dir.h"
+#include "native_client/src/shared/platform/nacl_time.h"
+#include "native_client/src/shared/platform/platform_init.h"
+#include "native_client/src/trusted/service_runtime/include/sys/dirent.h"
+#include "native_client/src/trusted/service_runtime/include/sys/errno.h"
+#include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_dirent_plus.h"
+
+#define PATH_BYTES 4096
+
+static char const *gDir;
+
+static void FilePath(char *path, int i) {
+  CHECK(SNPRINTF(path, PATH_BYTES, "%s/file_%08d", gDir, i) < PATH_BYTES);
+}
+
+static void CreateFiles(int count) {
+  char path[PATH_BYTES];
+  struct NaClHostDesc hd;
+  int i;
+
+  for (i = 0; i < count; ++i) {
+    FilePath(path, i);
+    CHECK(0 == NaClHostDescOpen(&hd, path,
+                                NACL_ABI_O_WRONLY | NACL_ABI_O_CREAT, 0600));
+    CHECK(0 == NaClHostDescClose(&hd));
+  }
+}
+
+static void RemoveFiles(int count) {
+  char path[PATH_BYTES];
+  int i;
+
+  for (i = 0; i < count; ++i) {
+    FilePath(path, i);
+    CHECK(0 == NaClHostDescUnlink(path));
+  }
+}
+
+/*
+ * Walks gDir and returns the time taken in microseconds, or -1 if the
+ * host does not support mode.  Checks that all files plus "." and ".."
+ * were seen.
+ */
+static int64_t Walk(int mode, void *buf, size_t buf_size, int count) {
+  struct NaClHostDir nhd;
+  char path[PATH_BYTES];
+  nacl_host_stat_t st;
+  ssize_t nbytes;
+  ssize_t pos;
+  uint16_t reclen;
+  char const *name;
+  int entries = 0;
+  int64_t start;
+
+  start = NaClGetTimeOfDayMicroseconds();
+  CHECK(0 == NaClHostDirOpen(&nhd, (char *) gDir));
+  for (;;) {
+    if (2 == mode) {
+      nbytes = NaClHostDirGetdentsPlus(&nhd, buf, buf_size);
+    } else {
+      nbytes = NaClHostDirGetdents(&nhd, buf, buf_size);
+    }
+    if (-NACL_ABI_ENOSYS == nbytes) {
+      CHECK(0 == NaClHostDirClose(&nhd));
+      return -1;
+    }
+    CHECK(nbytes >= 0);
+    if (0 == nbytes) {
+      break;
+    }
+    for (pos = 0; pos < nbytes; pos += reclen) {
+      if (2 == mode) {
+        struct nacl_abi_dirent_plus *nadp =
+            (struct nacl_abi_dirent_plus *) ((char *) buf + pos);
+        reclen = nadp->nacl_abi_d_reclen;
+      } else {
+        struct nacl_abi_dirent *nadp =
+            (struct nacl_abi_dirent *) ((char *) buf + pos);
+        reclen = nadp->nacl_abi_d_reclen;
+        name = nadp->nacl_abi_d_name;
+        if (1 == mode) {
+          CHECK(SNPRINTF(path, sizeof path, "%s/%s", gDir, name)
+                < (int) sizeof path);
+          CHECK(0 == NaClHostDescLstat(path, &st));
+        }
+      }
+      ++entries;
+    }
+  }
+  CHECK(0 == NaClHostDirClose(&nhd));
+  start = NaClGetTimeOfDayMicroseconds() - start;
+  CHECK(count + 2 == entries);
+  return start;
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 2 ? (int) strtol(argv[2], NULL, 0) : 100000;
+  size_t buf_size = argc > 3 ? strtoul(argv[3], NULL, 0) : 65536;
+  void *buf;
+  static char const *const kNames[] = {
+    "getdents:",
+    "getdents + lstat:",
+    "getdents_plus:",
+  };
+  int64_t us;
+  int mode;
+
+  if (argc < 2) {
+    fprintf(stderr,
+            "Usage: nacl_host_dir_benchmark <temp_dir> [count] [size]\n");
+    return 1;
+  }
+  CHECK(count > 0);
+  gDir = argv[1];
+  NaClPlatformInit();
+
+  buf = malloc(buf_size);
+  CHECK(NULL != buf);
+  CreateFiles(count);
+
+  printf("%d files, %"NACL_PRIuS" byte buffer\n", count, buf_size);
+  for (mode = 0; mode < (int) (sizeof kNames / sizeof kNames[0]); ++mode) {
+    us = Walk(mode, buf, buf_size, count);
+    if (us < 0) {
+      printf("%-18s not supported\n", kNames[mode]);
+    } else {
+      printf("%-18s %12.0f entries/s\n", kNames[mode],
+             (count + 2) * 1e6 / (double) (0 == us ? 1 : us));
+    }
+  }
+
+  RemoveFiles(count);
+  free(buf);
+  NaClPlatformFini();
+  return 0;
+}
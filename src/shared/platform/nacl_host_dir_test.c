@@ -5,7 +5,8 @@
  */
 
 /*
- * Exercise the NaClHostDir NaClHostDirGetdents interface.
+ * Exercise the NaClHostDir NaClHostDirGetdents and NaClHostDirGetdentsPlus
+ * interfaces.
  *
  * We use testdata input pairs: a file containing an expected
  * directory listing, and a sample directory.  The contents are just
@@ -47,6 +48,7 @@
 #include "native_client/src/trusted/desc/nacl_desc_base.h"
 #include "native_client/src/trusted/service_runtime/include/sys/dirent.h"
 #include "native_client/src/trusted/service_runtime/include/sys/errno.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_dirent_plus.h"
 #include "native_client/src/trusted/service_runtime/include/sys/stat.h"
 
 #define MAXLINE 1024  /* 256 = NAME_MAX+1 should suffice */
@@ -160,6 +162,75 @@ uint32_t ExtractNames(struct string_array *dest_array,
   return error_count;
 }
 
+#if NACL_LINUX
+/*
+ * Reads dir_path with NaClHostDirGetdentsPlus into dest_array, and
+ * checks the attributes returned against NaClHostDescStat.
+ */
+uint32_t ReadNamesPlus(struct string_array *dest_array,
+                       char                *dir_path) {
+  struct NaClHostDir          nhd;
+  union {
+    struct nacl_abi_dirent_plus nadp;
+    uint64_t                    align[1024 / sizeof(uint64_t)];
+  }                           buffer;
+  struct nacl_abi_dirent_plus *nadp;
+  ssize_t                     nbytes;
+  ssize_t                     pos;
+  char                        path[4096];
+  nacl_host_stat_t            host_stat;
+  struct nacl_abi_stat        nabi_stat;
+  int                         rv;
+  uint32_t                    error_count = 0;
+
+  rv = NaClHostDirOpen(&nhd, dir_path);
+  if (0 != rv) {
+    fprintf(stderr, "Could not open directory %s: %d\n", dir_path, rv);
+    return 1;
+  }
+  /* Too small for any entry. */
+  nbytes = NaClHostDirGetdentsPlus(&nhd, &buffer, 24);
+  if (-NACL_ABI_EINVAL != nbytes) {
+    fprintf(stderr, "GetdentsPlus: expected EINVAL, got %"NACL_PRIdS"\n",
+            nbytes);
+    ++error_count;
+  }
+  while (0 < (nbytes = NaClHostDirGetdentsPlus(&nhd, &buffer,
+                                               sizeof buffer))) {
+    for (pos = 0; pos < nbytes; pos += nadp->nacl_abi_d_reclen) {
+      nadp = (struct nacl_abi_dirent_plus *) ((char *) &buffer + pos);
+      StringArrayAdd(dest_array, strdup(nadp->nacl_abi_d_name));
+      if (0 == strcmp(nadp->nacl_abi_d_name, "..")) {
+        continue;
+      }
+      CHECK((size_t) SNPRINTF(path, sizeof path, "%s%c%s",
+                              dir_path, path_sep, nadp->nacl_abi_d_name)
+            < sizeof path);
+      if (0 != (rv = NaClHostDescStat(path, &host_stat))) {
+        fprintf(stderr, "could not stat %s: %d\n", path, rv);
+        ++error_count;
+        continue;
+      }
+      CHECK(0 == NaClAbiStatHostDescStatXlateCtor(&nabi_stat, &host_stat));
+      if (nabi_stat.nacl_abi_st_ino != nadp->nacl_abi_d_ino ||
+          nabi_stat.nacl_abi_st_mode != nadp->nacl_abi_d_mode ||
+          nabi_stat.nacl_abi_st_size != nadp->nacl_abi_d_size ||
+          nabi_stat.nacl_abi_st_mtime != nadp->nacl_abi_d_mtime) {
+        fprintf(stderr, "GetdentsPlus: attributes of %s differ from stat\n",
+                path);
+        ++error_count;
+      }
+    }
+  }
+  if (0 != nbytes) {
+    fprintf(stderr, "GetdentsPlus: error %"NACL_PRIdS"\n", nbytes);
+    ++error_count;
+  }
+  (void) NaClHostDirClose(&nhd);
+  return error_count;
+}
+#endif
+
 int OperateOnDir(char *dir_name, struct string_array *file_list,
                  int (*op)(char const *path)) {
   char    joined[JOINED_MAX];
@@ -291,6 +362,9 @@ int main(int argc, char **argv) {
   int                 retval;
   struct NaClHostDir  nhd;
   struct string_array actual;
+#if NACL_LINUX
+  struct string_array actual_plus;
+#endif
 
   union {
     struct nacl_abi_dirent  nad;
@@ -467,6 +541,28 @@ double_break:
   if (0 == retval && 0 != error_count) {
     retval = 10;
   }
+
+#if NACL_LINUX
+  StringArrayCtor(&actual_plus);
+  error_count += ReadNamesPlus(&actual_plus, test_dir);
+  StringArraySort(&actual_plus);
+  if (actual_plus.nelts != actual.nelts) {
+    fprintf(stderr, "GetdentsPlus returned %"NACL_PRIuS" entries, not %"
+            NACL_PRIuS"\n", actual_plus.nelts, actual.nelts);
+    ++error_count;
+  } else {
+    for (ix = 0; ix < actual.nelts; ++ix) {
+      if (0 != strcmp(actual.strings[ix], actual_plus.strings[ix])) {
+        fprintf(stderr, "GetdentsPlus entry %"NACL_PRIuS" differs: %s\n",
+                ix, actual_plus.strings[ix]);
+        ++error_count;
+      }
+    }
+  }
+  if (0 == retval && 0 != error_count) {
+    retval = 12;
+  }
+#endif
 cleanup:
   if (0 != CleanupDirectory(test_dir, &expected)) {
     if (0 == retval) {
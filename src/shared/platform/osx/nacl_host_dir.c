@@ -133,6 +133,15 @@ ssize_t NaClHostDirGetdents(struct NaClHostDir  *d,
   return (ssize_t) i;
 }
 
+ssize_t NaClHostDirGetdentsPlus(struct NaClHostDir  *d,
+                                void                *buf,
+                                size_t              len) {
+  UNREFERENCED_PARAMETER(d);
+  UNREFERENCED_PARAMETER(buf);
+  UNREFERENCED_PARAMETER(len);
+  return -NACL_ABI_ENOSYS;
+}
+
 int NaClHostDirRewind(struct NaClHostDir *d) {
   if (NULL == d) {
     NaClLog(LOG_FATAL, "NaClHostDirRewind: 'this' is NULL\n");
@@ -13,6 +13,8 @@
  * system call return interface of small negative numbers as errors.
  */
 
+#include <limits.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <sys/types.h>
@@ -20,6 +22,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <utime.h>
 
@@ -30,6 +33,7 @@
 /* pthread_once for NaClHostDescInit, which is no-op on other OSes */
 #endif
 
+#include "native_client/src/include/nacl_macros.h"
 #include "native_client/src/include/nacl_platform.h"
 #include "native_client/src/include/portability.h"
 
@@ -504,6 +508,64 @@ ssize_t NaClHostDescWrite(struct NaClHostDesc *d,
   return retval;
 }
 
+/*
+ * NaClImcMsgIoVec is defined to be layout-compatible with struct iovec,
+ * so it can be passed directly to readv/writev.
+ */
+static struct iovec const *NaClHostDescIoVec(
+    struct NaClImcMsgIoVec const *iov) {
+  NACL_COMPILE_TIME_ASSERT(sizeof(struct iovec) ==
+                           sizeof(struct NaClImcMsgIoVec));
+  NACL_COMPILE_TIME_ASSERT(offsetof(struct iovec, iov_base) ==
+                           offsetof(struct NaClImcMsgIoVec, base));
+  NACL_COMPILE_TIME_ASSERT(offsetof(struct iovec, iov_len) ==
+                           offsetof(struct NaClImcMsgIoVec, length));
+  return (struct iovec const *) iov;
+}
+
+ssize_t NaClHostDescReadv(struct NaClHostDesc           *d,
+                          struct NaClImcMsgIoVec const  *iov,
+                          size_t                        iovcnt) {
+  ssize_t retval;
+
+  NaClHostDescCheckValidity("NaClHostDescReadv", d);
+  if (NACL_ABI_O_WRONLY == (d->flags & NACL_ABI_O_ACCMODE)) {
+    NaClLog(3, "NaClHostDescReadv: WRONLY file\n");
+    return -NACL_ABI_EBADF;
+  }
+  return ((-1 == (retval = readv(d->d, NaClHostDescIoVec(iov), (int) iovcnt)))
+          ? -NaClXlateErrno(errno) : retval);
+}
+
+ssize_t NaClHostDescWritev(struct NaClHostDesc          *d,
+                           struct NaClImcMsgIoVec const *iov,
+                           size_t                       iovcnt) {
+  /*
+   * See NaClHostDescPWrite for details for why need_lock is required.
+   */
+  int need_lock;
+  ssize_t retval;
+
+  NaClHostDescCheckValidity("NaClHostDescWritev", d);
+  if (NACL_ABI_O_RDONLY == (d->flags & NACL_ABI_O_ACCMODE)) {
+    NaClLog(3, "NaClHostDescWritev: RDONLY file\n");
+    return -NACL_ABI_EBADF;
+  }
+
+  need_lock = NACL_LINUX && (0 != (d->flags & NACL_ABI_O_APPEND));
+  if (need_lock) {
+    NaClHostDescExclusiveLock(d->d);
+  }
+  retval = writev(d->d, NaClHostDescIoVec(iov), (int) iovcnt);
+  if (need_lock) {
+    NaClHostDescExclusiveUnlock(d->d);
+  }
+  if (-1 == retval) {
+    retval = -NaClXlateErrno(errno);
+  }
+  return retval;
+}
+
 nacl_off64_t NaClHostDescSeek(struct NaClHostDesc  *d,
                               nacl_off64_t         offset,
                               int                  whence) {
@@ -790,3 +852,34 @@ int NaClHostDescFtruncate(struct NaClHostDesc *d, nacl_off64_t length) {
   }
   return 0;
 }
+
+int NaClHostDescPrefetch(struct NaClHostDesc *d,
+                         nacl_off64_t        offset,
+                         nacl_off64_t        length) {
+#if NACL_OSX
+  struct radvisory ra;
+#else
+  int err;
+#endif
+
+  NaClHostDescCheckValidity("NaClHostDescPrefetch", d);
+#if NACL_LINUX
+  err = posix_fadvise64(d->d, offset, length, POSIX_FADV_WILLNEED);
+  if (0 != err) {
+    /* posix_fadvise returns the error rather than setting errno. */
+    return -NaClXlateErrno(err);
+  }
+#elif NACL_OSX
+  if (length > INT_MAX) {
+    length = INT_MAX;
+  }
+  ra.ra_offset = offset;
+  ra.ra_count = (int) length;
+  if (-1 == fcntl(d->d, F_RDADVISE, &ra)) {
+    return -NaClXlateErrno(errno);
+  }
+#else
+# error Unsupported platform
+#endif
+  return 0;
+}
@@ -1239,6 +1239,51 @@ ssize_t NaClHostDescWrite(struct NaClHostDesc *d,
   return bytes_written;
 }
 
+/*
+ * Windows has no readv/writev equivalent for synchronous file handles
+ * (ReadFileScatter requires page-aligned, unbuffered I/O), so these
+ * just perform one transfer per segment.
+ */
+ssize_t NaClHostDescReadv(struct NaClHostDesc           *d,
+                          struct NaClImcMsgIoVec const  *iov,
+                          size_t                        iovcnt) {
+  ssize_t total = 0;
+  ssize_t result;
+  size_t i;
+
+  for (i = 0; i < iovcnt; ++i) {
+    result = NaClHostDescRead(d, iov[i].base, iov[i].length);
+    if (result < 0) {
+      return 0 == total ? result : total;
+    }
+    total += result;
+    if ((size_t) result < iov[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
+ssize_t NaClHostDescWritev(struct NaClHostDesc          *d,
+                           struct NaClImcMsgIoVec const *iov,
+                           size_t                       iovcnt) {
+  ssize_t total = 0;
+  ssize_t result;
+  size_t i;
+
+  for (i = 0; i < iovcnt; ++i) {
+    result = NaClHostDescWrite(d, iov[i].base, iov[i].length);
+    if (result < 0) {
+      return 0 == total ? result : total;
+    }
+    total += result;
+    if ((size_t) result < iov[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
 nacl_off64_t NaClHostDescSeek(struct NaClHostDesc  *d,
                               nacl_off64_t         offset,
                               int                  whence) {
@@ -1619,6 +1664,19 @@ int NaClHostDescFtruncate(struct NaClHostDesc *d, nacl_off64_t length) {
   return DoTruncate((HANDLE) _get_osfhandle(d->d), length);
 }
 
+int NaClHostDescPrefetch(struct NaClHostDesc *d,
+                         nacl_off64_t        offset,
+                         nacl_off64_t        length) {
+  NaClHostDescCheckValidity("NaClHostDescPrefetch", d);
+  UNREFERENCED_PARAMETER(offset);
+  UNREFERENCED_PARAMETER(length);
+  /*
+   * There is no per-range read-ahead hint for an open file handle;
+   * PrefetchVirtualMemory() only applies to mapped views.
+   */
+  return 0;
+}
+
 int NaClHostDescTruncate(char const *path, nacl_abi_off_t length) {
   int retval;
 
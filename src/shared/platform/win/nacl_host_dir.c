@@ -234,6 +234,15 @@ done:
   return retval;
 }
 
+ssize_t NaClHostDirGetdentsPlus(struct NaClHostDir  *d,
+                                void                *buf,
+                                size_t              len) {
+  UNREFERENCED_PARAMETER(d);
+  UNREFERENCED_PARAMETER(buf);
+  UNREFERENCED_PARAMETER(len);
+  return -NACL_ABI_ENOSYS;
+}
+
 int NaClHostDirRewind(struct NaClHostDir *d) {
   int retval;
   if (NULL == d) {
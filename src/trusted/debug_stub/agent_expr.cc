@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <string.h>
+
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/trusted/debug_stub/agent_expr.h"
+
+namespace {
+
+// Opcodes, as defined in GDB's ax.def.
+enum {
+  kOpAdd = 0x02,
+  kOpSub = 0x03,
+  kOpMul = 0x04,
+  kOpDivSigned = 0x05,
+  kOpDivUnsigned = 0x06,
+  kOpRemSigned = 0x07,
+  kOpRemUnsigned = 0x08,
+  kOpLsh = 0x09,
+  kOpRshSigned = 0x0a,
+  kOpRshUnsigned = 0x0b,
+  kOpLogNot = 0x0e,
+  kOpBitAnd = 0x0f,
+  kOpBitOr = 0x10,
+  kOpBitXor = 0x11,
+  kOpBitNot = 0x12,
+  kOpEqual = 0x13,
+  kOpLessSigned = 0x14,
+  kOpLessUnsigned = 0x15,
+  kOpExt = 0x16,
+  kOpRef8 = 0x17,
+  kOpRef16 = 0x18,
+  kOpRef32 = 0x19,
+  kOpRef64 = 0x1a,
+  kOpIfGoto = 0x20,
+  kOpGoto = 0x21,
+  kOpConst8 = 0x22,
+  kOpConst16 = 0x23,
+  kOpConst32 = 0x24,
+  kOpConst64 = 0x25,
+  kOpReg = 0x26,
+  kOpEnd = 0x27,
+  kOpDup = 0x28,
+  kOpPop = 0x29,
+  kOpZeroExt = 0x2a,
+  kOpSwap = 0x2b,
+  kOpPick = 0x32,
+  kOpRot = 0x33
+};
+
+// GDB's own agent uses a stack of 100 entries; conditions are far
+// simpler than that in practice.
+const int kMaxStack = 64;
+
+// Bound the work done per evaluation, since the bytecode may loop.
+const int kMaxSteps = 100000;
+
+}  // namespace
+
+namespace gdb_rsp {
+
+bool EvalAgentExpr(const std::string &expr, IAgentExprContext *ctx,
+                   uint64_t *result) {
+  const uint8_t *code = reinterpret_cast<const uint8_t *>(expr.data());
+  size_t size = expr.size();
+  uint64_t stack[kMaxStack];
+  int sp = 0;
+  size_t pc = 0;
+
+// Helpers for checking the bytecode as it is run.  Each fails the
+// evaluation on error.
+#define NEED_STACK(n) if (sp < (n)) goto fail
+#define NEED_ROOM(n) if (sp + (n) > kMaxStack) goto fail
+#define NEED_CODE(n) if (pc + (n) > size) goto fail
+
+  for (int steps = 0; steps < kMaxSteps; steps++) {
+    NEED_CODE(1);
+    uint8_t op = code[pc++];
+
+    // Big-endian immediate operand, for opcodes that take one.
+    uint64_t imm = 0;
+    size_t imm_size = 0;
+    switch (op) {
+      case kOpExt:
+      case kOpZeroExt:
+      case kOpConst8:
+      case kOpPick:
+        imm_size = 1;
+        break;
+      case kOpIfGoto:
+      case kOpGoto:
+      case kOpConst16:
+      case kOpReg:
+        imm_size = 2;
+        break;
+      case kOpConst32:
+        imm_size = 4;
+        break;
+      case kOpConst64:
+        imm_size = 8;
+        break;
+    }
+    NEED_CODE(imm_size);
+    for (size_t i = 0; i < imm_size; i++) {
+      imm = (imm << 8) | code[pc++];
+    }
+
+    switch (op) {
+      case kOpAdd:
+      case kOpSub:
+      case kOpMul:
+      case kOpDivSigned:
+      case kOpDivUnsigned:
+      case kOpRemSigned:
+      case kOpRemUnsigned:
+      case kOpLsh:
+      case kOpRshSigned:
+      case kOpRshUnsigned:
+      case kOpBitAnd:
+      case kOpBitOr:
+      case kOpBitXor:
+      case kOpEqual:
+      case kOpLessSigned:
+      case kOpLessUnsigned: {
+        NEED_STACK(2);
+        uint64_t b = stack[--sp];
+        uint64_t a = stack[sp - 1];
+        int64_t sa = static_cast<int64_t>(a);
+        int64_t sb = static_cast<int64_t>(b);
+        uint64_t value;
+        switch (op) {
+          case kOpAdd: value = a + b; break;
+          case kOpSub: value = a - b; break;
+          case kOpMul: value = a * b; break;
+          case kOpDivSigned:
+            // Dividing INT64_MIN by -1 traps on x86, so reject it too.
+            if (sb == 0 || (sb == -1 && a == (1ULL << 63))) goto fail;
+            value = static_cast<uint64_t>(sa / sb);
+            break;
+          case kOpDivUnsigned:
+            if (b == 0) goto fail;
+            value = a / b;
+            break;
+          case kOpRemSigned:
+            if (sb == 0 || (sb == -1 && a == (1ULL << 63))) goto fail;
+            value = static_cast<uint64_t>(sa % sb);
+            break;
+          case kOpRemUnsigned:
+            if (b == 0) goto fail;
+            value = a % b;
+            break;
+          case kOpLsh: value = b >= 64 ? 0 : a << b; break;
+          case kOpRshSigned:
+            value = static_cast<uint64_t>(sa >> (b >= 64 ? 63 : b));
+            break;
+          case kOpRshUnsigned: value = b >= 64 ? 0 : a >> b; break;
+          case kOpBitAnd: value = a & b; break;
+          case kOpBitOr: value = a | b; break;
+          case kOpBitXor: value = a ^ b; break;
+          case kOpEqual: value = a == b; break;
+          case kOpLessSigned: value = sa < sb; break;
+          default: value = a < b; break;
+        }
+        stack[sp - 1] = value;
+        break;
+      }
+
+      case kOpLogNot:
+        NEED_STACK(1);
+        stack[sp - 1] = !stack[sp - 1];
+        break;
+
+      case kOpBitNot:
+        NEED_STACK(1);
+        stack[sp - 1] = ~stack[sp - 1];
+        break;
+
+      case kOpExt:
+        NEED_STACK(1);
+        if (imm == 0 || imm > 64) goto fail;
+        if (imm < 64) {
+          uint64_t sign = 1ULL << (imm - 1);
+          uint64_t value = stack[sp - 1] & ((sign << 1) - 1);
+          stack[sp - 1] = (value ^ sign) - sign;
+        }
+        break;
+
+      case kOpZeroExt:
+        NEED_STACK(1);
+        if (imm == 0 || imm > 64) goto fail;
+        if (imm < 64) {
+          stack[sp - 1] &= (1ULL << imm) - 1;
+        }
+        break;
+
+      case kOpRef8:
+      case kOpRef16:
+      case kOpRef32:
+      case kOpRef64: {
+        NEED_STACK(1);
+        uint32_t bytes = 1 << (op - kOpRef8);
+        uint8_t buf[8];
+        if (!ctx->ReadMemory(stack[sp - 1], buf, bytes)) goto fail;
+        // All NaCl targets are little-endian.
+        uint64_t value = 0;
+        for (uint32_t i = bytes; i > 0; i--) {
+          value = (value << 8) | buf[i - 1];
+        }
+        stack[sp - 1] = value;
+        break;
+      }
+
+      case kOpIfGoto:
+        NEED_STACK(1);
+        if (stack[--sp] != 0) {
+          pc = static_cast<size_t>(imm);
+        }
+        break;
+
+      case kOpGoto:
+        pc = static_cast<size_t>(imm);
+        break;
+
+      case kOpConst8:
+      case kOpConst16:
+      case kOpConst32:
+      case kOpConst64:
+        NEED_ROOM(1);
+        stack[sp++] = imm;
+        break;
+
+      case kOpReg: {
+        NEED_ROOM(1);
+        uint64_t value;
+        if (!ctx->GetRegister(static_cast<uint32_t>(imm), &value)) goto fail;
+        stack[sp++] = value;
+        break;
+      }
+
+      case kOpEnd:
+        NEED_STACK(1);
+        *result = stack[sp - 1];
+        return true;
+
+      case kOpDup:
+        NEED_STACK(1);
+        NEED_ROOM(1);
+        stack[sp] = stack[sp - 1];
+        sp++;
+        break;
+
+      case kOpPop:
+        NEED_STACK(1);
+        sp--;
+        break;
+
+      case kOpSwap: {
+        NEED_STACK(2);
+        uint64_t tmp = stack[sp - 1];
+        stack[sp - 1] = stack[sp - 2];
+        stack[sp - 2] = tmp;
+        break;
+      }
+
+      case kOpPick:
+        NEED_STACK(static_cast<int>(imm) + 1);
+        NEED_ROOM(1);
+        stack[sp] = stack[sp - 1 - imm];
+        sp++;
+        break;
+
+      case kOpRot: {
+        // a b c => c a b
+        NEED_STACK(3);
+        uint64_t c = stack[sp - 1];
+        stack[sp - 1] = stack[sp - 2];
+        stack[sp - 2] = stack[sp - 3];
+        stack[sp - 3] = c;
+        break;
+      }
+
+      default:
+        NaClLog(LOG_ERROR, "Unsupported agent expression opcode 0x%02x\n",
+                op);
+        goto fail;
+    }
+  }
+  NaClLog(LOG_ERROR, "Agent expression did not terminate\n");
+
+#undef NEED_STACK
+#undef NEED_ROOM
+#undef NEED_CODE
+
+ fail:
+  return false;
+}
+
+}  // namespace gdb_rsp
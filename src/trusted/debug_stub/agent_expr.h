@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This module evaluates GDB agent expressions, the bytecode GDB sends
+// with breakpoint conditions ("Z0,addr,kind;Xlen,bytes") so that the
+// stub can decide whether a breakpoint hit should be reported.  See:
+// https://sourceware.org/gdb/onlinedocs/gdb/Agent-Expressions.html
+//
+// Only the subset of the bytecode that makes sense for conditions is
+// supported: arithmetic, comparisons, jumps, constants and reads of
+// registers and memory.  Floating point, tracing, trace state variables
+// and printf are rejected as errors.
+#ifndef NATIVE_CLIENT_GDB_RSP_AGENT_EXPR_H_
+#define NATIVE_CLIENT_GDB_RSP_AGENT_EXPR_H_ 1
+
+#include <string>
+
+#include "native_client/src/include/portability.h"
+
+namespace gdb_rsp {
+
+// Provides the state of the stopped thread an expression is evaluated
+// against.
+class IAgentExprContext {
+ public:
+  virtual ~IAgentExprContext() {}
+
+  // Fetch register REGNO, numbered as in the target description.
+  virtual bool GetRegister(uint32_t regno, uint64_t *value) = 0;
+
+  // Read SIZE bytes of untrusted memory at ADDR.
+  virtual bool ReadMemory(uint64_t addr, void *dst, uint32_t size) = 0;
+};
+
+// Run the bytecode in EXPR.  Returns false if the expression is
+// malformed, uses an unsupported opcode, or faults (e.g. division by
+// zero or an unreadable address); otherwise sets *RESULT to the value
+// on top of the stack when the "end" opcode is reached.
+bool EvalAgentExpr(const std::string &expr, IAgentExprContext *ctx,
+                   uint64_t *result);
+
+}  // namespace gdb_rsp
+
+#endif  // NATIVE_CLIENT_GDB_RSP_AGENT_EXPR_H_
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "native_client/src/trusted/debug_stub/agent_expr.h"
+#include "native_client/src/trusted/debug_stub/test.h"
+
+using gdb_rsp::EvalAgentExpr;
+using gdb_rsp::IAgentExprContext;
+
+// Registers hold 0x100 + regno and memory is a small little-endian
+// buffer at address 0x1000.
+class FakeContext : public IAgentExprContext {
+ public:
+  FakeContext() {
+    for (int i = 0; i < 16; i++) {
+      memory_[i] = static_cast<uint8_t>(0xf0 + i);
+    }
+  }
+
+  virtual bool GetRegister(uint32_t regno, uint64_t *value) {
+    if (regno >= 16) return false;
+    *value = 0x100 + regno;
+    return true;
+  }
+
+  virtual bool ReadMemory(uint64_t addr, void *dst, uint32_t size) {
+    if (addr < 0x1000 || addr + size > 0x1000 + sizeof(memory_)) {
+      return false;
+    }
+    memcpy(dst, memory_ + (addr - 0x1000), size);
+    return true;
+  }
+
+ private:
+  uint8_t memory_[16];
+};
+
+static int CheckExpr(const char *name, const char *code, size_t size,
+                     bool expect_ok, uint64_t expect_value) {
+  FakeContext ctx;
+  uint64_t value = 0;
+  bool ok = EvalAgentExpr(std::string(code, size), &ctx, &value);
+  if (ok != expect_ok || (ok && value != expect_value)) {
+    printf("Agent expression %s: got %d/0x%llx, expected %d/0x%llx\n",
+           name, ok, (unsigned long long) value,
+           expect_ok, (unsigned long long) expect_value);
+    return 1;
+  }
+  return 0;
+}
+
+#define CHECK_EXPR(name, code, ok, value) \
+  errs += CheckExpr(name, code, sizeof(code) - 1, ok, value)
+
+int TestAgentExpr() {
+  int errs = 0;
+
+  // const8 2, const8 3, add, end
+  CHECK_EXPR("add", "\x22\x02\x22\x03\x02\x27", true, 5);
+  // const8 2, const8 3, sub, end
+  CHECK_EXPR("sub", "\x22\x02\x22\x03\x03\x27", true, (uint64_t) -1);
+  // const8 0xff, ext 8, end
+  CHECK_EXPR("ext", "\x22\xff\x16\x08\x27", true, (uint64_t) -1);
+  // const16 0x1234, zero_ext 8, end
+  CHECK_EXPR("zero_ext", "\x23\x12\x34\x2a\x08\x27", true, 0x34);
+  // const8 7, const8 0, div_signed, end
+  CHECK_EXPR("div by zero", "\x22\x07\x22\x00\x05\x27", false, 0);
+  // reg 3, const16 0x103, equal, end
+  CHECK_EXPR("reg", "\x26\x00\x03\x23\x01\x03\x13\x27", true, 1);
+  // reg 99, end
+  CHECK_EXPR("bad reg", "\x26\x00\x63\x27", false, 0);
+  // const16 0x1002, ref16, end
+  CHECK_EXPR("ref16", "\x23\x10\x02\x18\x27", true, 0xf3f2);
+  // const16 0x100e, ref32, end (crosses the end of memory)
+  CHECK_EXPR("bad ref", "\x23\x10\x0e\x19\x27", false, 0);
+  // const8 1, if_goto 8, const8 5, end, const8 9, end
+  CHECK_EXPR("if_goto", "\x22\x01\x20\x00\x08\x22\x05\x27\x22\x09\x27",
+             true, 9);
+  // goto 0: loops forever.
+  CHECK_EXPR("loop", "\x21\x00\x00", false, 0);
+  // const8 1, const8 2, const8 3, rot, end
+  CHECK_EXPR("rot", "\x22\x01\x22\x02\x22\x03\x33\x27", true, 2);
+  // const8 1, const8 2, pick 1, end
+  CHECK_EXPR("pick", "\x22\x01\x22\x02\x32\x01\x27", true, 1);
+  // add, end: stack underflow.
+  CHECK_EXPR("underflow", "\x02\x27", false, 0);
+  // const8 1 with no end.
+  CHECK_EXPR("truncated", "\x22\x01", false, 0);
+  // float: unsupported.
+  CHECK_EXPR("float", "\x01\x27", false, 0);
+
+  return errs;
+}
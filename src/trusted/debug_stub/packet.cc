@@ -23,7 +23,7 @@ using port::IPlatform;
 namespace gdb_rsp {
 
 #define MIN_PAD 1
-#define GROW_SIZE  64
+#define INITIAL_SIZE 64
 
 Packet::Packet() {
   seq_ = -1;
@@ -32,7 +32,7 @@ Packet::Packet() {
 
 void Packet::Clear() {
   data_.clear();
-  data_.resize(GROW_SIZE);
+  data_.resize(INITIAL_SIZE);
   data_[0] = 0;
 
   read_index_  = 0;
@@ -48,10 +48,11 @@ bool Packet::EndOfPacket() const {
 }
 
 void Packet::AddRawChar(char ch) {
-  // Grow by a fixed amount whenever we are within the pad boundry.
+  // Double the size whenever we are within the pad boundry, so that
+  // building a large reply (such as a binary memory read) is linear.
   // The pad boundry allows for the addition of NUL termination.
   if (data_.size() <= (write_index_ + MIN_PAD)) {
-    data_.resize(data_.size() + GROW_SIZE);
+    data_.resize(data_.size() * 2);
   }
 
   // Add character and always null terminate.
@@ -350,6 +351,29 @@ bool Packet::GetBlock(void *ptr, uint32_t len) {
   return res;
 }
 
+bool Packet::GetEscapedBlock(void *ptr, uint32_t len) {
+  assert(ptr);
+
+  uint8_t *p = reinterpret_cast<uint8_t *>(ptr);
+
+  // Binary data is read directly rather than through GetRawChar, since
+  // the sender escapes '*' and so the data is never run length encoded.
+  for (uint32_t offs = 0; offs < len; offs++) {
+    if (read_index_ >= write_index_) {
+      return false;
+    }
+    char ch = data_[read_index_++];
+    if (ch == '}') {
+      if (read_index_ >= write_index_) {
+        return false;
+      }
+      ch = data_[read_index_++] ^ 0x20;
+    }
+    p[offs] = static_cast<uint8_t>(ch);
+  }
+  return true;
+}
+
 bool Packet::GetWord16(uint16_t *ptr) {
   assert(ptr);
   return GetBlock(ptr, sizeof(*ptr));
@@ -97,10 +97,77 @@ int VerifyPacket(Packet *wr, Packet *rd, void *ctx, PacketFunc_t tx) {
   return errs;
 }
 
+int VerifyEscapedBlock(Packet *pkt) {
+  int errs = 0;
+  char ch;
+
+  // Binary data as GDB sends it in an 'X' packet: '}', '#', '$' and '*'
+  // are escaped as '}' followed by the byte xor-ed with 0x20.
+  const char escaped[] = "a}]}\x03}\x04}\x0a\x00z";
+  const uint8_t expected[] = { 'a', '}', '#', '$', '*', 0, 'z' };
+  uint8_t block[sizeof(expected)];
+
+  pkt->Clear();
+  for (size_t i = 0; i < sizeof(escaped) - 1; i++) {
+    pkt->AddRawChar(escaped[i]);
+  }
+  if (!pkt->GetEscapedBlock(block, sizeof(block)) ||
+      memcmp(block, expected, sizeof(block)) != 0) {
+    printf("Failed to decode escaped block.\n");
+    errs++;
+  }
+  if (pkt->GetRawChar(&ch)) {
+    printf("Escaped block left data behind.\n");
+    errs++;
+  }
+
+  // Asking for more data than the packet holds must fail.
+  pkt->Rewind();
+  if (pkt->GetEscapedBlock(block, sizeof(block) + 1)) {
+    printf("Escaped block read past end of packet.\n");
+    errs++;
+  }
+
+  // A trailing escape character is truncated data.
+  pkt->Clear();
+  pkt->AddRawChar('}');
+  if (pkt->GetEscapedBlock(block, 1)) {
+    printf("Accepted a truncated escape.\n");
+    errs++;
+  }
+  return errs;
+}
+
+int VerifyLargePacket(Packet *pkt) {
+  int errs = 0;
+  const size_t kSize = 256 * 1024;
+  std::string str;
+
+  pkt->Clear();
+  for (size_t i = 0; i < kSize; i++) {
+    pkt->AddRawChar(static_cast<char>('a' + i % 26));
+  }
+  if (pkt->GetPayloadSize() != kSize) {
+    printf("Large packet has the wrong size.\n");
+    errs++;
+  }
+  pkt->GetString(&str);
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] != static_cast<char>('a' + i % 26)) {
+      printf("Large packet is corrupt at %d.\n", static_cast<int>(i));
+      errs++;
+      break;
+    }
+  }
+  return errs;
+}
+
 int TestPacket() {
   int errs = 0;
   Packet pkt;
 
   errs += VerifyPacket(&pkt, &pkt, NULL, NULL);
+  errs += VerifyEscapedBlock(&pkt);
+  errs += VerifyLargePacket(&pkt);
   return errs;
 }
@@ -9,7 +9,6 @@
 #include <stdlib.h>
 
 #include <string>
-#include <sstream>
 
 #include "native_client/src/shared/platform/nacl_log.h"
 #include "native_client/src/trusted/debug_stub/packet.h"
@@ -87,10 +86,14 @@ bool Session::SendPacket(Packet *pkt) {
 }
 
 
+void Session::AddOutChar(char ch, char *xsum) {
+  out_buf_.push_back(ch);
+  *xsum += ch;
+}
+
 bool Session::SendPacketOnly(Packet *pkt) {
   const char *ptr;
   char ch;
-  std::stringstream outstr;
 
   char run_xsum = 0;
   int32_t seq;
@@ -102,55 +105,48 @@ bool Session::SendPacketOnly(Packet *pkt) {
     pkt->SetSequence(seq_++);
   }
 
+  // Room for "$", an optional "ss:" sequence, the payload and "#xx".
+  out_buf_.clear();
+  out_buf_.reserve(size + 7);
+
   // Signal start of response
-  outstr << '$';
+  out_buf_.push_back('$');
 
   // If there is a sequence, send as two nibble 8bit value + ':'
   if (pkt->GetSequence(&seq)) {
     IntToNibble((seq & 0xFF) >> 4, &ch);
-    outstr << ch;
-    run_xsum += ch;
-
+    AddOutChar(ch, &run_xsum);
     IntToNibble(seq & 0xF, &ch);
-    outstr << ch;
-    run_xsum += ch;
-
-    ch = ':';
-    outstr << ch;
-    run_xsum += ch;
+    AddOutChar(ch, &run_xsum);
+    AddOutChar(':', &run_xsum);
   }
 
   // Send the main payload
   for (size_t offs = 0; offs < size; ++offs) {
-    ch = ptr[offs];
-    outstr << ch;
-    run_xsum += ch;
+    AddOutChar(ptr[offs], &run_xsum);
   }
 
   if (GetFlags() & DEBUG_SEND) {
-    NaClLog(1, "TX %s\n", outstr.str().c_str());
+    NaClLog(1, "TX %.*s\n", static_cast<int>(out_buf_.size()), &out_buf_[0]);
   }
 
   // Send XSUM as two nible 8bit value preceeded by '#'
-  outstr << '#';
+  out_buf_.push_back('#');
   IntToNibble((run_xsum >> 4) & 0xF, &ch);
-  outstr << ch;
+  out_buf_.push_back(ch);
   IntToNibble(run_xsum & 0xF, &ch);
-  outstr << ch;
+  out_buf_.push_back(ch);
 
-  return io_->Write(outstr.str().data(),
-                    static_cast<int32_t>(outstr.str().length()));
+  return io_->Write(&out_buf_[0], static_cast<int32_t>(out_buf_.size()));
 }
 
 // Attempt to receive a packet
 bool Session::GetPacket(Packet *pkt) {
   char run_xsum, fin_xsum, ch;
-  std::string in;
 
   // Toss characters until we see a start of command
   do {
     if (!GetChar(&ch)) return false;
-    in += ch;
   } while (ch != '$');
 
  retry:
@@ -168,8 +164,6 @@ bool Session::GetPacket(Packet *pkt) {
     // If we see a '#' we must be done with the data
     if (ch == '#') break;
 
-    in += ch;
-
     // If we see a '$' we must have missed the last cmd
     if (ch == '$') {
       NaClLog(LOG_INFO, "RX Missing $, retry.\n");
@@ -192,7 +186,10 @@ bool Session::GetPacket(Packet *pkt) {
   NibbleToInt(ch, &val);
   fin_xsum |= val;
 
-  if (GetFlags() & DEBUG_RECV) NaClLog(1, "RX %s\n", in.c_str());
+  if (GetFlags() & DEBUG_RECV) {
+    NaClLog(1, "RX $%.*s\n", static_cast<int>(pkt->GetPayloadSize()),
+            pkt->GetPayload());
+  }
 
   pkt->ParseSequence();
 
@@ -27,7 +27,7 @@
 #ifndef NATIVE_CLIENT_GDB_RSP_SESSION_H_
 #define NATIVE_CLIENT_GDB_RSP_SESSION_H_ 1
 
-#include <sstream>
+#include <vector>
 
 #include "native_client/src/include/portability.h"
 #include "native_client/src/trusted/debug_stub/transport.h"
@@ -73,6 +73,9 @@ class Session {
  protected:
   virtual bool GetChar(char *ch);
 
+  // Append a character to out_buf_, updating the checksum.
+  void AddOutChar(char ch, char *xsum);
+
  private:
   Session(const Session&);
   Session &operator=(const Session&);
@@ -82,6 +85,9 @@ class Session {
   uint32_t flags_;          // Session flags for Sequence/Ack generation.
   uint8_t seq_;             // Next sequence number to use or -1.
   bool connected_;          // Is the connection still valid.
+  // Framed outbound packet.  Kept between packets so that sending
+  // does not allocate once it has grown to the largest packet size.
+  std::vector<char> out_buf_;
 };
 
 }  // namespace gdb_rsp
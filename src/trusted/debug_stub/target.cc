@@ -16,6 +16,7 @@
 #include "native_client/src/shared/platform/nacl_exit.h"
 #include "native_client/src/shared/platform/nacl_log.h"
 #include "native_client/src/trusted/debug_stub/abi.h"
+#include "native_client/src/trusted/debug_stub/agent_expr.h"
 #include "native_client/src/trusted/debug_stub/packet.h"
 #include "native_client/src/trusted/debug_stub/platform.h"
 #include "native_client/src/trusted/debug_stub/session.h"
@@ -31,6 +32,7 @@
 
 #if NACL_WINDOWS
 #define snprintf sprintf_s
+#define strtoull _strtoui64
 #endif
 
 using std::string;
@@ -60,6 +62,11 @@ static const uint64_t kGdbEBADF = 9;
 // Assume a buffer size that matches GDB's actual current request size.
 static const size_t kGdbPreadChunkSize = 4096;
 
+// Largest packet we advertise to GDB.  GDB sizes its memory reads and
+// writes to fit, so a large value means fewer round trips when reading
+// big regions of memory.
+static const uint32_t kMaxPacketSize = 0x20000;
+
 
 Target::Target(struct NaClApp *nap, const Abi *abi)
   : nap_(nap),
@@ -71,6 +78,7 @@ Target::Target(struct NaClApp *nap, const Abi *abi)
     sig_thread_(0),
     reg_thread_(0),
     step_over_breakpoint_thread_(0),
+    condition_step_addr_(0),
     all_threads_suspended_(false),
     detaching_(false),
     should_exit_(false) {
@@ -82,7 +90,7 @@ Target::~Target() {
 }
 
 bool Target::Init() {
-  string targ_xml = "l<target><architecture>";
+  string targ_xml = "<target><architecture>";
 
   targ_xml += abi_->GetName();
   targ_xml += "</architecture><osabi>NaCl</osabi>";
@@ -91,8 +99,12 @@ bool Target::Init() {
 
   // Set a more specific result which won't change.
   properties_["target.xml"] = targ_xml;
-  properties_["Supported"] =
-    "PacketSize=1000;qXfer:features:read+";
+  char supported[64];
+  snprintf(supported, sizeof(supported),
+           "PacketSize=%x;qXfer:features:read+;qXfer:threads:read+;"
+           "ConditionalBreakpoints+",
+           kMaxPacketSize);
+  properties_["Supported"] = supported;
 
   NaClXMutexCtor(&mutex_);
   ctx_ = new uint8_t[abi_->GetContextSize()];
@@ -198,6 +210,150 @@ bool Target::RemoveBreakpoint(uint32_t user_address) {
   }
   delete[] data;
   breakpoint_map_.erase(iter);
+  breakpoint_conditions_.erase(user_address);
+  return true;
+}
+
+// Write either the breakpoint instruction or the original code at an
+// existing breakpoint.
+bool Target::WriteBreakpointCode(uint32_t user_address, bool insert) {
+  const Abi::BPDef *bp_def = abi_->GetBreakpointDef();
+
+  BreakpointMap_t::iterator iter = breakpoint_map_.find(user_address);
+  if (iter == breakpoint_map_.end())
+    return false;
+
+  uintptr_t sysaddr = NaClUserToSys(nap_, user_address);
+  return IPlatform::SetMemory(nap_, sysaddr, bp_def->size_,
+                              insert ? bp_def->code_ : iter->second);
+}
+
+// Parse the "Xlen,bytes" conditions that follow "Z0,addr,kind;".  GDB
+// sends them back to back; we also accept them separated by ';'.
+bool Target::ParseBreakpointConditions(Packet *pktIn,
+                                       std::vector<string> *conditions) {
+  char ch;
+  while (pktIn->GetRawChar(&ch)) {
+    if (ch == ';') continue;
+    // Breakpoint commands ("cmds:") are not supported.
+    if (ch != 'X') return false;
+
+    uint64_t len;
+    char sep;
+    if (!pktIn->GetNumberSep(&len, &sep) || sep != ',' ||
+        len > kMaxPacketSize) {
+      return false;
+    }
+    string expr(static_cast<size_t>(len), 0);
+    if (len != 0 && !pktIn->GetBlock(&expr[0], static_cast<uint32_t>(len))) {
+      return false;
+    }
+    conditions->push_back(expr);
+  }
+  return true;
+}
+
+// Gives agent expressions access to the registers and memory of a
+// thread that stopped at a breakpoint.
+class Target::ConditionContext : public IAgentExprContext {
+ public:
+  ConditionContext(Target *target, Thread *thread) : target_(target) {
+    thread->GetRegisters(target_->ctx_);
+  }
+
+  virtual bool GetRegister(uint32_t regno, uint64_t *value) {
+    const Abi::RegDef *reg = target_->abi_->GetRegisterDef(regno);
+    if (reg == NULL || reg->bytes_ > sizeof(*value)) {
+      return false;
+    }
+    // All NaCl targets are little-endian.
+    *value = 0;
+    memcpy(value, target_->ctx_ + reg->offset_, reg->bytes_);
+    return true;
+  }
+
+  virtual bool ReadMemory(uint64_t addr, void *dst, uint32_t size) {
+    uint64_t user_addr = target_->AdjustUserAddr(addr);
+    uintptr_t sys_addr = NaClUserToSysAddrRange(target_->nap_,
+                                                (uintptr_t) user_addr, size);
+    if (sys_addr == kNaClBadAddress ||
+        !IPlatform::GetMemory(sys_addr, size, dst)) {
+      return false;
+    }
+    target_->EraseBreakpointsFromCopyOfMemory(
+        (uint32_t) user_addr, reinterpret_cast<uint8_t *>(dst), size);
+    return true;
+  }
+
+ private:
+  Target *target_;
+};
+
+// Returns whether GDB needs to hear about the fault of a suspended,
+// faulted thread.  The only faults it does not need to hear about are
+// hits of conditional breakpoints whose conditions are all false.
+bool Target::IsReportableFault(Thread *thread) {
+  if (thread->GetFaultSignal() != NACL_ABI_SIGTRAP ||
+      breakpoint_conditions_.empty()) {
+    return true;
+  }
+  // A single step that stops at a breakpoint address is not a hit of
+  // the breakpoint; only the breakpoint instruction's own fault is.
+  int signal = Thread::ExceptionToSignal(thread->GetAppThread()->fault_signal);
+  if (signal == NACL_ABI_SIGTRAP) {
+    return true;
+  }
+  uint32_t prog_ctr = (uint32_t) thread->GetContext()->prog_ctr;
+  ConditionMap_t::const_iterator iter = breakpoint_conditions_.find(prog_ctr);
+  if (iter == breakpoint_conditions_.end()) {
+    return true;
+  }
+
+  ConditionContext ctx(this, thread);
+  for (size_t i = 0; i < iter->second.size(); i++) {
+    uint64_t value;
+    // As in gdbserver, a condition that cannot be evaluated is
+    // treated as true, so that the user gets to see the problem.
+    if (!EvalAgentExpr(iter->second[i], &ctx, &value) || value != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// If every faulted thread is at a breakpoint whose conditions are false,
+// step one of them over its breakpoint and return true, without
+// involving GDB.  The breakpoint has to be lifted while the thread
+// executes the original instruction, so the other threads stay
+// suspended until the step is done; when it is, ProcessDebugEvent()
+// puts the breakpoint back and resumes everything.  Any other faulted
+// threads will fault again on the same breakpoint and be evaluated on
+// the next round.  As a precondition, all threads must be suspended.
+bool Target::StepOverUnreportedBreakpoint() {
+  Thread *step_thread = NULL;
+  for (ThreadMap_t::const_iterator iter = threads_.begin();
+       iter != threads_.end();
+       ++iter) {
+    Thread *thread = iter->second;
+    if (thread->GetFaultSignal() == 0) continue;
+    if (IsReportableFault(thread)) return false;
+    if (step_thread == NULL) step_thread = thread;
+  }
+  if (step_thread == NULL) return false;
+
+  uint32_t prog_ctr = (uint32_t) step_thread->GetContext()->prog_ctr;
+  if (!step_thread->SetStep(true)) {
+    // Without hardware single step, leave it to GDB.
+    return false;
+  }
+  if (!WriteBreakpointCode(prog_ctr, false)) {
+    step_thread->SetStep(false);
+    return false;
+  }
+  step_thread->UnqueueFaultedThread();
+  condition_step_addr_ = prog_ctr;
+  step_over_breakpoint_thread_ = step_thread->GetId();
+  step_thread->ResumeThread();
   return true;
 }
 
@@ -374,6 +530,23 @@ void Target::ProcessDebugEvent() {
     // suspend the single thread that we allowed to run.
     thread->SuspendThread();
     CopyFaultSignalFromAppThread(thread);
+    if (condition_step_addr_ != 0) {
+      // The stub stepped this thread over a breakpoint whose condition
+      // was false.  Put the breakpoint back and, unless the step hit a
+      // real fault that GDB needs to see, carry on running.
+      if (!WriteBreakpointCode(condition_step_addr_, true)) {
+        NaClLog(LOG_FATAL, "ProcessDebugEvent: Failed to restore "
+                "breakpoint at 0x%x\n", condition_step_addr_);
+      }
+      condition_step_addr_ = 0;
+      if (thread->GetFaultSignal() == NACL_ABI_SIGTRAP) {
+        thread->SetStep(false);
+        thread->UnqueueFaultedThread();
+        step_over_breakpoint_thread_ = 0;
+        ResumeAllThreads();
+        return;
+      }
+    }
     cur_signal_ = thread->GetFaultSignal();
     thread->UnqueueFaultedThread();
     sig_thread_ = step_over_breakpoint_thread_;
@@ -384,6 +557,10 @@ void Target::ProcessDebugEvent() {
     // need to ensure that all threads are suspended.  Then we can
     // retrieve a thread from the set of faulted threads.
     SuspendAllThreads();
+    if (StepOverUnreportedBreakpoint()) {
+      // No need to involve GDB.
+      return;
+    }
     UnqueueAnyFaultedThread(&sig_thread_, &cur_signal_);
     reg_thread_ = sig_thread_;
   } else {
@@ -506,6 +683,17 @@ void Target::SetStopReply(Packet *pktOut) const {
     // Add 'thread:<tid>;' pair. Note terminating ';' is required.
     pktOut->AddString("thread:");
     pktOut->AddNumberSep(sig_thread_, ';');
+
+    // Expedite the instruction pointer, which saves GDB reading all the
+    // registers of the thread just to find out where it stopped.
+    ThreadMap_t::const_iterator itr = threads_.find(sig_thread_);
+    if (itr != threads_.end()) {
+      const Abi::RegDef *ip = abi_->GetInstPtrDef();
+      itr->second->GetRegisters(ctx_);
+      pktOut->AddNumberSep(ip->index_, ':');
+      pktOut->AddBlock(ctx_ + ip->offset_, ip->bytes_);
+      pktOut->AddRawChar(';');
+    }
   }
 }
 
@@ -645,6 +833,160 @@ void Target::ProcessFilePacket(Packet *pktIn, Packet *pktOut, ErrDef *err) {
   *err = BAD_FORMAT;
 }
 
+void Target::ProcessXferRead(const string &data, const char *args,
+                             Packet *pktOut, ErrDef *err) {
+  char *end;
+  uint64_t offset = strtoull(args, &end, 16);
+  if (end == args || *end != ',') {
+    *err = BAD_FORMAT;
+    return;
+  }
+  args = end + 1;
+  uint64_t length = strtoull(args, &end, 16);
+  if (end == args || *end != 0) {
+    *err = BAD_FORMAT;
+    return;
+  }
+
+  // Leave room for the escaping of the data.
+  length = std::min(length, static_cast<uint64_t>(kMaxPacketSize / 2));
+  if (offset >= data.size()) {
+    pktOut->AddRawChar('l');
+    return;
+  }
+  size_t size = static_cast<size_t>(
+      std::min(length, static_cast<uint64_t>(data.size() - offset)));
+  // 'l' marks the last chunk, 'm' tells GDB to ask for more.
+  pktOut->AddRawChar(offset + size < data.size() ? 'm' : 'l');
+  pktOut->AddEscapedData(data.data() + offset, size);
+}
+
+void Target::GetThreadsXml(string *xml) {
+  *xml = "<?xml version=\"1.0\"?>\n<threads>\n";
+  for (ThreadMap_t::const_iterator itr = threads_.begin();
+       itr != threads_.end();
+       ++itr) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "<thread id=\"%x\"/>\n", itr->first);
+    *xml += buf;
+  }
+  *xml += "</threads>\n";
+}
+
+bool Target::ProcessVContActions(const char *actions, ErrDef *err) {
+  // Action applied to threads not named explicitly, or 0 if none.
+  char default_action = 0;
+  // Actions for explicitly named threads.  As in GDB, the leftmost
+  // action naming a thread wins.
+  std::map<uint32_t, char> thread_actions;
+
+  if (*actions == 0) {
+    *err = BAD_FORMAT;
+    return false;
+  }
+  while (*actions != 0) {
+    if (*actions++ != ';') {
+      *err = BAD_FORMAT;
+      return false;
+    }
+    char action = *actions++;
+    if (action == 'C' || action == 'S') {
+      // We have no way to inject a signal into untrusted code, so the
+      // signal number is accepted and ignored.
+      char *end;
+      strtoul(actions, &end, 16);
+      if (end == actions) {
+        *err = BAD_FORMAT;
+        return false;
+      }
+      actions = end;
+      action = action == 'C' ? 'c' : 's';
+    } else if (action != 'c' && action != 's') {
+      // Stop ('t') and range stepping ('r') are not supported.
+      *err = BAD_FORMAT;
+      return false;
+    }
+
+    if (*actions == ':') {
+      char *end;
+      const char *tid = actions + 1;
+      uint64_t thread_id = strtoull(tid, &end, 16);
+      if (end == tid) {
+        *err = BAD_FORMAT;
+        return false;
+      }
+      actions = end;
+      if (strncmp(tid, "-1", 2) != 0) {
+        if (threads_.find(static_cast<uint32_t>(thread_id)) ==
+            threads_.end()) {
+          *err = BAD_ARGS;
+          return false;
+        }
+        thread_actions.insert(std::make_pair(
+            static_cast<uint32_t>(thread_id), action));
+        continue;
+      }
+    }
+    if (default_action != 0) {
+      *err = BAD_FORMAT;
+      return false;
+    }
+    default_action = action;
+  }
+
+  if (default_action == 's') {
+    // Single stepping all threads is not supported.
+    *err = BAD_ARGS;
+    return false;
+  }
+
+  if (default_action == 0) {
+    // Resume one thread and keep other threads stopped.
+    //
+    // GDB uses single step of one thread to continue from a breakpoint,
+    // which works by:
+    // - replacing trap instruction with the original instruction;
+    // - single-stepping through the original instruction. Other threads
+    //   must remain stopped, otherwise they might execute the code at
+    //   the same address and thus miss the breakpoint;
+    // - replacing the original instruction with trap instruction;
+    // - continuing all threads;
+    //
+    // GDB sends continue of one thread for software single step, which
+    // is used:
+    // - on Win64 to step over rsp modification and subsequent rsp
+    //   sandboxing at once. For details, see:
+    //     http://code.google.com/p/nativeclient/issues/detail?id=2903
+    // - TODO: on ARM, which has no hardware support for single step
+    // - TODO: to step over syscalls
+    //
+    // Unfortunately, we can't make this just Win-specific. We might
+    // use Linux GDB to connect to Win debug stub, so even Linux GDB
+    // should send software single step. Vice versa, software single
+    // step-enabled Win GDB might be connected to Linux debug stub,
+    // so even Linux debug stub should accept software single step.
+    //
+    // Only the signaled thread can be resumed on its own.
+    if (thread_actions.size() != 1 ||
+        thread_actions.begin()->first != sig_thread_) {
+      *err = BAD_ARGS;
+      return false;
+    }
+    step_over_breakpoint_thread_ = sig_thread_;
+  }
+
+  // Everything is valid, so now set up single stepping.  Threads named
+  // with 'c' just continue along with the rest.
+  for (std::map<uint32_t, char>::const_iterator itr = thread_actions.begin();
+       itr != thread_actions.end();
+       ++itr) {
+    if (itr->second == 's') {
+      threads_[itr->first]->SetStep(true);
+    }
+  }
+  return true;
+}
+
 bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
   char cmd;
   int32_t seq = -1;
@@ -769,7 +1111,11 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
 
     // IN : $maaaa,llll
     // OUT: $xx..xx
-    case 'm': {
+    //
+    // IN : $xaaaa,llll
+    // OUT: $b<binary>
+    case 'm':
+    case 'x': {
         uint64_t user_addr;
         uint64_t wlen;
         uint32_t len;
@@ -798,13 +1144,22 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
         EraseBreakpointsFromCopyOfMemory((uint32_t) user_addr,
                                          block.get(), len);
 
-        pktOut->AddBlock(block.get(), len);
+        if (cmd == 'x') {
+          pktOut->AddRawChar('b');
+          pktOut->AddEscapedData(reinterpret_cast<char *>(block.get()), len);
+        } else {
+          pktOut->AddBlock(block.get(), len);
+        }
         break;
       }
 
     // IN : $Maaaa,llll:xx..xx
     // OUT: $OK
-    case 'M':  {
+    //
+    // IN : $Xaaaa,llll:<binary>
+    // OUT: $OK
+    case 'M':
+    case 'X': {
         uint64_t user_addr;
         uint64_t wlen;
         uint32_t len;
@@ -825,6 +1180,11 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
           break;
         }
         len = static_cast<uint32_t>(wlen);
+        // GDB probes for 'X' support with an empty write.
+        if (len == 0) {
+          pktOut->AddString("OK");
+          break;
+        }
         // We disallow the debugger from modifying code.
         if (user_addr < nap_->dynamic_text_end) {
           err = FAILED;
@@ -832,7 +1192,16 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
         }
 
         nacl::scoped_array<uint8_t> block(new uint8_t[len]);
-        pktIn->GetBlock(block.get(), len);
+        bool ok;
+        if (cmd == 'X') {
+          ok = pktIn->GetEscapedBlock(block.get(), len);
+        } else {
+          ok = pktIn->GetBlock(block.get(), len);
+        }
+        if (!ok) {
+          err = BAD_FORMAT;
+          break;
+        }
 
         if (!port::IPlatform::SetMemory(nap_, sys_addr, len, block.get())) {
           err = FAILED;
@@ -869,22 +1238,20 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
       }
 
       // Check for architecture query
-      tmp = "Xfer:features:read:target.xml";
+      tmp = "Xfer:features:read:target.xml:";
       if (!strncmp(str, tmp.data(), tmp.length())) {
-        stringvec args = StringSplit(&str[tmp.length()+1], ",");
-        if (args.size() != 2) break;
-
-        const char *out = properties_["target.xml"].data();
-        int offs = strtol(args[0].data(), NULL, 16);
-        int max  = strtol(args[1].data(), NULL, 16) + offs;
-        int len  = static_cast<int>(strlen(out));
-
-        if (max >= len) max = len;
+        ProcessXferRead(properties_["target.xml"], &str[tmp.length()],
+                        pktOut, &err);
+        break;
+      }
 
-        while (offs < max) {
-          pktOut->AddRawChar(out[offs]);
-          offs++;
-        }
+      // Check for thread list query, which gets all the threads in one
+      // packet instead of one per qsThreadInfo round trip.
+      tmp = "Xfer:threads:read::";
+      if (!strncmp(str, tmp.data(), tmp.length())) {
+        string xml;
+        GetThreadsXml(&xml);
+        ProcessXferRead(xml, &str[tmp.length()], pktOut, &err);
         break;
       }
 
@@ -930,84 +1297,9 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
           break;
         }
 
-        if (strcmp(subcommand, ";c") == 0) {
-          // Continue all threads.
-          return true;
-        }
-
-        if (strncmp(subcommand, ";s:", 3) == 0) {
-          // Single step one thread and optionally continue all other threads.
-          char *end;
-          uint32_t thread_id = static_cast<uint32_t>(
-              strtol(subcommand + 3, &end, 16));
-          if (end == subcommand + 3) {
-            err = BAD_ARGS;
-            break;
-          }
-
-          ThreadMap_t::iterator it = threads_.find(thread_id);
-          if (it == threads_.end()) {
-            err = BAD_ARGS;
-            break;
-          }
-
-          if (*end == 0) {
-            // Single step one thread and keep other threads stopped.
-            // GDB uses this to continue from a breakpoint, which works by:
-            // - replacing trap instruction with the original instruction;
-            // - single-stepping through the original instruction. Other threads
-            //   must remain stopped, otherwise they might execute the code at
-            //   the same address and thus miss the breakpoint;
-            // - replacing the original instruction with trap instruction;
-            // - continuing all threads;
-            if (thread_id != sig_thread_) {
-              err = BAD_ARGS;
-              break;
-            }
-            step_over_breakpoint_thread_ = sig_thread_;
-          } else if (strcmp(end, ";c") == 0) {
-            // Single step one thread and continue all other threads.
-          } else {
-            // Unsupported combination of single step and other args.
-            err = BAD_ARGS;
-            break;
-          }
-
-          it->second->SetStep(true);
+        if (ProcessVContActions(subcommand, &err)) {
           return true;
         }
-
-        // Continue one thread and keep other threads stopped.
-        //
-        // GDB sends this for software single step, which is used:
-        // - on Win64 to step over rsp modification and subsequent rsp
-        //   sandboxing at once. For details, see:
-        //     http://code.google.com/p/nativeclient/issues/detail?id=2903
-        // - TODO: on ARM, which has no hardware support for single step
-        // - TODO: to step over syscalls
-        //
-        // Unfortunately, we can't make this just Win-specific. We might
-        // use Linux GDB to connect to Win debug stub, so even Linux GDB
-        // should send software single step. Vice versa, software single
-        // step-enabled Win GDB might be connected to Linux debug stub,
-        // so even Linux debug stub should accept software single step.
-        if (strncmp(subcommand, ";c:", 3) == 0) {
-          char *end;
-          uint32_t thread_id = static_cast<uint32_t>(
-              strtol(subcommand + 3, &end, 16));
-          if (end != subcommand + 3 && *end == 0) {
-            if (thread_id == sig_thread_) {
-              step_over_breakpoint_thread_ = sig_thread_;
-              return true;
-            }
-          }
-
-          err = BAD_ARGS;
-          break;
-        }
-
-        // Unsupported form of vCont.
-        err = BAD_FORMAT;
         break;
       } else if (strncmp(str, "File:", 5) == 0) {
         ProcessFilePacket(pktIn, pktOut, &err);
@@ -1018,22 +1310,42 @@ bool Target::ProcessPacket(Packet *pktIn, Packet *pktOut) {
       return false;
     }
 
+    // IN : $Z0,aaaa,k[;Xlen,expr...]
+    // OUT: $OK
     case 'Z': {
       uint64_t breakpoint_type;
       uint64_t breakpoint_address;
       uint64_t breakpoint_kind;
+      char sep;
+      std::vector<string> conditions;
       if (!pktIn->GetNumberSep(&breakpoint_type, 0) ||
           breakpoint_type != 0 ||
           !pktIn->GetNumberSep(&breakpoint_address, 0) ||
-          !pktIn->GetNumberSep(&breakpoint_kind, 0)) {
+          !pktIn->GetNumberSep(&breakpoint_kind, &sep) ||
+          (sep == ';' && !ParseBreakpointConditions(pktIn, &conditions))) {
         err = BAD_FORMAT;
         break;
       }
-      if (breakpoint_address != (uint32_t) breakpoint_address ||
-          !AddBreakpoint((uint32_t) breakpoint_address)) {
+      if (breakpoint_address != (uint32_t) breakpoint_address) {
         err = FAILED;
         break;
       }
+      uint32_t user_address = (uint32_t) breakpoint_address;
+      // GDB sends Z0 again for an inserted breakpoint when its
+      // conditions change, so only a plain duplicate is an error.
+      bool update = breakpoint_map_.find(user_address) !=
+                        breakpoint_map_.end() &&
+                    (!conditions.empty() ||
+                     breakpoint_conditions_.count(user_address) != 0);
+      if (!update && !AddBreakpoint(user_address)) {
+        err = FAILED;
+        break;
+      }
+      if (conditions.empty()) {
+        breakpoint_conditions_.erase(user_address);
+      } else {
+        breakpoint_conditions_[user_address] = conditions;
+      }
       pktOut->AddString("OK");
       break;
     }
@@ -1186,15 +1498,20 @@ void Target::ResumeAllThreads() {
 // |thread_id| and the type of fault via |signal|.  As a precondition,
 // all threads must be currently suspended.
 void Target::UnqueueAnyFaultedThread(uint32_t *thread_id, int8_t *signal) {
-  for (ThreadMap_t::const_iterator iter = threads_.begin();
-       iter != threads_.end();
-       ++iter) {
-    Thread *thread = iter->second;
-    if (thread->GetFaultSignal() != 0) {
-      *signal = thread->GetFaultSignal();
-      *thread_id = thread->GetId();
-      thread->UnqueueFaultedThread();
-      return;
+  // Prefer a thread whose fault GDB needs to hear about, leaving threads
+  // at breakpoints with false conditions queued.
+  for (int pass = 0; pass < 2; pass++) {
+    for (ThreadMap_t::const_iterator iter = threads_.begin();
+         iter != threads_.end();
+         ++iter) {
+      Thread *thread = iter->second;
+      if (thread->GetFaultSignal() != 0 &&
+          (pass == 1 || IsReportableFault(thread))) {
+        *signal = thread->GetFaultSignal();
+        *thread_id = thread->GetId();
+        thread->UnqueueFaultedThread();
+        return;
+      }
     }
   }
   NaClLog(LOG_FATAL, "UnqueueAnyFaultedThread: No threads queued\n");
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "native_client/src/trusted/debug_stub/mutex.h"
 #include "native_client/src/trusted/debug_stub/platform.h"
@@ -51,6 +52,8 @@ class Target {
   typedef std::map<uint32_t, port::Thread*> ThreadMap_t;
   typedef std::map<std::string, std::string> PropertyMap_t;
   typedef std::map<uint32_t, uint8_t*> BreakpointMap_t;
+  // Agent expression bytecode of the conditions of a breakpoint.
+  typedef std::map<uint32_t, std::vector<std::string> > ConditionMap_t;
 
  public:
   // Contruct a Target object.  By default use the native ABI.
@@ -93,6 +96,16 @@ class Target {
   void EmitFileError(Packet *pktOut, int code);
   void ProcessFilePacket(Packet *pktIn, Packet *pktOut, ErrDef *err);
 
+  // Reply to a qXfer read of DATA, where ARGS is the "offset,length"
+  // part of the request.
+  void ProcessXferRead(const std::string &data, const char *args,
+                       Packet *pktOut, ErrDef *err);
+  void GetThreadsXml(std::string *xml);
+
+  // Parse the action list of a vCont packet and prepare the threads
+  // for resuming.  Returns true if the target should resume.
+  bool ProcessVContActions(const char *actions, ErrDef *err);
+
   void SetStopReply(Packet *pktOut) const;
 
   void Destroy();
@@ -108,6 +121,11 @@ class Target {
 
   bool AddBreakpoint(uint32_t user_address);
   bool RemoveBreakpoint(uint32_t user_address);
+  bool WriteBreakpointCode(uint32_t user_address, bool insert);
+  bool ParseBreakpointConditions(Packet *pktIn,
+                                 std::vector<std::string> *conditions);
+  bool IsReportableFault(port::Thread *thread);
+  bool StepOverUnreportedBreakpoint();
   void CopyFaultSignalFromAppThread(port::Thread *thread);
   void RemoveInitialBreakpoint();
   bool IsInitialBreakpointActive();
@@ -127,6 +145,8 @@ class Target {
   void MaskAlwaysValidRegisters();
 
  private:
+  class ConditionContext;
+
   struct NaClApp *nap_;
   const Abi *abi_;
 
@@ -138,6 +158,9 @@ class Target {
   ThreadMap_t threads_;
   ThreadMap_t::const_iterator threadItr_;
   BreakpointMap_t breakpoint_map_;
+  // Breakpoints that are only reported to GDB when one of their
+  // conditions evaluates to true.
+  ConditionMap_t breakpoint_conditions_;
   // If non-zero, an initial breakpoint is set at the given untrusted
   // code address.
   uint32_t initial_breakpoint_addr_;
@@ -161,6 +184,11 @@ class Target {
   // suspended.
   uint32_t step_over_breakpoint_thread_;
 
+  // If non-zero, step_over_breakpoint_thread_ is stepping over the
+  // breakpoint at this address because its condition was false.  The
+  // stub resumes all threads itself when the step finishes.
+  uint32_t condition_step_addr_;
+
   // Whether all threads are currently suspended.
   bool all_threads_suspended_;
 
@@ -24,6 +24,9 @@ int main(int argc, const char *argv[]) {
   printf("Testing ABI.\n");
   errs += TestAbi();
 
+  printf("Testing Agent Expressions.\n");
+  errs += TestAgentExpr();
+
   printf("Testing Packets.\n");
   errs += TestPacket();
 
@@ -24,6 +24,7 @@ int VerifyPacket(gdb_rsp::Packet *wr, gdb_rsp::Packet *rd,
                  void *ctx, PacketFunc_t tx);
 
 int TestAbi();
+int TestAgentExpr();
 int TestPacket();
 int TestSession();
 int TestUtil();
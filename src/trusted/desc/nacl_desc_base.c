@@ -81,13 +81,21 @@ int NaClDescCtor(struct NaClDesc *ndp) {
   ndp->metadata_type = NACL_DESC_METADATA_NONE_TYPE;
   ndp->metadata_num_bytes = 0;
   ndp->metadata = NULL;
-  return NaClRefCountCtor(&ndp->base);
+  if (!NaClFastMutexCtor(&ndp->mu)) {
+    return 0;
+  }
+  if (!NaClRefCountCtor(&ndp->base)) {
+    NaClFastMutexDtor(&ndp->mu);
+    return 0;
+  }
+  return 1;
 }
 
 static void NaClDescDtor(struct NaClRefCount *nrcp) {
   struct NaClDesc *ndp = (struct NaClDesc *) nrcp;
   free(ndp->metadata);
   ndp->metadata = NULL;
+  NaClFastMutexDtor(&ndp->mu);
   nrcp->vtbl = &kNaClRefCountVtbl;
   (*nrcp->vtbl->Dtor)(nrcp);
 }
@@ -209,6 +217,7 @@ int (*NaClDescInternalize[NACL_DESC_TYPE_MAX])(
   NaClDescInternalizeNotImplemented,  /* quota wrapper */
   NaClDescInternalizeNotImplemented,  /* custom */
   NaClDescNullInternalize,
+  NaClDescInternalizeNotImplemented,  /* buffered wrapper */
 };
 
 char const *NaClDescTypeString(enum NaClDescTypeTag type_tag) {
@@ -233,6 +242,7 @@ char const *NaClDescTypeString(enum NaClDescTypeTag type_tag) {
     MAP(NACL_DESC_QUOTA);
     MAP(NACL_DESC_CUSTOM);
     MAP(NACL_DESC_NULL);
+    MAP(NACL_DESC_BUFFERED);
   }
   return "BAD TYPE TAG";
 }
@@ -334,6 +344,48 @@ ssize_t NaClDescPWriteNotImplemented(struct NaClDesc *vself,
   return -NACL_ABI_EINVAL;
 }
 
+ssize_t NaClDescReadvGeneric(struct NaClDesc              *vself,
+                             struct NaClImcMsgIoVec const *iov,
+                             size_t                       iovcnt) {
+  ssize_t total = 0;
+  ssize_t result;
+  size_t  i;
+
+  for (i = 0; i < iovcnt; ++i) {
+    result = (*NACL_VTBL(NaClDesc, vself)->Read)(vself, iov[i].base,
+                                                 iov[i].length);
+    if (result < 0) {
+      return 0 == total ? result : total;
+    }
+    total += result;
+    if ((size_t) result < iov[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
+ssize_t NaClDescWritevGeneric(struct NaClDesc              *vself,
+                              struct NaClImcMsgIoVec const *iov,
+                              size_t                       iovcnt) {
+  ssize_t total = 0;
+  ssize_t result;
+  size_t  i;
+
+  for (i = 0; i < iovcnt; ++i) {
+    result = (*NACL_VTBL(NaClDesc, vself)->Write)(vself, iov[i].base,
+                                                  iov[i].length);
+    if (result < 0) {
+      return 0 == total ? result : total;
+    }
+    total += result;
+    if ((size_t) result < iov[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
 int NaClDescFstatNotImplemented(struct NaClDesc         *vself,
                                 struct nacl_abi_stat    *statbuf) {
   UNREFERENCED_PARAMETER(statbuf);
@@ -404,6 +456,16 @@ ssize_t NaClDescGetdentsNotImplemented(struct NaClDesc          *vself,
   return -NACL_ABI_EINVAL;
 }
 
+ssize_t NaClDescGetdentsPlusNotImplemented(struct NaClDesc  *vself,
+                                           void             *dirp,
+                                           size_t           count) {
+  UNREFERENCED_PARAMETER(vself);
+  UNREFERENCED_PARAMETER(dirp);
+  UNREFERENCED_PARAMETER(count);
+
+  return -NACL_ABI_ENOTDIR;
+}
+
 int NaClDescExternalizeSizeNotImplemented(struct NaClDesc *vself,
                                           size_t          *nbytes,
                                           size_t          *nhandles) {
@@ -627,7 +689,7 @@ int NaClDescSetMetadata(struct NaClDesc *self,
     return -NACL_ABI_ENOMEM;
   }
 
-  NaClRefCountLock(&self->base);
+  NaClFastMutexLock(&self->mu);
   if (0 != (self->flags & NACL_DESC_FLAGS_HAS_METADATA)) {
     rv = -NACL_ABI_EPERM;
     goto done;
@@ -640,7 +702,7 @@ int NaClDescSetMetadata(struct NaClDesc *self,
   self->flags = self->flags | NACL_DESC_FLAGS_HAS_METADATA;
   rv = 0;
  done:
-  NaClRefCountUnlock(&self->base);
+  NaClFastMutexUnlock(&self->mu);
   if (rv < 0) {
     free(buffer);
   }
@@ -653,7 +715,7 @@ int32_t NaClDescGetMetadata(struct NaClDesc *self,
   int rv;
   uint32_t bytes_to_copy;
 
-  NaClRefCountLock(&self->base);
+  NaClFastMutexLock(&self->mu);
   if (0 == (NACL_DESC_FLAGS_HAS_METADATA & self->flags)) {
     *metadata_buffer_bytes_in_out = 0;
     rv = NACL_DESC_METADATA_NONE_TYPE;
@@ -674,7 +736,7 @@ int32_t NaClDescGetMetadata(struct NaClDesc *self,
   *metadata_buffer_bytes_in_out = self->metadata_num_bytes;
   rv = self->metadata_type;
  done:
-  NaClRefCountUnlock(&self->base);
+  NaClFastMutexUnlock(&self->mu);
   return rv;
 }
 
@@ -684,17 +746,17 @@ int32_t NaClDescGetMetadata(struct NaClDesc *self,
  */
 void NaClDescSetFlags(struct NaClDesc *self,
                       uint32_t flags) {
-  NaClRefCountLock(&self->base);
+  NaClFastMutexLock(&self->mu);
   self->flags = ((self->flags & ~NACL_DESC_FLAGS_PUBLIC_MASK) |
                  (flags & NACL_DESC_FLAGS_PUBLIC_MASK));
-  NaClRefCountUnlock(&self->base);
+  NaClFastMutexUnlock(&self->mu);
 }
 
 uint32_t NaClDescGetFlags(struct NaClDesc *self) {
   uint32_t rv;
-  NaClRefCountLock(&self->base);
+  NaClFastMutexLock(&self->mu);
   rv = self->flags & NACL_DESC_FLAGS_PUBLIC_MASK;
-  NaClRefCountUnlock(&self->base);
+  NaClFastMutexUnlock(&self->mu);
   return rv;
 }
 
@@ -725,6 +787,8 @@ struct NaClDescVtbl const kNaClDescVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescFstatNotImplemented,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -732,6 +796,7 @@ struct NaClDescVtbl const kNaClDescVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
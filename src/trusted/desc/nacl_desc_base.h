@@ -93,7 +93,8 @@ enum NaClDescTypeTag {
   NACL_DESC_IMC_SOCKET,
   NACL_DESC_QUOTA,
   NACL_DESC_CUSTOM,
-  NACL_DESC_NULL
+  NACL_DESC_NULL,
+  NACL_DESC_BUFFERED
   /*
    * Add new NaClDesc subclasses here.
    *
@@ -101,7 +102,7 @@ enum NaClDescTypeTag {
    * also be updated to add new internalization functions.
    */
 };
-#define NACL_DESC_TYPE_MAX      (NACL_DESC_NULL + 1)
+#define NACL_DESC_TYPE_MAX      (NACL_DESC_BUFFERED + 1)
 #define NACL_DESC_TYPE_END_TAG  (0xff)
 
 struct NaClInternalRealHeader {
@@ -205,6 +206,21 @@ struct NaClDescVtbl {
                     size_t len,
                     nacl_off64_t offset) NACL_WUR;
 
+  /*
+   * Scatter/gather versions of Read and Write, with readv/writev
+   * semantics: the transfer stops at the first short read or write and
+   * the total number of bytes transferred is returned.  Subclasses
+   * without a native implementation use NaClDescReadvGeneric and
+   * NaClDescWritevGeneric, which call Read and Write per segment.
+   */
+  ssize_t (*Readv)(struct NaClDesc              *vself,
+                   struct NaClImcMsgIoVec const *iov,
+                   size_t                       iovcnt) NACL_WUR;
+
+  ssize_t (*Writev)(struct NaClDesc              *vself,
+                    struct NaClImcMsgIoVec const *iov,
+                    size_t                       iovcnt) NACL_WUR;
+
   int (*Fstat)(struct NaClDesc      *vself,
                struct nacl_abi_stat *statbuf);
 
@@ -227,6 +243,16 @@ struct NaClDescVtbl {
                       void            *dirp,
                       size_t          count) NACL_WUR;
 
+  /*
+   * Like Getdents, but fills dirp with struct nacl_abi_dirent_plus
+   * records, which also carry the type, size and modification time of
+   * each entry.  Descriptors that are not directories return
+   * -NACL_ABI_ENOTDIR.
+   */
+  ssize_t (*GetdentsPlus)(struct NaClDesc *vself,
+                          void            *dirp,
+                          size_t          count) NACL_WUR;
+
   /*
    * Externalization queries this for how many data bytes and how many
    * handles are needed to transfer the "this" or "self" descriptor
@@ -404,6 +430,11 @@ struct NaClDescVtbl {
 
 struct NaClDesc {
   struct NaClRefCount base NACL_IS_REFCOUNT_SUBCLASS;
+  /*
+   * Protects flags and the metadata fields.  Subclasses may also use
+   * it for short operations, to save on constructing another mutex.
+   */
+  struct NaClFastMutex mu;
   uint32_t flags;
 
   /* "public" flags -- settable by users of NaClDesc interface */
@@ -570,6 +601,14 @@ ssize_t NaClDescPWriteNotImplemented(struct NaClDesc *vself,
                                      size_t len,
                                      nacl_off64_t offset);
 
+ssize_t NaClDescReadvGeneric(struct NaClDesc              *vself,
+                             struct NaClImcMsgIoVec const *iov,
+                             size_t                       iovcnt);
+
+ssize_t NaClDescWritevGeneric(struct NaClDesc              *vself,
+                              struct NaClImcMsgIoVec const *iov,
+                              size_t                       iovcnt);
+
 int NaClDescFstatNotImplemented(struct NaClDesc       *vself,
                                 struct nacl_abi_stat  *statbuf);
 
@@ -589,6 +628,10 @@ ssize_t NaClDescGetdentsNotImplemented(struct NaClDesc  *vself,
                                        void             *dirp,
                                        size_t           count);
 
+ssize_t NaClDescGetdentsPlusNotImplemented(struct NaClDesc  *vself,
+                                           void             *dirp,
+                                           size_t           count);
+
 int NaClDescExternalizeSizeNotImplemented(struct NaClDesc *vself,
                                           size_t          *nbytes,
                                           size_t          *nhandles);
@@ -0,0 +1,803 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/portability.h"
+#include "native_client/src/include/nacl_macros.h"
+
+#include "native_client/src/shared/platform/nacl_host_desc.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_sync.h"
+#include "native_client/src/shared/platform/nacl_sync_checked.h"
+#include "native_client/src/shared/platform/nacl_threads.h"
+
+#include "native_client/src/trusted/desc/nacl_desc_buffered.h"
+
+#include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/desc/nacl_desc_io.h"
+#include "native_client/src/trusted/nacl_base/nacl_refcount.h"
+#include "native_client/src/trusted/service_runtime/include/sys/errno.h"
+
+static struct NaClDescVtbl const kNaClDescBufferedVtbl;
+
+static const size_t kFlusherStackSize = 64 << 10;
+
+#define NACL_DESC_BUFFERED_MAX_RUNS 16
+
+/* Bytes buffer[previous run's end, end) were written through owner. */
+struct NaClDescBufferedRun {
+  struct NaClDescBuffered   *owner;
+  size_t                    end;
+};
+
+/*
+ * The buffer, shared by all wrappers of the same host file, so that
+ * for example stdout and stderr redirected to one pipe or terminal
+ * reach it in the order they were written.  Each run is written out
+ * through the descriptor of the wrapper that buffered it, so sharing
+ * does not change which file offset or O_APPEND flag a write uses.
+ */
+struct NaClDescBufferedFile {
+  struct NaClMutex            mu;
+  char                        *buf;
+  size_t                      size;
+  size_t                      capacity;
+  struct NaClDescBufferedRun  runs[NACL_DESC_BUFFERED_MAX_RUNS];
+  size_t                      num_runs;
+  /* Host device and inode, if has_id; otherwise never shared. */
+  int                         has_id;
+  uint64_t                    dev;
+  uint64_t                    ino;
+  /*
+   * The rest is protected by gBufferedMu.  refs counts wrappers and
+   * NaClDescBufferedFlushAll calls in progress.
+   */
+  int                         refs;
+  struct NaClDescBufferedFile *next;
+  struct NaClDescBufferedFile *prev;
+};
+
+/*
+ * All live NaClDescBufferedFile objects, and the thread that flushes
+ * them.  gBufferedMu is never held while taking a file's mu.
+ */
+static struct NaClMutex gBufferedMu;
+static struct NaClCondVar gBufferedCv;
+static struct NaClDescBufferedFile *gBufferedList = NULL;
+static int gBufferedDirty = 0;
+static int gBufferedFlusherStarted = 0;
+static struct NaClThread gBufferedFlusher;
+
+/* Writes out the buffer run by run, recording each owner's first error. */
+static void NaClDescBufferedFlushMu(struct NaClDescBufferedFile *file) {
+  struct NaClDescBuffered *owner;
+  size_t start = 0;
+  size_t done;
+  size_t i;
+  ssize_t rv;
+
+  for (i = 0; i < file->num_runs; ++i) {
+    owner = file->runs[i].owner;
+    for (done = start; done < file->runs[i].end; done += (size_t) rv) {
+      rv = (*NACL_VTBL(NaClDesc, owner->desc)->
+            Write)(owner->desc, file->buf + done, file->runs[i].end - done);
+      if (rv <= 0) {
+        if (0 == owner->error) {
+          owner->error = rv < 0 ? (int) rv : -NACL_ABI_EIO;
+        }
+        NaClLog(3, "NaClDescBufferedFlushMu: dropped %"NACL_PRIuS" bytes\n",
+                file->runs[i].end - done);
+        break;
+      }
+    }
+    start = file->runs[i].end;
+  }
+  file->size = 0;
+  file->num_runs = 0;
+}
+
+static int NaClDescBufferedTakeErrorMu(struct NaClDescBuffered *self) {
+  int error = self->error;
+
+  self->error = 0;
+  return error;
+}
+
+/* Flushes before an operation that must see earlier writes. */
+static void NaClDescBufferedSync(struct NaClDescBuffered *self) {
+  NaClXMutexLock(&self->file->mu);
+  NaClDescBufferedFlushMu(self->file);
+  NaClXMutexUnlock(&self->file->mu);
+}
+
+static void NaClDescBufferedFileUnref(struct NaClDescBufferedFile *file);
+
+static void NaClDescBufferedMarkDirty(void) {
+  NaClXMutexLock(&gBufferedMu);
+  if (!gBufferedDirty) {
+    gBufferedDirty = 1;
+    NaClXCondVarSignal(&gBufferedCv);
+  }
+  NaClXMutexUnlock(&gBufferedMu);
+}
+
+static void WINAPI NaClDescBufferedFlusher(void *arg) {
+  struct nacl_abi_timespec interval;
+
+  UNREFERENCED_PARAMETER(arg);
+  interval.tv_sec = 0;
+  interval.tv_nsec = NACL_DESC_BUFFERED_FLUSH_MS * 1000 * 1000;
+
+  NaClXMutexLock(&gBufferedMu);
+  for (;;) {
+    while (!gBufferedDirty) {
+      NaClXCondVarWait(&gBufferedCv, &gBufferedMu);
+    }
+    /*
+     * Let more writes collect.  Nothing signals gBufferedCv while
+     * gBufferedDirty is set, so this normally waits the whole interval.
+     */
+    (void) NaClXCondVarTimedWaitRelative(&gBufferedCv, &gBufferedMu,
+                                         &interval);
+    gBufferedDirty = 0;
+    NaClXMutexUnlock(&gBufferedMu);
+    NaClDescBufferedFlushAll();
+    NaClXMutexLock(&gBufferedMu);
+  }
+}
+
+void NaClDescBufferedInit(void) {
+  if (!NaClMutexCtor(&gBufferedMu)) {
+    NaClLog(LOG_FATAL, "Cannot construct NaClDescBuffered mutex\n");
+  }
+  if (!NaClCondVarCtor(&gBufferedCv)) {
+    NaClLog(LOG_FATAL, "Cannot construct NaClDescBuffered condvar\n");
+  }
+}
+
+void NaClDescBufferedFini(void) {
+  /*
+   * The flusher thread cannot be stopped, so the lock and condvar are
+   * left in place; just make sure nothing is left unwritten.
+   */
+  NaClDescBufferedFlushAll();
+}
+
+/*
+ * Host writes can block, for example on a full pipe, so they are not
+ * made under gBufferedMu: that would stall the first write to every
+ * other buffered descriptor, and closing one, behind them.  Instead
+ * take a reference to each file and flush them after dropping it.
+ */
+void NaClDescBufferedFlushAll(void) {
+  struct NaClDescBufferedFile **files;
+  struct NaClDescBufferedFile *file;
+  size_t count = 0;
+  size_t i;
+
+  NaClXMutexLock(&gBufferedMu);
+  for (file = gBufferedList; NULL != file; file = file->next) {
+    ++count;
+  }
+  if (0 == count) {
+    NaClXMutexUnlock(&gBufferedMu);
+    return;
+  }
+  files = (struct NaClDescBufferedFile **) malloc(count * sizeof *files);
+  if (NULL == files) {
+    NaClXMutexUnlock(&gBufferedMu);
+    NaClLog(LOG_ERROR, "NaClDescBufferedFlushAll: out of memory\n");
+    return;
+  }
+  for (i = 0, file = gBufferedList; NULL != file; file = file->next) {
+    ++file->refs;
+    files[i++] = file;
+  }
+  NaClXMutexUnlock(&gBufferedMu);
+
+  for (i = 0; i < count; ++i) {
+    NaClXMutexLock(&files[i]->mu);
+    NaClDescBufferedFlushMu(files[i]);
+    NaClXMutexUnlock(&files[i]->mu);
+    NaClDescBufferedFileUnref(files[i]);
+  }
+  free(files);
+}
+
+void NaClDescBufferedResetAfterFork(void) {
+  struct NaClDescBufferedFile *file;
+  size_t i;
+
+  if (!NaClMutexCtor(&gBufferedMu)) {
+    NaClLog(LOG_FATAL, "Cannot construct NaClDescBuffered mutex\n");
+  }
+  if (!NaClCondVarCtor(&gBufferedCv)) {
+    NaClLog(LOG_FATAL, "Cannot construct NaClDescBuffered condvar\n");
+  }
+  gBufferedDirty = 0;
+  gBufferedFlusherStarted = 0;
+  for (file = gBufferedList; NULL != file; file = file->next) {
+    if (!NaClMutexCtor(&file->mu)) {
+      NaClLog(LOG_FATAL, "Cannot construct NaClDescBuffered mutex\n");
+    }
+    if (0 != file->size) {
+      NaClLog(3, "NaClDescBufferedResetAfterFork: discarded %"NACL_PRIuS
+              " bytes\n", file->size);
+    }
+    for (i = 0; i < file->num_runs; ++i) {
+      file->runs[i].owner->error = 0;
+    }
+    file->size = 0;
+    file->num_runs = 0;
+  }
+}
+
+/*
+ * Gets the identity of the host file under desc, if there is one.
+ * NaClDesc Fstat may report a fake inode number, so ask the host.
+ */
+static int NaClDescBufferedHostId(struct NaClDesc *desc,
+                                  uint64_t        *dev,
+                                  uint64_t        *ino) {
+  nacl_host_stat_t st;
+
+  if (NACL_DESC_HOST_IO != NACL_VTBL(NaClDesc, desc)->typeTag ||
+      0 != NaClHostDescFstat(((struct NaClDescIoDesc *) desc)->hd, &st) ||
+      0 == st.st_ino) {
+    return 0;
+  }
+  *dev = (uint64_t) st.st_dev;
+  *ino = (uint64_t) st.st_ino;
+  return 1;
+}
+
+static struct NaClDescBufferedFile *NaClDescBufferedFileMake(
+    size_t capacity) {
+  struct NaClDescBufferedFile *file;
+
+  file = (struct NaClDescBufferedFile *) calloc(1, sizeof *file);
+  if (NULL == file) {
+    return NULL;
+  }
+  file->buf = (char *) malloc(capacity);
+  if (NULL == file->buf) {
+    free(file);
+    return NULL;
+  }
+  if (!NaClMutexCtor(&file->mu)) {
+    free(file->buf);
+    free(file);
+    return NULL;
+  }
+  file->capacity = capacity;
+  return file;
+}
+
+static void NaClDescBufferedFileDelete(struct NaClDescBufferedFile *file) {
+  NaClMutexDtor(&file->mu);
+  free(file->buf);
+  free(file);
+}
+
+static void NaClDescBufferedFileUnref(struct NaClDescBufferedFile *file) {
+  NaClXMutexLock(&gBufferedMu);
+  if (0 != --file->refs) {
+    NaClXMutexUnlock(&gBufferedMu);
+    return;
+  }
+  if (NULL != file->prev) {
+    file->prev->next = file->next;
+  } else {
+    gBufferedList = file->next;
+  }
+  if (NULL != file->next) {
+    file->next->prev = file->prev;
+  }
+  NaClXMutexUnlock(&gBufferedMu);
+  NaClDescBufferedFileDelete(file);
+}
+
+int NaClDescBufferedCtor(struct NaClDescBuffered  *self,
+                         struct NaClDesc          *desc,
+                         size_t                   capacity) {
+  struct NaClDescBufferedFile *fresh;
+  struct NaClDescBufferedFile *file = NULL;
+  uint64_t dev = 0;
+  uint64_t ino = 0;
+  int has_id;
+
+  if (!NaClDescCtor(&self->base)) {
+    return 0;
+  }
+  fresh = NaClDescBufferedFileMake(capacity);
+  if (NULL == fresh) {
+    goto cleanup_base;
+  }
+  has_id = NaClDescBufferedHostId(desc, &dev, &ino);
+
+  NaClXMutexLock(&gBufferedMu);
+  if (!gBufferedFlusherStarted) {
+    gBufferedFlusherStarted = NaClThreadCtor(&gBufferedFlusher,
+                                             NaClDescBufferedFlusher, NULL,
+                                             kFlusherStackSize);
+  }
+  if (!gBufferedFlusherStarted) {
+    NaClXMutexUnlock(&gBufferedMu);
+    NaClLog(LOG_WARNING, "NaClDescBufferedCtor: cannot start flusher\n");
+    goto cleanup_fresh;
+  }
+  if (has_id) {
+    for (file = gBufferedList; NULL != file; file = file->next) {
+      if (file->has_id && file->dev == dev && file->ino == ino) {
+        break;
+      }
+    }
+  }
+  if (NULL == file) {
+    file = fresh;
+    fresh = NULL;
+    file->has_id = has_id;
+    file->dev = dev;
+    file->ino = ino;
+    file->prev = NULL;
+    file->next = gBufferedList;
+    if (NULL != gBufferedList) {
+      gBufferedList->prev = file;
+    }
+    gBufferedList = file;
+  }
+  ++file->refs;
+  self->desc = desc;  /* take ownership */
+  self->file = file;
+  self->error = 0;
+  NACL_VTBL(NaClDesc, self) = &kNaClDescBufferedVtbl;
+  NaClXMutexUnlock(&gBufferedMu);
+  if (NULL != fresh) {
+    NaClDescBufferedFileDelete(fresh);
+  }
+  return 1;
+
+ cleanup_fresh:
+  NaClDescBufferedFileDelete(fresh);
+ cleanup_base:
+  (*NACL_VTBL(NaClRefCount, self)->Dtor)((struct NaClRefCount *) self);
+  return 0;
+}
+
+struct NaClDesc *NaClDescBufferedMake(struct NaClDesc *desc) {
+  struct NaClDescBuffered *self;
+
+  self = (struct NaClDescBuffered *) malloc(sizeof *self);
+  if (NULL == self) {
+    return NULL;
+  }
+  if (!NaClDescBufferedCtor(self, desc,
+                            NACL_DESC_BUFFERED_DEFAULT_CAPACITY)) {
+    free(self);
+    return NULL;
+  }
+  return (struct NaClDesc *) self;
+}
+
+static void NaClDescBufferedDtor(struct NaClRefCount *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  /* Other wrappers' runs go out too; none may refer to self after this. */
+  NaClXMutexLock(&self->file->mu);
+  NaClDescBufferedFlushMu(self->file);
+  NaClXMutexUnlock(&self->file->mu);
+  if (0 != self->error) {
+    NaClLog(LOG_WARNING,
+            "NaClDescBufferedDtor: deferred write failed, error %d\n",
+            self->error);
+  }
+  NaClDescBufferedFileUnref(self->file);
+  self->file = NULL;
+  NaClRefCountUnref((struct NaClRefCount *) self->desc);
+  self->desc = NULL;
+
+  NACL_VTBL(NaClDesc, self) = &kNaClDescVtbl;
+  (*NACL_VTBL(NaClRefCount, self)->Dtor)(vself);
+}
+
+static uintptr_t NaClDescBufferedMap(struct NaClDesc          *vself,
+                                     struct NaClDescEffector  *effp,
+                                     void                     *start_addr,
+                                     size_t                   len,
+                                     int                      prot,
+                                     int                      flags,
+                                     nacl_off64_t             offset) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->
+          Map)(self->desc, effp, start_addr, len, prot, flags, offset);
+}
+
+static ssize_t NaClDescBufferedRead(struct NaClDesc *vself,
+                                    void            *buf,
+                                    size_t          len) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->Read)(self->desc, buf, len);
+}
+
+static ssize_t NaClDescBufferedWrite(struct NaClDesc  *vself,
+                                     void const       *buf,
+                                     size_t           len) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  struct NaClDescBufferedFile *file = self->file;
+  int was_empty = 0;
+  int extends_run;
+  ssize_t rv;
+
+  NaClXMutexLock(&file->mu);
+  rv = NaClDescBufferedTakeErrorMu(self);
+  if (0 != rv) {
+    goto done;
+  }
+  if (len >= file->capacity / 2) {
+    /* Large writes gain nothing from a copy; keep them in order. */
+    NaClDescBufferedFlushMu(file);
+    rv = NaClDescBufferedTakeErrorMu(self);
+    if (0 == rv) {
+      rv = (*NACL_VTBL(NaClDesc, self->desc)->Write)(self->desc, buf, len);
+    }
+    goto done;
+  }
+  extends_run = (0 != file->num_runs &&
+                 self == file->runs[file->num_runs - 1].owner);
+  if (file->size + len > file->capacity ||
+      (!extends_run && NACL_DESC_BUFFERED_MAX_RUNS == file->num_runs)) {
+    NaClDescBufferedFlushMu(file);
+    rv = NaClDescBufferedTakeErrorMu(self);
+    if (0 != rv) {
+      goto done;
+    }
+    extends_run = 0;
+  }
+  if (0 != len) {
+    was_empty = (0 == file->size);
+    if (!extends_run) {
+      file->runs[file->num_runs++].owner = self;
+    }
+    memcpy(file->buf + file->size, buf, len);
+    file->size += len;
+    file->runs[file->num_runs - 1].end = file->size;
+  }
+  rv = (ssize_t) len;
+ done:
+  NaClXMutexUnlock(&file->mu);
+  if (was_empty) {
+    NaClDescBufferedMarkDirty();
+  }
+  return rv;
+}
+
+static nacl_off64_t NaClDescBufferedSeek(struct NaClDesc  *vself,
+                                         nacl_off64_t     offset,
+                                         int              whence) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  nacl_off64_t rv;
+
+  /* Hold mu so that no write is buffered between the flush and seek. */
+  NaClXMutexLock(&self->file->mu);
+  NaClDescBufferedFlushMu(self->file);
+  rv = (*NACL_VTBL(NaClDesc, self->desc)->Seek)(self->desc, offset, whence);
+  NaClXMutexUnlock(&self->file->mu);
+  return rv;
+}
+
+static ssize_t NaClDescBufferedPRead(struct NaClDesc *vself,
+                                     void            *buf,
+                                     size_t          len,
+                                     nacl_off64_t    offset) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->PRead)(self->desc, buf, len,
+                                                   offset);
+}
+
+static ssize_t NaClDescBufferedPWrite(struct NaClDesc *vself,
+                                      void const      *buf,
+                                      size_t          len,
+                                      nacl_off64_t    offset) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->PWrite)(self->desc, buf, len,
+                                                    offset);
+}
+
+static ssize_t NaClDescBufferedReadv(struct NaClDesc              *vself,
+                                     struct NaClImcMsgIoVec const *iov,
+                                     size_t                       iovcnt) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->Readv)(self->desc, iov, iovcnt);
+}
+
+static int NaClDescBufferedFstat(struct NaClDesc      *vself,
+                                 struct nacl_abi_stat *statbuf) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->Fstat)(self->desc, statbuf);
+}
+
+static int NaClDescBufferedFchdir(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Fchdir)(self->desc);
+}
+
+static int NaClDescBufferedFchmod(struct NaClDesc *vself,
+                                  int             mode) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Fchmod)(self->desc, mode);
+}
+
+static int NaClDescBufferedFsync(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  int rv;
+
+  NaClXMutexLock(&self->file->mu);
+  NaClDescBufferedFlushMu(self->file);
+  rv = NaClDescBufferedTakeErrorMu(self);
+  NaClXMutexUnlock(&self->file->mu);
+  if (0 != rv) {
+    return rv;
+  }
+  return (*NACL_VTBL(NaClDesc, self->desc)->Fsync)(self->desc);
+}
+
+static int NaClDescBufferedFdatasync(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  int rv;
+
+  NaClXMutexLock(&self->file->mu);
+  NaClDescBufferedFlushMu(self->file);
+  rv = NaClDescBufferedTakeErrorMu(self);
+  NaClXMutexUnlock(&self->file->mu);
+  if (0 != rv) {
+    return rv;
+  }
+  return (*NACL_VTBL(NaClDesc, self->desc)->Fdatasync)(self->desc);
+}
+
+static int NaClDescBufferedFtruncate(struct NaClDesc  *vself,
+                                     nacl_abi_off_t   length) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->Ftruncate)(self->desc, length);
+}
+
+static ssize_t NaClDescBufferedGetdents(struct NaClDesc *vself,
+                                        void            *dirp,
+                                        size_t          count) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Getdents)(self->desc, dirp,
+                                                      count);
+}
+
+static ssize_t NaClDescBufferedGetdentsPlus(struct NaClDesc *vself,
+                                            void            *dirp,
+                                            size_t          count) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->GetdentsPlus)(self->desc, dirp,
+                                                          count);
+}
+
+static int NaClDescBufferedLock(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Lock)(self->desc);
+}
+
+static int NaClDescBufferedTryLock(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->TryLock)(self->desc);
+}
+
+static int NaClDescBufferedUnlock(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Unlock)(self->desc);
+}
+
+static int NaClDescBufferedWait(struct NaClDesc *vself,
+                                struct NaClDesc *mutex) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Wait)(self->desc, mutex);
+}
+
+static int NaClDescBufferedTimedWaitAbs(struct NaClDesc                *vself,
+                                        struct NaClDesc                *mutex,
+                                        struct nacl_abi_timespec const *ts) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->TimedWaitAbs)(self->desc, mutex,
+                                                          ts);
+}
+
+static int NaClDescBufferedSignal(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Signal)(self->desc);
+}
+
+static int NaClDescBufferedBroadcast(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Broadcast)(self->desc);
+}
+
+static ssize_t NaClDescBufferedSendMsg(struct NaClDesc                 *vself,
+                                       const struct NaClImcTypedMsgHdr *nitmhp,
+                                       int                             flags) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->SendMsg)(self->desc, nitmhp,
+                                                     flags);
+}
+
+static ssize_t NaClDescBufferedRecvMsg(struct NaClDesc           *vself,
+                                       struct NaClImcTypedMsgHdr *nitmhp,
+                                       int                       flags) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->RecvMsg)(self->desc, nitmhp,
+                                                     flags);
+}
+
+static ssize_t NaClDescBufferedLowLevelSendMsg(
+    struct NaClDesc                *vself,
+    struct NaClMessageHeader const *dgram,
+    int                            flags) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  NaClDescBufferedSync(self);
+  return (*NACL_VTBL(NaClDesc, self->desc)->LowLevelSendMsg)(
+      self->desc, dgram, flags);
+}
+
+static ssize_t NaClDescBufferedLowLevelRecvMsg(
+    struct NaClDesc           *vself,
+    struct NaClMessageHeader  *dgram,
+    int                       flags) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->LowLevelRecvMsg)(
+      self->desc, dgram, flags);
+}
+
+static int NaClDescBufferedConnectAddr(struct NaClDesc *vself,
+                                       struct NaClDesc **result) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->ConnectAddr)(self->desc, result);
+}
+
+static int NaClDescBufferedAcceptConn(struct NaClDesc *vself,
+                                      struct NaClDesc **result) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->AcceptConn)(self->desc, result);
+}
+
+static int NaClDescBufferedPost(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Post)(self->desc);
+}
+
+static int NaClDescBufferedSemWait(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->SemWait)(self->desc);
+}
+
+static int NaClDescBufferedGetValue(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->GetValue)(self->desc);
+}
+
+static int NaClDescBufferedSetMetadata(struct NaClDesc *vself,
+                                       int32_t metadata_type,
+                                       uint32_t metadata_num_bytes,
+                                       uint8_t const *metadata_bytes) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  return (*NACL_VTBL(NaClDesc, self->desc)->SetMetadata)(self->desc,
+                                                         metadata_type,
+                                                         metadata_num_bytes,
+                                                         metadata_bytes);
+}
+
+static int32_t NaClDescBufferedGetMetadata(
+    struct NaClDesc *vself,
+    uint32_t *metadata_buffer_bytes_in_out,
+    uint8_t *metadata_buffer) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  return (*NACL_VTBL(NaClDesc,
+                     self->desc)->GetMetadata)(self->desc,
+                                               metadata_buffer_bytes_in_out,
+                                               metadata_buffer);
+}
+
+static void NaClDescBufferedSetFlags(struct NaClDesc *vself,
+                                     uint32_t flags) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  (*NACL_VTBL(NaClDesc, self->desc)->SetFlags)(self->desc, flags);
+}
+
+static uint32_t NaClDescBufferedGetFlags(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  return (*NACL_VTBL(NaClDesc, self->desc)->GetFlags)(self->desc);
+}
+
+static int32_t NaClDescBufferedIsatty(struct NaClDesc *vself) {
+  struct NaClDescBuffered *self = (struct NaClDescBuffered *) vself;
+  return (*NACL_VTBL(NaClDesc, self->desc)->Isatty)(self->desc);
+}
+
+static struct NaClDescVtbl const kNaClDescBufferedVtbl = {
+  {
+    NaClDescBufferedDtor,
+  },
+  NaClDescBufferedMap,
+  NaClDescBufferedRead,
+  NaClDescBufferedWrite,
+  NaClDescBufferedSeek,
+  NaClDescBufferedPRead,
+  NaClDescBufferedPWrite,
+  NaClDescBufferedReadv,
+  NaClDescWritevGeneric,
+  NaClDescBufferedFstat,
+  NaClDescBufferedFchdir,
+  NaClDescBufferedFchmod,
+  NaClDescBufferedFsync,
+  NaClDescBufferedFdatasync,
+  NaClDescBufferedFtruncate,
+  NaClDescBufferedGetdents,
+  NaClDescBufferedGetdentsPlus,
+  NaClDescExternalizeSizeNotImplemented,
+  NaClDescExternalizeNotImplemented,
+  NaClDescBufferedLock,
+  NaClDescBufferedTryLock,
+  NaClDescBufferedUnlock,
+  NaClDescBufferedWait,
+  NaClDescBufferedTimedWaitAbs,
+  NaClDescBufferedSignal,
+  NaClDescBufferedBroadcast,
+  NaClDescBufferedSendMsg,
+  NaClDescBufferedRecvMsg,
+  NaClDescBufferedLowLevelSendMsg,
+  NaClDescBufferedLowLevelRecvMsg,
+  NaClDescBufferedConnectAddr,
+  NaClDescBufferedAcceptConn,
+  NaClDescBufferedPost,
+  NaClDescBufferedSemWait,
+  NaClDescBufferedGetValue,
+  NaClDescBufferedSetMetadata,
+  NaClDescBufferedGetMetadata,
+  NaClDescBufferedSetFlags,
+  NaClDescBufferedGetFlags,
+  NaClDescBufferedIsatty,
+  NACL_DESC_BUFFERED,
+};
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaClDescBuffered subclass of NaClDesc, which coalesces small writes
+ * to another NaClDesc.
+ *
+ * Intended for log-like descriptors (stdout, stderr and O_APPEND
+ * files) that see many short writes.  Writes smaller than half the
+ * buffer are copied into it and reported as complete; the buffer is
+ * written out when it fills, about NACL_DESC_BUFFERED_FLUSH_MS after
+ * first becoming non-empty, before any other operation on the
+ * descriptor (so reads, seeks and positional I/O see all earlier
+ * writes), on Fsync/Fdatasync, when the descriptor is destroyed, and
+ * from NaClDescBufferedFlushAll.  Each flush is a single Write where
+ * possible, so O_APPEND output is still appended in whole records.
+ * Wrappers of the same host file (for example stdout and stderr sent
+ * to one pipe or terminal) share a buffer, so their output keeps the
+ * order in which it was written.
+ *
+ * An error from a deferred write is returned by the next Write, Fsync
+ * or Fdatasync.  Buffered data is lost if the process crashes or is
+ * killed by a signal, since only a normal exit flushes it.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_DESC_NACL_DESC_BUFFERED_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_DESC_NACL_DESC_BUFFERED_H_
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+
+#include "native_client/src/trusted/desc/nacl_desc_base.h"
+
+#include "native_client/src/shared/platform/nacl_sync.h"
+
+EXTERN_C_BEGIN
+
+#define NACL_DESC_BUFFERED_DEFAULT_CAPACITY (64 << 10)
+#define NACL_DESC_BUFFERED_FLUSH_MS         10
+
+struct NaClDescBufferedFile;
+
+struct NaClDescBuffered {
+  struct NaClDesc               base NACL_IS_REFCOUNT_SUBCLASS;
+  struct NaClDesc               *desc;
+  /* The buffer, shared with other wrappers of the same host file. */
+  struct NaClDescBufferedFile   *file;
+  /*
+   * Negated NACL_ABI_E* value from a deferred write, or 0.  Protected
+   * by the file's lock.
+   */
+  int                           error;
+};
+
+/*
+ * Takes ownership of desc on success.  capacity is the buffer size in
+ * bytes.  If another wrapper of the same host file exists, its buffer
+ * is shared and capacity is ignored.
+ */
+int NaClDescBufferedCtor(struct NaClDescBuffered  *self,
+                         struct NaClDesc          *desc,
+                         size_t                   capacity) NACL_WUR;
+
+/*
+ * Wraps desc with the default capacity, taking ownership of it.
+ * Returns NULL, leaving desc with the caller, on failure.
+ */
+struct NaClDesc *NaClDescBufferedMake(struct NaClDesc *desc);
+
+/*
+ * Writes out the buffers of all NaClDescBuffered objects.  Called when
+ * the untrusted program exits.
+ */
+void NaClDescBufferedFlushAll(void);
+
+/*
+ * Called in the child after fork().  The flusher thread does not
+ * survive fork, and it or a writer may have held a lock at the time, so
+ * this recreates the locks, lets the next NaClDescBufferedCtor start a
+ * new flusher, and discards any bytes buffered by the parent, which the
+ * parent writes itself.  Callers should flush with
+ * NaClDescBufferedFlushAll before forking.
+ */
+void NaClDescBufferedResetAfterFork(void);
+
+/* Called from NaClNrdAllModulesInit/Fini. */
+void NaClDescBufferedInit(void);
+
+void NaClDescBufferedFini(void);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_DESC_NACL_DESC_BUFFERED_H_ */
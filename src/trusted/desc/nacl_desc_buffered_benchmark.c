@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Measures small O_APPEND writes, such as log lines, made directly to a
+ * NaClDescIoDesc and through a NaClDescBuffered wrapper.
+ *
+ *   nacl_desc_buffered_benchmark <temp_file> [count] [record_size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/portability.h"
+
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_time.h"
+
+#include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/desc/nacl_desc_buffered.h"
+#include "native_client/src/trusted/desc/nacl_desc_io.h"
+#include "native_client/src/trusted/desc/nrd_all_modules.h"
+
+#include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
+#include "native_client/src/trusted/service_runtime/include/sys/stat.h"
+
+static int64_t Run(char const *path, int buffered, int count,
+                   char const *record, size_t record_size) {
+  struct NaClDesc *d;
+  struct nacl_abi_stat st;
+  int64_t start;
+  int i;
+
+  d = (struct NaClDesc *) NaClDescIoDescOpen(
+      path,
+      NACL_ABI_O_WRONLY | NACL_ABI_O_CREAT | NACL_ABI_O_TRUNC |
+      NACL_ABI_O_APPEND,
+      0600);
+  CHECK(NULL != d);
+  if (buffered) {
+    d = NaClDescBufferedMake(d);
+    CHECK(NULL != d);
+  }
+
+  start = NaClGetTimeOfDayMicroseconds();
+  for (i = 0; i < count; ++i) {
+    CHECK((ssize_t) record_size ==
+          (*NACL_VTBL(NaClDesc, d)->Write)(d, record, record_size));
+  }
+  /* Include the final flush, as a close would. */
+  CHECK(0 == (*NACL_VTBL(NaClDesc, d)->Fdatasync)(d));
+  start = NaClGetTimeOfDayMicroseconds() - start;
+
+  CHECK(0 == (*NACL_VTBL(NaClDesc, d)->Fstat)(d, &st));
+  CHECK((nacl_abi_off_t) (count * record_size) == st.nacl_abi_st_size);
+  NaClDescUnref(d);
+  return start;
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 2 ? (int) strtol(argv[2], NULL, 0) : 200000;
+  size_t record_size = argc > 3 ? strtoul(argv[3], NULL, 0) : 64;
+  char *record;
+  int64_t direct_us;
+  int64_t buffered_us;
+
+  if (argc < 2) {
+    fprintf(stderr,
+            "Usage: nacl_desc_buffered_benchmark <temp_file> [count] [size]\n");
+    return 1;
+  }
+  CHECK(count > 0);
+  CHECK(record_size > 0);
+  NaClNrdAllModulesInit();
+
+  record = malloc(record_size);
+  CHECK(NULL != record);
+  memset(record, 'x', record_size);
+  record[record_size - 1] = '\n';
+
+  direct_us = Run(argv[1], 0, count, record, record_size);
+  buffered_us = Run(argv[1], 1, count, record, record_size);
+
+  printf("%d appends of %"NACL_PRIuS" bytes\n", count, record_size);
+  printf("direct:   %10.0f writes/s\n", count * 1e6 / (double) direct_us);
+  printf("buffered: %10.0f writes/s\n", count * 1e6 / (double) buffered_us);
+
+  free(record);
+  NaClNrdAllModulesFini();
+  return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/portability.h"
+#include "native_client/src/include/nacl_macros.h"
+
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_time.h"
+
+#include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/desc/nacl_desc_buffered.h"
+#include "native_client/src/trusted/desc/nacl_desc_io.h"
+#include "native_client/src/trusted/desc/nrd_all_modules.h"
+
+#include "native_client/src/trusted/service_runtime/include/sys/errno.h"
+#include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
+#include "native_client/src/trusted/service_runtime/include/sys/stat.h"
+
+#define TEST_CAPACITY 64
+
+static char const *gPath;
+
+static struct NaClDesc *OpenFile(int flags) {
+  struct NaClDescIoDesc *ndip = NaClDescIoDescOpen(gPath, flags, 0600);
+  CHECK(NULL != ndip);
+  return (struct NaClDesc *) ndip;
+}
+
+static struct NaClDesc *MakeBuffered(struct NaClDesc *inner) {
+  struct NaClDescBuffered *self = malloc(sizeof *self);
+  CHECK(NULL != self);
+  CHECK(NaClDescBufferedCtor(self, inner, TEST_CAPACITY));
+  return (struct NaClDesc *) self;
+}
+
+/* Size of the file as seen by the host, bypassing any buffer. */
+static nacl_abi_off_t HostFileSize(void) {
+  struct NaClDesc *raw = OpenFile(NACL_ABI_O_RDONLY);
+  struct nacl_abi_stat st;
+
+  CHECK(0 == (*NACL_VTBL(NaClDesc, raw)->Fstat)(raw, &st));
+  NaClDescUnref(raw);
+  return st.nacl_abi_st_size;
+}
+
+static void WriteString(struct NaClDesc *d, char const *s) {
+  ssize_t len = (ssize_t) strlen(s);
+  CHECK(len == (*NACL_VTBL(NaClDesc, d)->Write)(d, s, len));
+}
+
+static void CheckContents(char const *expected) {
+  struct NaClDesc *raw = OpenFile(NACL_ABI_O_RDONLY);
+  size_t len = strlen(expected);
+  char buf[256];
+
+  CHECK(len < sizeof buf);
+  CHECK((ssize_t) len == (*NACL_VTBL(NaClDesc, raw)->PRead)(raw, buf,
+                                                            sizeof buf, 0));
+  CHECK(0 == memcmp(buf, expected, len));
+  NaClDescUnref(raw);
+}
+
+static void TestCoalesceAndFsync(void) {
+  struct NaClDesc *d = MakeBuffered(
+      OpenFile(NACL_ABI_O_RDWR | NACL_ABI_O_CREAT | NACL_ABI_O_TRUNC));
+
+  /*
+   * The flusher thread may write the buffer out at any time, so only
+   * the state after an explicit flush is checked.
+   */
+  WriteString(d, "one ");
+  WriteString(d, "two ");
+  CHECK(0 == (*NACL_VTBL(NaClDesc, d)->Fsync)(d));
+  CheckContents("one two ");
+
+  /* Writes that do not fit flush what came before them. */
+  WriteString(d, "0123456789abcdefghijklmnopqrstu");
+  WriteString(d, "0123456789abcdefghijklmnopqrstu");
+  WriteString(d, "0123456789abcdefghijklmnopqrstu");
+  CHECK(0 == (*NACL_VTBL(NaClDesc, d)->Fdatasync)(d));
+  CHECK(8 + 3 * 31 == HostFileSize());
+  NaClDescUnref(d);
+}
+
+static void TestOrdering(void) {
+  struct NaClDesc *d = MakeBuffered(
+      OpenFile(NACL_ABI_O_RDWR | NACL_ABI_O_CREAT | NACL_ABI_O_TRUNC));
+  char buf[16];
+  static char const kLarge[] = "LARGE WRITE, NOT BUFFERED, >= HALF";
+
+  /* Positional and seeking operations see earlier buffered writes. */
+  WriteString(d, "abcdef");
+  CHECK(6 == (*NACL_VTBL(NaClDesc, d)->PRead)(d, buf, sizeof buf, 0));
+  CHECK(0 == memcmp(buf, "abcdef", 6));
+  WriteString(d, "gh");
+  CHECK(2 == (*NACL_VTBL(NaClDesc, d)->Seek)(d, 2, 0));
+  WriteString(d, "CD");
+  CHECK(3 == (*NACL_VTBL(NaClDesc, d)->PWrite)(d, "XYZ", 3, 5));
+  WriteString(d, "E");
+  CHECK(sizeof kLarge - 1 >= TEST_CAPACITY / 2);
+  WriteString(d, kLarge);
+  NaClDescUnref(d);
+  CheckContents("abCDELARGE WRITE, NOT BUFFERED, >= HALF");
+}
+
+static void TestDtorAndTimerFlush(void) {
+  struct NaClDesc *d = MakeBuffered(
+      OpenFile(NACL_ABI_O_WRONLY | NACL_ABI_O_CREAT | NACL_ABI_O_TRUNC |
+               NACL_ABI_O_APPEND));
+  struct nacl_abi_timespec ts;
+  int i;
+
+  WriteString(d, "tick ");
+  ts.tv_sec = 0;
+  ts.tv_nsec = 10 * 1000 * 1000;
+  for (i = 0; i < 200 && 0 == HostFileSize(); ++i) {
+    NaClNanosleep(&ts, NULL);
+  }
+  CheckContents("tick ");
+
+  WriteString(d, "tock");
+  NaClDescUnref(d);
+  CheckContents("tick tock");
+}
+
+static void TestSharedFileOrdering(void) {
+  struct NaClDesc *a;
+  struct NaClDesc *b;
+  char expected[256];
+  int i;
+
+  /*
+   * Two wrappers of the same file, as with stdout and stderr sent to
+   * one pipe, share a buffer, so alternating writes keep their order.
+   * More alternations than there are runs in the buffer force a flush
+   * part way through.
+   */
+  a = MakeBuffered(OpenFile(NACL_ABI_O_WRONLY | NACL_ABI_O_CREAT |
+                            NACL_ABI_O_TRUNC | NACL_ABI_O_APPEND));
+  b = MakeBuffered(OpenFile(NACL_ABI_O_WRONLY | NACL_ABI_O_APPEND));
+  expected[0] = '\0';
+  for (i = 0; i < 20; ++i) {
+    WriteString(a, "a");
+    WriteString(b, "B");
+    strcat(expected, "aB");
+  }
+  CHECK(0 == (*NACL_VTBL(NaClDesc, b)->Fsync)(b));
+  CheckContents(expected);
+
+  /* Closing one wrapper writes out what the other buffered first. */
+  WriteString(b, "12");
+  WriteString(a, "34");
+  strcat(expected, "1234");
+  NaClDescUnref(a);
+  CheckContents(expected);
+  NaClDescUnref(b);
+}
+
+static void TestDeferredError(void) {
+  struct NaClDesc *d = MakeBuffered(OpenFile(NACL_ABI_O_RDONLY));
+
+  /* The write to a read-only file fails only when flushed. */
+  WriteString(d, "lost");
+  CHECK(-NACL_ABI_EBADF == (*NACL_VTBL(NaClDesc, d)->Fsync)(d));
+  CHECK(0 == (*NACL_VTBL(NaClDesc, d)->Fsync)(d));
+  NaClDescUnref(d);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: nacl_desc_buffered_test <temp_file>\n");
+    return 1;
+  }
+  gPath = argv[1];
+  NaClNrdAllModulesInit();
+
+  TestCoalesceAndFsync();
+  TestOrdering();
+  TestDtorAndTimerFlush();
+  TestSharedFileOrdering();
+  TestDeferredError();
+
+  NaClNrdAllModulesFini();
+  printf("PASSED\n");
+  return 0;
+}
@@ -134,6 +134,8 @@ static struct NaClDescVtbl const kNaClDescCondVarVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescCondVarFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -141,6 +143,7 @@ static struct NaClDescVtbl const kNaClDescCondVarVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
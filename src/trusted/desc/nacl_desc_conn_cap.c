@@ -201,6 +201,8 @@ static struct NaClDescVtbl const kNaClDescConnCapVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescConnCapFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -208,6 +210,7 @@ static struct NaClDescVtbl const kNaClDescConnCapVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescConnCapExternalizeSize,
   NaClDescConnCapExternalize,
   NaClDescLockNotImplemented,
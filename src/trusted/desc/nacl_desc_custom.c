@@ -74,6 +74,8 @@ static const struct NaClDescVtbl kNaClDescCustomVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescFstatNotImplemented,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -81,6 +83,7 @@ static const struct NaClDescVtbl kNaClDescCustomVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
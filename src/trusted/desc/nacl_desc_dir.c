@@ -108,6 +108,14 @@ static ssize_t NaClDescDirDescGetdents(struct NaClDesc         *vself,
   return NaClHostDirGetdents(self->hd, dirp, count);
 }
 
+static ssize_t NaClDescDirDescGetdentsPlus(struct NaClDesc         *vself,
+                                           void                    *dirp,
+                                           size_t                  count) {
+  struct NaClDescDirDesc *self = (struct NaClDescDirDesc *) vself;
+
+  return NaClHostDirGetdentsPlus(self->hd, dirp, count);
+}
+
 static ssize_t NaClDescDirDescRead(struct NaClDesc         *vself,
                                    void                    *buf,
                                    size_t                  len) {
@@ -177,6 +185,8 @@ static struct NaClDescVtbl const kNaClDescDirDescVtbl = {
   NaClDescDirDescSeek,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescDirDescFstat,
   NaClDescDirDescFchdir,
   NaClDescDirDescFchmod,
@@ -184,6 +194,7 @@ static struct NaClDescVtbl const kNaClDescDirDescVtbl = {
   NaClDescDirDescFdatasync,
   NaClDescFtruncateNotImplemented,
   NaClDescDirDescGetdents,
+  NaClDescDirDescGetdentsPlus,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
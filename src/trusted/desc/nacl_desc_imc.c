@@ -386,6 +386,8 @@ static struct NaClDescVtbl const kNaClDescImcConnectedDescVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescFstatNotImplemented,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -393,6 +395,7 @@ static struct NaClDescVtbl const kNaClDescImcConnectedDescVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
@@ -430,6 +433,8 @@ static struct NaClDescVtbl const kNaClDescImcDescVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescImcDescFstat,  /* diff */
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -437,6 +442,7 @@ static struct NaClDescVtbl const kNaClDescImcDescVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
@@ -474,6 +480,8 @@ static struct NaClDescVtbl const kNaClDescXferableDataDescVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescXferableDataDescFstat,  /* diff */
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -481,6 +489,7 @@ static struct NaClDescVtbl const kNaClDescXferableDataDescVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescXferableDataDescExternalizeSize,  /* diff */
   NaClDescXferableDataDescExternalize,  /* diff */
   NaClDescLockNotImplemented,
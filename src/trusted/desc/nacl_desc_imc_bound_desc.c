@@ -143,6 +143,8 @@ static struct NaClDescVtbl const kNaClDescImcBoundDescVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescImcBoundDescFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -150,6 +152,7 @@ static struct NaClDescVtbl const kNaClDescImcBoundDescVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescLockNotImplemented,
@@ -278,6 +278,8 @@ static struct NaClDescVtbl const kNaClDescImcShmVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescImcShmFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -285,6 +287,7 @@ static struct NaClDescVtbl const kNaClDescImcShmVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescImcShmExternalizeSize,
   NaClDescImcShmExternalize,
   NaClDescLockNotImplemented,
@@ -59,6 +59,8 @@ static struct NaClDescVtbl const kNaClDescInvalidVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescFstatNotImplemented,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -66,6 +68,7 @@ static struct NaClDescVtbl const kNaClDescInvalidVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescInvalidExternalizeSize,
   NaClDescInvalidExternalize,
   NaClDescLockNotImplemented,
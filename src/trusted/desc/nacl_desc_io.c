@@ -255,6 +255,22 @@ static nacl_off64_t NaClDescIoDescSeek(struct NaClDesc          *vself,
   return NaClHostDescSeek(self->hd, offset, whence);
 }
 
+static ssize_t NaClDescIoDescReadv(struct NaClDesc              *vself,
+                                   struct NaClImcMsgIoVec const *iov,
+                                   size_t                       iovcnt) {
+  struct NaClDescIoDesc *self = (struct NaClDescIoDesc *) vself;
+
+  return NaClHostDescReadv(self->hd, iov, iovcnt);
+}
+
+static ssize_t NaClDescIoDescWritev(struct NaClDesc              *vself,
+                                    struct NaClImcMsgIoVec const *iov,
+                                    size_t                       iovcnt) {
+  struct NaClDescIoDesc *self = (struct NaClDescIoDesc *) vself;
+
+  return NaClHostDescWritev(self->hd, iov, iovcnt);
+}
+
 static ssize_t NaClDescIoDescPRead(struct NaClDesc *vself,
                                    void *buf,
                                    size_t len,
@@ -368,6 +384,8 @@ static struct NaClDescVtbl const kNaClDescIoDescVtbl = {
   NaClDescIoDescSeek,
   NaClDescIoDescPRead,
   NaClDescIoDescPWrite,
+  NaClDescIoDescReadv,
+  NaClDescIoDescWritev,
   NaClDescIoDescFstat,
   NaClDescFchdirNotImplemented,
   NaClDescIoDescFchmod,
@@ -375,6 +393,7 @@ static struct NaClDescVtbl const kNaClDescIoDescVtbl = {
   NaClDescIoDescFdatasync,
   NaClDescIoDescFtruncate,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescIoDescExternalizeSize,
   NaClDescIoDescExternalize,
   NaClDescLockNotImplemented,
@@ -110,6 +110,8 @@ static struct NaClDescVtbl const kNaClDescMutexVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescMutexFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -117,6 +119,7 @@ static struct NaClDescVtbl const kNaClDescMutexVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescMutexLock,
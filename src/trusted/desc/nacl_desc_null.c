@@ -141,6 +141,8 @@ static struct NaClDescVtbl const kNaClDescNullVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescNullPRead,
   NaClDescNullPWrite,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescNullFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -148,6 +150,7 @@ static struct NaClDescVtbl const kNaClDescNullVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescNullExternalizeSize,
   NaClDescNullExternalize,
   NaClDescLockNotImplemented,
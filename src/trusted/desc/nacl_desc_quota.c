@@ -239,6 +239,14 @@ abort:
   return rv;
 }
 
+ssize_t NaClDescQuotaReadv(struct NaClDesc              *vself,
+                           struct NaClImcMsgIoVec const *iov,
+                           size_t                       iovcnt) {
+  struct NaClDescQuota  *self = (struct NaClDescQuota *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->Readv)(self->desc, iov, iovcnt);
+}
+
 nacl_off64_t NaClDescQuotaSeek(struct NaClDesc  *vself,
                                nacl_off64_t     offset,
                                int              whence) {
@@ -299,6 +307,15 @@ ssize_t NaClDescQuotaGetdents(struct NaClDesc *vself,
   return (*NACL_VTBL(NaClDesc, self->desc)->Getdents)(self->desc, dirp, count);
 }
 
+ssize_t NaClDescQuotaGetdentsPlus(struct NaClDesc *vself,
+                                  void            *dirp,
+                                  size_t          count) {
+  struct NaClDescQuota  *self = (struct NaClDescQuota *) vself;
+
+  return (*NACL_VTBL(NaClDesc, self->desc)->GetdentsPlus)(self->desc, dirp,
+                                                          count);
+}
+
 int NaClDescQuotaLock(struct NaClDesc *vself) {
   struct NaClDescQuota  *self = (struct NaClDescQuota *) vself;
 
@@ -453,6 +470,8 @@ static struct NaClDescVtbl const kNaClDescQuotaVtbl = {
   NaClDescQuotaSeek,
   NaClDescQuotaPRead,
   NaClDescQuotaPWrite,
+  NaClDescQuotaReadv,
+  NaClDescWritevGeneric,
   NaClDescQuotaFstat,
   NaClDescQuotaFchdir,
   NaClDescQuotaFchmod,
@@ -460,6 +479,7 @@ static struct NaClDescVtbl const kNaClDescQuotaVtbl = {
   NaClDescQuotaFdatasync,
   NaClDescQuotaFtruncate,
   NaClDescQuotaGetdents,
+  NaClDescQuotaGetdentsPlus,
   NaClDescExternalizeSizeNotImplemented,
   NaClDescExternalizeNotImplemented,
   NaClDescQuotaLock,
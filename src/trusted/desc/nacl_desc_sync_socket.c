@@ -144,6 +144,8 @@ static struct NaClDescVtbl const kNaClDescSyncSocketVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescSyncSocketFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -151,6 +153,7 @@ static struct NaClDescVtbl const kNaClDescSyncSocketVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescSyncSocketExternalizeSize,
   NaClDescSyncSocketExternalize,
   NaClDescLockNotImplemented,
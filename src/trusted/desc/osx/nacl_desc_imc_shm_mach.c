@@ -279,6 +279,8 @@ static struct NaClDescVtbl const kNaClDescImcShmMachVtbl = {
     NaClDescSeekNotImplemented,
     NaClDescPReadNotImplemented,
     NaClDescPWriteNotImplemented,
+    NaClDescReadvGeneric,
+    NaClDescWritevGeneric,
     NaClDescImcShmMachFstat,
     NaClDescFchdirNotImplemented,
     NaClDescFchmodNotImplemented,
@@ -286,6 +288,7 @@ static struct NaClDescVtbl const kNaClDescImcShmMachVtbl = {
     NaClDescFdatasyncNotImplemented,
     NaClDescFtruncateNotImplemented,
     NaClDescGetdentsNotImplemented,
+    NaClDescGetdentsPlusNotImplemented,
     NaClDescExternalizeSizeNotImplemented,
     NaClDescExternalizeNotImplemented,
     NaClDescLockNotImplemented,
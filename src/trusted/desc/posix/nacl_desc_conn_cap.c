@@ -262,6 +262,8 @@ static struct NaClDescVtbl const kNaClDescConnCapFdVtbl = {
   NaClDescSeekNotImplemented,
   NaClDescPReadNotImplemented,
   NaClDescPWriteNotImplemented,
+  NaClDescReadvGeneric,
+  NaClDescWritevGeneric,
   NaClDescConnCapFdFstat,
   NaClDescFchdirNotImplemented,
   NaClDescFchmodNotImplemented,
@@ -269,6 +271,7 @@ static struct NaClDescVtbl const kNaClDescConnCapFdVtbl = {
   NaClDescFdatasyncNotImplemented,
   NaClDescFtruncateNotImplemented,
   NaClDescGetdentsNotImplemented,
+  NaClDescGetdentsPlusNotImplemented,
   NaClDescConnCapFdExternalizeSize,
   NaClDescConnCapFdExternalize,
   NaClDescLockNotImplemented,
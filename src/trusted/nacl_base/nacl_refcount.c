@@ -6,29 +6,26 @@
 
 #include "native_client/src/trusted/nacl_base/nacl_refcount.h"
 
+#include <stdlib.h>
+
 #include "native_client/src/shared/platform/nacl_log.h"
-#include "native_client/src/shared/platform/nacl_sync_checked.h"
 
 int NaClRefCountCtor(struct NaClRefCount *self) {
   NaClLog(4, "NaClRefCountCtor(0x%08"NACL_PRIxPTR").\n", (uintptr_t) self);
   self->ref_count = 1;
-  self->vtbl = (struct NaClRefCountVtbl *) NULL;
-  if (NaClFastMutexCtor(&self->mu)) {
-    self->vtbl = &kNaClRefCountVtbl;
-    return 1;
-  }
-  return 0;
+  self->vtbl = &kNaClRefCountVtbl;
+  return 1;
 }
 
 static void NaClRefCountDtor(struct NaClRefCount  *self) {
-  NaClLog(4, "NaClRefCountDtor(0x%08"NACL_PRIxPTR"), refcount %"NACL_PRIuS
+  NaClLog(4, "NaClRefCountDtor(0x%08"NACL_PRIxPTR"), refcount %"NACL_PRId32
           ", destroying.\n",
           (uintptr_t) self,
-          self->ref_count);
+          (int32_t) self->ref_count);
   /*
    * NB: refcount could be non-zero.  Here's why: if a subclass's Ctor
    * fails, it will have already run NaClRefCountCtor and have
-   * initialized the mutex and set the ref_count to 1.  Because Unref
+   * set the ref_count to 1.  Because Unref
    * would free memory and Ctors aren't factories, the subclass Ctor
    * cannot just invoke NaClRefCountUnref; instead, it must directly
    * invoke the base class Dtor.
@@ -50,12 +47,11 @@ static void NaClRefCountDtor(struct NaClRefCount  *self) {
       NaClLog(LOG_FATAL,
               ("NaClRefCountDtor invoked on a generic refcounted"
                " object at 0x%08"NACL_PRIxPTR" with non-zero"
-               " reference count (%"NACL_PRIuS")\n"),
+               " reference count (%"NACL_PRId32")\n"),
               (uintptr_t) self,
-              self->ref_count);
+              (int32_t) self->ref_count);
   }
 
-  NaClFastMutexDtor(&self->mu);
   self->vtbl = (struct NaClRefCountVtbl const *) NULL;
 }
 
@@ -66,29 +62,34 @@ struct NaClRefCountVtbl const kNaClRefCountVtbl = {
 struct NaClRefCount *NaClRefCountRef(struct NaClRefCount *nrcp) {
   NaClLog(4, "NaClRefCountRef(0x%08"NACL_PRIxPTR").\n",
           (uintptr_t) nrcp);
-  NaClFastMutexLock(&nrcp->mu);
-  if (0 == ++nrcp->ref_count) {
+  /*
+   * A result of 1 or less means that the count was zero (the object
+   * is already being destroyed) or has wrapped around.
+   */
+  if (AtomicIncrement(&nrcp->ref_count, 1) <= 1) {
     NaClLog(LOG_FATAL, "NaClRefCountRef integer overflow\n");
   }
-  NaClFastMutexUnlock(&nrcp->mu);
   return nrcp;
 }
 
 void NaClRefCountUnref(struct NaClRefCount *nrcp) {
-  int destroy;
+  Atomic32 ref_count;
 
   NaClLog(4, "NaClRefCountUnref(0x%08"NACL_PRIxPTR").\n",
           (uintptr_t) nrcp);
-  NaClFastMutexLock(&nrcp->mu);
-  if (0 == nrcp->ref_count) {
+  /*
+   * AtomicIncrement is a full barrier, so all other threads' writes
+   * to the object made before they dropped their references are
+   * visible to the thread that runs the Dtor.
+   */
+  ref_count = AtomicIncrement(&nrcp->ref_count, -1);
+  if (ref_count < 0) {
     NaClLog(LOG_FATAL,
             ("NaClRefCountUnref on 0x%08"NACL_PRIxPTR
              ", refcount already zero!\n"),
             (uintptr_t) nrcp);
   }
-  destroy = (0 == --nrcp->ref_count);
-  NaClFastMutexUnlock(&nrcp->mu);
-  if (destroy) {
+  if (0 == ref_count) {
     (*nrcp->vtbl->Dtor)(nrcp);
     free(nrcp);
   }
@@ -102,11 +103,3 @@ void NaClRefCountSafeUnref(struct NaClRefCount *nrcp) {
   }
   NaClRefCountUnref(nrcp);
 }
-
-void NaClRefCountLock(struct NaClRefCount *nrcp) {
-  NaClFastMutexLock(&nrcp->mu);
-}
-
-void NaClRefCountUnlock(struct NaClRefCount *nrcp) {
-  NaClFastMutexUnlock(&nrcp->mu);
-}
@@ -7,6 +7,7 @@
 #ifndef NATIVE_CLIENT_SRC_TRUSTED_NACL_BASE_NACL_REFCOUNT_H_
 #define NATIVE_CLIENT_SRC_TRUSTED_NACL_BASE_NACL_REFCOUNT_H_
 
+#include "native_client/src/include/atomic_ops.h"
 #include "native_client/src/include/nacl_base.h"
 #include "native_client/src/include/portability.h"
 
@@ -39,15 +40,12 @@ struct NaClRefCountVtbl;
 struct NaClRefCount {
   struct NaClRefCountVtbl const *vtbl NACL_IS_REFCOUNT_SUBCLASS;
 
-  /* protected */
-  struct NaClFastMutex          mu;
   /*
-   * To save on constructing another mutex, it is acceptable for a
-   * subclass to use this mutex for short operations.
+   * private.  Only ever modified with atomic operations, so taking and
+   * dropping references does not need a lock.  Subclasses that need a
+   * lock must provide their own.
    */
-
-  /* private */
-  size_t                        ref_count;
+  volatile Atomic32             ref_count;
 };
 
 struct NaClRefCountVtbl {
@@ -76,13 +74,6 @@ void NaClRefCountUnref(struct NaClRefCount *nrcp);
  */
 void NaClRefCountSafeUnref(struct NaClRefCount *nrcp);
 
-/*
- * For subclasses that need a lock for fast operations.  Exposing this
- * eliminates the need for constructing another lock in the subclass.
- */
-void NaClRefCountLock(struct NaClRefCount *nrcp);
-void NaClRefCountUnlock(struct NaClRefCount *nrcp);
-
 extern struct NaClRefCountVtbl const kNaClRefCountVtbl;
 
 EXTERN_C_END
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Checks that NaClRefCountRef/NaClRefCountUnref are safe to use from
+ * several threads at once and that the Dtor runs exactly once.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "native_client/src/include/portability.h"
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_threads.h"
+#include "native_client/src/shared/platform/platform_init.h"
+#include "native_client/src/trusted/nacl_base/nacl_refcount.h"
+
+#define kNumThreads     4
+#define kIterations     1000000
+
+static int g_dtor_calls = 0;
+
+struct TestObject {
+  struct NaClRefCount base;
+};
+
+static void TestObjectDtor(struct NaClRefCount *vself) {
+  ++g_dtor_calls;
+  vself->vtbl = &kNaClRefCountVtbl;
+  (*vself->vtbl->Dtor)(vself);
+}
+
+static struct NaClRefCountVtbl const kTestObjectVtbl = {
+  TestObjectDtor,
+};
+
+static struct TestObject *TestObjectMake(void) {
+  struct TestObject *obj = (struct TestObject *) malloc(sizeof *obj);
+  CHECK(NULL != obj);
+  CHECK(NaClRefCountCtor(&obj->base));
+  obj->base.vtbl = &kTestObjectVtbl;
+  return obj;
+}
+
+static void WINAPI RefUnrefThread(void *state) {
+  struct NaClRefCount *obj = (struct NaClRefCount *) state;
+  int i;
+
+  for (i = 0; i < kIterations; ++i) {
+    NaClRefCountUnref(NaClRefCountRef(obj));
+  }
+}
+
+static void RunTest(int num_threads) {
+  struct NaClThread threads[kNumThreads];
+  struct TestObject *obj = TestObjectMake();
+  int i;
+
+  g_dtor_calls = 0;
+  for (i = 0; i < num_threads; ++i) {
+    CHECK(NaClThreadCreateJoinable(&threads[i], RefUnrefThread, obj,
+                                   64 << 10));
+  }
+  for (i = 0; i < num_threads; ++i) {
+    NaClThreadJoin(&threads[i]);
+  }
+
+  CHECK(1 == obj->base.ref_count);
+  CHECK(0 == g_dtor_calls);
+  NaClRefCountUnref(&obj->base);
+  CHECK(1 == g_dtor_calls);
+}
+
+int main(void) {
+  int num_threads;
+
+  NaClPlatformInit();
+
+  for (num_threads = 1; num_threads <= kNumThreads; num_threads *= 2) {
+    RunTest(num_threads);
+  }
+
+  NaClPlatformFini();
+  printf("PASSED\n");
+  return 0;
+}
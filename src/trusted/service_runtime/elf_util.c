@@ -20,6 +20,7 @@
 #include "native_client/src/include/elf.h"
 #include "native_client/src/include/nacl_macros.h"
 #include "native_client/src/include/nacl_platform.h"
+#include "native_client/src/include/portability_io.h"
 
 #include "native_client/src/shared/gio/gio.h"
 #include "native_client/src/shared/platform/nacl_check.h"
@@ -28,6 +29,7 @@
 
 #include "native_client/src/trusted/desc/nacl_desc_base.h"
 #include "native_client/src/trusted/desc/nacl_desc_effector_trusted_mem.h"
+#include "native_client/src/trusted/desc/nacl_desc_io.h"
 #include "native_client/src/trusted/fault_injection/fault_injection.h"
 #include "native_client/src/trusted/perf_counter/nacl_perf_counter.h"
 #include "native_client/src/trusted/service_runtime/elf_util.h"
@@ -530,6 +532,43 @@ struct NaClElfImage *NaClElfImageNew(struct NaClDesc *ndp,
   return result;
 }
 
+void NaClElfImagePrefetch(struct NaClElfImage *image, struct NaClDesc *ndp) {
+  struct NaClHostDesc *hd;
+  int cur_ph;
+  int rv;
+
+  if (NACL_VTBL(NaClDesc, ndp)->typeTag != NACL_DESC_HOST_IO) {
+    return;
+  }
+  hd = ((struct NaClDescIoDesc *) ndp)->hd;
+  for (cur_ph = 0; cur_ph < image->ehdr.e_phnum; ++cur_ph) {
+    const Elf_Phdr *php = &image->phdrs[cur_ph];
+
+    if (PT_LOAD != php->p_type || 0 == php->p_filesz) {
+      continue;
+    }
+    rv = NaClHostDescPrefetch(hd, (nacl_off64_t) php->p_offset,
+                              (nacl_off64_t) php->p_filesz);
+    if (0 != rv) {
+      NaClLog(3, "NaClElfImagePrefetch: segment %d: error %d\n", cur_ph, rv);
+      return;
+    }
+  }
+}
+
+/*
+ * Records the time taken to load one segment in time_load, for the
+ * loader's per-segment timing.
+ */
+static void NaClElfMarkSegmentLoaded(struct NaClPerfCounter *time_load,
+                                     int segnum) {
+  char name[NACL_MAX_PERF_COUNTER_NAME];
+
+  SNPRINTF(name, sizeof name, "Segment %d", segnum);
+  NaClPerfCounterMark(time_load, name);
+  NaClPerfCounterIntervalLast(time_load);
+}
+
 /*
  * Attempt to map into the NaClApp object nap from the NaCl descriptor
  * ndp an ELF segment of type p_flags that start at file_offset for
@@ -786,6 +825,9 @@ NaClErrorCode NaClElfImageLoad(struct NaClElfImage *image,
   uintptr_t end_vaddr;
   ssize_t read_ret;
   int safe_for_mmap;
+  struct NaClPerfCounter time_load_segments;
+
+  NaClPerfCounterCtor(&time_load_segments, "NaClElfImageLoad");
 
   for (segnum = 0; segnum < image->ehdr.e_phnum; ++segnum) {
     const Elf_Phdr *php = &image->phdrs[segnum];
@@ -847,6 +889,7 @@ NaClErrorCode NaClElfImageLoad(struct NaClElfImage *image,
        */
       if (LOAD_OK == map_status) {
         /* Segment has been handled -- proceed to next segment */
+        NaClElfMarkSegmentLoaded(&time_load_segments, segnum);
         continue;
       } else if (LOAD_STATUS_UNKNOWN != map_status) {
         /*
@@ -882,6 +925,7 @@ NaClErrorCode NaClElfImageLoad(struct NaClElfImage *image,
 
     /* Tell Valgrind that we've mapped a segment of nacl_file. */
     NaClFileMappingForValgrind(paddr, filesz, offset);
+    NaClElfMarkSegmentLoaded(&time_load_segments, segnum);
   }
 
   return LOAD_OK;
@@ -895,6 +939,10 @@ NaClErrorCode NaClElfImageLoadDynamically(
     struct NaClValidationMetadata *metadata) {
   ssize_t read_ret;
   int segnum;
+  struct NaClPerfCounter time_load_segments;
+
+  NaClPerfCounterCtor(&time_load_segments, "NaClElfImageLoadDynamically");
+
   for (segnum = 0; segnum < image->ehdr.e_phnum; ++segnum) {
     const Elf_Phdr *php = &image->phdrs[segnum];
     Elf_Addr vaddr = php->p_vaddr & ~(NACL_MAP_PAGESIZE - 1);
@@ -1015,6 +1063,7 @@ NaClErrorCode NaClElfImageLoadDynamically(
                                   0);
       }
     }
+    NaClElfMarkSegmentLoaded(&time_load_segments, segnum);
   }
   return LOAD_OK;
 }
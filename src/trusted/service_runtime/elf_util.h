@@ -35,6 +35,14 @@ NaClErrorCode NaClElfImageValidateProgramHeaders(
   uint8_t             addr_bits,
   struct NaClElfImageInfo *info);
 
+/*
+ * Asks the host to start reading the file contents of all PT_LOAD
+ * segments of image into its page cache, so that loading them later
+ * waits less on storage.  This is only a hint, and does nothing for
+ * descriptors that are not host files.
+ */
+void NaClElfImagePrefetch(struct NaClElfImage *image, struct NaClDesc *ndp);
+
 /*
  * Loads an ELF executable before the address space's memory
  * protections have been set up by NaClMemoryProtection().
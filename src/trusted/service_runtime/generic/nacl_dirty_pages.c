@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "native_client/src/trusted/service_runtime/nacl_dirty_pages.h"
+
+#include "native_client/src/include/nacl_macros.h"
+
+/*
+ * Hosts other than Linux have no way to track writes that also covers
+ * writes made by system calls, so every page is reported as dirty.
+ */
+int NaClDirtyPagesScanMu(struct NaClApp *nap,
+                         uintptr_t      sysaddr,
+                         size_t         num_pages,
+                         uint8_t        *bitmap) {
+  UNREFERENCED_PARAMETER(nap);
+  UNREFERENCED_PARAMETER(sysaddr);
+  UNREFERENCED_PARAMETER(num_pages);
+  UNREFERENCED_PARAMETER(bitmap);
+  return -1;
+}
@@ -45,6 +45,7 @@
 #define NACL_sys_fsync                  26
 #define NACL_sys_fdatasync              27
 #define NACL_sys_fchmod                 28
+#define NACL_sys_list_mapping_changes   29
 
 #define NACL_sys_exit                   30
 #define NACL_sys_getpid                 31
@@ -121,6 +122,14 @@
 
 #define NACL_sys_pread                  130
 #define NACL_sys_pwrite                 131
+#define NACL_sys_readv                  132
+#define NACL_sys_writev                 133
+#define NACL_sys_preadv                 134
+#define NACL_sys_aio_setup              135
+#define NACL_sys_aio_enter              136
+#define NACL_sys_aio_destroy            137
+#define NACL_sys_get_dirty_pages        138
+#define NACL_sys_getdents_plus          139
 
 #define NACL_sys_truncate               140
 #define NACL_sys_lstat                  141
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl Service Runtime API.  Submission and completion rings for the
+ * aio_setup, aio_enter and aio_destroy syscalls.
+ *
+ * A ring lives in untrusted memory and is laid out as a struct
+ * nacl_abi_aio_ring followed by |entries| submission queue entries and
+ * then |entries| completion queue entries; NACL_ABI_AIO_RING_SIZE gives
+ * the total size.  Untrusted code fills in SQEs and advances sq_tail,
+ * and consumes CQEs and advances cq_head.  The service runtime advances
+ * sq_head as it accepts SQEs and cq_tail as it posts CQEs.  Indices are
+ * free-running and wrap at 2^32; an index selects entry
+ * (index & (entries - 1)).
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_AIO_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_AIO_H_
+
+#if defined(NACL_IN_TOOLCHAIN_HEADERS)
+# include <stdint.h>
+#else
+# include "native_client/src/include/portability.h"
+#endif
+
+/* Opcodes for nacl_abi_aio_sqe.opcode. */
+#define NACL_ABI_AIO_PREAD  1
+#define NACL_ABI_AIO_PWRITE 2
+#define NACL_ABI_AIO_FSYNC  3
+
+/* Ring sizes must be a power of two no larger than this. */
+#define NACL_ABI_AIO_MAX_ENTRIES 4096
+
+/* Maximum number of rings a process may have at once. */
+#define NACL_ABI_AIO_MAX_RINGS 16
+
+/*
+ * Submission queue entry.  buf and len are ignored for
+ * NACL_ABI_AIO_FSYNC.  user_data is returned unchanged in the CQE.
+ */
+struct nacl_abi_aio_sqe {
+  uint32_t opcode;
+  int32_t desc;
+  uint32_t buf;
+  uint32_t len;
+  int64_t offset;
+  uint64_t user_data;
+};
+
+/*
+ * Completion queue entry.  result is the number of bytes transferred,
+ * 0 for NACL_ABI_AIO_FSYNC, or a negated NACL_ABI_E* value.
+ */
+struct nacl_abi_aio_cqe {
+  uint64_t user_data;
+  int32_t result;
+  uint32_t reserved;
+};
+
+struct nacl_abi_aio_ring {
+  uint32_t sq_head;
+  uint32_t sq_tail;
+  uint32_t cq_head;
+  uint32_t cq_tail;
+  uint32_t entries;
+  uint32_t reserved[3];
+};
+
+#define NACL_ABI_AIO_RING_SIZE(entries) \
+    (sizeof(struct nacl_abi_aio_ring) + \
+     (entries) * (sizeof(struct nacl_abi_aio_sqe) + \
+                  sizeof(struct nacl_abi_aio_cqe)))
+
+#endif
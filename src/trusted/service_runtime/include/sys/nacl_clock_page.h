@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl Service Runtime API.  Layout of the read-only clock page.
+ *
+ * When enabled, the service runtime maps a single read-only page into
+ * the untrusted address space and passes its address to untrusted
+ * code in the auxv under AT_NACL_CLOCK_PAGE (see elf_auxv.h).  The
+ * service runtime periodically refreshes the base times stored in the
+ * page, and
+ * untrusted code extrapolates from them using the timestamp counter,
+ * so that clock_gettime() for CLOCK_REALTIME and CLOCK_MONOTONIC does
+ * not need to enter the service runtime.
+ *
+ * Updates are protected by a sequence lock: |seq| is odd while the
+ * page is being written.  A reader must read |seq|, read the fields,
+ * and then re-read |seq|, retrying if the two values differ or are
+ * odd.  A reader must fall back to the clock_gettime syscall if
+ * |version| is not NACL_ABI_CLOCK_PAGE_VERSION, if the
+ * NACL_ABI_CLOCK_PAGE_TSC_VALID flag is clear, or if the timestamp
+ * counter has advanced more than |max_tsc_delta| ticks past
+ * |tsc_base| (which happens if the updater has stalled).
+ *
+ * The time in nanoseconds for a timestamp counter value |tsc| is
+ *
+ *   base_ns + (((tsc - tsc_base) * tsc_mult) >> tsc_shift)
+ *
+ * for base_ns in {monotonic_ns, realtime_ns}.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_CLOCK_PAGE_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_CLOCK_PAGE_H_
+
+#if defined(NACL_IN_TOOLCHAIN_HEADERS)
+# include <stdint.h>
+#else
+# include "native_client/src/include/portability.h"
+#endif
+
+#define NACL_ABI_CLOCK_PAGE_VERSION   1
+
+#define NACL_ABI_CLOCK_PAGE_TSC_VALID 0x1
+
+struct nacl_abi_clock_page {
+  volatile uint32_t seq;
+  uint32_t version;
+  uint32_t flags;
+  uint32_t tsc_shift;
+  uint64_t tsc_mult;
+  uint64_t tsc_base;
+  uint64_t max_tsc_delta;
+  uint64_t monotonic_ns;
+  uint64_t realtime_ns;
+};
+
+#endif
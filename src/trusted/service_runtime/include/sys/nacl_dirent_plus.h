@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl Service Runtime API.  Directory entries returned by the
+ * getdents_plus syscall.
+ *
+ * getdents_plus(fd, buf, count) works like getdents, but each entry
+ * also carries the file type, size and modification time of the
+ * entry, so that a directory walk does not need a stat per name.
+ * Records are packed one after another, each nacl_abi_d_reclen bytes
+ * long (a multiple of 8), and buf must be 8-byte aligned.  The
+ * attributes are those of the entry itself, not of what a symbolic
+ * link points to.  Where they cannot be read, for example because the
+ * file was removed after the directory was read, and for "..", only
+ * the file type is filled in and the other attributes are 0.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_DIRENT_PLUS_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_DIRENT_PLUS_H_
+
+#if defined(NACL_IN_TOOLCHAIN_HEADERS)
+# include <stdint.h>
+#else
+# include "native_client/src/include/portability.h"
+#endif
+
+#define NACL_ABI_DIRENT_PLUS_NAME_MAX 255
+
+struct nacl_abi_dirent_plus {
+  uint64_t nacl_abi_d_ino;
+  int64_t  nacl_abi_d_off;
+  int64_t  nacl_abi_d_size;
+  int64_t  nacl_abi_d_mtime;
+  int64_t  nacl_abi_d_mtimensec;
+  uint32_t nacl_abi_d_mode;      /* NACL_ABI_S_IF* type and owner bits */
+  uint16_t nacl_abi_d_reclen;
+  char     nacl_abi_d_name[NACL_ABI_DIRENT_PLUS_NAME_MAX + 1];
+};
+
+#endif
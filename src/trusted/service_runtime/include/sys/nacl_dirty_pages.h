@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl dirty page tracking, for garbage collectors that want to rescan
+ * only the pages written since their last collection.
+ *
+ * get_dirty_pages(start, length, bitmap, flags) reports which pages of
+ * [start, start + length) were written since the previous call for
+ * those pages, and starts tracking them afresh.  Bit i of the bitmap,
+ * counting from the least significant bit of bitmap[0], describes the
+ * page at start + i * NACL_ABI_DIRTY_PAGE_SIZE; the bitmap holds one
+ * bit per page, rounded up to a whole byte.  Writes by the service
+ * runtime on the program's behalf, such as read() into the range, are
+ * counted as well.  The return value is the number of dirty pages.
+ *
+ * The first call for a page, or one after the page was remapped,
+ * reports it as dirty.  Where the host cannot track writes, every page
+ * is reported as dirty, unless NACL_ABI_DIRTY_PAGES_EXACT is passed, in
+ * which case the call fails with ENOSYS and the caller may fall back
+ * to a write barrier of its own.
+ */
+
+#ifndef _NATIVE_CLIENT_SRC_SERVICE_RUNTIME_INCLUDE_SYS_NACL_DIRTY_PAGES_H_
+#define _NATIVE_CLIENT_SRC_SERVICE_RUNTIME_INCLUDE_SYS_NACL_DIRTY_PAGES_H_ 1
+
+#define NACL_ABI_DIRTY_PAGE_SHIFT 12
+#define NACL_ABI_DIRTY_PAGE_SIZE (1 << NACL_ABI_DIRTY_PAGE_SHIFT)
+
+/* Fail with ENOSYS rather than report every page as dirty. */
+#define NACL_ABI_DIRTY_PAGES_EXACT 0x1
+
+#endif /* _NATIVE_CLIENT_SRC_SERVICE_RUNTIME_INCLUDE_SYS_NACL_DIRTY_PAGES_H_ */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl Service Runtime API.  Scatter/gather vector for the readv,
+ * writev and preadv syscalls.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_IOVEC_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_INCLUDE_SYS_NACL_IOVEC_H_
+
+#if defined(NACL_IN_TOOLCHAIN_HEADERS)
+# include <stdint.h>
+#else
+# include "native_client/src/include/portability.h"
+#endif
+
+/* Maximum number of segments accepted by a single syscall. */
+#define NACL_ABI_IOV_MAX 1024
+
+/* Has the same layout as untrusted code's struct iovec. */
+struct NaClUserIoVec {
+  uint32_t base;
+  uint32_t length;
+};
+
+#endif
@@ -25,4 +25,18 @@ struct NaClMemMappingInfo {
   uint32_t vmmap_type;
 };
 
+/*
+ * list_mapping_changes returns only what changed in the memory map
+ * since a generation the caller saw before.  For each address range
+ * whose mappings changed, it returns a marker entry with this
+ * vmmap_type and with prot and max_prot set to 0, followed by the
+ * current mappings in that range, clipped to it and sorted by address.
+ * The caller should drop the mappings it knows of in each marked range
+ * and replace them with the ones that follow the marker.  When the
+ * change log no longer covers the caller's generation (or it is 0),
+ * a single range covering the whole address space is returned; if its
+ * size does not fit in 32 bits, the marker's size is 0.
+ */
+#define NACL_ABI_MAPPING_CHANGED_RANGE 0x100
+
 #endif /* _NATIVE_CLIENT_SRC_SERVICE_RUNTIME_INCLUDE_SYS_NACL_LIST_MAPPINGS_H_ */
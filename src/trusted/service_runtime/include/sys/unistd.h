@@ -297,6 +297,9 @@ enum {
   NACL_ABI__SC_NACL_PNACL_MODE,
 #define NACL_ABI__SC_NACL_PNACL_MODE \
     NACL_ABI__SC_NACL_PNACL_MODE
+  NACL_ABI__SC_NACL_MAPPING_GENERATION,
+#define NACL_ABI__SC_NACL_MAPPING_GENERATION \
+    NACL_ABI__SC_NACL_MAPPING_GENERATION
 };
 
 #if defined(NACL_IN_TOOLCHAIN_HEADERS)
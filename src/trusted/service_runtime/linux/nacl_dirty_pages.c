@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Linux dirty page tracking with asynchronous userfaultfd write
+ * protection (Linux 6.7).  The range is registered with a userfaultfd
+ * in UFFD_FEATURE_WP_ASYNC mode, so the kernel itself resolves write
+ * faults on write-protected pages, from untrusted code and from system
+ * calls alike, by clearing the page's uffd-wp bit.  A PAGEMAP_SCAN
+ * ioctl on /proc/self/pagemap then reports the pages without the bit
+ * and sets it again in the same pass, so no write can fall between
+ * reading and clearing the dirty state.
+ *
+ * Soft-dirty bits (/proc/self/clear_refs) are not used: they can only
+ * be cleared for the whole process, separately from reading them, and
+ * a write between the two would be lost.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "native_client/src/include/nacl_macros.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_dirty_pages.h"
+#include "native_client/src/trusted/service_runtime/nacl_dirty_pages.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+
+/*
+ * From <linux/userfaultfd.h> and <linux/fs.h>, which C libraries may
+ * not have, or have from before these features existed.
+ */
+#define NACL_UFFD_USER_MODE_ONLY 1
+#define NACL_UFFD_API 0xAAULL
+#define NACL_UFFD_FEATURE_WP_UNPOPULATED (1ULL << 13)
+#define NACL_UFFD_FEATURE_WP_ASYNC (1ULL << 15)
+#define NACL_UFFDIO_REGISTER_MODE_WP (1ULL << 1)
+#define NACL_UFFDIO_WRITEPROTECT_MODE_WP (1ULL << 0)
+
+struct NaClUffdioApi {
+  uint64_t api;
+  uint64_t features;
+  uint64_t ioctls;
+};
+
+struct NaClUffdioRegister {
+  uint64_t start;
+  uint64_t len;
+  uint64_t mode;
+  uint64_t ioctls;
+};
+
+struct NaClUffdioWriteprotect {
+  uint64_t start;
+  uint64_t len;
+  uint64_t mode;
+};
+
+#define NACL_UFFDIO_API _IOWR(0xAA, 0x3F, struct NaClUffdioApi)
+#define NACL_UFFDIO_REGISTER _IOWR(0xAA, 0x00, struct NaClUffdioRegister)
+#define NACL_UFFDIO_WRITEPROTECT \
+    _IOWR(0xAA, 0x06, struct NaClUffdioWriteprotect)
+
+#define NACL_PAGE_IS_WRITTEN (1ULL << 1)
+#define NACL_PM_SCAN_WP_MATCHING (1ULL << 0)
+#define NACL_PM_SCAN_CHECK_WPASYNC (1ULL << 1)
+
+struct NaClPageRegion {
+  uint64_t start;
+  uint64_t end;
+  uint64_t categories;
+};
+
+struct NaClPmScanArg {
+  uint64_t size;
+  uint64_t flags;
+  uint64_t start;
+  uint64_t end;
+  uint64_t walk_end;
+  uint64_t vec;
+  uint64_t vec_len;
+  uint64_t max_pages;
+  uint64_t category_inverted;
+  uint64_t category_mask;
+  uint64_t category_anyof_mask;
+  uint64_t return_mask;
+};
+
+#define NACL_PAGEMAP_SCAN _IOWR('f', 16, struct NaClPmScanArg)
+
+struct NaClDirtyPages {
+  int usable;
+  int uffd;
+  int pagemap_fd;
+};
+
+/* Number of dirty runs read per PAGEMAP_SCAN call. */
+#define NACL_DIRTY_PAGES_REGIONS 128
+
+static void NaClDirtyPagesOpen(struct NaClDirtyPages *dp) {
+  struct NaClUffdioApi api;
+
+  dp->usable = 0;
+  dp->pagemap_fd = -1;
+#if defined(__NR_userfaultfd)
+  /*
+   * UFFD_USER_MODE_ONLY keeps this working with
+   * vm.unprivileged_userfaultfd=0.  Write faults from the kernel are
+   * still resolved, since async mode never queues a fault.
+   */
+  dp->uffd = (int) syscall(__NR_userfaultfd,
+                           O_CLOEXEC | O_NONBLOCK | NACL_UFFD_USER_MODE_ONLY);
+#else
+  dp->uffd = -1;
+  errno = ENOSYS;
+#endif
+  if (-1 == dp->uffd) {
+    NaClLog(2, "NaClDirtyPagesOpen: userfaultfd failed, errno %d\n", errno);
+    return;
+  }
+  memset(&api, 0, sizeof api);
+  api.api = NACL_UFFD_API;
+  api.features = (NACL_UFFD_FEATURE_WP_ASYNC |
+                  NACL_UFFD_FEATURE_WP_UNPOPULATED);
+  if (0 != ioctl(dp->uffd, NACL_UFFDIO_API, &api)) {
+    NaClLog(2, "NaClDirtyPagesOpen: no async write protection, errno %d\n",
+            errno);
+    (void) close(dp->uffd);
+    return;
+  }
+  dp->pagemap_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+  if (-1 == dp->pagemap_fd) {
+    NaClLog(2, "NaClDirtyPagesOpen: cannot open pagemap, errno %d\n", errno);
+    (void) close(dp->uffd);
+    return;
+  }
+  dp->usable = 1;
+}
+
+static void NaClDirtyPagesSetBits(uint8_t *bitmap, size_t first,
+                                  size_t end) {
+  while (first < end && 0 != (first & 7)) {
+    bitmap[first >> 3] |= (uint8_t) (1 << (first & 7));
+    ++first;
+  }
+  if (first + 8 <= end) {
+    memset(bitmap + (first >> 3), 0xff, (end - first) >> 3);
+    first += (end - first) & ~(size_t) 7;
+  }
+  while (first < end) {
+    bitmap[first >> 3] |= (uint8_t) (1 << (first & 7));
+    ++first;
+  }
+}
+
+/*
+ * Returns 1 on success, 0 if some mapping in the range is not
+ * registered for async write protection, and -1 on other errors.
+ */
+static int NaClDirtyPagesScanRange(struct NaClDirtyPages *dp,
+                                   uintptr_t sysaddr,
+                                   size_t num_pages,
+                                   uint8_t *bitmap) {
+  struct NaClPageRegion regions[NACL_DIRTY_PAGES_REGIONS];
+  struct NaClPmScanArg arg;
+  uint64_t start = sysaddr;
+  uint64_t end = sysaddr + ((uint64_t) num_pages << NACL_ABI_DIRTY_PAGE_SHIFT);
+  uint64_t first;
+  uint64_t last;
+  int count;
+  int i;
+
+  while (start < end) {
+    memset(&arg, 0, sizeof arg);
+    arg.size = sizeof arg;
+    arg.flags = NACL_PM_SCAN_WP_MATCHING | NACL_PM_SCAN_CHECK_WPASYNC;
+    arg.start = start;
+    arg.end = end;
+    arg.vec = (uintptr_t) regions;
+    arg.vec_len = NACL_ARRAY_SIZE(regions);
+    arg.category_mask = NACL_PAGE_IS_WRITTEN;
+    arg.return_mask = NACL_PAGE_IS_WRITTEN;
+    count = ioctl(dp->pagemap_fd, NACL_PAGEMAP_SCAN, &arg);
+    if (count < 0) {
+      if (EPERM == errno) {
+        return 0;
+      }
+      NaClLog(LOG_WARNING, "NaClDirtyPagesScanRange: PAGEMAP_SCAN failed,"
+              " errno %d\n", errno);
+      return -1;
+    }
+    for (i = 0; i < count; ++i) {
+      first = (regions[i].start - sysaddr) >> NACL_ABI_DIRTY_PAGE_SHIFT;
+      last = (regions[i].end - sysaddr) >> NACL_ABI_DIRTY_PAGE_SHIFT;
+      NaClDirtyPagesSetBits(bitmap, (size_t) first, (size_t) last);
+    }
+    /* walk_end is short of end only when regions filled up. */
+    if (arg.walk_end <= start) {
+      return -1;
+    }
+    start = arg.walk_end;
+  }
+  return 1;
+}
+
+int NaClDirtyPagesScanMu(struct NaClApp *nap,
+                         uintptr_t      sysaddr,
+                         size_t         num_pages,
+                         uint8_t        *bitmap) {
+  struct NaClDirtyPages *dp = nap->dirty_pages;
+  struct NaClUffdioRegister reg;
+  struct NaClUffdioWriteprotect wp;
+  int rv;
+
+  if (NULL == dp) {
+    dp = (struct NaClDirtyPages *) malloc(sizeof *dp);
+    if (NULL == dp) {
+      return -1;
+    }
+    NaClDirtyPagesOpen(dp);
+    nap->dirty_pages = dp;
+  }
+  if (!dp->usable) {
+    return -1;
+  }
+
+  rv = NaClDirtyPagesScanRange(dp, sysaddr, num_pages, bitmap);
+  if (0 != rv) {
+    return rv;
+  }
+  /*
+   * Part of the range was never registered, or was remapped since.
+   * The scan may have cleared dirty state before it stopped, so report
+   * the whole range.  Registering an already registered mapping is a
+   * no-op.  Registration leaves pages unprotected, so the whole range is
+   * then write-protected (with WP_UNPOPULATED, unpopulated pages too),
+   * so that the next scan only reports pages written after this call.
+   */
+  memset(&reg, 0, sizeof reg);
+  reg.start = sysaddr;
+  reg.len = (uint64_t) num_pages << NACL_ABI_DIRTY_PAGE_SHIFT;
+  reg.mode = NACL_UFFDIO_REGISTER_MODE_WP;
+  if (0 != ioctl(dp->uffd, NACL_UFFDIO_REGISTER, &reg)) {
+    NaClLog(2, "NaClDirtyPagesScanMu: UFFDIO_REGISTER failed, errno %d\n",
+            errno);
+    return -1;
+  }
+  memset(&wp, 0, sizeof wp);
+  wp.start = reg.start;
+  wp.len = reg.len;
+  wp.mode = NACL_UFFDIO_WRITEPROTECT_MODE_WP;
+  if (0 != ioctl(dp->uffd, NACL_UFFDIO_WRITEPROTECT, &wp)) {
+    NaClLog(2, "NaClDirtyPagesScanMu: UFFDIO_WRITEPROTECT failed,"
+            " errno %d\n", errno);
+    return -1;
+  }
+  return 0;
+}
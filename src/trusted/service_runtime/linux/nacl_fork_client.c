@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Client for "sel_ldr --fork_server".
+ *
+ *   sel_ldr_fork_client [-n count] <socket> [args...]
+ *
+ * asks the server listening on <socket> to run its nexe with the
+ * given arguments and this process's stdin, stdout and stderr, and
+ * exits with the nexe's exit status.  With -n, the launch is repeated
+ * count times and launch latency statistics are printed on stderr.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "native_client/src/trusted/service_runtime/nacl_fork_server.h"
+
+static int64_t NowMicroseconds(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int CompareInt64(void const *a, void const *b) {
+  int64_t x = *(int64_t const *) a;
+  int64_t y = *(int64_t const *) b;
+  return x < y ? -1 : x > y;
+}
+
+/* Returns the wait status of the launched nexe, or -1 on error. */
+static int Launch(char const *socket_path, char *args, size_t args_size,
+                  uint32_t argc) {
+  struct NaClForkServerRequest req;
+  struct NaClForkServerReply reply;
+  struct sockaddr_un addr;
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(3 * sizeof(int))];
+  } control;
+  struct msghdr msg;
+  struct iovec iov[2];
+  struct cmsghdr *cmsg;
+  int fds[3] = { 0, 1, 2 };
+  size_t received;
+  int sock;
+
+  sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0) {
+    perror("sel_ldr_fork_client: socket");
+    return -1;
+  }
+  memset(&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path, sizeof addr.sun_path - 1);
+  if (0 != connect(sock, (struct sockaddr *) &addr, sizeof addr)) {
+    perror("sel_ldr_fork_client: connect");
+    close(sock);
+    return -1;
+  }
+
+  req.magic = NACL_FORK_SERVER_REQUEST_MAGIC;
+  req.argc = argc;
+  req.args_size = (uint32_t) args_size;
+  iov[0].iov_base = &req;
+  iov[0].iov_len = sizeof req;
+  iov[1].iov_base = args;
+  iov[1].iov_len = args_size;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof control.buf;
+  cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof fds);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof fds);
+  if (sendmsg(sock, &msg, 0) != (ssize_t) (sizeof req + args_size)) {
+    perror("sel_ldr_fork_client: sendmsg");
+    close(sock);
+    return -1;
+  }
+
+  received = 0;
+  while (received < sizeof reply) {
+    ssize_t n = read(sock, (char *) &reply + received,
+                     sizeof reply - received);
+    if (n < 0 && EINTR == errno) {
+      continue;
+    }
+    if (n <= 0) {
+      fprintf(stderr, "sel_ldr_fork_client: server closed connection\n");
+      close(sock);
+      return -1;
+    }
+    received += n;
+  }
+  close(sock);
+  if (NACL_FORK_SERVER_REPLY_MAGIC != reply.magic) {
+    fprintf(stderr, "sel_ldr_fork_client: bad reply from server\n");
+    return -1;
+  }
+  return reply.wait_status;
+}
+
+int main(int argc, char **argv) {
+  char const *socket_path;
+  char *args;
+  size_t args_size = 0;
+  int64_t *latencies;
+  int64_t total = 0;
+  int count = 1;
+  int status = -1;
+  int opt;
+  int i;
+
+  while ((opt = getopt(argc, argv, "+n:")) != -1) {
+    switch (opt) {
+      case 'n':
+        count = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: sel_ldr_fork_client [-n count] socket [args...]\n");
+        return 1;
+    }
+  }
+  if (optind >= argc || count < 1) {
+    fprintf(stderr,
+            "Usage: sel_ldr_fork_client [-n count] socket [args...]\n");
+    return 1;
+  }
+  socket_path = argv[optind++];
+
+  for (i = optind; i < argc; ++i) {
+    args_size += strlen(argv[i]) + 1;
+  }
+  if (args_size > NACL_FORK_SERVER_MAX_ARGS_SIZE) {
+    fprintf(stderr, "sel_ldr_fork_client: argument list too long\n");
+    return 1;
+  }
+  args = (char *) malloc(args_size + 1);
+  latencies = (int64_t *) malloc(count * sizeof *latencies);
+  if (NULL == args || NULL == latencies) {
+    fprintf(stderr, "sel_ldr_fork_client: out of memory\n");
+    return 1;
+  }
+  args_size = 0;
+  for (i = optind; i < argc; ++i) {
+    size_t len = strlen(argv[i]) + 1;
+    memcpy(args + args_size, argv[i], len);
+    args_size += len;
+  }
+
+  for (i = 0; i < count; ++i) {
+    int64_t start = NowMicroseconds();
+    status = Launch(socket_path, args, args_size,
+                    (uint32_t) (argc - optind));
+    if (status < 0) {
+      return 1;
+    }
+    latencies[i] = NowMicroseconds() - start;
+    total += latencies[i];
+  }
+
+  if (count > 1) {
+    qsort(latencies, count, sizeof *latencies, CompareInt64);
+    fprintf(stderr,
+            "launches: %d  mean: %lld us  median: %lld us  p90: %lld us"
+            "  max: %lld us\n",
+            count, (long long) (total / count),
+            (long long) latencies[count / 2],
+            (long long) latencies[count * 9 / 10],
+            (long long) latencies[count - 1]);
+  }
+
+  if (WIFEXITED(status)) {
+    return WEXITSTATUS(status);
+  }
+  if (WIFSIGNALED(status)) {
+    return 128 + WTERMSIG(status);
+  }
+  return 1;
+}
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "native_client/src/trusted/service_runtime/nacl_fork_server.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "native_client/src/shared/platform/nacl_global_secure_random.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/trusted/desc/nacl_desc_buffered.h"
+#include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
+#include "native_client/src/trusted/service_runtime/nacl_text.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+
+/* A slow or stuck client must not stall other launches for long. */
+static const int kRequestTimeoutSeconds = 5;
+
+static const int kStdioFlags[3] = {
+  NACL_ABI_O_RDONLY,
+  NACL_ABI_O_WRONLY | NACL_ABI_O_APPEND,
+  NACL_ABI_O_WRONLY | NACL_ABI_O_APPEND,
+};
+
+struct ForkServerChild {
+  pid_t pid;
+  int conn;
+};
+
+struct ForkServer {
+  int listen_fd;
+  int signal_fd;
+  sigset_t saved_mask;
+  struct ForkServerChild *children;
+  size_t num_children;
+  size_t children_allocated;
+};
+
+struct ForkServerRequest {
+  struct NaClForkServerRequest header;
+  int fds[3];
+  char *args;
+};
+
+static int ReadFully(int fd, void *buf, size_t size) {
+  char *p = (char *) buf;
+
+  while (size > 0) {
+    ssize_t n = read(fd, p, size);
+    if (n < 0 && EINTR == errno) {
+      continue;
+    }
+    if (n <= 0) {
+      return 0;
+    }
+    p += n;
+    size -= n;
+  }
+  return 1;
+}
+
+static int WriteFully(int fd, void const *buf, size_t size) {
+  char const *p = (char const *) buf;
+
+  while (size > 0) {
+    ssize_t n = write(fd, p, size);
+    if (n < 0 && EINTR == errno) {
+      continue;
+    }
+    if (n <= 0) {
+      return 0;
+    }
+    p += n;
+    size -= n;
+  }
+  return 1;
+}
+
+static void CloseRequestFds(struct ForkServerRequest *req) {
+  int i;
+
+  for (i = 0; i < 3; ++i) {
+    if (-1 != req->fds[i]) {
+      (void) close(req->fds[i]);
+      req->fds[i] = -1;
+    }
+  }
+}
+
+/*
+ * Reads a request from conn.  On failure, returns 0 and leaves no
+ * descriptors or memory to free.
+ */
+static int ReadRequest(int conn, struct ForkServerRequest *req) {
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(3 * sizeof(int))];
+  } control;
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  ssize_t received;
+  uint32_t nuls;
+  uint32_t i;
+
+  req->fds[0] = req->fds[1] = req->fds[2] = -1;
+  req->args = NULL;
+
+  memset(&msg, 0, sizeof msg);
+  iov.iov_base = &req->header;
+  iov.iov_len = sizeof req->header;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof control.buf;
+  do {
+    received = recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+  } while (received < 0 && EINTR == errno);
+  if (received <= 0) {
+    return 0;
+  }
+  for (cmsg = CMSG_FIRSTHDR(&msg); NULL != cmsg;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (SOL_SOCKET == cmsg->cmsg_level && SCM_RIGHTS == cmsg->cmsg_type &&
+        CMSG_LEN(3 * sizeof(int)) == cmsg->cmsg_len) {
+      memcpy(req->fds, CMSG_DATA(cmsg), sizeof req->fds);
+    }
+  }
+  if (-1 == req->fds[0] || 0 != (msg.msg_flags & MSG_CTRUNC)) {
+    NaClLog(LOG_ERROR, "NaClForkServer: request without stdio descriptors\n");
+    CloseRequestFds(req);
+    return 0;
+  }
+  if ((size_t) received < sizeof req->header &&
+      !ReadFully(conn, (char *) &req->header + received,
+                 sizeof req->header - received)) {
+    CloseRequestFds(req);
+    return 0;
+  }
+  if (NACL_FORK_SERVER_REQUEST_MAGIC != req->header.magic ||
+      req->header.args_size > NACL_FORK_SERVER_MAX_ARGS_SIZE) {
+    NaClLog(LOG_ERROR, "NaClForkServer: malformed request\n");
+    CloseRequestFds(req);
+    return 0;
+  }
+
+  req->args = (char *) malloc(req->header.args_size + 1);
+  if (NULL == req->args ||
+      !ReadFully(conn, req->args, req->header.args_size)) {
+    free(req->args);
+    req->args = NULL;
+    CloseRequestFds(req);
+    return 0;
+  }
+  nuls = 0;
+  for (i = 0; i < req->header.args_size; ++i) {
+    if ('\0' == req->args[i]) {
+      ++nuls;
+    }
+  }
+  if (nuls != req->header.argc ||
+      (req->header.args_size > 0 &&
+       '\0' != req->args[req->header.args_size - 1])) {
+    NaClLog(LOG_ERROR, "NaClForkServer: malformed argument list\n");
+    free(req->args);
+    req->args = NULL;
+    CloseRequestFds(req);
+    return 0;
+  }
+  return 1;
+}
+
+/*
+ * Turns the calling process, just forked, into the process that runs
+ * the request.
+ */
+static void SetUpChild(struct NaClApp *nap,
+                       struct ForkServer *server,
+                       int conn,
+                       struct ForkServerRequest *req,
+                       int *argc_p,
+                       char ***argv_p) {
+  char **argv;
+  char *arg;
+  size_t i;
+  int fd;
+
+  /*
+   * The server has already drawn from the global secure RNG (address
+   * space reservation, for one), so its buffer holds bytes that every
+   * child would otherwise hand out again.  Reconstructing it discards
+   * them, and also recreates its mutex in case another server thread
+   * held it at the fork.
+   */
+  NaClGlobalSecureRngInit();
+  NaClDescBufferedResetAfterFork();
+
+  (void) close(server->listen_fd);
+  (void) close(server->signal_fd);
+  (void) close(conn);
+  for (i = 0; i < server->num_children; ++i) {
+    (void) close(server->children[i].conn);
+  }
+  free(server->children);
+  if (0 != sigprocmask(SIG_SETMASK, &server->saved_mask, NULL)) {
+    NaClLog(LOG_FATAL, "NaClForkServer: sigprocmask failed\n");
+  }
+
+  /*
+   * The host descriptors are redirected too, so that sel_ldr's own
+   * diagnostics go to the requester.
+   */
+  for (fd = 0; fd < 3; ++fd) {
+    if (dup2(req->fds[fd], fd) < 0) {
+      NaClLog(LOG_FATAL, "NaClForkServer: dup2 failed, errno %d\n", errno);
+    }
+    NaClAddHostDescriptor(nap, req->fds[fd], kStdioFlags[fd], fd);
+    /* As in NaClAppInitialDescriptorHookup. */
+    if (0 != (kStdioFlags[fd] & NACL_ABI_O_APPEND)) {
+      NaClAppSetDesc(nap, fd,
+                     NaClAppMaybeBufferDesc(nap, NaClAppGetDesc(nap, fd)));
+    }
+  }
+
+  if (LOAD_OK != NaClDynamicTextUnshare(nap)) {
+    NaClLog(LOG_FATAL, "NaClForkServer: cannot unshare dynamic text\n");
+  }
+
+  argv = (char **) malloc((req->header.argc + 2) * sizeof *argv);
+  if (NULL == argv) {
+    NaClLog(LOG_FATAL, "NaClForkServer: out of memory\n");
+  }
+  argv[0] = (*argv_p)[0];
+  arg = req->args;
+  for (i = 0; i < req->header.argc; ++i) {
+    argv[i + 1] = arg;
+    arg += strlen(arg) + 1;
+  }
+  argv[req->header.argc + 1] = NULL;
+  *argc_p = (int) req->header.argc + 1;
+  *argv_p = argv;
+}
+
+static int AddChild(struct ForkServer *server, pid_t pid, int conn) {
+  if (server->num_children == server->children_allocated) {
+    size_t new_allocated = 2 * server->children_allocated + 16;
+    struct ForkServerChild *new_children = (struct ForkServerChild *)
+        realloc(server->children, new_allocated * sizeof *new_children);
+    if (NULL == new_children) {
+      return 0;
+    }
+    server->children = new_children;
+    server->children_allocated = new_allocated;
+  }
+  server->children[server->num_children].pid = pid;
+  server->children[server->num_children].conn = conn;
+  server->num_children++;
+  return 1;
+}
+
+static void ReapChildren(struct ForkServer *server) {
+  struct signalfd_siginfo info;
+  int status;
+  pid_t pid;
+  size_t i;
+
+  /* Drain the signalfd; SIGCHLDs may have been coalesced. */
+  while (read(server->signal_fd, &info, sizeof info) == sizeof info) {
+  }
+
+  while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+    for (i = 0; i < server->num_children; ++i) {
+      if (server->children[i].pid == pid) {
+        struct NaClForkServerReply reply;
+
+        reply.magic = NACL_FORK_SERVER_REPLY_MAGIC;
+        reply.pid = pid;
+        reply.wait_status = status;
+        if (!WriteFully(server->children[i].conn, &reply, sizeof reply)) {
+          NaClLog(LOG_WARNING,
+                  "NaClForkServer: could not report exit of %d\n", pid);
+        }
+        (void) close(server->children[i].conn);
+        server->children[i] = server->children[--server->num_children];
+        break;
+      }
+    }
+    NaClLog(2, "NaClForkServer: child %d exited, status 0x%x\n",
+            pid, status);
+  }
+}
+
+/*
+ * Handles one connection.  Returns 1 in the child, 0 in the server.
+ */
+static int HandleConnection(struct NaClApp *nap,
+                            struct ForkServer *server,
+                            int conn,
+                            int *argc_p,
+                            char ***argv_p) {
+  struct ForkServerRequest req;
+  struct timeval timeout;
+  pid_t pid;
+
+  timeout.tv_sec = kRequestTimeoutSeconds;
+  timeout.tv_usec = 0;
+  (void) setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+  if (!ReadRequest(conn, &req)) {
+    (void) close(conn);
+    return 0;
+  }
+
+  /* Don't let the child inherit unflushed output. */
+  fflush((FILE *) NULL);
+  NaClDescBufferedFlushAll();
+  pid = fork();
+  if (0 == pid) {
+    SetUpChild(nap, server, conn, &req, argc_p, argv_p);
+    return 1;
+  }
+
+  CloseRequestFds(&req);
+  free(req.args);
+  if (pid < 0) {
+    NaClLog(LOG_ERROR, "NaClForkServer: fork failed, errno %d\n", errno);
+    (void) close(conn);
+  } else if (!AddChild(server, pid, conn)) {
+    /* The requester sees EOF instead of an exit status. */
+    (void) close(conn);
+  } else {
+    NaClLog(2, "NaClForkServer: started child %d\n", pid);
+  }
+  return 0;
+}
+
+int NaClForkServerRun(struct NaClApp *nap,
+                      char const *socket_path,
+                      int *argc_p,
+                      char ***argv_p) {
+  struct ForkServer server;
+  struct sockaddr_un addr;
+  sigset_t sigchld_mask;
+
+  memset(&server, 0, sizeof server);
+  if (strlen(socket_path) >= sizeof addr.sun_path) {
+    NaClLog(LOG_ERROR, "NaClForkServer: socket path too long\n");
+    return 0;
+  }
+  memset(&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path, sizeof addr.sun_path - 1);
+
+  /*
+   * Collect SIGCHLD through a signalfd so that the server loop never
+   * runs code in a signal handler.
+   */
+  sigemptyset(&sigchld_mask);
+  sigaddset(&sigchld_mask, SIGCHLD);
+  if (0 != sigprocmask(SIG_BLOCK, &sigchld_mask, &server.saved_mask)) {
+    NaClLog(LOG_ERROR, "NaClForkServer: sigprocmask failed\n");
+    return 0;
+  }
+  server.signal_fd = signalfd(-1, &sigchld_mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (server.signal_fd < 0) {
+    NaClLog(LOG_ERROR, "NaClForkServer: signalfd failed, errno %d\n", errno);
+    return 0;
+  }
+
+  server.listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (server.listen_fd < 0) {
+    NaClLog(LOG_ERROR, "NaClForkServer: socket failed, errno %d\n", errno);
+    return 0;
+  }
+  (void) unlink(socket_path);
+  if (0 != bind(server.listen_fd, (struct sockaddr *) &addr, sizeof addr) ||
+      0 != listen(server.listen_fd, SOMAXCONN)) {
+    NaClLog(LOG_ERROR, "NaClForkServer: cannot listen on %s, errno %d\n",
+            socket_path, errno);
+    return 0;
+  }
+  NaClLog(LOG_INFO, "NaClForkServer: listening on %s\n", socket_path);
+
+  for (;;) {
+    struct pollfd fds[2];
+
+    fds[0].fd = server.listen_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = server.signal_fd;
+    fds[1].events = POLLIN;
+    if (poll(fds, 2, -1) < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      NaClLog(LOG_FATAL, "NaClForkServer: poll failed, errno %d\n", errno);
+    }
+    if (0 != (fds[1].revents & POLLIN)) {
+      ReapChildren(&server);
+    }
+    if (0 != (fds[0].revents & POLLIN)) {
+      int conn = accept4(server.listen_fd, NULL, NULL, SOCK_CLOEXEC);
+      if (conn < 0) {
+        if (EINTR != errno && EAGAIN != errno && ECONNABORTED != errno) {
+          NaClLog(LOG_ERROR, "NaClForkServer: accept failed, errno %d\n",
+                  errno);
+        }
+        continue;
+      }
+      if (HandleConnection(nap, &server, conn, argc_p, argv_p)) {
+        return 1;
+      }
+    }
+  }
+}
@@ -181,29 +181,25 @@ static int DispatchToUntrustedHandler(struct NaClAppThread *natp,
   uint32_t new_stack_ptr;
   uintptr_t context_user_addr;
 
-  if (!NaClSignalCheckSandboxInvariants(regs, natp)) {
-    return 0;
-  }
+  /* Check the cheapest reasons for not dispatching first. */
   if (nap->exception_handler == 0) {
     return 0;
   }
   if (natp->exception_flag) {
     return 0;
   }
+  if (!NaClSignalCheckSandboxInvariants(regs, natp)) {
+    return 0;
+  }
 
   natp->exception_flag = 1;
 
   if (natp->exception_stack == 0) {
-    new_stack_ptr = regs->stack_ptr - NACL_STACK_RED_ZONE;
+    new_stack_ptr = NaClSignalExceptionFramePtr(
+        (uint32_t) regs->stack_ptr - NACL_STACK_RED_ZONE);
   } else {
-    new_stack_ptr = natp->exception_stack;
+    new_stack_ptr = natp->exception_frame_ptr;
   }
-  /* Allocate space for the stack frame, and ensure its alignment. */
-  new_stack_ptr -=
-      sizeof(struct NaClExceptionFrame) - NACL_STACK_PAD_BELOW_ALIGN;
-  new_stack_ptr = new_stack_ptr & ~NACL_STACK_ALIGN_MASK;
-  new_stack_ptr -= NACL_STACK_ARGS_SIZE;
-  new_stack_ptr -= NACL_STACK_PAD_BELOW_ALIGN;
   frame_addr = NaClUserToSysAddrRange(nap, new_stack_ptr,
                                       sizeof(struct NaClExceptionFrame));
   if (frame_addr == kNaClBadAddress) {
@@ -326,7 +322,7 @@ static void SignalCatch(int sig, siginfo_t *info, void *uc) {
       (sig == SIGSEGV || sig == SIGILL || sig == SIGFPE ||
        (NACL_ARCH(NACL_BUILD_ARCH) == NACL_mips && sig == SIGTRAP))) {
     if (DispatchToUntrustedHandler(natp, &sig_ctx)) {
-      NaClSignalContextToHandler(uc, &sig_ctx);
+      NaClSignalContextToHandlerForException(uc, &sig_ctx);
       /* Resume untrusted code using the modified register state. */
       return;
     }
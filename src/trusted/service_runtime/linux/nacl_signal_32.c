@@ -87,5 +87,19 @@ void NaClSignalContextToHandler(void *raw_ctx,
   mctx->gregs[REG_GS] = sig_ctx->gs;
 }
 
+/*
+ * Update only the registers that are changed when entering the
+ * untrusted exception handler.
+ */
+void NaClSignalContextToHandlerForException(
+    void *raw_ctx, const struct NaClSignalContext *sig_ctx) {
+  ucontext_t *uctx = (ucontext_t *) raw_ctx;
+  mcontext_t *mctx = &uctx->uc_mcontext;
+
+  mctx->gregs[REG_EIP] = sig_ctx->prog_ctr;
+  mctx->gregs[REG_ESP] = sig_ctx->stack_ptr;
+  mctx->gregs[REG_EFL] = sig_ctx->flags;
+}
+
 
 
@@ -100,5 +100,20 @@ void NaClSignalContextToHandler(void *raw_ctx,
    */
 }
 
+/*
+ * Update only the registers that are changed when entering the
+ * untrusted exception handler.
+ */
+void NaClSignalContextToHandlerForException(
+    void *raw_ctx, const struct NaClSignalContext *sig_ctx) {
+  ucontext_t *uctx = (ucontext_t *) raw_ctx;
+  mcontext_t *mctx = &uctx->uc_mcontext;
+
+  mctx->gregs[REG_RIP] = sig_ctx->prog_ctr;
+  mctx->gregs[REG_RSP] = sig_ctx->stack_ptr;
+  mctx->gregs[REG_RDI] = sig_ctx->rdi;
+  mctx->gregs[REG_EFL] = sig_ctx->flags;
+}
+
 
 
@@ -70,3 +70,18 @@ void NaClSignalContextToHandler(void *raw_ctx,
   mctx->arm_lr = sig_ctx->lr;
   mctx->arm_cpsr = sig_ctx->cpsr;
 }
+
+/*
+ * Update only the registers that are changed when entering the
+ * untrusted exception handler.
+ */
+void NaClSignalContextToHandlerForException(
+    void *raw_ctx, const struct NaClSignalContext *sig_ctx) {
+  ucontext_t *uctx = (ucontext_t *) raw_ctx;
+  struct sigcontext *mctx = &uctx->uc_mcontext;
+
+  mctx->arm_pc = sig_ctx->prog_ctr;
+  mctx->arm_sp = sig_ctx->stack_ptr;
+  mctx->arm_r0 = sig_ctx->r0;
+  mctx->arm_lr = sig_ctx->lr;
+}
@@ -105,3 +105,19 @@ void NaClSignalContextToHandler(void *raw_ctx,
   mctx->gregs[30] = sig_ctx->frame_ptr;
   mctx->gregs[31] = sig_ctx->return_addr;
 }
+
+/*
+ * Update only the registers that are changed when entering the
+ * untrusted exception handler.
+ */
+void NaClSignalContextToHandlerForException(
+    void *raw_ctx, const struct NaClSignalContext *sig_ctx) {
+  ucontext_t *uctx = (ucontext_t *) raw_ctx;
+  mcontext_t *mctx = &uctx->uc_mcontext;
+
+  mctx->pc = sig_ctx->prog_ctr;
+  mctx->gregs[4] = sig_ctx->a0;
+  mctx->gregs[25] = sig_ctx->t9;
+  mctx->gregs[29] = sig_ctx->stack_ptr;
+  mctx->gregs[31] = sig_ctx->return_addr;
+}
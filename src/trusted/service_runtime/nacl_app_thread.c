@@ -23,6 +23,7 @@
 #include "native_client/src/trusted/service_runtime/nacl_switch_to_app.h"
 #include "native_client/src/trusted/service_runtime/nacl_stack_safety.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_profile.h"
 #include "native_client/src/trusted/service_runtime/osx/mach_thread_map.h"
 
 
@@ -188,6 +189,7 @@ struct NaClAppThread *NaClAppThreadMake(struct NaClApp *nap,
 
   natp->signal_stack = NULL;
   natp->exception_stack = 0;
+  natp->exception_frame_ptr = 0;
   natp->exception_flag = 0;
 
   if (!NaClMutexCtor(&natp->mu)) {
@@ -210,6 +212,7 @@ struct NaClAppThread *NaClAppThreadMake(struct NaClApp *nap,
   if (!NaClCondVarCtor(&natp->futex_condvar)) {
     goto cleanup_suspend_mu;
   }
+  NaClSyscallProfileThreadInit(natp);
   return natp;
 
  cleanup_suspend_mu:
@@ -264,6 +267,7 @@ void NaClAppThreadDelete(struct NaClAppThread *natp) {
   if (natp->host_thread_is_defined) {
     NaClThreadDtor(&natp->host_thread);
   }
+  NaClSyscallProfileThreadFini(natp);
   free(natp->suspended_registers);
   NaClMutexDtor(&natp->suspend_mu);
   NaClSignalStackFree(natp->signal_stack);
@@ -26,6 +26,7 @@ EXTERN_C_BEGIN
 
 struct NaClApp;
 struct NaClAppThreadSuspendedRegisters;
+struct NaClSyscallProfile;
 
 /*
  * The thread hosting the NaClAppThread may change suspend_state
@@ -131,12 +132,24 @@ struct NaClAppThread {
   /* Stack for signal handling, registered with sigaltstack(). */
   void                      *signal_stack;
 
+  /*
+   * Per-thread syscall counters, or NULL if profiling is disabled.
+   * Only written by this thread; see nacl_syscall_profile.h.
+   */
+  struct NaClSyscallProfile *syscall_profile;
+
   /*
    * exception_stack is the address of the top of the untrusted
    * exception handler stack, or 0 if no such stack is registered for
    * this thread.
    */
   uint32_t                  exception_stack;
+  /*
+   * exception_frame_ptr is where the exception frame goes on that
+   * stack, computed once when the stack is registered rather than on
+   * every fault.  It is only meaningful if exception_stack is not 0.
+   */
+  uint32_t                  exception_frame_ptr;
   /*
    * exception_flag is a boolean.  When it is 1, untrusted exception
    * handling is disabled for this thread.  It is set to 1 when the
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "native_client/src/trusted/service_runtime/nacl_clock_page.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/build_config.h"
+#include "native_client/src/include/concurrency_ops.h"
+#include "native_client/src/include/nacl_platform.h"
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_clock.h"
+#include "native_client/src/shared/platform/nacl_host_desc.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_sync_checked.h"
+#include "native_client/src/shared/platform/nacl_threads.h"
+#include "native_client/src/shared/platform/nacl_time.h"
+#include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/desc/nacl_desc_effector_trusted_mem.h"
+#include "native_client/src/trusted/desc/nacl_desc_imc_shm.h"
+#include "native_client/src/trusted/service_runtime/include/bits/mman.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_clock_page.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+
+#if NACL_WINDOWS && NACL_ARCH(NACL_BUILD_ARCH) == NACL_x86
+# include <intrin.h>
+#endif
+
+/*
+ * How often the updater thread refreshes the base times.  Between
+ * updates, untrusted code extrapolates using the timestamp counter,
+ * so this only bounds how quickly adjustments to the host's realtime
+ * clock become visible.
+ */
+static const uint32_t kClockPageUpdateIntervalNs = 10 * 1000 * 1000;
+
+/*
+ * Readers fall back to the syscall if the updater has not run for
+ * this many update intervals.
+ */
+static const uint32_t kClockPageMaxStaleIntervals = 8;
+
+static const size_t kClockPageThreadStackSize = 64 << 10;
+
+#if NACL_ARCH(NACL_BUILD_ARCH) == NACL_x86
+
+static uint64_t ReadTimestampCounter(void) {
+#if NACL_WINDOWS
+  return __rdtsc();
+#else
+  uint32_t edx;
+  uint32_t eax;
+  __asm__ volatile("rdtsc" : "=d"(edx), "=a"(eax));
+  return (((uint64_t) edx) << 32) | eax;
+#endif
+}
+
+static void Cpuid(uint32_t op, uint32_t reg[4]) {
+#if NACL_WINDOWS
+  __cpuid((int *) reg, op);
+#elif NACL_BUILD_SUBARCH == 64
+  __asm__ volatile("push %%rbx       \n\t"
+                   "cpuid            \n\t"
+                   "movl %%ebx, %1   \n\t"
+                   "pop %%rbx        \n\t"
+                   : "=a"(reg[0]), "=S"(reg[1]), "=c"(reg[2]), "=d"(reg[3])
+                   : "a"(op)
+                   : "cc");
+#else
+  __asm__ volatile("pushl %%ebx      \n\t"
+                   "cpuid            \n\t"
+                   "movl %%ebx, %1   \n\t"
+                   "popl %%ebx       \n\t"
+                   : "=a"(reg[0]), "=S"(reg[1]), "=c"(reg[2]), "=d"(reg[3])
+                   : "a"(op)
+                   : "cc");
+#endif
+}
+
+int NaClClockPageIsSupported(void) {
+  uint32_t reg[4];
+
+  /*
+   * Leaf 0x80000007, EDX bit 8: the timestamp counter runs at a
+   * constant rate in all ACPI P-, C- and T-states, which is what
+   * makes extrapolating from it across cores and idle periods safe.
+   */
+  Cpuid(0x80000000, reg);
+  if (reg[0] < 0x80000007) {
+    return 0;
+  }
+  Cpuid(0x80000007, reg);
+  return 0 != (reg[3] & (1 << 8));
+}
+
+#else
+
+static uint64_t ReadTimestampCounter(void) {
+  return 0;
+}
+
+int NaClClockPageIsSupported(void) {
+  return 0;
+}
+
+#endif
+
+static uint64_t ClockNowNs(nacl_clockid_t clk_id) {
+  struct nacl_abi_timespec ts;
+
+  if (0 != NaClClockGetTime(clk_id, &ts)) {
+    NaClLog(LOG_FATAL, "NaClClockPage: NaClClockGetTime failed\n");
+  }
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * Samples the host clocks and the timestamp counter as close together
+ * as possible, attributing the host times to the midpoint of the two
+ * counter reads.
+ */
+static void ClockSample(uint64_t *tsc, uint64_t *mono_ns, uint64_t *real_ns) {
+  uint64_t tsc_before = ReadTimestampCounter();
+  *mono_ns = ClockNowNs(NACL_CLOCK_MONOTONIC);
+  *real_ns = ClockNowNs(NACL_CLOCK_REALTIME);
+  *tsc = tsc_before + (ReadTimestampCounter() - tsc_before) / 2;
+}
+
+/*
+ * Bounds how far past tsc_base readers may extrapolate: the product
+ * (tsc - tsc_base) * mult must not overflow, and a stalled updater
+ * must not leave readers on stale parameters indefinitely.
+ */
+static uint64_t MaxTscDelta(uint64_t mult, uint64_t ticks_per_interval) {
+  uint64_t max_delta = ticks_per_interval * kClockPageMaxStaleIntervals;
+  if (max_delta > UINT64_MAX / mult) {
+    max_delta = UINT64_MAX / mult;
+  }
+  return max_delta;
+}
+
+static void ClockPageWrite(struct nacl_abi_clock_page *page,
+                           uint64_t tsc, uint64_t mult, uint64_t max_delta,
+                           uint64_t mono_ns, uint64_t real_ns) {
+  page->seq++;
+  NaClWriteMemoryBarrier();
+  page->tsc_base = tsc;
+  page->tsc_mult = mult;
+  page->max_tsc_delta = max_delta;
+  page->monotonic_ns = mono_ns;
+  page->realtime_ns = real_ns;
+  page->flags = NACL_ABI_CLOCK_PAGE_TSC_VALID;
+  NaClWriteMemoryBarrier();
+  page->seq++;
+}
+
+static void WINAPI ClockPageUpdater(void *state) {
+  struct NaClApp *nap = (struct NaClApp *) state;
+  struct nacl_abi_clock_page *page = nap->clock_page;
+  struct nacl_abi_timespec interval;
+  uint64_t last_tsc;
+  uint64_t last_mono_ns;
+  uint64_t unused_real_ns;
+
+  interval.tv_sec = 0;
+  interval.tv_nsec = kClockPageUpdateIntervalNs;
+
+  ClockSample(&last_tsc, &last_mono_ns, &unused_real_ns);
+  for (;;) {
+    uint64_t tsc;
+    uint64_t host_mono_ns;
+    uint64_t mono_ns;
+    uint64_t real_ns;
+    uint64_t elapsed_ns;
+    uint64_t elapsed_ticks;
+    uint64_t mult;
+
+    (void) NaClNanosleep(&interval, NULL);
+    ClockSample(&tsc, &host_mono_ns, &real_ns);
+    mono_ns = host_mono_ns;
+
+    elapsed_ns = host_mono_ns - last_mono_ns;
+    elapsed_ticks = tsc - last_tsc;
+    if (0 == elapsed_ticks || elapsed_ns >= ((uint64_t) 1 << 31)) {
+      /*
+       * We were descheduled for a long time (or the counter did not
+       * move); the extrapolation in the page has already been
+       * invalidated by max_tsc_delta, so just restart calibration.
+       */
+      last_tsc = tsc;
+      last_mono_ns = host_mono_ns;
+      continue;
+    }
+
+    /*
+     * Keep CLOCK_MONOTONIC monotonic across updates: if readers
+     * extrapolating from the previous parameters could already have
+     * seen a later time than the host now reports, publish that time
+     * instead and slow the rate for the next interval so the host
+     * clock catches up.
+     */
+    mult = (elapsed_ns << 32) / elapsed_ticks;
+    if (0 != (page->flags & NACL_ABI_CLOCK_PAGE_TSC_VALID) &&
+        tsc - page->tsc_base <= page->max_tsc_delta) {
+      uint64_t extrapolated_ns =
+          page->monotonic_ns +
+          (((tsc - page->tsc_base) * page->tsc_mult) >> page->tsc_shift);
+      if (extrapolated_ns > mono_ns) {
+        uint64_t ahead_ns = extrapolated_ns - mono_ns;
+        mono_ns = extrapolated_ns;
+        if (ahead_ns < elapsed_ns / 2) {
+          mult = ((elapsed_ns - ahead_ns) << 32) / elapsed_ticks;
+        } else {
+          mult /= 2;
+        }
+      }
+    }
+    if (0 == mult) {
+      mult = 1;
+    }
+
+    ClockPageWrite(page, tsc, mult,
+                   MaxTscDelta(mult, elapsed_ticks), mono_ns, real_ns);
+    last_tsc = tsc;
+    last_mono_ns = host_mono_ns;
+  }
+}
+
+int NaClClockPageInit(struct NaClApp *nap) {
+  struct NaClDescImcShm *shm;
+  uintptr_t trusted_addr;
+  uintptr_t usrpage;
+  uintptr_t usraddr;
+  uintptr_t sysaddr;
+  uintptr_t map_result;
+  size_t size = NACL_MAP_PAGESIZE;
+
+  CHECK(NULL == nap->clock_page_shm);
+
+  if (!NaClClockPageIsSupported()) {
+    NaClLog(2, "NaClClockPageInit: no invariant TSC, not using clock page\n");
+    return 0;
+  }
+
+  shm = (struct NaClDescImcShm *) malloc(sizeof *shm);
+  if (NULL == shm) {
+    return 0;
+  }
+  if (!NaClDescImcShmAllocCtor(shm, size, /* executable= */ 0)) {
+    free(shm);
+    NaClLog(LOG_WARNING, "NaClClockPageInit: shm alloc ctor failed\n");
+    return 0;
+  }
+
+  /* Writable view for the updater thread, outside the sandbox. */
+  trusted_addr = (*NACL_VTBL(NaClDesc, &shm->base)->
+                  Map)(&shm->base,
+                       NaClDescEffectorTrustedMem(),
+                       NULL,
+                       size,
+                       NACL_ABI_PROT_READ | NACL_ABI_PROT_WRITE,
+                       NACL_ABI_MAP_SHARED,
+                       0);
+  if (NaClPtrIsNegErrno(&trusted_addr)) {
+    NaClLog(LOG_WARNING, "NaClClockPageInit: trusted Map failed\n");
+    NaClDescUnref(&shm->base);
+    return 0;
+  }
+
+  /* Read-only view for untrusted code. */
+  NaClXMutexLock(&nap->mu);
+  NaClVmHoleOpeningMu(nap);
+  usrpage = NaClVmmapFindMapSpace(&nap->mem_map, size >> NACL_PAGESHIFT);
+  if (0 == usrpage) {
+    NaClVmHoleClosingMu(nap);
+    NaClXMutexUnlock(&nap->mu);
+    NaClLog(LOG_WARNING, "NaClClockPageInit: no address space for page\n");
+    NaClHostDescUnmapUnsafe((void *) trusted_addr, size);
+    NaClDescUnref(&shm->base);
+    return 0;
+  }
+  usraddr = usrpage << NACL_PAGESHIFT;
+  sysaddr = NaClUserToSys(nap, usraddr);
+  map_result = (*NACL_VTBL(NaClDesc, &shm->base)->
+                Map)(&shm->base,
+                     nap->effp,
+                     (void *) sysaddr,
+                     size,
+                     NACL_ABI_PROT_READ,
+                     NACL_ABI_MAP_SHARED | NACL_ABI_MAP_FIXED,
+                     0);
+  if (map_result != sysaddr) {
+    NaClLog(LOG_FATAL, "NaClClockPageInit: could not map clock page\n");
+  }
+  NaClVmmapAddWithOverwrite(&nap->mem_map,
+                            usrpage,
+                            size >> NACL_PAGESHIFT,
+                            NACL_ABI_PROT_READ,
+                            NACL_ABI_MAP_SHARED,
+                            &shm->base,
+                            0,
+                            size);
+  NaClVmHoleClosingMu(nap);
+  NaClXMutexUnlock(&nap->mu);
+
+  nap->clock_page_shm = &shm->base;
+  nap->clock_page = (struct nacl_abi_clock_page *) trusted_addr;
+  nap->clock_page->version = NACL_ABI_CLOCK_PAGE_VERSION;
+  nap->clock_page->tsc_shift = 32;
+
+  /*
+   * The page is published with flags == 0 until the updater has
+   * calibrated the counter, so readers use the syscall until then.
+   */
+  if (!NaClThreadCtor(&nap->clock_page_thread, ClockPageUpdater, nap,
+                      kClockPageThreadStackSize)) {
+    NaClLog(LOG_WARNING, "NaClClockPageInit: could not start updater\n");
+    /*
+     * Replace the untrusted view with inaccessible anonymous memory
+     * rather than unmapping it, so as not to open an address space
+     * hole.
+     */
+    NaClXMutexLock(&nap->mu);
+    map_result = NaClHostDescMap((struct NaClHostDesc *) NULL,
+                                 nap->effp,
+                                 (void *) sysaddr,
+                                 size,
+                                 NACL_ABI_PROT_NONE,
+                                 (NACL_ABI_MAP_PRIVATE |
+                                  NACL_ABI_MAP_ANONYMOUS |
+                                  NACL_ABI_MAP_FIXED),
+                                 0);
+    if (map_result != sysaddr) {
+      NaClLog(LOG_FATAL, "NaClClockPageInit: could not unmap clock page\n");
+    }
+    NaClVmmapRemove(&nap->mem_map, usrpage, size >> NACL_PAGESHIFT);
+    NaClXMutexUnlock(&nap->mu);
+    NaClHostDescUnmapUnsafe((void *) trusted_addr, size);
+    nap->clock_page = NULL;
+    nap->clock_page_shm = NULL;
+    NaClDescUnref(&shm->base);
+    return 0;
+  }
+  nap->clock_page_addr = usraddr;
+  NaClLog(2, "NaClClockPageInit: clock page at 0x%08"NACL_PRIxPTR"\n",
+          usraddr);
+  return 1;
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl service runtime.  Read-only clock page shared with untrusted
+ * code; see include/sys/nacl_clock_page.h for the ABI.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_CLOCK_PAGE_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_CLOCK_PAGE_H_ 1
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+
+EXTERN_C_BEGIN
+
+struct NaClApp;
+
+/*
+ * Returns non-zero if the host can support the clock page, i.e., this
+ * is an x86 machine with an invariant timestamp counter.
+ */
+int NaClClockPageIsSupported(void);
+
+/*
+ * Allocates the clock page, maps it read-only into the untrusted
+ * address space and starts the trusted thread that keeps it updated.
+ * On success, nap->clock_page_addr holds the untrusted address of the
+ * page.  Failure is not fatal: untrusted code simply falls back to
+ * the clock_gettime syscall.
+ *
+ * Must be called after the address space has been set up and before
+ * untrusted code starts running.  Returns bool-as-int.
+ */
+int NaClClockPageInit(struct NaClApp *nap);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_CLOCK_PAGE_H_ */
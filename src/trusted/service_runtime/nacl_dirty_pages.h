@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Host side of the get_dirty_pages syscall; see sys_dirty_pages.h.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_DIRTY_PAGES_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_DIRTY_PAGES_H_
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+
+EXTERN_C_BEGIN
+
+struct NaClApp;
+
+/*
+ * Sets the bits of bitmap (which must start out zeroed) for the pages
+ * of [sysaddr, sysaddr + num_pages * NACL_ABI_DIRTY_PAGE_SIZE) written
+ * since the last scan of each page, and starts tracking them afresh.
+ * Must be called with nap->mu held, so that the mappings in the range
+ * do not change during the scan.
+ *
+ * Returns 1 if bitmap holds the result, 0 if tracking of (part of) the
+ * range only starts now, and -1 if the host cannot track writes to the
+ * range.  In the last two cases the caller must treat every page as
+ * dirty.
+ */
+int NaClDirtyPagesScanMu(struct NaClApp *nap,
+                         uintptr_t      sysaddr,
+                         size_t         num_pages,
+                         uint8_t        *bitmap);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_DIRTY_PAGES_H_ */
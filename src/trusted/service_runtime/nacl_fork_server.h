@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl service runtime.  Fork server.
+ *
+ * "sel_ldr --fork_server <path> -B irt.nexe app.nexe" does all of the
+ * work of starting a nexe that does not depend on the invocation --
+ * platform qualification, reserving the address space, loading and
+ * validating the nexe and the IRT -- and then, instead of running the
+ * nexe, listens on a Unix domain socket at <path>.  Each connection is
+ * one launch request: the server forks, and the child runs the nexe
+ * with the requester's stdin, stdout and stderr and argument list.
+ *
+ * Children share the address space layout of the server, and inherit
+ * its validation cache.  Each child reseeds the global secure RNG, so
+ * children do not see the same random bytes.
+ *
+ * Protocol (all integers in host byte order):
+ *
+ *   request:  struct NaClForkServerRequest, sent with exactly three
+ *             file descriptors (stdin, stdout, stderr) attached as
+ *             SCM_RIGHTS, followed by args_size bytes holding argc
+ *             NUL-terminated argument strings.  These follow the
+ *             argv[0] chosen by the server.
+ *   reply:    struct NaClForkServerReply, sent when the child exits.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_FORK_SERVER_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_FORK_SERVER_H_ 1
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+
+EXTERN_C_BEGIN
+
+struct NaClApp;
+
+#define NACL_FORK_SERVER_REQUEST_MAGIC  0x4e434652  /* "NCFR" */
+#define NACL_FORK_SERVER_REPLY_MAGIC    0x4e434653  /* "NCFS" */
+#define NACL_FORK_SERVER_MAX_ARGS_SIZE  (64 << 10)
+
+struct NaClForkServerRequest {
+  uint32_t magic;
+  uint32_t argc;
+  uint32_t args_size;
+};
+
+struct NaClForkServerReply {
+  uint32_t magic;
+  int32_t pid;
+  /* As returned by waitpid(). */
+  int32_t wait_status;
+};
+
+/*
+ * Serves launch requests on the socket at socket_path.  Only returns
+ * in a forked child (return value 1), after the child has installed
+ * the request's descriptors as nacl descs 0-2 and replaced the
+ * app argument list in argc_p and argv_p, which must hold the
+ * server's own, with the request's.  Returns 0 if the server cannot
+ * be set up.
+ *
+ * Must be called with nap fully loaded but before any untrusted
+ * thread is created.  Only the calling thread exists in a child; other
+ * trusted threads, such as the profiler's, stay in the server.
+ */
+int NaClForkServerRun(struct NaClApp *nap,
+                      char const *socket_path,
+                      int *argc_p,
+                      char ***argv_p);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_FORK_SERVER_H_ */
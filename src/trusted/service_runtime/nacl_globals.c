@@ -18,6 +18,7 @@
 #include "native_client/src/trusted/service_runtime/nacl_app.h"
 #include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
 #include "native_client/src/trusted/service_runtime/nacl_globals.h"
+#include "native_client/src/trusted/validator/validation_cache_memory.h"
 
 struct NaClThreadContext    *nacl_user[NACL_THREAD_MAX] = {NULL};
 #if NACL_WINDOWS
@@ -30,10 +31,20 @@ uint32_t                    nacl_thread_ids[NACL_THREAD_MAX] = {0};
  */
 uintptr_t                   nacl_global_xlate_base;
 
+struct NaClValidationCache  *nacl_validation_cache_memory = NULL;
+
 void NaClGlobalModuleInit(void) {
   NaClInitGlobals();
+  nacl_validation_cache_memory =
+      NaClValidationCacheMemoryCreate(NACL_VALIDATION_CACHE_MEMORY_ENTRIES);
+  if (NULL == nacl_validation_cache_memory) {
+    NaClLog(LOG_WARNING,
+            "NaClGlobalModuleInit: could not create validation cache\n");
+  }
 }
 
 
 void  NaClGlobalModuleFini(void) {
+  NaClValidationCacheMemoryDestroy(nacl_validation_cache_memory);
+  nacl_validation_cache_memory = NULL;
 }
@@ -63,6 +63,12 @@ static INLINE struct NaClAppThread *NaClAppThreadGetFromIndex(
   return NaClAppThreadFromThreadContext(nacl_user[thread_index]);
 }
 
+/*
+ * Process-wide in-memory validation cache, used by NaClApps whose
+ * embedder does not supply a validation cache.  May be NULL.
+ */
+extern struct NaClValidationCache *nacl_validation_cache_memory;
+
 /* hack for gdb */
 #if NACL_WINDOWS
 __declspec(dllexport)
@@ -156,6 +156,17 @@ void NaClSignalContextFromHandler(struct NaClSignalContext *sig_ctx,
 void NaClSignalContextToHandler(void *raw_ctx,
                                 const struct NaClSignalContext *sig_ctx);
 
+#if NACL_LINUX
+/*
+ * Like NaClSignalContextToHandler(), but only updates the registers
+ * that are changed to enter the untrusted exception handler: the
+ * program counter, stack pointer, argument register and, depending on
+ * the architecture, flags or return address.
+ */
+void NaClSignalContextToHandlerForException(
+    void *raw_ctx, const struct NaClSignalContext *sig_ctx);
+#endif
+
 
 int NaClSignalContextIsUntrusted(struct NaClAppThread *natp,
                                  const struct NaClSignalContext *sig_ctx);
@@ -177,6 +188,12 @@ void NaClSignalSetUpExceptionFrame(volatile struct NaClExceptionFrame *frame,
                                    const struct NaClSignalContext *regs,
                                    uint32_t context_user_addr);
 
+/*
+ * Returns the untrusted stack pointer at which an exception frame is
+ * written, given the top of the stack it is written to.
+ */
+uint32_t NaClSignalExceptionFramePtr(uint32_t stack_top);
+
 #if NACL_OSX
 
 # include <mach/thread_status.h>
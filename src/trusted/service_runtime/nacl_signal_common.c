@@ -318,3 +318,14 @@ void NaClSignalSetUpExceptionFrame(volatile struct NaClExceptionFrame *frame,
   frame->return_addr = 0;
 #endif
 }
+
+uint32_t NaClSignalExceptionFramePtr(uint32_t stack_top) {
+  uint32_t frame_ptr = stack_top;
+
+  /* Allocate space for the stack frame, and ensure its alignment. */
+  frame_ptr -= sizeof(struct NaClExceptionFrame) - NACL_STACK_PAD_BELOW_ALIGN;
+  frame_ptr &= ~NACL_STACK_ALIGN_MASK;
+  frame_ptr -= NACL_STACK_ARGS_SIZE;
+  frame_ptr -= NACL_STACK_PAD_BELOW_ALIGN;
+  return frame_ptr;
+}
@@ -59,13 +59,20 @@ int32_t NaClSysNotImplementedDecoder(struct NaClAppThread *natp) {
   return -NACL_ABI_ENOSYS;
 }
 
-void NaClAddSyscall(struct NaClApp *nap, uint32_t num,
-                    int32_t (*fn)(struct NaClAppThread *)) {
+void NaClAddNamedSyscall(struct NaClApp *nap, uint32_t num,
+                         int32_t (*fn)(struct NaClAppThread *),
+                         const char *name) {
   CHECK(num < NACL_MAX_SYSCALLS);
   if (nap->syscall_table[num].handler != &NaClSysNotImplementedDecoder) {
     NaClLog(LOG_FATAL, "Duplicate syscall number %d\n", num);
   }
   nap->syscall_table[num].handler = fn;
+  nap->syscall_table[num].name = name;
+}
+
+void NaClAddSyscall(struct NaClApp *nap, uint32_t num,
+                    int32_t (*fn)(struct NaClAppThread *)) {
+  NaClAddNamedSyscall(nap, num, fn, NULL);
 }
 
 int32_t NaClSysNull(struct NaClAppThread *natp) {
@@ -751,6 +758,19 @@ int32_t NaClSysSysconf(struct NaClAppThread *natp,
       result_value = nap->pnacl_mode;
       break;
     }
+    case NACL_ABI__SC_NACL_MAPPING_GENERATION: {
+      /*
+       * A cheap way to check whether list_mapping_changes has anything
+       * to report.  The result is really a uint32_t.
+       */
+      if (!nap->enable_list_mappings) {
+        goto cleanup;
+      }
+      NaClXMutexLock(&nap->mu);
+      result_value = (int32_t) nap->mem_map.generation;
+      NaClXMutexUnlock(&nap->mu);
+      break;
+    }
 #if NACL_ARCH(NACL_BUILD_ARCH) == NACL_x86
     case NACL_ABI__SC_NACL_CPU_FEATURE_X86: {
       NaClCPUFeaturesX86 *features = (NaClCPUFeaturesX86 *) nap->cpu_features;
@@ -30,6 +30,10 @@ int32_t NaClSysNotImplementedDecoder(struct NaClAppThread *natp);
 void NaClAddSyscall(struct NaClApp *nap, uint32_t num,
                     int32_t (*fn)(struct NaClAppThread *));
 
+void NaClAddNamedSyscall(struct NaClApp *nap, uint32_t num,
+                         int32_t (*fn)(struct NaClAppThread *),
+                         const char *name);
+
 int32_t NaClSysNull(struct NaClAppThread *natp);
 
 int NaClHighResolutionTimerEnabled(void);
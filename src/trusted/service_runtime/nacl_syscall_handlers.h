@@ -14,6 +14,8 @@ struct NaClAppThread;
 
 struct NaClSyscallTableEntry {
   int32_t (*handler)(struct NaClAppThread *natp);
+  /* Name of the handler, for diagnostics.  May be NULL. */
+  const char *name;
 };
 
 #endif
@@ -23,6 +23,8 @@
 #include "native_client/src/trusted/service_runtime/nacl_copy.h"
 #include "native_client/src/trusted/service_runtime/nacl_switch_to_app.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_handlers.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_list.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_profile.h"
 #include "native_client/src/trusted/service_runtime/sel_ldr.h"
 #include "native_client/src/trusted/service_runtime/sel_rt.h"
 
@@ -95,6 +97,7 @@ struct NaClThreadContext *NaClSyscallCSegHook(struct NaClThreadContext *ntcp) {
   size_t                    sysnum;
   uintptr_t                 sp_user;
   uint32_t                  sysret;
+  uint64_t                  profile_start_ns = 0;
 
   /*
    * Mark the thread as running on a trusted stack as soon as possible
@@ -112,20 +115,15 @@ struct NaClThreadContext *NaClSyscallCSegHook(struct NaClThreadContext *ntcp) {
   NaClAppThreadSetSuspendState(natp, NACL_APP_THREAD_UNTRUSTED,
                                NACL_APP_THREAD_TRUSTED);
 
-  nap = natp->nap;
+  if (NACL_UNLIKELY(NULL != natp->syscall_profile)) {
+    profile_start_ns = NaClSyscallProfileNowNs();
+    NaClSyscallProfileEnter(natp->syscall_profile, profile_start_ns);
+  }
 
-  NaClCopyTakeLock(nap);
-  /*
-   * held until syscall args are copied, which occurs in the generated
-   * code.
-   */
+  nap = natp->nap;
 
   sysnum = (tramp_ret - NACL_SYSCALL_START_ADDR) >> NACL_SYSCALL_BLOCK_SHIFT;
 
-  NaClLog(4, "Entering syscall %"NACL_PRIuS
-          ": return address 0x%08"NACL_PRIxNACL_REG"\n",
-          sysnum, natp->user.new_prog_ctr);
-
   /*
    * usr_syscall_args is used by Decoder functions in
    * nacl_syscall_handlers.c which is automatically generated file and
@@ -141,20 +139,42 @@ struct NaClThreadContext *NaClSyscallCSegHook(struct NaClThreadContext *ntcp) {
   natp->usr_syscall_args = NaClRawUserStackAddrNormalize(sp_user +
                                                          NACL_SYSARGS_FIX);
 
-  if (NACL_UNLIKELY(sysnum >= NACL_MAX_SYSCALLS)) {
-    NaClLog(2, "INVALID system call %"NACL_PRIuS"\n", sysnum);
-    sysret = (uint32_t) -NACL_ABI_EINVAL;
-    NaClCopyDropLock(nap);
-  } else {
-    sysret = (*(nap->syscall_table[sysnum].handler))(natp);
-    /* Implicitly drops lock */
+  /*
+   * The suspend state transitions above and below are not skipped on
+   * the fast path: the thread suspension API relies on them to tell
+   * whether the registers it captures are untrusted ones.
+   */
+  if (!NACL_SYSCALL_FAST_PATH ||
+      !NaClSyscallFastPath(natp, sysnum, &sysret)) {
+    NaClCopyTakeLock(nap);
+    /*
+     * held until syscall args are copied, which occurs in the generated
+     * code.
+     */
+
+    NaClLog(4, "Entering syscall %"NACL_PRIuS
+            ": return address 0x%08"NACL_PRIxNACL_REG"\n",
+            sysnum, natp->user.new_prog_ctr);
+
+    if (NACL_UNLIKELY(sysnum >= NACL_MAX_SYSCALLS)) {
+      NaClLog(2, "INVALID system call %"NACL_PRIuS"\n", sysnum);
+      sysret = (uint32_t) -NACL_ABI_EINVAL;
+      NaClCopyDropLock(nap);
+    } else {
+      sysret = (*(nap->syscall_table[sysnum].handler))(natp);
+      /* Implicitly drops lock */
+    }
+    NaClLog(4,
+            ("Returning from syscall %"NACL_PRIuS": return value %"NACL_PRId32
+             " (0x%"NACL_PRIx32")\n"),
+            sysnum, sysret, sysret);
   }
-  NaClLog(4,
-          ("Returning from syscall %"NACL_PRIuS": return value %"NACL_PRId32
-           " (0x%"NACL_PRIx32")\n"),
-          sysnum, sysret, sysret);
   natp->user.sysret = sysret;
 
+  if (NACL_UNLIKELY(NULL != natp->syscall_profile)) {
+    NaClSyscallProfileExit(natp->syscall_profile, sysnum, profile_start_ns);
+  }
+
   /*
    * After this NaClAppThreadSetSuspendState() call, we should not
    * claim any mutexes, otherwise we risk deadlock.
@@ -6,12 +6,17 @@
 
 #include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_handlers.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_list.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_register.h"
 #include "native_client/src/trusted/service_runtime/nacl_text.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+#include "native_client/src/trusted/service_runtime/sys_aio.h"
 #include "native_client/src/trusted/service_runtime/sys_clock.h"
+#include "native_client/src/trusted/service_runtime/sys_dirty_pages.h"
 #include "native_client/src/trusted/service_runtime/sys_exception.h"
 #include "native_client/src/trusted/service_runtime/sys_fdio.h"
 #include "native_client/src/trusted/service_runtime/sys_filename.h"
+#include "native_client/src/trusted/service_runtime/sys_futex.h"
 #include "native_client/src/trusted/service_runtime/sys_imc.h"
 #include "native_client/src/trusted/service_runtime/sys_list_mappings.h"
 #include "native_client/src/trusted/service_runtime/sys_memory.h"
@@ -35,11 +40,14 @@ NACL_DEFINE_SYSCALL_3(NaClSysLseek)
 NACL_DEFINE_SYSCALL_2(NaClSysFstat)
 NACL_DEFINE_SYSCALL_2(NaClSysStat)
 NACL_DEFINE_SYSCALL_3(NaClSysGetdents)
+NACL_DEFINE_SYSCALL_3(NaClSysGetdentsPlus)
 NACL_DEFINE_SYSCALL_1(NaClSysIsatty)
 NACL_DEFINE_SYSCALL_1(NaClSysBrk)
 NACL_DEFINE_SYSCALL_6(NaClSysMmap)
 NACL_DEFINE_SYSCALL_3(NaClSysMprotect)
 NACL_DEFINE_SYSCALL_2(NaClSysListMappings)
+NACL_DEFINE_SYSCALL_3(NaClSysListMappingChanges)
+NACL_DEFINE_SYSCALL_4(NaClSysGetDirtyPages)
 NACL_DEFINE_SYSCALL_2(NaClSysMunmap)
 NACL_DEFINE_SYSCALL_1(NaClSysExit)
 NACL_DEFINE_SYSCALL_0(NaClSysGetpid)
@@ -70,6 +78,12 @@ NACL_DEFINE_SYSCALL_3(NaClSysReadlink)
 NACL_DEFINE_SYSCALL_2(NaClSysUtimes)
 NACL_DEFINE_SYSCALL_4(NaClSysPRead)
 NACL_DEFINE_SYSCALL_4(NaClSysPWrite)
+NACL_DEFINE_SYSCALL_3(NaClSysReadv)
+NACL_DEFINE_SYSCALL_3(NaClSysWritev)
+NACL_DEFINE_SYSCALL_4(NaClSysPReadv)
+NACL_DEFINE_SYSCALL_2(NaClSysAioSetup)
+NACL_DEFINE_SYSCALL_3(NaClSysAioEnter)
+NACL_DEFINE_SYSCALL_1(NaClSysAioDestroy)
 NACL_DEFINE_SYSCALL_1(NaClSysImcMakeBoundSock)
 NACL_DEFINE_SYSCALL_1(NaClSysImcAccept)
 NACL_DEFINE_SYSCALL_1(NaClSysImcConnect)
@@ -122,11 +136,15 @@ void NaClAppRegisterDefaultSyscalls(struct NaClApp *nap) {
   NACL_REGISTER_SYSCALL(nap, NaClSysFstat, NACL_sys_fstat);
   NACL_REGISTER_SYSCALL(nap, NaClSysStat, NACL_sys_stat);
   NACL_REGISTER_SYSCALL(nap, NaClSysGetdents, NACL_sys_getdents);
+  NACL_REGISTER_SYSCALL(nap, NaClSysGetdentsPlus, NACL_sys_getdents_plus);
   NACL_REGISTER_SYSCALL(nap, NaClSysIsatty, NACL_sys_isatty);
   NACL_REGISTER_SYSCALL(nap, NaClSysBrk, NACL_sys_brk);
   NACL_REGISTER_SYSCALL(nap, NaClSysMmap, NACL_sys_mmap);
   NACL_REGISTER_SYSCALL(nap, NaClSysMprotect, NACL_sys_mprotect);
   NACL_REGISTER_SYSCALL(nap, NaClSysListMappings, NACL_sys_list_mappings);
+  NACL_REGISTER_SYSCALL(nap, NaClSysListMappingChanges,
+                        NACL_sys_list_mapping_changes);
+  NACL_REGISTER_SYSCALL(nap, NaClSysGetDirtyPages, NACL_sys_get_dirty_pages);
   NACL_REGISTER_SYSCALL(nap, NaClSysMunmap, NACL_sys_munmap);
   NACL_REGISTER_SYSCALL(nap, NaClSysExit, NACL_sys_exit);
   NACL_REGISTER_SYSCALL(nap, NaClSysGetpid, NACL_sys_getpid);
@@ -157,6 +175,12 @@ void NaClAppRegisterDefaultSyscalls(struct NaClApp *nap) {
   NACL_REGISTER_SYSCALL(nap, NaClSysUtimes, NACL_sys_utimes);
   NACL_REGISTER_SYSCALL(nap, NaClSysPRead, NACL_sys_pread);
   NACL_REGISTER_SYSCALL(nap, NaClSysPWrite, NACL_sys_pwrite);
+  NACL_REGISTER_SYSCALL(nap, NaClSysReadv, NACL_sys_readv);
+  NACL_REGISTER_SYSCALL(nap, NaClSysWritev, NACL_sys_writev);
+  NACL_REGISTER_SYSCALL(nap, NaClSysPReadv, NACL_sys_preadv);
+  NACL_REGISTER_SYSCALL(nap, NaClSysAioSetup, NACL_sys_aio_setup);
+  NACL_REGISTER_SYSCALL(nap, NaClSysAioEnter, NACL_sys_aio_enter);
+  NACL_REGISTER_SYSCALL(nap, NaClSysAioDestroy, NACL_sys_aio_destroy);
   NACL_REGISTER_SYSCALL(nap, NaClSysImcMakeBoundSock,
                         NACL_sys_imc_makeboundsock);
   NACL_REGISTER_SYSCALL(nap, NaClSysImcAccept, NACL_sys_imc_accept);
@@ -202,3 +226,84 @@ void NaClAppRegisterDefaultSyscalls(struct NaClApp *nap) {
   NACL_REGISTER_SYSCALL(nap, NaClSysFutexWake, NACL_sys_futex_wake);
   NACL_REGISTER_SYSCALL(nap, NaClSysGetRandomBytes, NACL_sys_get_random_bytes);
 }
+
+int NaClSyscallFastPath(struct NaClAppThread *natp, size_t sysnum,
+                        uint32_t *sysret) {
+#if NACL_SYSCALL_FAST_PATH
+  int32_t (*default_handler)(struct NaClAppThread *natp);
+  uint32_t sys_args[2];
+
+  switch (sysnum) {
+    case NACL_sys_tls_get:
+      default_handler = NaClSysTlsGetDecoder;
+      break;
+    case NACL_sys_second_tls_get:
+      default_handler = NaClSysSecondTlsGetDecoder;
+      break;
+    case NACL_sys_sched_yield:
+      default_handler = NaClSysSchedYieldDecoder;
+      break;
+    case NACL_sys_exception_clear_flag:
+      default_handler = NaClSysExceptionClearFlagDecoder;
+      break;
+    case NACL_sys_futex_wake:
+      default_handler = NaClSysFutexWakeDecoder;
+      break;
+    case NACL_sys_clock_gettime:
+      default_handler = NaClSysClockGetTimeDecoder;
+      break;
+    case NACL_sys_sem_post:
+      default_handler = NaClSysSemPostDecoder;
+      break;
+    default:
+      return 0;
+  }
+  if (natp->nap->syscall_table[sysnum].handler != default_handler) {
+    return 0;
+  }
+
+  switch (sysnum) {
+    case NACL_sys_tls_get:
+      *sysret = NaClSysTlsGet(natp);
+      return 1;
+    case NACL_sys_second_tls_get:
+      *sysret = NaClSysSecondTlsGet(natp);
+      return 1;
+    case NACL_sys_sched_yield:
+      *sysret = NaClSysSchedYield(natp);
+      return 1;
+    case NACL_sys_exception_clear_flag:
+      *sysret = NaClSysExceptionClearFlag(natp);
+      return 1;
+  }
+
+  /*
+   * The remaining syscalls take one or two arguments.  Copy in exactly
+   * as many as the generic decoder would, so that faults are reported
+   * identically.
+   */
+  if (!NaClCopyInFromUser(natp->nap, sys_args, natp->usr_syscall_args,
+                          (NACL_sys_sem_post == sysnum ? 1 : 2)
+                          * sizeof(sys_args[0]))) {
+    *sysret = (uint32_t) -NACL_ABI_EFAULT;
+    return 1;
+  }
+  switch (sysnum) {
+    case NACL_sys_futex_wake:
+      *sysret = NaClSysFutexWake(natp, sys_args[0], sys_args[1]);
+      break;
+    case NACL_sys_clock_gettime:
+      *sysret = NaClSysClockGetTime(natp, sys_args[0], sys_args[1]);
+      break;
+    default:
+      *sysret = NaClSysSemPost(natp, sys_args[0]);
+      break;
+  }
+  return 1;
+#else
+  UNREFERENCED_PARAMETER(natp);
+  UNREFERENCED_PARAMETER(sysnum);
+  UNREFERENCED_PARAMETER(sysret);
+  return 0;
+#endif
+}
@@ -11,12 +11,41 @@
 
 EXTERN_C_BEGIN
 
+struct NaClAppThread;
+
+/*
+ * NACL_SYSCALL_FAST_PATH selects, at compile time, whether
+ * NaClSyscallCSegHook tries NaClSyscallFastPath before the generic
+ * syscall table dispatch.
+ */
+#ifndef NACL_SYSCALL_FAST_PATH
+# define NACL_SYSCALL_FAST_PATH 1
+#endif
+
 /*
  * This function registers the default set of syscall handlers in the
  * NaClApp's syscall handler table.
  */
 void NaClAppRegisterDefaultSyscalls(struct NaClApp *nap);
 
+/*
+ * Fast path for the hottest syscalls (tls_get, second_tls_get,
+ * sched_yield, exception_clear_flag, futex_wake, clock_gettime and
+ * sem_post).  These are called directly rather than through the
+ * syscall table and the generic decoder, and the zero-argument ones do
+ * not take the copy lock at all.  exception_clear_flag is here because
+ * untrusted exception handlers call it on every fault they recover
+ * from.  A syscall is only handled here if its table entry is still
+ * the default handler, so an embedder's replacement is always
+ * honoured.
+ *
+ * Must be called with natp->usr_syscall_args set and without the
+ * copy lock held.  Returns non-zero and stores the result in *sysret
+ * if the syscall was handled; returns 0 otherwise.
+ */
+int NaClSyscallFastPath(struct NaClAppThread *natp, size_t sysnum,
+                        uint32_t *sysret);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "native_client/src/trusted/service_runtime/nacl_syscall_profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/build_config.h"
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_clock.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_sync.h"
+#include "native_client/src/shared/platform/nacl_sync_checked.h"
+#include "native_client/src/shared/platform/nacl_threads.h"
+#include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+
+#if !NACL_WINDOWS
+# include <signal.h>
+# include <unistd.h>
+#endif
+
+struct NaClSyscallProfileState {
+  /* Protects retired, exited_threads and out. */
+  struct NaClMutex mu;
+  /* Sum of the counters of all threads that have exited. */
+  struct NaClSyscallProfile retired;
+  int exited_threads;
+  FILE *out;
+#if !NACL_WINDOWS
+  struct NaClThread signal_thread;
+#endif
+};
+
+static const double kPercentiles[] = { 0.50, 0.90, 0.99 };
+
+uint64_t NaClSyscallProfileNowNs(void) {
+  struct nacl_abi_timespec ts;
+
+  if (0 != NaClClockGetTime(NACL_CLOCK_MONOTONIC, &ts)) {
+    return 0;
+  }
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int HistogramBucket(uint64_t ns) {
+  int bucket = 0;
+  while (ns > 1 && bucket < NACL_SYSCALL_PROFILE_BUCKETS - 1) {
+    ns >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void NaClSyscallProfileExit(struct NaClSyscallProfile *prof,
+                            size_t sysnum, uint64_t start_ns) {
+  uint64_t now_ns = NaClSyscallProfileNowNs();
+  uint64_t elapsed_ns = now_ns - start_ns;
+
+  prof->trusted_ns += elapsed_ns;
+  prof->last_exit_ns = now_ns;
+  if (sysnum < NACL_MAX_SYSCALLS) {
+    struct NaClSyscallProfileCounters *c = &prof->syscalls[sysnum];
+    c->calls++;
+    c->total_ns += elapsed_ns;
+    if (elapsed_ns > c->max_ns) {
+      c->max_ns = elapsed_ns;
+    }
+    c->histogram[HistogramBucket(elapsed_ns)]++;
+  }
+}
+
+static void ProfileAdd(struct NaClSyscallProfile *dest,
+                       const struct NaClSyscallProfile *src) {
+  size_t i;
+  int b;
+
+  for (i = 0; i < NACL_MAX_SYSCALLS; ++i) {
+    struct NaClSyscallProfileCounters *d = &dest->syscalls[i];
+    const struct NaClSyscallProfileCounters *s = &src->syscalls[i];
+    d->calls += s->calls;
+    d->total_ns += s->total_ns;
+    if (s->max_ns > d->max_ns) {
+      d->max_ns = s->max_ns;
+    }
+    for (b = 0; b < NACL_SYSCALL_PROFILE_BUCKETS; ++b) {
+      d->histogram[b] += s->histogram[b];
+    }
+  }
+  dest->trusted_ns += src->trusted_ns;
+  dest->untrusted_ns += src->untrusted_ns;
+}
+
+/*
+ * Returns the upper bound of the histogram bucket containing the
+ * given fraction of calls.
+ */
+static uint64_t HistogramPercentile(const struct NaClSyscallProfileCounters *c,
+                                    double fraction) {
+  uint64_t target = (uint64_t) (c->calls * fraction);
+  uint64_t seen = 0;
+  int b;
+
+  for (b = 0; b < NACL_SYSCALL_PROFILE_BUCKETS - 1; ++b) {
+    seen += c->histogram[b];
+    if (seen > target) {
+      break;
+    }
+  }
+  if (b == NACL_SYSCALL_PROFILE_BUCKETS - 1) {
+    return c->max_ns;
+  }
+  return ((uint64_t) 2 << b) - 1;
+}
+
+#if !NACL_WINDOWS
+static void WINAPI SignalDumpThread(void *state) {
+  struct NaClApp *nap = (struct NaClApp *) state;
+  sigset_t set;
+  int sig;
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGUSR2);
+  for (;;) {
+    if (0 != sigwait(&set, &sig)) {
+      NaClLog(LOG_ERROR, "NaClSyscallProfile: sigwait failed\n");
+      return;
+    }
+    NaClSyscallProfileDump(nap);
+  }
+}
+#endif
+
+void NaClSyscallProfileInit(struct NaClApp *nap) {
+  struct NaClSyscallProfileState *state;
+  const char *path = getenv("NACL_SYSCALL_PROFILE");
+
+  nap->syscall_profile = NULL;
+  if (NULL == path) {
+    return;
+  }
+  state = (struct NaClSyscallProfileState *) calloc(1, sizeof *state);
+  if (NULL == state) {
+    NaClLog(LOG_FATAL, "NaClSyscallProfileInit: out of memory\n");
+  }
+  if (!NaClMutexCtor(&state->mu)) {
+    NaClLog(LOG_FATAL, "NaClSyscallProfileInit: NaClMutexCtor failed\n");
+  }
+  if ('\0' == path[0] || 0 == strcmp(path, "-")) {
+    state->out = stderr;
+  } else {
+    state->out = fopen(path, "a");
+    if (NULL == state->out) {
+      NaClLog(LOG_ERROR,
+              "NaClSyscallProfileInit: cannot open %s, using stderr\n", path);
+      state->out = stderr;
+    }
+  }
+  nap->syscall_profile = state;
+
+#if !NACL_WINDOWS
+  {
+    /*
+     * Block SIGUSR2 in this thread, so that it is blocked in all
+     * threads created afterwards, and collect it synchronously in a
+     * dedicated thread.  This avoids doing any work in a signal
+     * handler, which might run on an untrusted thread.
+     */
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR2);
+    if (0 != pthread_sigmask(SIG_BLOCK, &set, NULL) ||
+        !NaClThreadCtor(&state->signal_thread, SignalDumpThread, nap,
+                        64 << 10)) {
+      NaClLog(LOG_WARNING,
+              "NaClSyscallProfileInit: SIGUSR2 dumps not available\n");
+    }
+  }
+#endif
+  NaClLog(LOG_INFO, "Syscall profiling enabled\n");
+}
+
+void NaClSyscallProfileThreadInit(struct NaClAppThread *natp) {
+  natp->syscall_profile = NULL;
+  if (NULL == natp->nap->syscall_profile) {
+    return;
+  }
+  natp->syscall_profile =
+      (struct NaClSyscallProfile *) calloc(1, sizeof *natp->syscall_profile);
+  if (NULL == natp->syscall_profile) {
+    NaClLog(LOG_WARNING,
+            "NaClSyscallProfileThreadInit: not profiling thread\n");
+  }
+}
+
+void NaClSyscallProfileThreadFini(struct NaClAppThread *natp) {
+  struct NaClSyscallProfileState *state = natp->nap->syscall_profile;
+
+  if (NULL == natp->syscall_profile) {
+    return;
+  }
+  NaClXMutexLock(&state->mu);
+  ProfileAdd(&state->retired, natp->syscall_profile);
+  state->exited_threads++;
+  NaClXMutexUnlock(&state->mu);
+  free(natp->syscall_profile);
+  natp->syscall_profile = NULL;
+}
+
+static void DumpThread(FILE *out, const char *separator, int thread_num,
+                       const struct NaClSyscallProfile *prof) {
+  uint64_t calls = 0;
+  size_t i;
+
+  for (i = 0; i < NACL_MAX_SYSCALLS; ++i) {
+    calls += prof->syscalls[i].calls;
+  }
+  fprintf(out,
+          "%s{\"thread\":%d,\"syscalls\":%"NACL_PRIu64","
+          "\"trusted_ns\":%"NACL_PRIu64",\"untrusted_ns\":%"NACL_PRIu64"}",
+          separator, thread_num, calls, prof->trusted_ns, prof->untrusted_ns);
+}
+
+void NaClSyscallProfileDump(struct NaClApp *nap) {
+  struct NaClSyscallProfileState *state = nap->syscall_profile;
+  struct NaClSyscallProfile *total;
+  const char *separator = "";
+  size_t i;
+  size_t p;
+  int b;
+
+  if (NULL == state) {
+    return;
+  }
+  total = (struct NaClSyscallProfile *) malloc(sizeof *total);
+  if (NULL == total) {
+    NaClLog(LOG_ERROR, "NaClSyscallProfileDump: out of memory\n");
+    return;
+  }
+
+  /*
+   * Live threads' counters are read without synchronization, so a
+   * report taken while the app is running may be slightly torn.
+   */
+  NaClXMutexLock(&nap->threads_mu);
+  NaClXMutexLock(&state->mu);
+  memcpy(total, &state->retired, sizeof *total);
+
+  fprintf(state->out, "{\"threads\":[");
+  for (i = 0; i < nap->threads.num_entries; ++i) {
+    struct NaClAppThread *natp = NaClGetThreadMu(nap, (int) i);
+    if (NULL == natp || NULL == natp->syscall_profile) {
+      continue;
+    }
+    DumpThread(state->out, separator, (int) i, natp->syscall_profile);
+    ProfileAdd(total, natp->syscall_profile);
+    separator = ",";
+  }
+  NaClXMutexUnlock(&nap->threads_mu);
+
+  fprintf(state->out,
+          "],\"exited_threads\":%d,\"trusted_ns\":%"NACL_PRIu64","
+          "\"untrusted_ns\":%"NACL_PRIu64",\"syscalls\":[",
+          state->exited_threads, total->trusted_ns, total->untrusted_ns);
+  separator = "";
+  for (i = 0; i < NACL_MAX_SYSCALLS; ++i) {
+    const struct NaClSyscallProfileCounters *c = &total->syscalls[i];
+    const char *name = nap->syscall_table[i].name;
+
+    if (0 == c->calls) {
+      continue;
+    }
+    fprintf(state->out,
+            "%s{\"num\":%"NACL_PRIuS",\"name\":\"%s\","
+            "\"calls\":%"NACL_PRIu64",\"total_ns\":%"NACL_PRIu64","
+            "\"max_ns\":%"NACL_PRIu64,
+            separator, i, NULL != name ? name : "unknown",
+            c->calls, c->total_ns, c->max_ns);
+    for (p = 0; p < NACL_ARRAY_SIZE(kPercentiles); ++p) {
+      fprintf(state->out, ",\"p%d_ns\":%"NACL_PRIu64,
+              (int) (kPercentiles[p] * 100),
+              HistogramPercentile(c, kPercentiles[p]));
+    }
+    fprintf(state->out, ",\"histogram\":[");
+    for (b = 0; b < NACL_SYSCALL_PROFILE_BUCKETS; ++b) {
+      fprintf(state->out, "%s%"NACL_PRIu32, b > 0 ? "," : "",
+              c->histogram[b]);
+    }
+    fprintf(state->out, "]}");
+    separator = ",";
+  }
+  fprintf(state->out, "]}\n");
+  fflush(state->out);
+  NaClXMutexUnlock(&state->mu);
+  free(total);
+}
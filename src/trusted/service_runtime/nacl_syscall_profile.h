@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl service runtime.  Syscall profiler.
+ *
+ * When the NACL_SYSCALL_PROFILE environment variable is set, every
+ * NaClAppThread gets a private block of counters recording, for each
+ * syscall number, the number of calls, the total and maximum latency
+ * and a log2 latency histogram, as well as the time the thread spent
+ * in trusted and untrusted code.  The counters are only ever written
+ * by the owning thread, so recording takes no locks.  When a thread
+ * exits its counters are folded into a per-NaClApp total.
+ *
+ * A JSON report is written when the app reports its exit status, and
+ * (on POSIX hosts) whenever sel_ldr receives SIGUSR2.  The value of
+ * NACL_SYSCALL_PROFILE names the file the reports are appended to,
+ * one JSON object per line; "-" or an empty value means stderr.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_SYSCALL_PROFILE_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_SYSCALL_PROFILE_H_ 1
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+#include "native_client/src/trusted/service_runtime/include/bits/nacl_syscalls.h"
+
+EXTERN_C_BEGIN
+
+struct NaClApp;
+struct NaClAppThread;
+
+/*
+ * Bucket i of the latency histogram counts calls that took
+ * [2^i, 2^(i+1)) nanoseconds; bucket 0 also counts calls under 1ns
+ * and the last bucket is open-ended.
+ */
+#define NACL_SYSCALL_PROFILE_BUCKETS 40
+
+struct NaClSyscallProfileCounters {
+  uint64_t calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  uint32_t histogram[NACL_SYSCALL_PROFILE_BUCKETS];
+};
+
+struct NaClSyscallProfile {
+  struct NaClSyscallProfileCounters syscalls[NACL_MAX_SYSCALLS];
+  uint64_t trusted_ns;
+  uint64_t untrusted_ns;
+  /* Time the last syscall returned to untrusted code, or 0. */
+  uint64_t last_exit_ns;
+};
+
+/*
+ * Enables profiling for nap if NACL_SYSCALL_PROFILE is set.  Called
+ * from NaClAppWithEmptySyscallTableCtor, before any NaClAppThreads
+ * exist and before the outer sandbox is enabled (the report file is
+ * opened here).  On POSIX hosts this blocks SIGUSR2 in the calling
+ * thread, so it is blocked only in threads created after this call;
+ * threads started earlier can still take the signal.
+ */
+void NaClSyscallProfileInit(struct NaClApp *nap);
+
+/* Allocates natp->syscall_profile if profiling is enabled. */
+void NaClSyscallProfileThreadInit(struct NaClAppThread *natp);
+
+/*
+ * Folds the thread's counters into the NaClApp's totals and frees
+ * them.  Called from NaClAppThreadDelete.
+ */
+void NaClSyscallProfileThreadFini(struct NaClAppThread *natp);
+
+/* Monotonic time used for profiling, in nanoseconds. */
+uint64_t NaClSyscallProfileNowNs(void);
+
+/*
+ * Called by NaClSyscallCSegHook once the thread is in the trusted
+ * state, and just before it returns to the untrusted state.
+ */
+static INLINE void NaClSyscallProfileEnter(struct NaClSyscallProfile *prof,
+                                           uint64_t now_ns) {
+  if (0 != prof->last_exit_ns) {
+    prof->untrusted_ns += now_ns - prof->last_exit_ns;
+  }
+}
+
+void NaClSyscallProfileExit(struct NaClSyscallProfile *prof,
+                            size_t sysnum, uint64_t start_ns);
+
+/* Appends a JSON report to the profile file. */
+void NaClSyscallProfileDump(struct NaClApp *nap);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_SYSCALL_PROFILE_H_ */
@@ -82,6 +82,6 @@
                                      sys_args[3], sys_args[4], sys_args[5]))
 
 #define NACL_REGISTER_SYSCALL(NAP, FUNC, NUM) \
-    NaClAddSyscall((NAP), (NUM), FUNC##Decoder)
+    NaClAddNamedSyscall((NAP), (NUM), FUNC##Decoder, #FUNC)
 
 #endif
@@ -271,6 +271,24 @@ struct NaClDynamicRegion* NaClDynamicRegionFind(struct NaClApp *nap,
   return (p != NULL && ptr < p->start + p->size) ? p : NULL;
 }
 
+/*
+ * Records the creation or deletion of a dynamic code region in the
+ * memory map's change log, so that list_mapping_changes reports it.
+ * This must be called after the region list is updated, and without
+ * holding nap->dynamic_load_mutex, since readers take nap->mu first.
+ */
+static void NaClDyncodeNoteChange(struct NaClApp *nap,
+                                  uintptr_t sys_addr,
+                                  size_t size) {
+  uintptr_t user_addr = NaClSysToUser(nap, sys_addr);
+  uintptr_t first_page = user_addr >> NACL_PAGESHIFT;
+  uintptr_t end_page = NaClRoundPage(user_addr + size) >> NACL_PAGESHIFT;
+
+  NaClXMutexLock(&nap->mu);
+  NaClVmmapNoteChange(&nap->mem_map, first_page, end_page - first_page);
+  NaClXMutexUnlock(&nap->mu);
+}
+
 int NaClDynamicRegionCreate(struct NaClApp *nap,
                             uintptr_t start,
                             size_t size,
@@ -599,6 +617,113 @@ static uintptr_t CachedMapWritableText(struct NaClApp *nap,
   return nap->dynamic_mapcache_ret;
 }
 
+#if !NACL_WINDOWS
+NaClErrorCode NaClDynamicTextUnshare(struct NaClApp *nap) {
+  uintptr_t       dynamic_text_size;
+  uintptr_t       text_sysaddr;
+  uintptr_t       copy_addr;
+  uintptr_t       mmap_ret;
+  struct NaClDesc *old_shm;
+  struct NaClDesc *shm;
+  uint32_t        num_pages;
+  uint32_t        index;
+  uint32_t        run_start;
+  size_t          i;
+
+  if (NULL == nap->text_shm) {
+    return LOAD_OK;
+  }
+  old_shm = nap->text_shm;
+  dynamic_text_size = nap->dynamic_text_end - nap->dynamic_text_start;
+  num_pages = (uint32_t) (dynamic_text_size / NACL_MAP_PAGESIZE);
+  text_sysaddr = NaClUserToSys(nap, nap->dynamic_text_start);
+
+  NaClXMutexLock(&nap->dynamic_load_mutex);
+  /* The cached writable view refers to the old object. */
+  CachedMapWritableText(nap, 0, 0);
+
+  shm = MakeImcShmDesc(dynamic_text_size);
+  if (NULL == shm) {
+    NaClXMutexUnlock(&nap->dynamic_load_mutex);
+    return LOAD_NO_MEMORY_FOR_DYNAMIC_TEXT;
+  }
+
+  /* Copy the allocated pages through a temporary writable view. */
+  copy_addr = (*NACL_VTBL(NaClDesc, shm)->
+               Map)(shm,
+                    NaClDescEffectorTrustedMem(),
+                    NULL,
+                    dynamic_text_size,
+                    NACL_ABI_PROT_READ | NACL_ABI_PROT_WRITE,
+                    NACL_ABI_MAP_SHARED,
+                    0);
+  if (NaClPtrIsNegErrno(&copy_addr)) {
+    NaClXMutexUnlock(&nap->dynamic_load_mutex);
+    NaClDescUnref(shm);
+    return LOAD_NO_MEMORY_FOR_DYNAMIC_TEXT;
+  }
+  for (index = 0; index < num_pages; index++) {
+    if (BitmapIsBitSet(nap->dynamic_page_bitmap, index)) {
+      memcpy((void *) (copy_addr + index * NACL_MAP_PAGESIZE),
+             (void *) (text_sysaddr + index * NACL_MAP_PAGESIZE),
+             NACL_MAP_PAGESIZE);
+    }
+  }
+  NaClHostDescUnmapUnsafe((void *) copy_addr, dynamic_text_size);
+
+  /* MAP_FIXED replaces the old mapping atomically. */
+  mmap_ret = (*NACL_VTBL(NaClDesc, shm)->
+              Map)(shm,
+                   NaClDescEffectorTrustedMem(),
+                   (void *) text_sysaddr,
+                   dynamic_text_size,
+                   NACL_ABI_PROT_NONE,
+                   NACL_ABI_MAP_SHARED | NACL_ABI_MAP_FIXED,
+                   0);
+  if (text_sysaddr != mmap_ret) {
+    NaClLog(LOG_FATAL, "NaClDynamicTextUnshare: could not map new shm\n");
+  }
+  for (index = 0; index < num_pages; ) {
+    if (!BitmapIsBitSet(nap->dynamic_page_bitmap, index)) {
+      index++;
+      continue;
+    }
+    run_start = index;
+    while (index < num_pages &&
+           BitmapIsBitSet(nap->dynamic_page_bitmap, index)) {
+      index++;
+    }
+    if (NaClMprotect((void *) (text_sysaddr +
+                               run_start * NACL_MAP_PAGESIZE),
+                     (index - run_start) * NACL_MAP_PAGESIZE,
+                     PROT_READ | PROT_EXEC) != 0) {
+      NaClLog(LOG_FATAL, "NaClDynamicTextUnshare: NaClMprotect() failed\n");
+    }
+  }
+
+  nap->text_shm = shm;
+  NaClXMutexUnlock(&nap->dynamic_load_mutex);
+
+  /*
+   * Point the memory map's record of the region at the new object.
+   * This is done after dropping dynamic_load_mutex, since
+   * NaClSysListMappings takes nap->mu before dynamic_load_mutex.
+   */
+  NaClXMutexLock(&nap->mu);
+  for (i = 0; i < nap->mem_map.nvalid; ++i) {
+    struct NaClVmmapEntry *entry = nap->mem_map.vmentry[i];
+    if (entry->desc == old_shm) {
+      entry->desc = NaClDescRef(shm);
+      NaClDescUnref(old_shm);
+    }
+  }
+  NaClXMutexUnlock(&nap->mu);
+
+  NaClDescUnref(old_shm);
+  return LOAD_OK;
+}
+#endif
+
 /*
  * A wrapper around CachedMapWritableText that performs common address
  * calculations.
@@ -761,6 +886,9 @@ int32_t NaClTextDyncodeCreate(struct NaClApp *nap,
 
  cleanup_unlock:
   NaClXMutexUnlock(&nap->dynamic_load_mutex);
+  if (0 == retval) {
+    NaClDyncodeNoteChange(nap, dest_addr, size);
+  }
   return retval;
 }
 
@@ -1049,6 +1177,9 @@ int32_t NaClSysDyncodeDelete(struct NaClAppThread *natp,
 
  cleanup_unlock:
   NaClXMutexUnlock(&nap->dynamic_load_mutex);
+  if (0 == retval) {
+    NaClDyncodeNoteChange(nap, dest_addr, size);
+  }
   return retval;
 }
 
@@ -1064,3 +1195,26 @@ void NaClDyncodeVisit(
   }
   NaClXMutexUnlock(&nap->dynamic_load_mutex);
 }
+
+void NaClDyncodeVisitRange(
+    struct NaClApp *nap,
+    uintptr_t      start,
+    size_t         size,
+    void           (*fn)(void *state, struct NaClDynamicRegion *region),
+    void           *state) {
+  struct NaClDynamicRegion *region;
+  struct NaClDynamicRegion *end;
+
+  NaClXMutexLock(&nap->dynamic_load_mutex);
+  region = NaClDynamicRegionFindClosestLEQ(nap, start);
+  if (NULL == region) {
+    region = nap->dynamic_regions;
+  } else if (region->start + region->size <= start) {
+    ++region;
+  }
+  end = nap->dynamic_regions + nap->num_dynamic_regions;
+  for (; region < end && region->start < start + size; ++region) {
+    fn(state, region);
+  }
+  NaClXMutexUnlock(&nap->dynamic_load_mutex);
+}
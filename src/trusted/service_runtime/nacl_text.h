@@ -7,6 +7,7 @@
 #ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_TEXT_H_
 #define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_NACL_TEXT_H_
 
+#include "native_client/src/include/build_config.h"
 #include "native_client/src/include/portability.h"
 #include "native_client/src/include/nacl_compiler_annotations.h"
 #include "native_client/src/trusted/service_runtime/nacl_error_code.h"
@@ -72,6 +73,17 @@ struct NaClValidationMetadata;
  */
 NaClErrorCode NaClMakeDynamicTextShared(struct NaClApp *nap) NACL_WUR;
 
+#if !NACL_WINDOWS
+/*
+ * Replace the shared memory object backing the dynamic text region
+ * with a private copy of it.  A process forked from a fully loaded
+ * NaClApp (see nacl_fork_server.h) shares the parent's text_shm, so
+ * without this, code loaded by one child would be visible to its
+ * siblings.  Must be called before any untrusted thread runs.
+ */
+NaClErrorCode NaClDynamicTextUnshare(struct NaClApp *nap) NACL_WUR;
+#endif
+
 struct NaClDescEffectorShm;
 int NaClDescEffectorShmCtor(struct NaClDescEffectorShm *self) NACL_WUR;
 
@@ -103,6 +115,17 @@ void NaClDyncodeVisit(
     void           (*fn)(void *state, struct NaClDynamicRegion *region),
     void           *state);
 
+/*
+ * Like NaClDyncodeVisit, but only visits the regions that overlap
+ * [start, start + size), given as system addresses.
+ */
+void NaClDyncodeVisitRange(
+    struct NaClApp *nap,
+    uintptr_t      start,
+    size_t         size,
+    void           (*fn)(void *state, struct NaClDynamicRegion *region),
+    void           *state);
+
 EXTERN_C_END
 
 #endif
@@ -10,6 +10,11 @@
 
 #include <errno.h>
 
+#include "native_client/src/include/build_config.h"
+#if NACL_LINUX
+# include <sys/mman.h>
+#endif
+
 #include "native_client/src/include/nacl_platform.h"
 #include "native_client/src/include/portability.h"
 #include "native_client/src/shared/platform/nacl_log.h"
@@ -106,6 +111,38 @@ NaClErrorCode NaClAllocAddrSpace(struct NaClApp *nap) {
   return NaClAllocAddrSpaceAslr(nap, 1);
 }
 
+int NaClAdviseHugePages(struct NaClApp *nap, uintptr_t sys_addr, size_t size) {
+#if NACL_LINUX && defined(MADV_HUGEPAGE)
+  uintptr_t start;
+  uintptr_t end;
+  int       err;
+
+  if (!nap->enable_huge_pages) {
+    return 0;
+  }
+  start = (sys_addr + NACL_HUGE_PAGE_SIZE - 1) & ~(NACL_HUGE_PAGE_SIZE - 1);
+  end = (sys_addr + size) & ~(NACL_HUGE_PAGE_SIZE - 1);
+  if (start < sys_addr || end <= start) {
+    return 0;
+  }
+  if (0 != (err = NaClMadvise((void *) start, end - start, MADV_HUGEPAGE))) {
+    /* EINVAL here means the host kernel was built without THP. */
+    NaClLog(2, "NaClAdviseHugePages: madvise failed, error %d\n", err);
+    return 0;
+  }
+  NaClLog(3,
+          ("NaClAdviseHugePages: 0x%08"NACL_PRIxPTR", size 0x%08"NACL_PRIxS
+           "\n"),
+          start, (size_t) (end - start));
+  return 1;
+#else
+  UNREFERENCED_PARAMETER(nap);
+  UNREFERENCED_PARAMETER(sys_addr);
+  UNREFERENCED_PARAMETER(size);
+  return 0;
+#endif
+}
+
 /*
  * Apply memory protection to memory regions.
  * Expects that "nap->mu" lock is already held.
@@ -113,6 +150,7 @@ NaClErrorCode NaClAllocAddrSpace(struct NaClApp *nap) {
 NaClErrorCode NaClMemoryProtection(struct NaClApp *nap) {
   uintptr_t start_addr;
   size_t    region_size;
+  int       map_flags;
   int       err;
 
   /*
@@ -157,11 +195,19 @@ NaClErrorCode NaClMemoryProtection(struct NaClApp *nap) {
             err);
     return LOAD_MPROTECT_FAIL;
   }
+  /*
+   * The static text has been validated by now and is never written
+   * again, so it is safe for the host to collapse it into huge pages.
+   */
+  map_flags = NACL_ABI_MAP_PRIVATE;
+  if (NaClAdviseHugePages(nap, start_addr, region_size)) {
+    map_flags |= NACL_MAP_HUGE_PAGES;
+  }
   NaClVmmapAdd(&nap->mem_map,
                NaClSysToUser(nap, start_addr) >> NACL_PAGESHIFT,
                region_size >> NACL_PAGESHIFT,
                NACL_ABI_PROT_READ | NACL_ABI_PROT_EXEC,
-               NACL_ABI_MAP_PRIVATE,
+               map_flags,
                NULL,
                0,
                0);
@@ -263,11 +309,15 @@ NaClErrorCode NaClMemoryProtection(struct NaClApp *nap) {
               err);
       return LOAD_MPROTECT_FAIL;
     }
+    map_flags = NACL_ABI_MAP_PRIVATE;
+    if (NaClAdviseHugePages(nap, start_addr, region_size)) {
+      map_flags |= NACL_MAP_HUGE_PAGES;
+    }
     NaClVmmapAdd(&nap->mem_map,
                  NaClSysToUser(nap, start_addr) >> NACL_PAGESHIFT,
                  region_size >> NACL_PAGESHIFT,
                  NACL_ABI_PROT_READ | NACL_ABI_PROT_WRITE,
-                 NACL_ABI_MAP_PRIVATE,
+                 map_flags,
                  NULL,
                  0,
                  0);
@@ -97,6 +97,23 @@ NaClErrorCode NaClAllocateSpace(void **mem, size_t addrsp_size) NACL_WUR;
  */
 void NaClAddrSpaceFree(struct NaClApp *nap);
 
+/*
+ * Size of the huge pages used for transparent huge page backing.
+ */
+#define NACL_HUGE_PAGE_SIZE ((size_t) 2 << 20)
+
+/*
+ * If huge pages are enabled (NACL_ENABLE_HUGE_PAGES), asks the host
+ * to back the NACL_HUGE_PAGE_SIZE-aligned blocks lying entirely
+ * within [sys_addr, sys_addr + size) with transparent huge pages.
+ * This is only advice: the host may ignore it, and partial blocks at
+ * either end are left alone.  Returns non-zero if any block was
+ * advised, in which case the caller should mark the corresponding
+ * vmmap entry with NACL_MAP_HUGE_PAGES.  Currently only implemented
+ * on Linux; elsewhere it always returns 0.
+ */
+int NaClAdviseHugePages(struct NaClApp *nap, uintptr_t sys_addr, size_t size);
+
 EXTERN_C_END
 
 #endif
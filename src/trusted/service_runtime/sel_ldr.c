@@ -31,6 +31,7 @@
 #include "native_client/src/shared/platform/nacl_time.h"
 
 #include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/desc/nacl_desc_buffered.h"
 #include "native_client/src/trusted/desc/nacl_desc_conn_cap.h"
 #include "native_client/src/trusted/desc/nacl_desc_imc.h"
 #include "native_client/src/trusted/desc/nacl_desc_io.h"
@@ -41,6 +42,7 @@
 #include "native_client/src/trusted/service_runtime/arch/sel_ldr_arch.h"
 #include "native_client/src/trusted/service_runtime/include/bits/nacl_syscalls.h"
 #include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_iovec.h"
 #include "native_client/src/trusted/service_runtime/include/sys/stat.h"
 #include "native_client/src/trusted/service_runtime/include/sys/time.h"
 #include "native_client/src/trusted/service_runtime/nacl_app.h"
@@ -50,6 +52,7 @@
 #include "native_client/src/trusted/service_runtime/nacl_resource.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_list.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_profile.h"
 #include "native_client/src/trusted/service_runtime/nacl_valgrind_hooks.h"
 #include "native_client/src/trusted/service_runtime/sel_addrspace.h"
 #include "native_client/src/trusted/service_runtime/sel_ldr.h"
@@ -75,8 +78,11 @@ int NaClAppWithEmptySyscallTableCtor(struct NaClApp *nap) {
   /* Zero-initialize in case we miss any fields below. */
   memset(nap, 0, sizeof(*nap));
 
-  /* The validation cache will be injected later, if it exists. */
-  nap->validation_cache = NULL;
+  /*
+   * Default to the process-wide in-memory cache.  An embedder-supplied
+   * validation cache will be injected later, if it exists.
+   */
+  nap->validation_cache = nacl_validation_cache_memory;
 
   nap->validator = NaClCreateValidator();
 
@@ -186,6 +192,7 @@ int NaClAppWithEmptySyscallTableCtor(struct NaClApp *nap) {
 
   for (i = 0; i < NACL_MAX_SYSCALLS; ++i) {
     nap->syscall_table[i].handler = &NaClSysNotImplementedDecoder;
+    nap->syscall_table[i].name = NULL;
   }
 
   nap->module_initialization_state = NACL_MODULE_UNINITIALIZED;
@@ -209,6 +216,24 @@ int NaClAppWithEmptySyscallTableCtor(struct NaClApp *nap) {
     NaClLog(LOG_INFO, "DANGER: ENABLED LIST_MAPPINGS\n");
     nap->enable_list_mappings = 1;
   }
+  nap->enable_clock_page = 0;
+  if (IsEnvironmentVariableSet("NACL_ENABLE_CLOCK_PAGE")) {
+    nap->enable_clock_page = 1;
+  }
+  nap->clock_page_addr = 0;
+  nap->clock_page = NULL;
+  nap->clock_page_shm = NULL;
+  nap->enable_huge_pages = 0;
+  if (IsEnvironmentVariableSet("NACL_ENABLE_HUGE_PAGES")) {
+    nap->enable_huge_pages = 1;
+  }
+  nap->enable_buffered_writes = 0;
+  if (IsEnvironmentVariableSet("NACL_ENABLE_BUFFERED_WRITES")) {
+    nap->enable_buffered_writes = 1;
+  }
+  NaClSyscallProfileInit(nap);
+  nap->aio = NULL;
+  nap->dirty_pages = NULL;
   nap->pnacl_mode = 0;
 
   if (!NaClMutexCtor(&nap->threads_mu)) {
@@ -574,6 +599,21 @@ int32_t NaClAppSetDescAvail(struct NaClApp  *nap,
   return pos;
 }
 
+struct NaClDesc *NaClAppMaybeBufferDesc(struct NaClApp   *nap,
+                                        struct NaClDesc  *ndp) {
+  struct NaClDesc *buffered;
+
+  if (!nap->enable_buffered_writes || NULL == ndp) {
+    return ndp;
+  }
+  buffered = NaClDescBufferedMake(ndp);
+  if (NULL == buffered) {
+    NaClLog(LOG_WARNING, "NaClAppMaybeBufferDesc: writes left unbuffered\n");
+    return ndp;
+  }
+  return buffered;
+}
+
 int NaClAddThreadMu(struct NaClApp        *nap,
                     struct NaClAppThread  *natp) {
   size_t pos;
@@ -732,6 +772,13 @@ void NaClAppInitialDescriptorHookup(struct NaClApp *nap) {
       NaClAddHostDescriptor(nap, DUP(g_nacl_redir_control[ix].d),
                             g_nacl_redir_control[ix].nacl_flags, (int) ix);
     }
+
+    if (0 != (g_nacl_redir_control[ix].nacl_flags & NACL_ABI_O_APPEND)) {
+      ndp = NaClAppGetDesc(nap, (int) ix);
+      if (NULL != ndp) {
+        NaClAppSetDesc(nap, (int) ix, NaClAppMaybeBufferDesc(nap, ndp));
+      }
+    }
   }
 
   NaClLog(4, "... done.\n");
@@ -896,6 +943,39 @@ void NaClVmIoHasEnded(struct NaClApp *nap,
   NaClXMutexUnlock(&nap->mu);
 }
 
+void NaClVmIoWillStartVec(struct NaClApp              *nap,
+                          struct NaClUserIoVec const  *iov,
+                          size_t                      iovcnt) {
+  size_t i;
+
+  NaClXMutexLock(&nap->mu);
+  for (i = 0; i < iovcnt; ++i) {
+    if (0 != iov[i].length) {
+      (*nap->mem_io_regions->vtbl->AddInterval)(
+          nap->mem_io_regions,
+          iov[i].base, iov[i].base + iov[i].length - 1);
+    }
+  }
+  NaClXMutexUnlock(&nap->mu);
+}
+
+
+void NaClVmIoHasEndedVec(struct NaClApp               *nap,
+                         struct NaClUserIoVec const   *iov,
+                         size_t                       iovcnt) {
+  size_t i;
+
+  NaClXMutexLock(&nap->mu);
+  for (i = 0; i < iovcnt; ++i) {
+    if (0 != iov[i].length) {
+      (*nap->mem_io_regions->vtbl->RemoveInterval)(
+          nap->mem_io_regions,
+          iov[i].base, iov[i].base + iov[i].length - 1);
+    }
+  }
+  NaClXMutexUnlock(&nap->mu);
+}
+
 void NaClVmIoPendingCheck_mu(struct NaClApp *nap,
                              uint32_t addr_first_usr,
                              uint32_t addr_last_usr) {
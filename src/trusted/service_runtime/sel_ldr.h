@@ -61,12 +61,17 @@ EXTERN_C_BEGIN
 
 #define NACL_DEFAULT_STACK_MAX  (16 << 20)  /* main thread stack */
 
+struct NaClAio;
 struct NaClAppThread;
 struct NaClDesc;  /* see native_client/src/trusted/desc/nacl_desc_base.h */
+struct NaClDirtyPages;
 struct NaClDynamicRegion;
 struct NaClSignalContext;
+struct NaClSyscallProfileState;
+struct NaClUserIoVec;
 struct NaClValidationCache;
 struct NaClValidationMetadata;
+struct nacl_abi_clock_page;
 
 struct NaClDebugCallbacks {
   void (*thread_create_hook)(struct NaClAppThread *natp);
@@ -313,6 +318,45 @@ struct NaClApp {
   int                       validator_stub_out_mode;
 
   int                       enable_list_mappings;
+
+  /*
+   * Read-only clock page shared with untrusted code; see
+   * nacl_clock_page.h.  clock_page_addr is the untrusted address of the
+   * page, or 0 if there is none.
+   */
+  int                       enable_clock_page;
+  uintptr_t                 clock_page_addr;
+  struct nacl_abi_clock_page *clock_page;
+  struct NaClDesc           *clock_page_shm;
+  struct NaClThread         clock_page_thread;
+
+  /*
+   * Opt-in transparent huge page backing for the data segment, heap,
+   * anonymous mmaps and static text; see NaClAdviseHugePages.
+   */
+  int                       enable_huge_pages;
+
+  /*
+   * Opt-in write combining for stdout, stderr and O_APPEND files; see
+   * nacl_desc_buffered.h and NaClAppMaybeBufferDesc.
+   */
+  int                       enable_buffered_writes;
+
+  /* Non-NULL if syscall profiling is enabled; see nacl_syscall_profile.h. */
+  struct NaClSyscallProfileState *syscall_profile;
+
+  /*
+   * Asynchronous I/O rings and worker threads, created by the first
+   * aio_setup syscall; see sys_aio.h.  Protected by mu.
+   */
+  struct NaClAio            *aio;
+
+  /*
+   * Host state for the get_dirty_pages syscall, created by its first
+   * call; see nacl_dirty_pages.h.  Protected by mu.
+   */
+  struct NaClDirtyPages     *dirty_pages;
+
   /* Whether or not the app is a PNaCl app.  Boolean. */
   int                       pnacl_mode;
 
@@ -570,6 +614,15 @@ struct NaClDesc *NaClAppGetDesc(struct NaClApp *nap,
 int32_t NaClAppSetDescAvail(struct NaClApp   *nap,
                             struct NaClDesc  *ndp);
 
+/*
+ * Wraps a log-like descriptor in a NaClDescBuffered if buffered writes
+ * are enabled.  Takes ownership of ndp and returns the descriptor to
+ * install, which is ndp itself if it was not wrapped.  Output still
+ * buffered when sel_ldr crashes or is killed by a signal is lost.
+ */
+struct NaClDesc *NaClAppMaybeBufferDesc(struct NaClApp   *nap,
+                                        struct NaClDesc  *ndp);
+
 /*
  * Versions that are called while already holding the desc_mu lock
  */
@@ -737,6 +790,19 @@ void NaClVmIoHasEnded(struct NaClApp *nap,
                       uint32_t addr_first_usr,
                       uint32_t addr_last_usr);
 
+/*
+ * Vectored versions of NaClVmIoWillStart and NaClVmIoHasEnded, which
+ * record every non-empty segment of iov while taking the VM lock
+ * once.
+ */
+void NaClVmIoWillStartVec(struct NaClApp              *nap,
+                          struct NaClUserIoVec const  *iov,
+                          size_t                      iovcnt);
+
+void NaClVmIoHasEndedVec(struct NaClApp               *nap,
+                         struct NaClUserIoVec const   *iov,
+                         size_t                       iovcnt);
+
 /*
  * Used by operations (mmap, munmap) that will open a VM hole.
  * Invoked while holding the VM lock.  Check that no I/O is pending;
@@ -25,6 +25,7 @@
 #include "native_client/src/shared/platform/nacl_time.h"
 
 #include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/desc/nacl_desc_buffered.h"
 #include "native_client/src/trusted/perf_counter/nacl_perf_counter.h"
 
 #include "native_client/src/trusted/service_runtime/include/sys/errno.h"
@@ -33,14 +34,18 @@
 #include "native_client/src/trusted/service_runtime/arch/sel_ldr_arch.h"
 #include "native_client/src/trusted/service_runtime/elf_util.h"
 #include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
+#include "native_client/src/trusted/service_runtime/nacl_clock_page.h"
+#include "native_client/src/trusted/service_runtime/nacl_globals.h"
 #include "native_client/src/trusted/service_runtime/nacl_signal.h"
 #include "native_client/src/trusted/service_runtime/nacl_switch_to_app.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_profile.h"
 #include "native_client/src/trusted/service_runtime/nacl_text.h"
 #include "native_client/src/trusted/service_runtime/sel_memory.h"
 #include "native_client/src/trusted/service_runtime/sel_ldr.h"
 #include "native_client/src/trusted/service_runtime/sel_util.h"
 #include "native_client/src/trusted/service_runtime/sel_addrspace.h"
+#include "native_client/src/trusted/validator/validation_cache_memory.h"
 
 
 /*
@@ -223,6 +228,8 @@ NaClErrorCode NaClAppLoadFileAslr(struct NaClDesc *ndp,
     ret = subret;
     goto done;
   }
+  /* Start reading the segments in while the headers are checked. */
+  NaClElfImagePrefetch(image, ndp);
 
   subret = NaClElfImageValidateProgramHeaders(image,
                                               nap->addr_bits,
@@ -448,6 +455,7 @@ NaClErrorCode NaClAppLoadFileDynamically(
   if (NULL == image || LOAD_OK != ret) {
     goto done;
   }
+  NaClElfImagePrefetch(image, ndp);
   ret = NaClElfImageLoadDynamically(image, nap, ndp, metadata);
   if (LOAD_OK != ret) {
     goto done;
@@ -500,6 +508,27 @@ int NaClReportExitStatus(struct NaClApp *nap, int exit_status) {
 
   NaClXMutexUnlock(&nap->mu);
 
+  /* The embedder may exit without closing stdout and stderr. */
+  if (nap->enable_buffered_writes) {
+    NaClDescBufferedFlushAll();
+  }
+
+  if (NULL != nap->syscall_profile) {
+    NaClSyscallProfileDump(nap);
+  }
+
+  if (NULL != nap->validation_cache &&
+      nap->validation_cache == nacl_validation_cache_memory) {
+    struct NaClValidationCacheMemoryStats stats;
+    NaClValidationCacheMemoryGetStats(nap->validation_cache, &stats);
+    NaClLog(2,
+            ("Validation cache: %"NACL_PRIu64" hits, %"NACL_PRIu64" misses,"
+             " %"NACL_PRIu64" insertions, %"NACL_PRIu64" evictions,"
+             " %"NACL_PRIuS" entries\n"),
+            stats.hits, stats.misses, stats.insertions, stats.evictions,
+            stats.entries);
+  }
+
   return 0;
 }
 
@@ -610,6 +639,12 @@ int NaClCreateMainThread(struct NaClApp     *nap,
   if (0 != nap->dynamic_text_start) {
     auxv_entries++;
   }
+  if (nap->enable_clock_page && 0 == nap->clock_page_addr) {
+    (void) NaClClockPageInit(nap);
+  }
+  if (0 != nap->clock_page_addr) {
+    auxv_entries++;
+  }
   ptr_tbl_size = (((NACL_STACK_GETS_ARG ? 1 : 0) +
                    (3 + argc + 1 + envc + 1 + auxv_entries * 2)) *
                   sizeof(uint32_t));
@@ -689,6 +724,10 @@ int NaClCreateMainThread(struct NaClApp     *nap,
     *p++ = AT_BASE;
     *p++ = (uint32_t) nap->dynamic_text_start;
   }
+  if (0 != nap->clock_page_addr) {
+    *p++ = AT_NACL_CLOCK_PAGE;
+    *p++ = (uint32_t) nap->clock_page_addr;
+  }
   *p++ = AT_NULL;
   *p++ = 0;
 
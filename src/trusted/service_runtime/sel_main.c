@@ -34,6 +34,7 @@
 #include "native_client/src/trusted/fault_injection/fault_injection.h"
 #include "native_client/src/trusted/fault_injection/test_injection.h"
 #include "native_client/src/trusted/perf_counter/nacl_perf_counter.h"
+#include "native_client/src/trusted/service_runtime/elf_util.h"
 #include "native_client/src/trusted/service_runtime/env_cleanser.h"
 #include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
 #include "native_client/src/trusted/service_runtime/load_file.h"
@@ -41,6 +42,7 @@
 #include "native_client/src/trusted/service_runtime/nacl_all_modules.h"
 #include "native_client/src/trusted/service_runtime/nacl_debug_init.h"
 #include "native_client/src/trusted/service_runtime/nacl_error_log_hook.h"
+#include "native_client/src/trusted/service_runtime/nacl_fork_server.h"
 #include "native_client/src/trusted/service_runtime/nacl_globals.h"
 #include "native_client/src/trusted/service_runtime/nacl_signal.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
@@ -134,7 +136,11 @@ static void PrintUsage(void) {
           " -v increases verbosity\n"
           " -e enable hardware exception handling\n"
           " -E <name=value>|<name> set an environment variable\n"
-          " -p pass through all environment variables\n");
+          " -p pass through all environment variables\n"
+          " -K <socket>, --fork_server <socket>\n"
+          "    load the nexe and blob library, then fork a copy of sel_ldr\n"
+          "    to run the nexe for each request received on the Unix\n"
+          "    domain socket (Linux only; see nacl_fork_server.h)\n");
   fprintf(stderr,
           " -m <directory> mount directory as root.\n"
           "    If not provided (and -a is also missing), no filesystem access\n"
@@ -165,6 +171,7 @@ static void PrintUsage(void) {
 static const struct option longopts[] = {
   { "r_debug", required_argument, NULL, 'D' },
   { "reserved_at_zero", required_argument, NULL, 'z' },
+  { "fork_server", required_argument, NULL, 'K' },
   { NULL, 0, NULL, 0 }
 };
 
@@ -179,6 +186,7 @@ struct SelLdrOptions {
   char *nacl_file;
   char *blob_library_file;
   char *root_mount;
+  char *fork_server_socket;
   int app_argc;
   char **app_argv;
 
@@ -204,6 +212,7 @@ static void SelLdrOptionsCtor(struct SelLdrOptions *options) {
   options->nacl_file = NULL;
   options->blob_library_file = NULL;
   options->root_mount = NULL;
+  options->fork_server_socket = NULL;
   options->app_argc = 0;
   options->app_argv = NULL;
 
@@ -247,7 +256,7 @@ static void NaClSelLdrParseArgs(int argc, char **argv,
    */
   while ((opt = my_getopt(argc, argv,
 #if NACL_LINUX
-                       "+D:z:"
+                       "+D:K:z:"
 #endif
                        "aB:cdeE:f:Fgh:i:l:m:pqQr:RsSvw:X:")) != -1) {
     switch (opt) {
@@ -269,6 +278,11 @@ static void NaClSelLdrParseArgs(int argc, char **argv,
       case 'D':
         NaClHandleRDebug(optarg, argv[0]);
         break;
+#endif
+#if NACL_LINUX
+      case 'K':
+        options->fork_server_socket = optarg;
+        break;
 #endif
       case 'e':
         options->enable_exception_handling = 1;
@@ -476,6 +490,7 @@ int NaClSelLdrMain(int argc, char **argv) {
 
   NaClErrorCode                 errcode = LOAD_INTERNAL;
   struct NaClDesc               *blob_file = NULL;
+  struct NaClElfImage           *irt_image;
 
   int                           ret_code;
 
@@ -641,6 +656,16 @@ int NaClSelLdrMain(int argc, char **argv) {
       perror("sel_main");
       NaClLog(LOG_FATAL, "Cannot open \"%s\".\n", options->blob_library_file);
     }
+    /*
+     * The IRT is loaded only after the nexe, since its placement depends
+     * on the nexe's dynamic text, but its segments can be read in from
+     * storage while the nexe is loaded and validated.
+     */
+    irt_image = NaClElfImageNew(blob_file, &errcode);
+    if (NULL != irt_image) {
+      NaClElfImagePrefetch(irt_image, blob_file);
+      NaClElfImageDelete(irt_image);
+    }
     NaClPerfCounterMark(&time_all_main, "SnapshotBlob");
     NaClPerfCounterIntervalLast(&time_all_main);
   }
@@ -674,9 +699,12 @@ int NaClSelLdrMain(int argc, char **argv) {
    * Enable the outer sandbox, if one is defined.  Do this as soon as
    * possible, but after we have opened files.
    *
-   * We cannot enable the sandbox if file access is enabled.
+   * We cannot enable the sandbox if file access is enabled.  A fork
+   * server needs to accept connections, so it enables the sandbox in
+   * each child instead.
    */
-  if (!NaClFileAccessEnabled() && g_enable_outer_sandbox_func != NULL) {
+  if (!NaClFileAccessEnabled() && g_enable_outer_sandbox_func != NULL &&
+      NULL == options->fork_server_socket) {
     g_enable_outer_sandbox_func();
   }
 
@@ -694,6 +722,19 @@ int NaClSelLdrMain(int argc, char **argv) {
     NaClDescUnref(blob_file);
   }
 
+#if NACL_LINUX
+  if (NULL != options->fork_server_socket) {
+    /* Only returns in a child process, which runs one request. */
+    if (!NaClForkServerRun(nap, options->fork_server_socket,
+                           &options->app_argc, &options->app_argv)) {
+      goto error;
+    }
+    if (!NaClFileAccessEnabled() && g_enable_outer_sandbox_func != NULL) {
+      g_enable_outer_sandbox_func();
+    }
+  }
+#endif
+
   /*
    * Print out a marker for scripts to use to mark the start of app
    * output.
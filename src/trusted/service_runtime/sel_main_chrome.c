@@ -203,7 +203,9 @@ static int LoadApp(struct NaClApp *nap, struct NaClChromeMainArgs *args) {
     NaClSetCreateMemoryObjectFunc(args->create_memory_object_func);
 
   /* Inject the validation caching interface, if it exists. */
-  nap->validation_cache = args->validation_cache;
+  if (NULL != args->validation_cache) {
+    nap->validation_cache = args->validation_cache;
+  }
 
   NaClAppInitialDescriptorHookup(nap);
 
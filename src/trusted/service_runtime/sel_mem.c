@@ -14,6 +14,7 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "native_client/src/include/nacl_platform.h"
 #include "native_client/src/include/portability.h"
@@ -126,6 +127,8 @@ int NaClVmmapCtor(struct NaClVmmap *self) {
   }
   self->nvalid = 0;
   self->is_sorted = 1;
+  self->generation = 1;
+  memset(self->change_log, 0, sizeof self->change_log);
   return 1;
 }
 
@@ -265,14 +268,66 @@ void NaClVmmapMakeSorted(struct NaClVmmap  *self) {
 #endif
 }
 
-void NaClVmmapAdd(struct NaClVmmap  *self,
-                  uintptr_t         page_num,
-                  size_t            npages,
-                  int               prot,
-                  int               flags,
-                  struct NaClDesc   *desc,
-                  nacl_off64_t      offset,
-                  nacl_off64_t      file_size) {
+void NaClVmmapNoteChange(struct NaClVmmap  *self,
+                         uintptr_t         page_num,
+                         size_t            npages) {
+  struct NaClVmmapChange *change;
+
+  /* Generation 0 is reserved to mean "no previous generation". */
+  if (0 == ++self->generation) {
+    self->generation = 1;
+  }
+  change = &self->change_log[self->generation % NACL_VMMAP_CHANGE_LOG_SIZE];
+  change->generation = self->generation;
+  change->page_num = page_num;
+  change->npages = npages;
+}
+
+int NaClVmmapVisitChanges(struct NaClVmmap  *self,
+                          uint32_t          generation,
+                          void              (*fn)(void      *state,
+                                                  uintptr_t page_num,
+                                                  size_t    npages),
+                          void              *state) {
+  uint32_t                g;
+  struct NaClVmmapChange  *change;
+
+  if (0 == generation ||
+      self->generation - generation > NACL_VMMAP_CHANGE_LOG_SIZE) {
+    return 0;
+  }
+  /* Check that the whole range is still in the log before calling fn. */
+  for (g = generation + 1; g != self->generation + 1; ++g) {
+    if (0 == g) {
+      continue;
+    }
+    change = &self->change_log[g % NACL_VMMAP_CHANGE_LOG_SIZE];
+    if (change->generation != g) {
+      return 0;
+    }
+  }
+  for (g = generation + 1; g != self->generation + 1; ++g) {
+    if (0 == g) {
+      continue;
+    }
+    change = &self->change_log[g % NACL_VMMAP_CHANGE_LOG_SIZE];
+    (*fn)(state, change->page_num, change->npages);
+  }
+  return 1;
+}
+
+/*
+ * Adds an entry without recording a change, for use by functions that
+ * record the change for the whole range they modify.
+ */
+static void NaClVmmapAddEntry(struct NaClVmmap  *self,
+                              uintptr_t         page_num,
+                              size_t            npages,
+                              int               prot,
+                              int               flags,
+                              struct NaClDesc   *desc,
+                              nacl_off64_t      offset,
+                              nacl_off64_t      file_size) {
   struct NaClVmmapEntry *entry;
 
   NaClLog(2,
@@ -302,6 +357,19 @@ void NaClVmmapAdd(struct NaClVmmap  *self,
   ++self->nvalid;
 }
 
+void NaClVmmapAdd(struct NaClVmmap  *self,
+                  uintptr_t         page_num,
+                  size_t            npages,
+                  int               prot,
+                  int               flags,
+                  struct NaClDesc   *desc,
+                  nacl_off64_t      offset,
+                  nacl_off64_t      file_size) {
+  NaClVmmapAddEntry(self, page_num, npages, prot, flags, desc, offset,
+                    file_size);
+  NaClVmmapNoteChange(self, page_num, npages);
+}
+
 /*
  * Update the virtual memory map.  Deletion is handled by a remove
  * flag, since a NULL desc just means that the memory is backed by the
@@ -342,14 +410,14 @@ static void NaClVmmapUpdate(struct NaClVmmap  *self,
        * Split existing mapping into two parts, with new mapping in
        * the middle.
        */
-      NaClVmmapAdd(self,
-                   new_region_end_page,
-                   ent_end_page - new_region_end_page,
-                   ent->prot,
-                   ent->flags,
-                   ent->desc,
-                   ent->offset + additional_offset,
-                   ent->file_size);
+      NaClVmmapAddEntry(self,
+                        new_region_end_page,
+                        ent_end_page - new_region_end_page,
+                        ent->prot,
+                        ent->flags,
+                        ent->desc,
+                        ent->offset + additional_offset,
+                        ent->file_size);
       ent->npages = page_num - ent->page_num;
       break;
     } else if (ent->page_num < page_num && page_num < ent_end_page) {
@@ -373,10 +441,12 @@ static void NaClVmmapUpdate(struct NaClVmmap  *self,
   }
 
   if (!remove) {
-    NaClVmmapAdd(self, page_num, npages, prot, flags, desc, offset, file_size);
+    NaClVmmapAddEntry(self, page_num, npages, prot, flags, desc, offset,
+                      file_size);
   }
 
   NaClVmmapRemoveMarked(self);
+  NaClVmmapNoteChange(self, page_num, npages);
 }
 
 void NaClVmmapAddWithOverwrite(struct NaClVmmap   *self,
@@ -463,6 +533,8 @@ int NaClVmmapChangeProt(struct NaClVmmap   *self,
   size_t      i;
   size_t      nvalid;
   uintptr_t   new_region_end_page = page_num + npages;
+  uintptr_t   changed_page_num = page_num;
+  size_t      changed_npages = npages;
 
   /*
    * NaClVmmapCheckExistingMapping should be always called before
@@ -494,51 +566,51 @@ int NaClVmmapChangeProt(struct NaClVmmap   *self,
 
     if (ent->page_num < page_num && new_region_end_page < ent_end_page) {
       /* Split existing mapping into two parts */
-      NaClVmmapAdd(self,
-                   new_region_end_page,
-                   ent_end_page - new_region_end_page,
-                   ent->prot,
-                   ent->flags,
-                   ent->desc,
-                   ent->offset + additional_offset,
-                   ent->file_size);
+      NaClVmmapAddEntry(self,
+                        new_region_end_page,
+                        ent_end_page - new_region_end_page,
+                        ent->prot,
+                        ent->flags,
+                        ent->desc,
+                        ent->offset + additional_offset,
+                        ent->file_size);
       ent->npages = page_num - ent->page_num;
       /* Add the new mapping into the middle. */
-      NaClVmmapAdd(self,
-                   page_num,
-                   npages,
-                   prot,
-                   ent->flags,
-                   ent->desc,
-                   ent->offset + (page_num - ent->page_num),
-                   ent->file_size);
+      NaClVmmapAddEntry(self,
+                        page_num,
+                        npages,
+                        prot,
+                        ent->flags,
+                        ent->desc,
+                        ent->offset + (page_num - ent->page_num),
+                        ent->file_size);
       break;
     } else if (ent->page_num < page_num && page_num < ent_end_page) {
       /* New mapping overlaps end of existing mapping. */
       ent->npages = page_num - ent->page_num;
       /* Add the overlapping part of the mapping. */
-      NaClVmmapAdd(self,
-                   page_num,
-                   ent_end_page - page_num,
-                   prot,
-                   ent->flags,
-                   ent->desc,
-                   ent->offset + (page_num - ent->page_num),
-                   ent->file_size);
+      NaClVmmapAddEntry(self,
+                        page_num,
+                        ent_end_page - page_num,
+                        prot,
+                        ent->flags,
+                        ent->desc,
+                        ent->offset + (page_num - ent->page_num),
+                        ent->file_size);
       /* The remaining part (if any) will be added in other iteration. */
       page_num = ent_end_page;
       npages = new_region_end_page - ent_end_page;
     } else if (ent->page_num < new_region_end_page &&
                new_region_end_page < ent_end_page) {
       /* New mapping overlaps start of existing mapping, split it. */
-      NaClVmmapAdd(self,
-                   page_num,
-                   npages,
-                   prot,
-                   ent->flags,
-                   ent->desc,
-                   ent->offset,
-                   ent->file_size);
+      NaClVmmapAddEntry(self,
+                        page_num,
+                        npages,
+                        prot,
+                        ent->flags,
+                        ent->desc,
+                        ent->offset,
+                        ent->file_size);
       ent->page_num = new_region_end_page;
       ent->npages = ent_end_page - new_region_end_page;
       ent->offset += additional_offset;
@@ -554,6 +626,7 @@ int NaClVmmapChangeProt(struct NaClVmmap   *self,
       assert(new_region_end_page <= ent->page_num || ent_end_page <= page_num);
     }
   }
+  NaClVmmapNoteChange(self, changed_page_num, changed_npages);
   return 1;
 }
 
@@ -672,6 +745,8 @@ void NaClVmmapIterErase(struct NaClVmmapIter *nvip) {
   struct NaClVmmap  *nvp;
 
   nvp = nvip->vmmap;
+  NaClVmmapNoteChange(nvp, nvp->vmentry[nvip->entry_ix]->page_num,
+                      nvp->vmentry[nvip->entry_ix]->npages);
   free(nvp->vmentry[nvip->entry_ix]);
   nvp->vmentry[nvip->entry_ix] = nvp->vmentry[--nvp->nvalid];
   nvp->is_sorted = 0;
@@ -692,6 +767,38 @@ void  NaClVmmapVisit(struct NaClVmmap *self,
 }
 
 
+void  NaClVmmapVisitRange(struct NaClVmmap  *self,
+                          uintptr_t         page_num,
+                          size_t            npages,
+                          void              (*fn)(void                  *state,
+                                                  struct NaClVmmapEntry *entry),
+                          void              *state) {
+  size_t    lo;
+  size_t    hi;
+  uintptr_t end_page = page_num + npages;
+
+  NaClVmmapMakeSorted(self);
+  /*
+   * Entries do not overlap, so they are sorted by end page as well.
+   * Find the first one that ends after page_num.
+   */
+  lo = 0;
+  hi = self->nvalid;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    struct NaClVmmapEntry *ent = self->vmentry[mid];
+    if (ent->page_num + ent->npages <= page_num) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  for (; lo < self->nvalid && self->vmentry[lo]->page_num < end_page; ++lo) {
+    (*fn)(state, self->vmentry[lo]);
+  }
+}
+
+
 /*
  * Linear search, from high addresses down.
  */
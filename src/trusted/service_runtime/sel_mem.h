@@ -21,6 +21,12 @@ EXTERN_C_BEGIN
 struct NaClDesc;
 
 #define NACL_MAP_COPY   0x100
+/*
+ * Internal flag recording that the host was asked to back (part of)
+ * the entry with huge pages; see NaClAdviseHugePages.  Like
+ * NACL_MAP_COPY it is never visible to untrusted code.
+ */
+#define NACL_MAP_HUGE_PAGES 0x200
 
 /*
  * Interface is based on setting properties and query properties by
@@ -49,10 +55,27 @@ struct NaClVmmapEntry {
   nacl_off64_t      file_size;  /* backing store size */
 };
 
+/*
+ * Every modification of the map is assigned the next generation
+ * number, and the page ranges touched by the most recent
+ * NACL_VMMAP_CHANGE_LOG_SIZE of them are kept, so that callers that
+ * remember a generation can find out what changed since without
+ * looking at the whole map.
+ */
+#define NACL_VMMAP_CHANGE_LOG_SIZE 256
+
+struct NaClVmmapChange {
+  uint32_t              generation;
+  uintptr_t             page_num;
+  size_t                npages;
+};
+
 struct NaClVmmap {
   struct NaClVmmapEntry **vmentry;       /* must not overlap */
   size_t                nvalid, size;
   int                   is_sorted;
+  uint32_t              generation;      /* never 0 */
+  struct NaClVmmapChange change_log[NACL_VMMAP_CHANGE_LOG_SIZE];
 };
 
 void NaClVmmapDebug(struct NaClVmmap  *self,
@@ -137,6 +160,41 @@ void  NaClVmmapVisit(struct NaClVmmap   *self,
                                               struct NaClVmmapEntry *entry),
                      void               *state);
 
+/*
+ * Like NaClVmmapVisit, but only calls fn on the entries that overlap
+ * pages [page_num, page_num + npages).  Uses binary search to find the
+ * first one.
+ */
+void  NaClVmmapVisitRange(struct NaClVmmap  *self,
+                          uintptr_t         page_num,
+                          size_t            npages,
+                          void              (*fn)(void                  *state,
+                                                  struct NaClVmmapEntry *entry),
+                          void              *state);
+
+/*
+ * Records a change to pages [page_num, page_num + npages) in the
+ * change log.  The functions above that modify the map do this
+ * themselves; this is for changes that the map does not track, such as
+ * the creation and deletion of dynamic code regions.
+ */
+void  NaClVmmapNoteChange(struct NaClVmmap  *self,
+                          uintptr_t         page_num,
+                          size_t            npages);
+
+/*
+ * Calls fn on the page range of each change made after generation, in
+ * order.  Returns 0 without calling fn if the change log no longer
+ * covers that generation, or if generation is 0, in which case the
+ * caller should look at the whole map instead.
+ */
+int   NaClVmmapVisitChanges(struct NaClVmmap  *self,
+                            uint32_t          generation,
+                            void              (*fn)(void      *state,
+                                                    uintptr_t page_num,
+                                                    size_t    npages),
+                            void              *state);
+
 /*
  * Returns page number starting at which there is a hole of at least
  * num_pages in size.  Linear search from high addresses on down.
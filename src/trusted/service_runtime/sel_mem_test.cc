@@ -4,6 +4,9 @@
  * found in the LICENSE file.
  */
 
+#include <utility>
+#include <vector>
+
 #include "native_client/src/include/nacl_platform.h"
 #include "native_client/src/trusted/service_runtime/sel_mem.h"
 #include "native_client/src/shared/platform/nacl_log.h"
@@ -234,3 +237,64 @@ TEST_F(SelMemTest, FindSpaceTest) {
 
   NaClVmmapDtor(&mem_map);
 }
+
+static void NoteChangedRange(void *state, uintptr_t page_num, size_t npages) {
+  std::vector<std::pair<uintptr_t, size_t> > *changes =
+      reinterpret_cast<std::vector<std::pair<uintptr_t, size_t> > *>(state);
+  changes->push_back(std::make_pair(page_num, npages));
+}
+
+static void NoteEntry(void *state, struct NaClVmmapEntry *entry) {
+  std::vector<uintptr_t> *entries =
+      reinterpret_cast<std::vector<uintptr_t> *>(state);
+  entries->push_back(entry->page_num);
+}
+
+TEST_F(SelMemTest, ChangeLogTest) {
+  struct NaClVmmap mem_map;
+  std::vector<std::pair<uintptr_t, size_t> > changes;
+
+  EXPECT_EQ(1, NaClVmmapCtor(&mem_map));
+  uint32_t start = mem_map.generation;
+  EXPECT_NE(0U, start);
+
+  // Nothing has changed yet.
+  EXPECT_EQ(1, NaClVmmapVisitChanges(&mem_map, start,
+                                     NoteChangedRange, &changes));
+  EXPECT_EQ(0U, changes.size());
+
+  NaClVmmapAddWithOverwrite(&mem_map, 32, 12, NACL_ABI_PROT_READ,
+                            NACL_ABI_MAP_PRIVATE, NULL, 0, 0);
+  NaClVmmapChangeProt(&mem_map, 36, 2, NACL_ABI_PROT_NONE);
+  EXPECT_NE(start, mem_map.generation);
+
+  EXPECT_EQ(1, NaClVmmapVisitChanges(&mem_map, start,
+                                     NoteChangedRange, &changes));
+  bool found_add = false;
+  bool found_prot = false;
+  for (size_t i = 0; i < changes.size(); ++i) {
+    found_add |= changes[i].first == 32 && changes[i].second == 12;
+    found_prot |= changes[i].first == 36 && changes[i].second == 2;
+  }
+  EXPECT_TRUE(found_add);
+  EXPECT_TRUE(found_prot);
+
+  // Only the entries overlapping the range are visited.
+  std::vector<uintptr_t> entries;
+  NaClVmmapVisitRange(&mem_map, 37, 4, NoteEntry, &entries);
+  ASSERT_EQ(2U, entries.size());
+  EXPECT_EQ(36U, entries[0]);
+  EXPECT_EQ(38U, entries[1]);
+
+  // Generation 0 and generations older than the log are not covered.
+  EXPECT_EQ(0, NaClVmmapVisitChanges(&mem_map, 0,
+                                     NoteChangedRange, &changes));
+  for (int i = 0; i < NACL_VMMAP_CHANGE_LOG_SIZE; ++i) {
+    NaClVmmapChangeProt(&mem_map, 32, 1,
+                        (i & 1) ? NACL_ABI_PROT_READ : NACL_ABI_PROT_NONE);
+  }
+  EXPECT_EQ(0, NaClVmmapVisitChanges(&mem_map, start,
+                                     NoteChangedRange, &changes));
+
+  NaClVmmapDtor(&mem_map);
+}
@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl service run-time, asynchronous I/O system calls.
+ *
+ * Each ring has a trusted copy of sq_head and cq_tail, so untrusted
+ * code can only affect what it has written itself: sq_tail is checked
+ * against the trusted sq_head, every SQE is copied in exactly once
+ * before it is looked at, and CQEs are only written to the slots
+ * between cq_head and cq_head + entries.  A ring never has more than
+ * |entries| requests outstanding (running or waiting to be posted), so
+ * a ring whose CQ is never drained only holds up its own requests.
+ *
+ * Lock order: aio->mu, then nap->mu or nap->desc_mu.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/trusted/service_runtime/sys_aio.h"
+
+#include "native_client/src/include/concurrency_ops.h"
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_sync.h"
+#include "native_client/src/shared/platform/nacl_sync_checked.h"
+#include "native_client/src/shared/platform/nacl_threads.h"
+#include "native_client/src/trusted/desc/nacl_desc_base.h"
+#include "native_client/src/trusted/service_runtime/include/sys/errno.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_aio.h"
+#include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
+#include "native_client/src/trusted/service_runtime/nacl_copy.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+
+/*
+ * Requests mostly block in the host kernel, so this bounds how many
+ * can be in progress at once across all rings.
+ */
+#define NACL_AIO_WORKERS 8
+
+static const size_t kNaClAioWorkerStackSize = 64 << 10;
+
+struct NaClAioRing;
+
+struct NaClAioOp {
+  struct NaClAioOp *next;
+  struct NaClAioRing *ring;
+  struct nacl_abi_aio_sqe sqe;
+  struct NaClDesc *ndp;
+  uintptr_t sysaddr;
+  int32_t result;
+};
+
+struct NaClAioRing {
+  uint32_t addr;
+  uint32_t entries;
+  uint32_t sq_head;
+  uint32_t cq_tail;
+  /* Requests queued for or being run by a worker. */
+  uint32_t running;
+  /* Finished requests waiting for space in the CQ, oldest first. */
+  uint32_t num_done;
+  struct NaClAioOp *done_head;
+  struct NaClAioOp **done_tail;
+  /* Threads in NaClSysAioEnter waiting on this ring. */
+  uint32_t waiters;
+  int destroying;
+};
+
+struct NaClAio {
+  struct NaClApp *nap;
+  struct NaClMutex mu;
+  /* Signalled when requests are queued. */
+  struct NaClCondVar work_cv;
+  /* Broadcast when a request finishes or a ring is destroyed. */
+  struct NaClCondVar done_cv;
+  struct NaClAioOp *queue_head;
+  struct NaClAioOp **queue_tail;
+  struct NaClAioRing *rings[NACL_ABI_AIO_MAX_RINGS];
+  struct NaClThread workers[NACL_AIO_WORKERS];
+};
+
+static uint32_t NaClAioSqeAddr(struct NaClAioRing *ring, uint32_t index) {
+  return (ring->addr + sizeof(struct nacl_abi_aio_ring)
+          + (index & (ring->entries - 1)) * sizeof(struct nacl_abi_aio_sqe));
+}
+
+static uint32_t NaClAioCqeAddr(struct NaClAioRing *ring, uint32_t index) {
+  return (ring->addr + sizeof(struct nacl_abi_aio_ring)
+          + ring->entries * sizeof(struct nacl_abi_aio_sqe)
+          + (index & (ring->entries - 1)) * sizeof(struct nacl_abi_aio_cqe));
+}
+
+static void NaClAioAddDoneMu(struct NaClAioRing *ring, struct NaClAioOp *op) {
+  op->next = NULL;
+  *ring->done_tail = op;
+  ring->done_tail = &op->next;
+  ring->num_done++;
+}
+
+/*
+ * Copies as many finished requests to the CQ as fit, then publishes
+ * them by advancing cq_tail.
+ */
+static void NaClAioPostCompletionsMu(struct NaClApp *nap,
+                                     struct NaClAioRing *ring) {
+  struct nacl_abi_aio_cqe cqe;
+  struct NaClAioOp *op;
+  uint32_t cq_head;
+  uint32_t cq_tail = ring->cq_tail;
+
+  if (NULL == ring->done_head || ring->destroying) {
+    return;
+  }
+  if (!NaClCopyInFromUser(nap, &cq_head,
+                          ring->addr + offsetof(struct nacl_abi_aio_ring,
+                                                cq_head),
+                          sizeof cq_head)) {
+    return;
+  }
+  while (NULL != ring->done_head && cq_tail - cq_head < ring->entries) {
+    op = ring->done_head;
+    cqe.user_data = op->sqe.user_data;
+    cqe.result = op->result;
+    cqe.reserved = 0;
+    if (!NaClCopyOutToUser(nap, NaClAioCqeAddr(ring, cq_tail),
+                           &cqe, sizeof cqe)) {
+      break;
+    }
+    ring->done_head = op->next;
+    if (NULL == ring->done_head) {
+      ring->done_tail = &ring->done_head;
+    }
+    ring->num_done--;
+    free(op);
+    cq_tail++;
+  }
+  if (cq_tail != ring->cq_tail) {
+    ring->cq_tail = cq_tail;
+    /* Untrusted code must see the CQEs before the new cq_tail. */
+    NaClWriteMemoryBarrier();
+    if (!NaClCopyOutToUser(nap,
+                           ring->addr + offsetof(struct nacl_abi_aio_ring,
+                                                 cq_tail),
+                           &cq_tail, sizeof cq_tail)) {
+      NaClLog(3, "NaClAioPostCompletionsMu: could not update cq_tail\n");
+    }
+  }
+}
+
+/*
+ * Checks a request and takes the references it needs to run.  Returns
+ * 0 on success, or a negated NACL_ABI_E* value with nothing held.
+ */
+static int32_t NaClAioStart(struct NaClApp *nap, struct NaClAioOp *op) {
+  struct nacl_abi_aio_sqe *sqe = &op->sqe;
+
+  switch (sqe->opcode) {
+    case NACL_ABI_AIO_PREAD:
+    case NACL_ABI_AIO_PWRITE:
+      if (sqe->offset < 0) {
+        return -NACL_ABI_EINVAL;
+      }
+      /* The result must fit in the CQE. */
+      if (sqe->len > INT32_MAX) {
+        sqe->len = INT32_MAX;
+      }
+      op->sysaddr = NaClUserToSysAddrRange(nap, sqe->buf, sqe->len);
+      if (kNaClBadAddress == op->sysaddr) {
+        return -NACL_ABI_EFAULT;
+      }
+      break;
+    case NACL_ABI_AIO_FSYNC:
+      break;
+    default:
+      return -NACL_ABI_EINVAL;
+  }
+  op->ndp = NaClAppGetDesc(nap, sqe->desc);
+  if (NULL == op->ndp) {
+    return -NACL_ABI_EBADF;
+  }
+  if (NACL_ABI_AIO_FSYNC != sqe->opcode && 0 != sqe->len) {
+    NaClVmIoWillStart(nap, sqe->buf, sqe->buf + sqe->len - 1);
+  }
+  return 0;
+}
+
+static void NaClAioRun(struct NaClApp *nap, struct NaClAioOp *op) {
+  struct nacl_abi_aio_sqe *sqe = &op->sqe;
+  struct NaClDesc *ndp = op->ndp;
+  ssize_t result;
+
+  switch (sqe->opcode) {
+    case NACL_ABI_AIO_PREAD:
+      result = (*NACL_VTBL(NaClDesc, ndp)->
+                PRead)(ndp, (void *) op->sysaddr, sqe->len, sqe->offset);
+      break;
+    case NACL_ABI_AIO_PWRITE:
+      result = (*NACL_VTBL(NaClDesc, ndp)->
+                PWrite)(ndp, (void *) op->sysaddr, sqe->len, sqe->offset);
+      break;
+    default:
+      result = (*NACL_VTBL(NaClDesc, ndp)->Fsync)(ndp);
+      break;
+  }
+  if (NACL_ABI_AIO_FSYNC != sqe->opcode && 0 != sqe->len) {
+    NaClVmIoHasEnded(nap, sqe->buf, sqe->buf + sqe->len - 1);
+  }
+  NaClDescUnref(ndp);
+  op->ndp = NULL;
+  op->result = (int32_t) result;
+}
+
+static void WINAPI NaClAioWorker(void *state) {
+  struct NaClAio *aio = (struct NaClAio *) state;
+  struct NaClAioOp *op;
+  struct NaClAioRing *ring;
+
+  for (;;) {
+    NaClXMutexLock(&aio->mu);
+    while (NULL == aio->queue_head) {
+      NaClXCondVarWait(&aio->work_cv, &aio->mu);
+    }
+    op = aio->queue_head;
+    aio->queue_head = op->next;
+    if (NULL == aio->queue_head) {
+      aio->queue_tail = &aio->queue_head;
+    }
+    NaClXMutexUnlock(&aio->mu);
+
+    NaClAioRun(aio->nap, op);
+
+    NaClXMutexLock(&aio->mu);
+    ring = op->ring;
+    ring->running--;
+    NaClAioAddDoneMu(ring, op);
+    NaClAioPostCompletionsMu(aio->nap, ring);
+    NaClXCondVarBroadcast(&aio->done_cv);
+    NaClXMutexUnlock(&aio->mu);
+  }
+}
+
+static struct NaClAio *NaClAioNew(struct NaClApp *nap) {
+  struct NaClAio *aio;
+  int started = 0;
+  int i;
+
+  aio = (struct NaClAio *) malloc(sizeof *aio);
+  if (NULL == aio) {
+    return NULL;
+  }
+  memset(aio, 0, sizeof *aio);
+  aio->nap = nap;
+  aio->queue_head = NULL;
+  aio->queue_tail = &aio->queue_head;
+  if (!NaClMutexCtor(&aio->mu)) {
+    goto cleanup_aio;
+  }
+  if (!NaClCondVarCtor(&aio->work_cv)) {
+    goto cleanup_mu;
+  }
+  if (!NaClCondVarCtor(&aio->done_cv)) {
+    goto cleanup_work_cv;
+  }
+  for (i = 0; i < NACL_AIO_WORKERS; ++i) {
+    if (!NaClThreadCtor(&aio->workers[i], NaClAioWorker, aio,
+                        kNaClAioWorkerStackSize)) {
+      break;
+    }
+    ++started;
+  }
+  if (started < NACL_AIO_WORKERS) {
+    NaClLog(LOG_WARNING, "NaClAioNew: started only %d of %d workers\n",
+            started, NACL_AIO_WORKERS);
+  }
+  if (started > 0) {
+    return aio;
+  }
+
+  NaClCondVarDtor(&aio->done_cv);
+ cleanup_work_cv:
+  NaClCondVarDtor(&aio->work_cv);
+ cleanup_mu:
+  NaClMutexDtor(&aio->mu);
+ cleanup_aio:
+  free(aio);
+  return NULL;
+}
+
+/*
+ * Returns the app's aio state, creating it (and its worker threads) if
+ * create is set.  The state lives as long as the app.
+ */
+static struct NaClAio *NaClAioGet(struct NaClApp *nap, int create) {
+  struct NaClAio *aio;
+
+  NaClXMutexLock(&nap->mu);
+  aio = nap->aio;
+  if (NULL == aio && create) {
+    aio = NaClAioNew(nap);
+    nap->aio = aio;
+  }
+  NaClXMutexUnlock(&nap->mu);
+  return aio;
+}
+
+static struct NaClAioRing *NaClAioLookupMu(struct NaClAio *aio,
+                                           int32_t ring_id) {
+  if (ring_id < 0 || ring_id >= NACL_ABI_AIO_MAX_RINGS) {
+    return NULL;
+  }
+  return aio->rings[ring_id];
+}
+
+int32_t NaClSysAioSetup(struct NaClAppThread *natp,
+                        uint32_t ring_addr,
+                        uint32_t entries) {
+  struct NaClApp *nap = natp->nap;
+  struct NaClAio *aio;
+  struct NaClAioRing *ring;
+  struct nacl_abi_aio_ring header;
+  int32_t retval;
+  int32_t i;
+
+  NaClLog(3,
+          ("Entered NaClSysAioSetup(0x%08"NACL_PRIxPTR", 0x%08"NACL_PRIx32
+           ", %"NACL_PRIu32")\n"),
+          (uintptr_t) natp, ring_addr, entries);
+
+  if (0 == entries || entries > NACL_ABI_AIO_MAX_ENTRIES
+      || 0 != (entries & (entries - 1))) {
+    return -NACL_ABI_EINVAL;
+  }
+  if (0 != (ring_addr & 7)) {
+    return -NACL_ABI_EINVAL;
+  }
+  if (kNaClBadAddress == NaClUserToSysAddrRange(
+          nap, ring_addr, NACL_ABI_AIO_RING_SIZE(entries))) {
+    return -NACL_ABI_EFAULT;
+  }
+  memset(&header, 0, sizeof header);
+  header.entries = entries;
+  if (!NaClCopyOutToUser(nap, ring_addr, &header, sizeof header)) {
+    return -NACL_ABI_EFAULT;
+  }
+
+  aio = NaClAioGet(nap, 1);
+  if (NULL == aio) {
+    return -NACL_ABI_ENOMEM;
+  }
+  ring = (struct NaClAioRing *) malloc(sizeof *ring);
+  if (NULL == ring) {
+    return -NACL_ABI_ENOMEM;
+  }
+  memset(ring, 0, sizeof *ring);
+  ring->addr = ring_addr;
+  ring->entries = entries;
+  ring->done_head = NULL;
+  ring->done_tail = &ring->done_head;
+
+  retval = -NACL_ABI_EMFILE;
+  NaClXMutexLock(&aio->mu);
+  for (i = 0; i < NACL_ABI_AIO_MAX_RINGS; ++i) {
+    if (NULL == aio->rings[i]) {
+      aio->rings[i] = ring;
+      retval = i;
+      break;
+    }
+  }
+  NaClXMutexUnlock(&aio->mu);
+  if (retval < 0) {
+    free(ring);
+  }
+  return retval;
+}
+
+int32_t NaClSysAioEnter(struct NaClAppThread *natp,
+                        int32_t ring_id,
+                        uint32_t to_submit,
+                        uint32_t min_complete) {
+  struct NaClApp *nap = natp->nap;
+  struct NaClAio *aio;
+  struct NaClAioRing *ring;
+  struct NaClAioOp *op;
+  uint32_t sq_tail;
+  uint32_t cq_head;
+  uint32_t submitted = 0;
+  int32_t retval;
+
+  NaClLog(3,
+          ("Entered NaClSysAioEnter(0x%08"NACL_PRIxPTR", %d, %"NACL_PRIu32
+           ", %"NACL_PRIu32")\n"),
+          (uintptr_t) natp, (int) ring_id, to_submit, min_complete);
+
+  aio = NaClAioGet(nap, 0);
+  if (NULL == aio) {
+    return -NACL_ABI_EBADF;
+  }
+  NaClXMutexLock(&aio->mu);
+  ring = NaClAioLookupMu(aio, ring_id);
+  if (NULL == ring) {
+    retval = -NACL_ABI_EBADF;
+    goto cleanup;
+  }
+
+  if (!NaClCopyInFromUser(nap, &sq_tail,
+                          ring->addr + offsetof(struct nacl_abi_aio_ring,
+                                                sq_tail),
+                          sizeof sq_tail)) {
+    retval = -NACL_ABI_EFAULT;
+    goto cleanup;
+  }
+  if (sq_tail - ring->sq_head > ring->entries) {
+    retval = -NACL_ABI_EINVAL;
+    goto cleanup;
+  }
+  if (to_submit > sq_tail - ring->sq_head) {
+    to_submit = sq_tail - ring->sq_head;
+  }
+
+  /*
+   * Untrusted code may still be writing SQEs; whatever is copied in is
+   * checked as it stands, so a race only hurts the racing code.
+   */
+  retval = 0;
+  while (submitted < to_submit
+         && ring->running + ring->num_done < ring->entries) {
+    op = (struct NaClAioOp *) malloc(sizeof *op);
+    if (NULL == op) {
+      retval = -NACL_ABI_ENOMEM;
+      break;
+    }
+    if (!NaClCopyInFromUser(nap, &op->sqe,
+                            NaClAioSqeAddr(ring, ring->sq_head),
+                            sizeof op->sqe)) {
+      free(op);
+      retval = -NACL_ABI_EFAULT;
+      break;
+    }
+    op->next = NULL;
+    op->ring = ring;
+    op->ndp = NULL;
+    op->result = NaClAioStart(nap, op);
+    if (0 == op->result) {
+      *aio->queue_tail = op;
+      aio->queue_tail = &op->next;
+      ring->running++;
+    } else {
+      NaClAioAddDoneMu(ring, op);
+    }
+    ring->sq_head++;
+    submitted++;
+  }
+  if (submitted > 0) {
+    NaClXCondVarBroadcast(&aio->work_cv);
+    if (!NaClCopyOutToUser(nap,
+                           ring->addr + offsetof(struct nacl_abi_aio_ring,
+                                                 sq_head),
+                           &ring->sq_head, sizeof ring->sq_head)) {
+      retval = -NACL_ABI_EFAULT;
+    }
+  }
+  if (0 != retval && 0 == submitted) {
+    goto cleanup;
+  }
+
+  /* Untrusted code may have made room in the CQ since the last post. */
+  NaClAioPostCompletionsMu(nap, ring);
+  while (min_complete > 0 && !ring->destroying) {
+    if (!NaClCopyInFromUser(nap, &cq_head,
+                            ring->addr + offsetof(struct nacl_abi_aio_ring,
+                                                  cq_head),
+                            sizeof cq_head)) {
+      break;
+    }
+    if (ring->cq_tail - cq_head >= min_complete || 0 == ring->running) {
+      break;
+    }
+    ring->waiters++;
+    NaClXCondVarWait(&aio->done_cv, &aio->mu);
+    ring->waiters--;
+  }
+  if (ring->destroying && 0 == ring->waiters) {
+    NaClXCondVarBroadcast(&aio->done_cv);
+  }
+  retval = (int32_t) submitted;
+
+ cleanup:
+  NaClXMutexUnlock(&aio->mu);
+  return retval;
+}
+
+int32_t NaClSysAioDestroy(struct NaClAppThread *natp,
+                          int32_t ring_id) {
+  struct NaClApp *nap = natp->nap;
+  struct NaClAio *aio;
+  struct NaClAioRing *ring;
+  struct NaClAioOp *op;
+
+  NaClLog(3, "Entered NaClSysAioDestroy(0x%08"NACL_PRIxPTR", %d)\n",
+          (uintptr_t) natp, (int) ring_id);
+
+  aio = NaClAioGet(nap, 0);
+  if (NULL == aio) {
+    return -NACL_ABI_EBADF;
+  }
+  NaClXMutexLock(&aio->mu);
+  ring = NaClAioLookupMu(aio, ring_id);
+  if (NULL == ring) {
+    NaClXMutexUnlock(&aio->mu);
+    return -NACL_ABI_EBADF;
+  }
+  aio->rings[ring_id] = NULL;
+  ring->destroying = 1;
+  NaClXCondVarBroadcast(&aio->done_cv);
+  while (ring->running > 0 || ring->waiters > 0) {
+    NaClXCondVarWait(&aio->done_cv, &aio->mu);
+  }
+  NaClXMutexUnlock(&aio->mu);
+
+  while (NULL != ring->done_head) {
+    op = ring->done_head;
+    ring->done_head = op->next;
+    free(op);
+  }
+  free(ring);
+  return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl service run-time, asynchronous I/O system calls.
+ *
+ * Untrusted code queues pread, pwrite and fsync requests in a ring in
+ * its own memory (see include/sys/nacl_aio.h) and hands them to the
+ * service runtime with aio_enter.  A pool of trusted worker threads
+ * performs them and posts completions back to the ring, so a thread can
+ * keep many requests in flight with one syscall per batch.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_SYS_AIO_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_SYS_AIO_H_
+
+#include "native_client/src/include/portability.h"
+
+struct NaClAppThread;
+
+/*
+ * Registers the ring at ring_addr, which must be NACL_ABI_AIO_RING_SIZE
+ * bytes and 8-byte aligned.  entries must be a power of two no larger
+ * than NACL_ABI_AIO_MAX_ENTRIES.  The ring's indices are reset to 0.
+ * Returns a ring id on success.
+ */
+int32_t NaClSysAioSetup(struct NaClAppThread *natp,
+                        uint32_t ring_addr,
+                        uint32_t entries);
+
+/*
+ * Accepts up to to_submit SQEs between sq_head and sq_tail, then waits
+ * until at least min_complete CQEs are available to untrusted code or
+ * no more can arrive.  Returns the number of SQEs accepted.  An SQE
+ * that cannot be started (bad descriptor, opcode or buffer) is still
+ * accepted, and completes with an error.
+ */
+int32_t NaClSysAioEnter(struct NaClAppThread *natp,
+                        int32_t ring_id,
+                        uint32_t to_submit,
+                        uint32_t min_complete);
+
+/*
+ * Waits for the ring's outstanding requests to finish, then forgets
+ * the ring.  Completions not yet posted to the ring are discarded.
+ */
+int32_t NaClSysAioDestroy(struct NaClAppThread *natp,
+                          int32_t ring_id);
+
+#endif
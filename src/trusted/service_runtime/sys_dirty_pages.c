@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/trusted/service_runtime/sys_dirty_pages.h"
+
+#include "native_client/src/shared/platform/nacl_log.h"
+#include "native_client/src/shared/platform/nacl_sync_checked.h"
+#include "native_client/src/trusted/service_runtime/include/sys/errno.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_dirty_pages.h"
+#include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
+#include "native_client/src/trusted/service_runtime/nacl_copy.h"
+#include "native_client/src/trusted/service_runtime/nacl_dirty_pages.h"
+#include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
+#include "native_client/src/trusted/service_runtime/sel_ldr.h"
+
+static int32_t NaClDirtyPagesCount(uint8_t const *bitmap, size_t bytes) {
+  int32_t count = 0;
+  size_t ix;
+  uint8_t bits;
+
+  for (ix = 0; ix < bytes; ++ix) {
+    for (bits = bitmap[ix]; 0 != bits; bits &= bits - 1) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+int32_t NaClSysGetDirtyPages(struct NaClAppThread  *natp,
+                             uint32_t              start,
+                             uint32_t              length,
+                             uint32_t              bitmap_addr,
+                             uint32_t              flags) {
+  struct NaClApp  *nap = natp->nap;
+  int32_t         retval;
+  uintptr_t       sysaddr;
+  size_t          num_pages;
+  size_t          bitmap_bytes;
+  uint8_t         *bitmap = NULL;
+  int             scanned;
+
+  NaClLog(3,
+          ("Entered NaClSysGetDirtyPages(0x%08"NACL_PRIxPTR", 0x%08"
+           NACL_PRIx32", 0x%"NACL_PRIx32", 0x%08"NACL_PRIx32", 0x%"
+           NACL_PRIx32")\n"),
+          (uintptr_t) natp, start, length, bitmap_addr, flags);
+
+  if (0 != (flags & ~NACL_ABI_DIRTY_PAGES_EXACT) ||
+      0 != (start & (NACL_ABI_DIRTY_PAGE_SIZE - 1)) ||
+      0 == length) {
+    return -NACL_ABI_EINVAL;
+  }
+  num_pages = ((length >> NACL_ABI_DIRTY_PAGE_SHIFT) +
+               (0 != (length & (NACL_ABI_DIRTY_PAGE_SIZE - 1))));
+  if (((uint64_t) start + ((uint64_t) num_pages << NACL_ABI_DIRTY_PAGE_SHIFT))
+      > ((uint64_t) 1 << nap->addr_bits)) {
+    return -NACL_ABI_EFAULT;
+  }
+  sysaddr = NaClUserToSysAddrRange(nap, start,
+                                   num_pages << NACL_ABI_DIRTY_PAGE_SHIFT);
+  bitmap_bytes = (num_pages + 7) / 8;
+  /*
+   * Check the bitmap before the scan, which forgets what it reports.
+   * Only an unmap racing with this call can make the copy out fail.
+   */
+  if (kNaClBadAddress == sysaddr ||
+      kNaClBadAddress == NaClUserToSysAddrRange(nap, bitmap_addr,
+                                                bitmap_bytes)) {
+    return -NACL_ABI_EFAULT;
+  }
+  bitmap = (uint8_t *) calloc(bitmap_bytes, 1);
+  if (NULL == bitmap) {
+    return -NACL_ABI_ENOMEM;
+  }
+
+  NaClXMutexLock(&nap->mu);
+  if (NaClSysCommonAddrRangeContainsExecutablePages(
+          nap, start, num_pages << NACL_ABI_DIRTY_PAGE_SHIFT)) {
+    NaClXMutexUnlock(&nap->mu);
+    retval = -NACL_ABI_EACCES;
+    goto cleanup;
+  }
+  scanned = NaClDirtyPagesScanMu(nap, sysaddr, num_pages, bitmap);
+  NaClXMutexUnlock(&nap->mu);
+
+  if (scanned < 0 && 0 != (flags & NACL_ABI_DIRTY_PAGES_EXACT)) {
+    retval = -NACL_ABI_ENOSYS;
+    goto cleanup;
+  }
+  if (scanned <= 0) {
+    memset(bitmap, 0xff, bitmap_bytes);
+    if (0 != (num_pages & 7)) {
+      bitmap[bitmap_bytes - 1] = (uint8_t) ((1 << (num_pages & 7)) - 1);
+    }
+  }
+  retval = NaClDirtyPagesCount(bitmap, bitmap_bytes);
+  if (!NaClCopyOutToUser(nap, bitmap_addr, bitmap, bitmap_bytes)) {
+    retval = -NACL_ABI_EFAULT;
+  }
+
+ cleanup:
+  free(bitmap);
+  return retval;
+}
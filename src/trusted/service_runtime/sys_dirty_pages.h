@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * NaCl service run-time, get_dirty_pages system call.
+ *
+ * Lets an untrusted garbage collector find the pages written since its
+ * last collection without an mprotect-and-fault write barrier; see
+ * include/sys/nacl_dirty_pages.h.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_SYS_DIRTY_PAGES_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_SYS_DIRTY_PAGES_H_
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+
+EXTERN_C_BEGIN
+
+struct NaClAppThread;
+
+/*
+ * Stores a bitmap of the pages of [start, start + length) written since
+ * the last call at bitmap_addr, one bit per NACL_ABI_DIRTY_PAGE_SIZE
+ * page, and returns the number of dirty pages.  start must be page
+ * aligned, and the range may not contain executable pages.
+ */
+int32_t NaClSysGetDirtyPages(struct NaClAppThread  *natp,
+                             uint32_t              start,
+                             uint32_t              length,
+                             uint32_t              bitmap_addr,
+                             uint32_t              flags);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_SERVICE_RUNTIME_SYS_DIRTY_PAGES_H_ */
@@ -10,6 +10,7 @@
 #include "native_client/src/trusted/service_runtime/include/sys/errno.h"
 #include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
 #include "native_client/src/trusted/service_runtime/nacl_copy.h"
+#include "native_client/src/trusted/service_runtime/nacl_signal.h"
 #include "native_client/src/trusted/service_runtime/sel_ldr.h"
 #include "native_client/src/trusted/service_runtime/win/debug_exception_handler.h"
 
@@ -66,6 +67,12 @@ int32_t NaClSysExceptionStack(struct NaClAppThread *natp,
                                                    stack_addr + stack_size)) {
     return -NACL_ABI_EINVAL;
   }
+  /*
+   * A fault cannot be delivered to this thread between these two
+   * assignments, because the thread is running trusted code.
+   */
+  natp->exception_frame_ptr =
+      NaClSignalExceptionFramePtr(stack_addr + stack_size);
   natp->exception_stack = stack_addr + stack_size;
   return 0;
 }
@@ -6,6 +6,7 @@
 
 #include "native_client/src/trusted/service_runtime/sys_fdio.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "native_client/src/trusted/desc/nacl_desc_base.h"
@@ -205,6 +206,66 @@ cleanup:
   return retval;
 }
 
+int32_t NaClSysGetdentsPlus(struct NaClAppThread *natp,
+                            int                  d,
+                            uint32_t             dirp,
+                            size_t               count) {
+  struct NaClApp  *nap = natp->nap;
+  int32_t         retval = -NACL_ABI_EINVAL;
+  ssize_t         getdents_ret;
+  uintptr_t       sysaddr;
+  struct NaClDesc *ndp;
+
+  NaClLog(3,
+          ("Entered NaClSysGetdentsPlus(0x%08"NACL_PRIxPTR", "
+           "%d, 0x%08"NACL_PRIx32", "
+           "%"NACL_PRIuS"[0x%"NACL_PRIxS"])\n"),
+          (uintptr_t) natp, d, dirp, count, count);
+
+  if (!NaClFileAccessEnabled()) {
+    /* As for getdents. */
+    return -NACL_ABI_EACCES;
+  }
+
+  ndp = NaClAppGetDesc(nap, d);
+  if (NULL == ndp) {
+    retval = -NACL_ABI_EBADF;
+    goto cleanup;
+  }
+  if (0 == count) {
+    /* Too small for any entry; also keeps the NaClVmIo range valid. */
+    retval = -NACL_ABI_EINVAL;
+    goto cleanup_unref;
+  }
+  sysaddr = NaClUserToSysAddrRange(nap, dirp, count);
+  if (kNaClBadAddress == sysaddr) {
+    NaClLog(4, " illegal address for directory data\n");
+    retval = -NACL_ABI_EFAULT;
+    goto cleanup_unref;
+  }
+  if (count > INT32_MAX) {
+    count = INT32_MAX;
+  }
+
+  /*
+   * Unlike getdents, this stats every entry, which can take a while,
+   * so register the buffer as in use rather than holding nap->mu.
+   */
+  NaClVmIoWillStart(nap, dirp, dirp + (uint32_t) count - 1);
+  getdents_ret = (*NACL_VTBL(NaClDesc, ndp)->
+                  GetdentsPlus)(ndp, (void *) sysaddr, count);
+  NaClVmIoHasEnded(nap, dirp, dirp + (uint32_t) count - 1);
+  /* getdents_ret is at most count, which was clamped above. */
+  retval = (int32_t) getdents_ret;
+  NaClLog(4, "getdents_plus returned %d\n", retval);
+
+cleanup_unref:
+  NaClDescUnref(ndp);
+
+cleanup:
+  return retval;
+}
+
 int32_t NaClSysRead(struct NaClAppThread  *natp,
                     int                   d,
                     uint32_t              buf,
@@ -344,6 +405,132 @@ cleanup:
   return retval;
 }
 
+int32_t NaClSysIoVecCopyIn(struct NaClSysIoVec  *self,
+                           struct NaClApp       *nap,
+                           uint32_t             iov_addr,
+                           uint32_t             iovcnt) {
+  uint32_t  total = 0;
+  uintptr_t sysaddr;
+  size_t    i;
+
+  self->iov = self->inline_iov;
+  self->user_iov = self->inline_user_iov;
+  self->count = 0;
+  if (iovcnt > NACL_ABI_IOV_MAX) {
+    return -NACL_ABI_EINVAL;
+  }
+  if (iovcnt > NACL_SYS_IOVEC_INLINE) {
+    self->iov = malloc(iovcnt * sizeof *self->iov);
+    self->user_iov = malloc(iovcnt * sizeof *self->user_iov);
+    if (NULL == self->iov || NULL == self->user_iov) {
+      NaClSysIoVecDtor(self);
+      return -NACL_ABI_ENOMEM;
+    }
+  }
+  if (!NaClCopyInFromUser(nap, self->user_iov, (uintptr_t) iov_addr,
+                          iovcnt * sizeof *self->user_iov)) {
+    NaClSysIoVecDtor(self);
+    return -NACL_ABI_EFAULT;
+  }
+  /*
+   * The untrusted segments were copied in above, so they cannot
+   * change under us after being checked here.
+   */
+  for (i = 0; i < iovcnt; ++i) {
+    uint32_t length = self->user_iov[i].length;
+
+    if (length > INT32_MAX - total) {
+      length = INT32_MAX - total;
+      self->user_iov[i].length = length;
+    }
+    sysaddr = NaClUserToSysAddrRange(nap, self->user_iov[i].base, length);
+    if (kNaClBadAddress == sysaddr) {
+      NaClSysIoVecDtor(self);
+      return -NACL_ABI_EFAULT;
+    }
+    self->iov[i].base = (void *) sysaddr;
+    self->iov[i].length = length;
+    total += length;
+    if (INT32_MAX == total) {
+      ++i;
+      break;
+    }
+  }
+  self->count = i;
+  return 0;
+}
+
+void NaClSysIoVecDtor(struct NaClSysIoVec *self) {
+  if (self->iov != self->inline_iov) {
+    free(self->iov);
+  }
+  if (self->user_iov != self->inline_user_iov) {
+    free(self->user_iov);
+  }
+  self->iov = NULL;
+  self->user_iov = NULL;
+  self->count = 0;
+}
+
+static int32_t NaClSysVectorIo(struct NaClAppThread *natp,
+                               int                  d,
+                               uint32_t             iov_addr,
+                               uint32_t             iovcnt,
+                               int                  is_write) {
+  struct NaClApp      *nap = natp->nap;
+  struct NaClDesc     *ndp;
+  struct NaClSysIoVec iov;
+  int32_t             retval;
+  ssize_t             result;
+
+  ndp = NaClAppGetDesc(nap, d);
+  if (NULL == ndp) {
+    return -NACL_ABI_EBADF;
+  }
+  retval = NaClSysIoVecCopyIn(&iov, nap, iov_addr, iovcnt);
+  if (0 != retval) {
+    NaClDescUnref(ndp);
+    return retval;
+  }
+
+  NaClVmIoWillStartVec(nap, iov.user_iov, iov.count);
+  if (is_write) {
+    result = (*NACL_VTBL(NaClDesc, ndp)->Writev)(ndp, iov.iov, iov.count);
+  } else {
+    result = (*NACL_VTBL(NaClDesc, ndp)->Readv)(ndp, iov.iov, iov.count);
+  }
+  NaClVmIoHasEndedVec(nap, iov.user_iov, iov.count);
+  NaClLog(4, "%s returned %"NACL_PRIdS"\n",
+          is_write ? "writev" : "readv", result);
+
+  NaClSysIoVecDtor(&iov);
+  NaClDescUnref(ndp);
+  /* This cast is safe because NaClSysIoVecCopyIn clamped the length. */
+  return (int32_t) result;
+}
+
+int32_t NaClSysReadv(struct NaClAppThread *natp,
+                     int                  d,
+                     uint32_t             iov,
+                     uint32_t             iovcnt) {
+  NaClLog(3,
+          ("Entered NaClSysReadv(0x%08"NACL_PRIxPTR", "
+           "%d, 0x%08"NACL_PRIx32", %"NACL_PRIu32")\n"),
+          (uintptr_t) natp, d, iov, iovcnt);
+  return NaClSysVectorIo(natp, d, iov, iovcnt, 0);
+}
+
+int32_t NaClSysWritev(struct NaClAppThread  *natp,
+                      int                   d,
+                      uint32_t              iov,
+                      uint32_t              iovcnt) {
+  NaClLog(3,
+          ("Entered NaClSysWritev(0x%08"NACL_PRIxPTR", "
+           "%d, 0x%08"NACL_PRIx32", %"NACL_PRIu32")\n"),
+          (uintptr_t) natp, d, iov, iovcnt);
+  return NaClSysVectorIo(natp, d, iov, iovcnt, 1);
+}
+
 /*
  * This implements 64-bit offsets, so we use |offp| as an in/out
  * address so we can have a 64 bit return value.
@@ -9,7 +9,9 @@
 
 #include "native_client/src/include/nacl_base.h"
 #include "native_client/src/include/portability.h"
+#include "native_client/src/public/imc_types.h"
 #include "native_client/src/trusted/service_runtime/include/machine/_types.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_iovec.h"
 
 EXTERN_C_BEGIN
 
@@ -37,6 +39,16 @@ int32_t NaClSysWrite(struct NaClAppThread *natp,
                      uint32_t             buf,
                      uint32_t             count);
 
+int32_t NaClSysReadv(struct NaClAppThread *natp,
+                     int                  d,
+                     uint32_t             iov,
+                     uint32_t             iovcnt);
+
+int32_t NaClSysWritev(struct NaClAppThread  *natp,
+                      int                   d,
+                      uint32_t              iov,
+                      uint32_t              iovcnt);
+
 int32_t NaClSysLseek(struct NaClAppThread *natp,
                      int                  d,
                      uint32_t             offp,
@@ -51,6 +63,11 @@ int32_t NaClSysGetdents(struct NaClAppThread  *natp,
                         uint32_t              dirp,
                         size_t                count);
 
+int32_t NaClSysGetdentsPlus(struct NaClAppThread *natp,
+                            int                  d,
+                            uint32_t             dirp,
+                            size_t               count);
+
 int32_t NaClSysFchdir(struct NaClAppThread *natp,
                       int                  d);
 
@@ -71,6 +88,41 @@ int32_t NaClSysFtruncate(struct NaClAppThread *natp,
 int32_t NaClSysIsatty(struct NaClAppThread *natp,
                       int                  d);
 
+/*
+ * Vectors with up to this many segments are held in NaClSysIoVec
+ * itself rather than on the heap.
+ */
+#define NACL_SYS_IOVEC_INLINE 8
+
+/*
+ * An untrusted scatter/gather vector that has been copied into
+ * trusted memory and validated.
+ */
+struct NaClSysIoVec {
+  /* Segments as trusted addresses, for NaClDesc Readv/Writev. */
+  struct NaClImcMsgIoVec  *iov;
+  /* The same segments as untrusted addresses, for NaClVmIoWillStartVec. */
+  struct NaClUserIoVec    *user_iov;
+  size_t                  count;
+  struct NaClImcMsgIoVec  inline_iov[NACL_SYS_IOVEC_INLINE];
+  struct NaClUserIoVec    inline_user_iov[NACL_SYS_IOVEC_INLINE];
+};
+
+/*
+ * Copies in and validates the iovcnt-element struct NaClUserIoVec
+ * array at untrusted address iov_addr.  The total length is clamped
+ * to INT32_MAX, like the count argument of read and write, by
+ * shortening or dropping the trailing segments.  Returns 0 on
+ * success, or a negated NaCl ABI errno value, in which case there is
+ * nothing to free.
+ */
+int32_t NaClSysIoVecCopyIn(struct NaClSysIoVec  *self,
+                           struct NaClApp       *nap,
+                           uint32_t             iov_addr,
+                           uint32_t             iovcnt);
+
+void NaClSysIoVecDtor(struct NaClSysIoVec *self);
+
 EXTERN_C_END
 
 #endif
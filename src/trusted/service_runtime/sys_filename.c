@@ -126,6 +126,8 @@ int32_t NaClSysOpen(struct NaClAppThread  *natp,
          */
         NaClDescSetFlags(desc,
                          NaClDescGetFlags(desc) | NACL_DESC_FLAGS_MMAP_EXEC_OK);
+      } else if (0 != (flags & NACL_ABI_O_APPEND)) {
+        desc = NaClAppMaybeBufferDesc(nap, desc);
       }
       retval = NaClAppSetDescAvail(nap, desc);
       NaClLog(1, "Entered into open file table at %d\n", retval);
@@ -14,6 +14,7 @@
 
 #include "native_client/src/include/nacl_platform.h"
 #include "native_client/src/include/portability_string.h"
+#include "native_client/src/shared/platform/nacl_check.h"
 #include "native_client/src/shared/platform/nacl_sync_checked.h"
 #include "native_client/src/trusted/desc/nacl_desc_io.h"
 #include "native_client/src/trusted/service_runtime/include/bits/mman.h"
@@ -30,6 +31,20 @@ struct NaClSysListMappingsState {
   uint32_t count;
   uint32_t capacity;
   int out_of_memory;
+  /* Mappings are clipped to [clip_start, clip_end). */
+  uint64_t clip_start;
+  uint64_t clip_end;
+};
+
+/* A range of pages whose mappings changed. */
+struct NaClSysListMappingsRange {
+  uintptr_t page_num;
+  uintptr_t end_page;
+};
+
+struct NaClSysListMappingsChanges {
+  struct NaClSysListMappingsRange ranges[NACL_VMMAP_CHANGE_LOG_SIZE];
+  size_t count;
 };
 
 static const int kStartCapacity = 8;
@@ -77,6 +92,31 @@ static void NaClSysListMappingsAdd(struct NaClSysListMappingsState *state,
   info->vmmap_type = vmmap_type;
 }
 
+/* Like NaClSysListMappingsAdd, but clips the mapping to the state's range. */
+static void NaClSysListMappingsAddClipped(
+    struct NaClSysListMappingsState *state,
+    uint32_t start,
+    uint32_t size,
+    uint32_t prot,
+    uint32_t max_prot,
+    uint32_t vmmap_type) {
+  uint64_t clipped_start = start;
+  uint64_t clipped_end = (uint64_t) start + size;
+
+  if (clipped_start < state->clip_start) {
+    clipped_start = state->clip_start;
+  }
+  if (clipped_end > state->clip_end) {
+    clipped_end = state->clip_end;
+  }
+  if (clipped_end <= clipped_start) {
+    return;
+  }
+  NaClSysListMappingsAdd(state, (uint32_t) clipped_start,
+                         (uint32_t) (clipped_end - clipped_start),
+                         prot, max_prot, vmmap_type);
+}
+
 static int NaClSysListMappingsOrder(const void *a, const void *b) {
   const struct NaClMemMappingInfo *am = (const struct NaClMemMappingInfo *) a;
   const struct NaClMemMappingInfo *bm = (const struct NaClMemMappingInfo *) b;
@@ -99,7 +139,7 @@ static void NaClSysListMappingsVisit(void *statev,
       state->nap->dynamic_text_end == start + size) {
     return;
   }
-  NaClSysListMappingsAdd(
+  NaClSysListMappingsAddClipped(
       state,
       /* start= */ start,
       /* size= */ size,
@@ -113,7 +153,7 @@ static void NaClSysListMappingsDyncodeVisit(void *statev,
   struct NaClSysListMappingsState *state =
       (struct NaClSysListMappingsState *) statev;
 
-  NaClSysListMappingsAdd(
+  NaClSysListMappingsAddClipped(
       state,
       /* start= */ (uint32_t) NaClSysToUser(state->nap, rg->start),
       /* size= */ (uint32_t) rg->size,
@@ -137,6 +177,8 @@ int32_t NaClSysListMappings(struct NaClAppThread *natp,
   state.capacity = 0;
   state.out_of_memory = 0;
   state.regions = NULL;
+  state.clip_start = 0;
+  state.clip_end = (uint64_t) 1 << nap->addr_bits;
 
   NaClXMutexLock(&nap->mu);
   NaClVmmapVisit(&nap->mem_map, NaClSysListMappingsVisit, &state);
@@ -164,3 +206,145 @@ int32_t NaClSysListMappings(struct NaClAppThread *natp,
 
   return state.count;
 }
+
+static void NaClSysListMappingsNoteChange(void *changesv,
+                                          uintptr_t page_num,
+                                          size_t npages) {
+  struct NaClSysListMappingsChanges *changes =
+      (struct NaClSysListMappingsChanges *) changesv;
+
+  /* NaClVmmapVisitChanges reports at most NACL_VMMAP_CHANGE_LOG_SIZE. */
+  CHECK(changes->count < NACL_VMMAP_CHANGE_LOG_SIZE);
+  changes->ranges[changes->count].page_num = page_num;
+  changes->ranges[changes->count].end_page = page_num + npages;
+  ++changes->count;
+}
+
+static int NaClSysListMappingsRangeOrder(const void *a, const void *b) {
+  const struct NaClSysListMappingsRange *ar =
+      (const struct NaClSysListMappingsRange *) a;
+  const struct NaClSysListMappingsRange *br =
+      (const struct NaClSysListMappingsRange *) b;
+
+  if (ar->page_num < br->page_num) return -1;
+  if (ar->page_num > br->page_num) return 1;
+  return 0;
+}
+
+/* Sorts the ranges and merges the ones that overlap or touch. */
+static void NaClSysListMappingsCoalesce(
+    struct NaClSysListMappingsChanges *changes) {
+  size_t i;
+  size_t out = 0;
+
+  qsort(changes->ranges, changes->count, sizeof(changes->ranges[0]),
+        NaClSysListMappingsRangeOrder);
+  for (i = 0; i < changes->count; ++i) {
+    struct NaClSysListMappingsRange *range = &changes->ranges[i];
+    if (out > 0 && range->page_num <= changes->ranges[out - 1].end_page) {
+      if (range->end_page > changes->ranges[out - 1].end_page) {
+        changes->ranges[out - 1].end_page = range->end_page;
+      }
+    } else {
+      changes->ranges[out++] = *range;
+    }
+  }
+  changes->count = out;
+}
+
+int32_t NaClSysListMappingChanges(struct NaClAppThread *natp,
+                                  uint32_t generation_addr,
+                                  uint32_t regions,
+                                  uint32_t count) {
+  struct NaClApp *nap = natp->nap;
+  struct NaClSysListMappingsState state;
+  struct NaClSysListMappingsChanges changes;
+  uintptr_t all_pages = (uintptr_t) 1 << (nap->addr_bits - NACL_PAGESHIFT);
+  uint32_t generation;
+  uint32_t current;
+  size_t i;
+
+  if (!nap->enable_list_mappings) {
+    return -NACL_ABI_ENOSYS;
+  }
+  if (!NaClCopyInFromUser(nap, &generation, generation_addr,
+                          sizeof(generation))) {
+    return -NACL_ABI_EFAULT;
+  }
+
+  state.nap = nap;
+  state.count = 0;
+  state.capacity = 0;
+  state.out_of_memory = 0;
+  state.regions = NULL;
+
+  NaClXMutexLock(&nap->mu);
+  current = nap->mem_map.generation;
+  if (generation == current) {
+    NaClXMutexUnlock(&nap->mu);
+    return 0;
+  }
+
+  changes.count = 0;
+  if (!NaClVmmapVisitChanges(&nap->mem_map, generation,
+                             NaClSysListMappingsNoteChange, &changes)) {
+    changes.count = 1;
+    changes.ranges[0].page_num = 0;
+    changes.ranges[0].end_page = all_pages;
+  }
+  NaClSysListMappingsCoalesce(&changes);
+
+  for (i = 0; i < changes.count; ++i) {
+    struct NaClSysListMappingsRange *range = &changes.ranges[i];
+    uint64_t size;
+    uint32_t first;
+
+    state.clip_start = (uint64_t) range->page_num << NACL_PAGESHIFT;
+    state.clip_end = (uint64_t) range->end_page << NACL_PAGESHIFT;
+    size = state.clip_end - state.clip_start;
+    /*
+     * The whole 4GB address space of x86-64 does not fit in 32 bits, so
+     * a marker covering it has a size of 0 instead.
+     */
+    NaClSysListMappingsAdd(
+        &state,
+        /* start= */ (uint32_t) state.clip_start,
+        /* size= */ size > UINT32_MAX ? 0 : (uint32_t) size,
+        /* prot= */ 0,
+        /* max_prot= */ 0,
+        /* vmmap_type= */ NACL_ABI_MAPPING_CHANGED_RANGE);
+    first = state.count;
+    NaClVmmapVisitRange(&nap->mem_map, range->page_num,
+                        range->end_page - range->page_num,
+                        NaClSysListMappingsVisit, &state);
+    NaClDyncodeVisitRange(nap, nap->mem_start + (uintptr_t) state.clip_start,
+                          (size_t) (state.clip_end - state.clip_start),
+                          NaClSysListMappingsDyncodeVisit, &state);
+    if (!state.out_of_memory) {
+      qsort(state.regions + first, state.count - first,
+            sizeof(*state.regions), NaClSysListMappingsOrder);
+    }
+  }
+  NaClXMutexUnlock(&nap->mu);
+
+  if (state.out_of_memory) {
+    NaClLog(3, "Out of memory while gathering memory map changes\n");
+    free(state.regions);
+    return -NACL_ABI_ENOMEM;
+  }
+
+  if (state.count <= count) {
+    if (!NaClCopyOutToUser(nap, regions, state.regions,
+                           sizeof(*state.regions) * state.count) ||
+        !NaClCopyOutToUser(nap, generation_addr, &current,
+                           sizeof(current))) {
+      NaClLog(3, "Illegal address for ListMappingChanges at 0x%08"
+              NACL_PRIxPTR"\n", (uintptr_t) regions);
+      free(state.regions);
+      return -NACL_ABI_EFAULT;
+    }
+  }
+  free(state.regions);
+
+  return state.count;
+}
@@ -25,6 +25,17 @@ int32_t NaClSysListMappings(struct NaClAppThread *natp,
                             uint32_t             regions,
                             uint32_t             count);
 
+/*
+ * Lists what changed in the memory map since the generation stored at
+ * generation_addr, which the caller got from a previous call or from
+ * sysconf(NACL_ABI__SC_NACL_MAPPING_GENERATION).  See
+ * include/sys/nacl_list_mappings.h for the format of the result.
+ */
+int32_t NaClSysListMappingChanges(struct NaClAppThread *natp,
+                                  uint32_t             generation_addr,
+                                  uint32_t             regions,
+                                  uint32_t             count);
+
 EXTERN_C_END
 
 #endif  /* NATIVE_CLIENT_SERVICE_RUNTIME_NACL_SYS_LIST_MAPPINGS_H__ */
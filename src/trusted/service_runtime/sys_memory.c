@@ -24,8 +24,10 @@
 #include "native_client/src/trusted/service_runtime/internal_errno.h"
 #include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
 #include "native_client/src/trusted/service_runtime/nacl_copy.h"
+#include "native_client/src/trusted/service_runtime/nacl_globals.h"
 #include "native_client/src/trusted/service_runtime/nacl_syscall_common.h"
 #include "native_client/src/trusted/service_runtime/nacl_text.h"
+#include "native_client/src/trusted/service_runtime/sel_addrspace.h"
 #include "native_client/src/trusted/service_runtime/sel_ldr.h"
 #include "native_client/src/trusted/service_runtime/sel_memory.h"
 #include "native_client/src/trusted/validator/validation_metadata.h"
@@ -173,6 +175,12 @@ int32_t NaClSysBrk(struct NaClAppThread *natp,
                 start_new_region,
                 region_size);
       }
+      if (NaClAdviseHugePages(nap,
+                              NaClUserToSys(nap,
+                                            ent->page_num << NACL_PAGESHIFT),
+                              ent->npages << NACL_PAGESHIFT)) {
+        ent->flags |= NACL_MAP_HUGE_PAGES;
+      }
       NaClLog(4, "segment now: page_num 0x%08"NACL_PRIxPTR", "
               "npages 0x%"NACL_PRIxS"\n",
               ent->page_num, ent->npages);
@@ -728,6 +736,31 @@ int32_t NaClSysMmapIntern(struct NaClApp        *nap,
       val_flags = nap->pnacl_mode ? NACL_DISABLE_NONTEMPORALS_X86 : 0;
       /* Ask validator / validation cache */
       NaClMetadataFromNaClDescCtor(&metadata, ndp);
+      if (NaClCodeIdentityFile != metadata.identity_type &&
+          NULL != nap->validation_cache &&
+          nap->validation_cache == nacl_validation_cache_memory) {
+        /*
+         * Without origin information the code could only be identified
+         * by its contents, which is too large a key to cache.  The
+         * in-memory cache does not outlive this process, so it can use
+         * the host file's device and inode instead.
+         */
+        NaClMetadataDtor(&metadata);
+        NaClMetadataFromHostFDCtor(&metadata,
+                                   ((struct NaClDescIoDesc *) ndp)->hd->d);
+      }
+      if (NaClCodeIdentityFile == metadata.identity_type) {
+        /*
+         * The cache is keyed on the range of the file being mapped.  A
+         * range extending past the end of the file cannot be identified
+         * by the file alone, so identify it by its contents instead.
+         */
+        if (offset + (nacl_off64_t) length <= metadata.file_size) {
+          metadata.code_offset = offset;
+        } else {
+          NaClMetadataDtor(&metadata);
+        }
+      }
       validator_status = NACL_FI("MMAP_FORCE_MMAP_VALIDATION_FAIL",
                                  (*nap->validator->
                                   Validate)(usraddr,
@@ -904,6 +937,10 @@ int32_t NaClSysMmapIntern(struct NaClApp        *nap,
     }
   }
 
+  if (NULL == ndp && NaClAdviseHugePages(nap, sysaddr, alloc_rounded_length)) {
+    flags |= NACL_MAP_HUGE_PAGES;
+  }
+
   if (alloc_rounded_length > 0) {
     NaClVmmapAddWithOverwrite(&nap->mem_map,
                               NaClSysToUser(nap, sysaddr) >> NACL_PAGESHIFT,
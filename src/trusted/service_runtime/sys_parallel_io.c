@@ -20,6 +20,7 @@
 #include "native_client/src/trusted/service_runtime/nacl_app_thread.h"
 #include "native_client/src/trusted/service_runtime/nacl_copy.h"
 #include "native_client/src/trusted/service_runtime/sel_ldr.h"
+#include "native_client/src/trusted/service_runtime/sys_fdio.h"
 
 int32_t NaClSysPRead(struct NaClAppThread *natp,
                      int32_t desc,
@@ -118,3 +119,72 @@ int32_t NaClSysPWrite(struct NaClAppThread *natp,
   NaClDescSafeUnref(ndp);
   return retval;
 }
+
+/*
+ * NaClDesc has no positional scatter/gather method, so this issues
+ * one PRead per segment.  That still saves untrusted code a
+ * trampoline crossing and descriptor lookup per segment.
+ */
+int32_t NaClSysPReadv(struct NaClAppThread *natp,
+                      int32_t desc,
+                      uint32_t iov_addr,
+                      uint32_t iovcnt,
+                      uint32_t offset_addr) {
+  struct NaClApp *nap = natp->nap;
+  struct NaClDesc *ndp = NULL;
+  struct NaClSysIoVec iov;
+  nacl_abi_off64_t offset;
+  int32_t retval = -NACL_ABI_EINVAL;
+  ssize_t pread_result;
+  ssize_t total = 0;
+  size_t i;
+
+  NaClLog(3,
+          ("Entered NaClSysPReadv(0x%08"NACL_PRIxPTR", %d, 0x%08"NACL_PRIx32
+           ", %"NACL_PRIu32", 0x%08"NACL_PRIx32")\n"),
+          (uintptr_t) natp, (int) desc, iov_addr, iovcnt, offset_addr);
+  ndp = NaClAppGetDesc(nap, (int) desc);
+  if (NULL == ndp) {
+    retval = -NACL_ABI_EBADF;
+    goto cleanup;
+  }
+  if (!NaClCopyInFromUser(nap, &offset, (uintptr_t) offset_addr,
+                          sizeof offset)) {
+    retval = -NACL_ABI_EFAULT;
+    goto cleanup;
+  }
+  if (offset < 0) {
+    retval = -NACL_ABI_EINVAL;
+    goto cleanup;
+  }
+  retval = NaClSysIoVecCopyIn(&iov, nap, iov_addr, iovcnt);
+  if (0 != retval) {
+    goto cleanup;
+  }
+
+  NaClVmIoWillStartVec(nap, iov.user_iov, iov.count);
+  for (i = 0; i < iov.count; ++i) {
+    pread_result = (*NACL_VTBL(NaClDesc, ndp)->
+                    PRead)(ndp, iov.iov[i].base, iov.iov[i].length,
+                           offset + (nacl_abi_off64_t) total);
+    if (pread_result < 0) {
+      if (0 == total) {
+        total = pread_result;
+      }
+      break;
+    }
+    total += pread_result;
+    if ((size_t) pread_result < iov.iov[i].length) {
+      break;
+    }
+  }
+  NaClVmIoHasEndedVec(nap, iov.user_iov, iov.count);
+  NaClSysIoVecDtor(&iov);
+
+  /* This cast is safe because NaClSysIoVecCopyIn clamped the length. */
+  retval = (int32_t) total;
+
+ cleanup:
+  NaClDescSafeUnref(ndp);
+  return retval;
+}
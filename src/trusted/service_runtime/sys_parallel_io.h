@@ -23,4 +23,10 @@ int32_t NaClSysPWrite(struct NaClAppThread *natp,
                       uint32_t buffer_bytes,
                       uint32_t offset_addr);
 
+int32_t NaClSysPReadv(struct NaClAppThread *natp,
+                      int32_t desc,
+                      uint32_t iov_addr,
+                      uint32_t iovcnt,
+                      uint32_t offset_addr);
+
 #endif
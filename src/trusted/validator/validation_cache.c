@@ -10,6 +10,7 @@
 #include <sys/stat.h>
 
 #include "native_client/src/include/build_config.h"
+#include "native_client/src/include/nacl_compiler_annotations.h"
 #include "native_client/src/shared/platform/nacl_check.h"
 #include "native_client/src/shared/platform/nacl_host_desc.h"
 #include "native_client/src/trusted/desc/desc_metadata_types.h"
@@ -37,10 +38,11 @@ int NaClCachingIsInexpensive(struct NaClValidationCache *cache,
   }
 }
 
-void NaClMetadataFromFDCtor(struct NaClValidationMetadata *metadata,
-                            int file_desc,
-                            const char* file_name,
-                            size_t file_name_length) {
+static void MetadataFromFDCtor(struct NaClValidationMetadata *metadata,
+                               int file_desc,
+                               const char* file_name,
+                               size_t file_name_length,
+                               int use_device) {
   struct NaClHostDesc wrapper;
   nacl_host_stat_t stat;
 #if NACL_WINDOWS
@@ -64,6 +66,7 @@ void NaClMetadataFromFDCtor(struct NaClValidationMetadata *metadata,
    * significant bits of a 64-bit volume serial number - but again, since it's
    * random we can live with it.
    */
+  UNREFERENCED_PARAMETER(use_device);
   if (!GetFileInformationByHandle((HANDLE) _get_osfhandle(file_desc),
                                   &file_info))
     return;
@@ -71,7 +74,12 @@ void NaClMetadataFromFDCtor(struct NaClValidationMetadata *metadata,
   metadata->file_id = ((((uint64_t)file_info.nFileIndexHigh) << 32) |
                        file_info.nFileIndexLow);
 #else
-  /* st_dev is not actually a property of the device, so skip it. */
+  /*
+   * st_dev is not actually a property of the device, so skip it unless
+   * the identity is only used within this process.
+   */
+  if (use_device)
+    metadata->device_id = stat.st_dev;
   metadata->file_id = stat.st_ino;
 #endif
 
@@ -89,6 +97,21 @@ void NaClMetadataFromFDCtor(struct NaClValidationMetadata *metadata,
   metadata->identity_type = NaClCodeIdentityFile;
 }
 
+void NaClMetadataFromFDCtor(struct NaClValidationMetadata *metadata,
+                            int file_desc,
+                            const char* file_name,
+                            size_t file_name_length) {
+  MetadataFromFDCtor(metadata, file_desc, file_name, file_name_length, 0);
+}
+
+void NaClMetadataFromHostFDCtor(struct NaClValidationMetadata *metadata,
+                                int file_desc) {
+  static const char kHostFileName[] = "<host file>";
+
+  MetadataFromFDCtor(metadata, file_desc, kHostFileName,
+                     sizeof kHostFileName - 1, 1);
+}
+
 void NaClMetadataDtor(struct NaClValidationMetadata *metadata) {
   free(metadata->file_name);
   /* Prevent use after free. */
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "native_client/src/trusted/validator/validation_cache_memory.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/public/validation_cache.h"
+#include "native_client/src/shared/platform/nacl_check.h"
+#include "native_client/src/shared/platform/nacl_sync.h"
+#include "native_client/src/shared/platform/nacl_sync_checked.h"
+
+/*
+ * Queries larger than this are not cached.  File identity queries are
+ * a few hundred bytes at most, dominated by the file name.
+ */
+static const size_t kMaxKeySize = 8192;
+
+struct CacheEntry {
+  struct CacheEntry *hash_next;
+  /* Doubly linked LRU list, most recently used first. */
+  struct CacheEntry *lru_prev;
+  struct CacheEntry *lru_next;
+  uint32_t hash;
+  size_t key_size;
+  uint8_t key[1];  /* Actually key_size bytes. */
+};
+
+struct MemoryCache {
+  /* Must be first: the NaClValidationCache pointer is the MemoryCache. */
+  struct NaClValidationCache base;
+  struct NaClMutex mu;
+  struct CacheEntry **buckets;
+  size_t num_buckets;
+  /* Sentinel of the LRU list. */
+  struct CacheEntry lru;
+  size_t max_entries;
+  struct NaClValidationCacheMemoryStats stats;
+};
+
+struct Query {
+  struct MemoryCache *cache;
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+  /* Set if the key could not be recorded; the query then always misses. */
+  int invalid;
+};
+
+/* FNV-1a. */
+static uint32_t HashKey(const uint8_t *data, size_t size) {
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static void LruUnlink(struct CacheEntry *entry) {
+  entry->lru_prev->lru_next = entry->lru_next;
+  entry->lru_next->lru_prev = entry->lru_prev;
+}
+
+static void LruPushFront(struct MemoryCache *cache, struct CacheEntry *entry) {
+  entry->lru_prev = &cache->lru;
+  entry->lru_next = cache->lru.lru_next;
+  cache->lru.lru_next->lru_prev = entry;
+  cache->lru.lru_next = entry;
+}
+
+static struct CacheEntry **FindEntry_mu(struct MemoryCache *cache,
+                                        uint32_t hash,
+                                        const uint8_t *key,
+                                        size_t key_size) {
+  struct CacheEntry **link = &cache->buckets[hash % cache->num_buckets];
+
+  while (NULL != *link) {
+    struct CacheEntry *entry = *link;
+    if (entry->hash == hash && entry->key_size == key_size &&
+        0 == memcmp(entry->key, key, key_size)) {
+      break;
+    }
+    link = &entry->hash_next;
+  }
+  return link;
+}
+
+static void EvictOldest_mu(struct MemoryCache *cache) {
+  struct CacheEntry *victim = cache->lru.lru_prev;
+  struct CacheEntry **link;
+
+  CHECK(victim != &cache->lru);
+  link = FindEntry_mu(cache, victim->hash, victim->key, victim->key_size);
+  CHECK(*link == victim);
+  *link = victim->hash_next;
+  LruUnlink(victim);
+  free(victim);
+  cache->stats.entries--;
+  cache->stats.evictions++;
+}
+
+static void *CreateQuery(void *handle) {
+  struct Query *query = (struct Query *) malloc(sizeof *query);
+
+  if (NULL == query) {
+    return NULL;
+  }
+  query->cache = (struct MemoryCache *) handle;
+  query->data = NULL;
+  query->size = 0;
+  query->capacity = 0;
+  query->invalid = 0;
+  return query;
+}
+
+static void AddData(void *vquery, const unsigned char *data, size_t length) {
+  struct Query *query = (struct Query *) vquery;
+
+  if (query->invalid) {
+    return;
+  }
+  if (length > kMaxKeySize - query->size) {
+    query->invalid = 1;
+    return;
+  }
+  if (query->size + length > query->capacity) {
+    size_t new_capacity = query->capacity > 0 ? query->capacity : 256;
+    uint8_t *new_data;
+
+    while (new_capacity < query->size + length) {
+      new_capacity *= 2;
+    }
+    new_data = (uint8_t *) realloc(query->data, new_capacity);
+    if (NULL == new_data) {
+      query->invalid = 1;
+      return;
+    }
+    query->data = new_data;
+    query->capacity = new_capacity;
+  }
+  memcpy(query->data + query->size, data, length);
+  query->size += length;
+}
+
+static int QueryKnownToValidate(void *vquery) {
+  struct Query *query = (struct Query *) vquery;
+  struct MemoryCache *cache = query->cache;
+  struct CacheEntry *entry = NULL;
+
+  if (!query->invalid) {
+    NaClXMutexLock(&cache->mu);
+    entry = *FindEntry_mu(cache, HashKey(query->data, query->size),
+                          query->data, query->size);
+    if (NULL != entry) {
+      LruUnlink(entry);
+      LruPushFront(cache, entry);
+      cache->stats.hits++;
+    } else {
+      cache->stats.misses++;
+    }
+    NaClXMutexUnlock(&cache->mu);
+  }
+  return NULL != entry;
+}
+
+static void SetKnownToValidate(void *vquery) {
+  struct Query *query = (struct Query *) vquery;
+  struct MemoryCache *cache = query->cache;
+  struct CacheEntry **link;
+  struct CacheEntry *entry;
+  uint32_t hash;
+
+  if (query->invalid) {
+    return;
+  }
+  hash = HashKey(query->data, query->size);
+  entry = (struct CacheEntry *) malloc(offsetof(struct CacheEntry, key)
+                                       + query->size);
+  if (NULL == entry) {
+    return;
+  }
+  entry->hash = hash;
+  entry->key_size = query->size;
+  memcpy(entry->key, query->data, query->size);
+
+  NaClXMutexLock(&cache->mu);
+  link = FindEntry_mu(cache, hash, query->data, query->size);
+  if (NULL != *link) {
+    /* Another thread validated the same code concurrently. */
+    free(entry);
+  } else {
+    if (cache->stats.entries >= cache->max_entries) {
+      EvictOldest_mu(cache);
+      /* Eviction may have changed the bucket's chain. */
+      link = FindEntry_mu(cache, hash, query->data, query->size);
+    }
+    entry->hash_next = NULL;
+    *link = entry;
+    LruPushFront(cache, entry);
+    cache->stats.entries++;
+    cache->stats.insertions++;
+  }
+  NaClXMutexUnlock(&cache->mu);
+}
+
+static void DestroyQuery(void *vquery) {
+  struct Query *query = (struct Query *) vquery;
+
+  free(query->data);
+  free(query);
+}
+
+struct NaClValidationCache *NaClValidationCacheMemoryCreate(
+    size_t max_entries) {
+  struct MemoryCache *cache;
+
+  if (0 == max_entries) {
+    return NULL;
+  }
+  cache = (struct MemoryCache *) calloc(1, sizeof *cache);
+  if (NULL == cache) {
+    return NULL;
+  }
+  cache->num_buckets = max_entries;
+  cache->buckets = (struct CacheEntry **) calloc(cache->num_buckets,
+                                                 sizeof *cache->buckets);
+  if (NULL == cache->buckets) {
+    free(cache);
+    return NULL;
+  }
+  if (!NaClMutexCtor(&cache->mu)) {
+    free(cache->buckets);
+    free(cache);
+    return NULL;
+  }
+  cache->lru.lru_prev = &cache->lru;
+  cache->lru.lru_next = &cache->lru;
+  cache->max_entries = max_entries;
+
+  cache->base.handle = cache;
+  cache->base.CreateQuery = CreateQuery;
+  cache->base.AddData = AddData;
+  cache->base.QueryKnownToValidate = QueryKnownToValidate;
+  cache->base.SetKnownToValidate = SetKnownToValidate;
+  cache->base.DestroyQuery = DestroyQuery;
+  /* Use the default policy: only cache code identified by file. */
+  cache->base.CachingIsInexpensive = NULL;
+  return &cache->base;
+}
+
+void NaClValidationCacheMemoryDestroy(struct NaClValidationCache *vcache) {
+  struct MemoryCache *cache = (struct MemoryCache *) vcache;
+  struct CacheEntry *entry;
+  struct CacheEntry *next;
+
+  if (NULL == cache) {
+    return;
+  }
+  for (entry = cache->lru.lru_next; entry != &cache->lru; entry = next) {
+    next = entry->lru_next;
+    free(entry);
+  }
+  NaClMutexDtor(&cache->mu);
+  free(cache->buckets);
+  free(cache);
+}
+
+void NaClValidationCacheMemoryGetStats(
+    struct NaClValidationCache *vcache,
+    struct NaClValidationCacheMemoryStats *stats) {
+  struct MemoryCache *cache = (struct MemoryCache *) vcache;
+
+  NaClXMutexLock(&cache->mu);
+  *stats = cache->stats;
+  NaClXMutexUnlock(&cache->mu);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * An in-memory implementation of the NaClValidationCache interface,
+ * for use when the embedder does not supply a validation cache.
+ *
+ * Queries are only made for code whose identity is a file (see
+ * NaClCachingIsInexpensive), so a query's data is small: the
+ * validator id, the CPU features and the file identity, offset and
+ * length added by NaClAddCodeIdentity.  The cache stores those bytes
+ * verbatim rather than a digest of them, so distinct queries can
+ * never collide.  The least recently used entry is evicted when the
+ * cache is full.
+ */
+
+#ifndef NATIVE_CLIENT_SRC_TRUSTED_VALIDATOR_VALIDATION_CACHE_MEMORY_H_
+#define NATIVE_CLIENT_SRC_TRUSTED_VALIDATOR_VALIDATION_CACHE_MEMORY_H_
+
+#include "native_client/src/include/nacl_base.h"
+#include "native_client/src/include/portability.h"
+
+EXTERN_C_BEGIN
+
+struct NaClValidationCache;
+
+/* Default capacity of the process-wide cache, in entries. */
+#define NACL_VALIDATION_CACHE_MEMORY_ENTRIES 1024
+
+struct NaClValidationCacheMemoryStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t insertions;
+  uint64_t evictions;
+  size_t entries;
+};
+
+/*
+ * Creates an empty cache holding at most |max_entries| entries.
+ * Returns NULL on allocation failure.
+ */
+struct NaClValidationCache *NaClValidationCacheMemoryCreate(
+    size_t max_entries);
+
+/* Frees the cache.  There must be no outstanding queries. */
+void NaClValidationCacheMemoryDestroy(struct NaClValidationCache *cache);
+
+void NaClValidationCacheMemoryGetStats(
+    struct NaClValidationCache *cache,
+    struct NaClValidationCacheMemoryStats *stats);
+
+EXTERN_C_END
+
+#endif  /* NATIVE_CLIENT_SRC_TRUSTED_VALIDATOR_VALIDATION_CACHE_MEMORY_H_ */
@@ -8,6 +8,8 @@
 
 #include <fcntl.h>
 
+#include <string>
+
 #include "native_client/src/include/build_config.h"
 #include "native_client/src/include/nacl_compiler_annotations.h"
 #include "native_client/src/shared/platform/nacl_host_desc.h"
@@ -17,6 +19,7 @@
 #include "native_client/src/trusted/validator/ncvalidate.h"
 #include "native_client/src/trusted/validator/validation_cache.h"
 #include "native_client/src/trusted/validator/validation_cache_internal.h"
+#include "native_client/src/trusted/validator/validation_cache_memory.h"
 #include "native_client/src/trusted/cpu_features/arch/x86/cpu_x86.h"
 #include "native_client/src/trusted/service_runtime/include/sys/fcntl.h"
 #include "native_client/src/trusted/validator/rich_file_info.h"
@@ -508,6 +511,74 @@ TEST_F(ValidationCachingFileOriginTests, Full) {
   EXPECT_EQ(0, memcmp("foobar", outp.file_path, outp.file_path_length));
 }
 
+class ValidationCacheMemoryTests : public ::testing::Test {
+ protected:
+  struct NaClValidationCache *cache;
+
+  void SetUp() {
+    cache = NaClValidationCacheMemoryCreate(2);
+    ASSERT_NE((struct NaClValidationCache *) NULL, cache);
+  }
+
+  void TearDown() {
+    NaClValidationCacheMemoryDestroy(cache);
+  }
+
+  // Returns whether the key was known, then marks it known.
+  int QueryAndSet(const char *key, size_t size) {
+    void *query = cache->CreateQuery(cache->handle);
+    int known;
+
+    cache->AddData(query, (const unsigned char *) key, size);
+    known = cache->QueryKnownToValidate(query);
+    if (!known)
+      cache->SetKnownToValidate(query);
+    cache->DestroyQuery(query);
+    return known;
+  }
+
+  struct NaClValidationCacheMemoryStats GetStats() {
+    struct NaClValidationCacheMemoryStats stats;
+    NaClValidationCacheMemoryGetStats(cache, &stats);
+    return stats;
+  }
+};
+
+TEST_F(ValidationCacheMemoryTests, HitAfterSet) {
+  EXPECT_EQ(0, QueryAndSet("foo", 3));
+  EXPECT_EQ(1, QueryAndSet("foo", 3));
+  // A prefix is a different key.
+  EXPECT_EQ(0, QueryAndSet("fo", 2));
+
+  struct NaClValidationCacheMemoryStats stats = GetStats();
+  EXPECT_EQ((uint64_t) 1, stats.hits);
+  EXPECT_EQ((uint64_t) 2, stats.misses);
+  EXPECT_EQ((uint64_t) 2, stats.insertions);
+  EXPECT_EQ((size_t) 2, stats.entries);
+}
+
+TEST_F(ValidationCacheMemoryTests, EvictsLeastRecentlyUsed) {
+  EXPECT_EQ(0, QueryAndSet("a", 1));
+  EXPECT_EQ(0, QueryAndSet("b", 1));
+  // Touch "a" so that "b" is the oldest entry.
+  EXPECT_EQ(1, QueryAndSet("a", 1));
+  EXPECT_EQ(0, QueryAndSet("c", 1));
+  EXPECT_EQ(1, QueryAndSet("a", 1));
+  EXPECT_EQ(1, QueryAndSet("c", 1));
+  EXPECT_EQ(0, QueryAndSet("b", 1));
+
+  struct NaClValidationCacheMemoryStats stats = GetStats();
+  EXPECT_EQ((uint64_t) 2, stats.evictions);
+  EXPECT_EQ((size_t) 2, stats.entries);
+}
+
+TEST_F(ValidationCacheMemoryTests, OversizedKeyNotCached) {
+  std::string big(1 << 16, 'x');
+  EXPECT_EQ(0, QueryAndSet(big.data(), big.size()));
+  EXPECT_EQ(0, QueryAndSet(big.data(), big.size()));
+  EXPECT_EQ((size_t) 0, GetStats().entries);
+}
+
 // Test driver function.
 int main(int argc, char *argv[]) {
   // One file we know must exist is this executable.
@@ -49,6 +49,15 @@ extern void NaClMetadataFromFDCtor(struct NaClValidationMetadata *metadata,
                                    const char* file_name,
                                    size_t file_name_length);
 
+/*
+ * Identifies an open host file by its fstat information alone, for
+ * descriptors that carry no origin information.  Device numbers are not
+ * stable across reboots, so this identity must only be used with a cache
+ * that does not outlive the process.
+ */
+extern void NaClMetadataFromHostFDCtor(struct NaClValidationMetadata *metadata,
+                                       int file_desc);
+
 extern
 void NaClMetadataFromNaClDescCtor(struct NaClValidationMetadata *metadata,
                                   struct NaClDesc *desc);
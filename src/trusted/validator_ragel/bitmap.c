@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * A small pool of bitmaps shared by the validators.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "native_client/src/include/build_config.h"
+#include "native_client/src/trusted/validator_ragel/bitmap.h"
+
+#if NACL_WINDOWS
+# include <windows.h>
+#else
+# include <sched.h>
+#endif
+
+/* Each validation holds two bitmaps; leave room for two at once. */
+#define BITMAP_POOL_SLOTS 4
+
+/*
+ * Bitmaps are allocated with at least this many words so that a pooled
+ * one fits most dynamic code chunks.
+ */
+#define BITMAP_POOL_MIN_WORDS 16
+
+/*
+ * Larger bitmaps (for chunks of more than 128KB of code with 32-bit
+ * words, 256KB with 64-bit words) are not kept: only the initial text
+ * segment is that large, and it is validated once.
+ */
+#define BITMAP_POOL_MAX_WORDS 4096
+
+/*
+ * Pooled bitmaps, with their capacities in words.  An empty slot has a
+ * NULL bitmap.
+ */
+static struct {
+  bitmap_word *bitmap;
+  size_t word_count;
+} g_bitmap_pool[BITMAP_POOL_SLOTS];
+
+/*
+ * A spin lock, held only for a few loads and stores.  The validators
+ * are also built into a DLL without the platform library, so the host
+ * primitives are used directly rather than NaClMutex.
+ */
+#if NACL_WINDOWS
+static volatile LONG g_bitmap_pool_lock = 0;
+
+static void BitmapPoolLock(void) {
+  /* InterlockedExchange is a full barrier. */
+  while (InterlockedExchange(&g_bitmap_pool_lock, 1) != 0) {
+    SwitchToThread();
+  }
+}
+
+static void BitmapPoolUnlock(void) {
+  InterlockedExchange(&g_bitmap_pool_lock, 0);
+}
+#else
+static volatile int g_bitmap_pool_lock = 0;
+
+static void BitmapPoolLock(void) {
+  /* An acquire barrier. */
+  while (__sync_lock_test_and_set(&g_bitmap_pool_lock, 1) != 0) {
+    sched_yield();
+  }
+}
+
+static void BitmapPoolUnlock(void) {
+  /* A release barrier and a store of 0. */
+  __sync_lock_release(&g_bitmap_pool_lock);
+}
+#endif
+
+bitmap_word *BitmapAcquire(size_t indexes) {
+  size_t word_count = (indexes + NACL_HOST_WORDSIZE - 1) / NACL_HOST_WORDSIZE;
+  bitmap_word *bitmap = NULL;
+  size_t i;
+
+  if (word_count <= BITMAP_POOL_MAX_WORDS) {
+    size_t best = BITMAP_POOL_SLOTS;
+
+    BitmapPoolLock();
+    for (i = 0; i < BITMAP_POOL_SLOTS; i++) {
+      if (g_bitmap_pool[i].bitmap != NULL &&
+          g_bitmap_pool[i].word_count >= word_count &&
+          (best == BITMAP_POOL_SLOTS ||
+           g_bitmap_pool[i].word_count < g_bitmap_pool[best].word_count)) {
+        best = i;
+      }
+    }
+    if (best != BITMAP_POOL_SLOTS) {
+      bitmap = g_bitmap_pool[best].bitmap;
+      g_bitmap_pool[best].bitmap = NULL;
+    }
+    BitmapPoolUnlock();
+
+    if (bitmap != NULL) {
+      memset(bitmap, 0, word_count * sizeof(bitmap_word));
+      return bitmap;
+    }
+    if (word_count < BITMAP_POOL_MIN_WORDS)
+      word_count = BITMAP_POOL_MIN_WORDS;
+  }
+
+  /*
+   * Each bitmap is preceded by a word holding its capacity in words, so
+   * BitmapRelease knows whether the bitmap can be pooled.
+   */
+  bitmap = calloc(word_count + 1, sizeof(bitmap_word));
+  if (bitmap == NULL)
+    return NULL;
+  bitmap[0] = word_count;
+  return bitmap + 1;
+}
+
+void BitmapRelease(bitmap_word *bitmap) {
+  bitmap_word *to_free = bitmap;
+  size_t word_count;
+  size_t i;
+
+  if (bitmap == NULL)
+    return;
+  word_count = (size_t) bitmap[-1];
+
+  if (word_count <= BITMAP_POOL_MAX_WORDS) {
+    BitmapPoolLock();
+    /* Use an empty slot, or else replace a smaller pooled bitmap. */
+    for (i = 0; i < BITMAP_POOL_SLOTS && to_free == bitmap; i++) {
+      if (g_bitmap_pool[i].bitmap == NULL) {
+        g_bitmap_pool[i].bitmap = bitmap;
+        g_bitmap_pool[i].word_count = word_count;
+        to_free = NULL;
+      }
+    }
+    for (i = 0; i < BITMAP_POOL_SLOTS && to_free == bitmap; i++) {
+      if (g_bitmap_pool[i].word_count < word_count) {
+        to_free = g_bitmap_pool[i].bitmap;
+        g_bitmap_pool[i].bitmap = bitmap;
+        g_bitmap_pool[i].word_count = word_count;
+      }
+    }
+    BitmapPoolUnlock();
+  }
+
+  if (to_free != NULL)
+    free(to_free - 1);
+}
@@ -29,6 +29,17 @@ static INLINE bitmap_word *BitmapAllocate(size_t indexes) {
   return calloc(word_count, sizeof(bitmap_word));
 }
 
+/*
+ * BitmapAcquire returns a zeroed bitmap like BitmapAllocate, but reuses
+ * a buffer given back with BitmapRelease when one is large enough.
+ * Validators need two bitmaps for every chunk they check and dynamic
+ * code arrives in many small chunks, so this saves a calloc and a free
+ * per bitmap.  Bitmaps from BitmapAcquire must be given back with
+ * BitmapRelease, which accepts NULL.  Both are thread-safe.
+ */
+bitmap_word *BitmapAcquire(size_t indexes);
+void BitmapRelease(bitmap_word *bitmap);
+
 static FORCEINLINE int BitmapIsBitSet(bitmap_word *bitmap, size_t index) {
   return (bitmap[index / NACL_HOST_WORDSIZE] &
                        (((bitmap_word)1) << (index % NACL_HOST_WORDSIZE))) != 0;
@@ -99,6 +99,27 @@ static NaClValidationStatus ApplyDfaValidator_x86_64(
 }
 
 
+/* Arguments of CodeCopyChunk.  */
+struct CodeCopyChunkData {
+  const NaClCPUFeaturesX86 *cpu_features;
+  NaClCopyInstructionFunc copy_func;
+};
+
+static Bool CodeCopyChunk(uint8_t *data_existing,
+                          uint8_t *data_new,
+                          size_t size,
+                          void *chunk_data) {
+  struct CodeCopyChunkData *data = chunk_data;
+  struct CodeCopyCallbackData callback_data;
+  callback_data.copy_func = data->copy_func;
+  callback_data.existing_minus_new = data_existing - data_new;
+  return ValidateChunkAMD64(data_new, size,
+                            CALL_USER_CALLBACK_ON_EACH_INSTRUCTION,
+                            data->cpu_features,
+                            NaClDfaProcessCodeCopyInstruction,
+                            &callback_data);
+}
+
 static NaClValidationStatus ValidatorCodeCopy_x86_64(
     uintptr_t guest_addr,
     uint8_t *data_existing,
@@ -108,16 +129,17 @@ static NaClValidationStatus ValidatorCodeCopy_x86_64(
     NaClCopyInstructionFunc copy_func) {
   /* TODO(jfb) Use a safe cast here. */
   NaClCPUFeaturesX86 *cpu_features = (NaClCPUFeaturesX86 *) f;
-  struct CodeCopyCallbackData callback_data;
+  struct CodeCopyChunkData chunk_data;
   UNREFERENCED_PARAMETER(guest_addr);
 
   if (size & kBundleMask)
     return NaClValidationFailed;
-  callback_data.copy_func = copy_func;
-  callback_data.existing_minus_new = data_existing - data_new;
-  if (ValidateChunkAMD64(data_new, size, CALL_USER_CALLBACK_ON_EACH_INSTRUCTION,
-                         cpu_features, NaClDfaProcessCodeCopyInstruction,
-                         &callback_data))
+  chunk_data.cpu_features = cpu_features;
+  chunk_data.copy_func = copy_func;
+  /* Unchanged bundles need no copying: try to only copy the changed ones.  */
+  if (NaClDfaForEachChangedRun(data_existing, data_new, size,
+                               CodeCopyChunk, &chunk_data) ||
+      CodeCopyChunk(data_existing, data_new, size, &chunk_data))
     return NaClValidationSucceeded;
   if (errno == ENOMEM)
     return NaClValidationFailedOutOfMemory;
@@ -210,6 +232,16 @@ static Bool ProcessCodeReplacementInstruction(const uint8_t *begin_new,
                 instruction_length - INFO_ANYFIELDS_SIZE(info_new)) == 0;
 }
 
+static Bool CodeReplacementChunk(uint8_t *data_existing,
+                                 uint8_t *data_new,
+                                 size_t size,
+                                 void *cpu_features) {
+  return ValidateChunkAMD64(data_new, size,
+                            CALL_USER_CALLBACK_ON_EACH_INSTRUCTION,
+                            cpu_features, ProcessCodeReplacementInstruction,
+                            (void *)(data_existing - data_new));
+}
+
 static NaClValidationStatus ValidatorCodeReplacement_x86_64(
     uintptr_t guest_addr,
     uint8_t *data_existing,
@@ -222,9 +254,18 @@ static NaClValidationStatus ValidatorCodeReplacement_x86_64(
 
   if (size & kBundleMask)
     return NaClValidationFailed;
-  if (ValidateChunkAMD64(data_new, size, CALL_USER_CALLBACK_ON_EACH_INSTRUCTION,
-                         cpu_features, ProcessCodeReplacementInstruction,
-                         (void *)(data_existing - data_new)))
+  /*
+   * Usually only a few bundles change (e.g. when call targets or inline
+   * caches are patched), so first validate only those.  Instruction
+   * boundaries in each changed bundle are checked to be unchanged, so jumps
+   * from the unchanged bundles into the changed ones stay valid.  If a
+   * changed bundle contains a jump whose target lies outside the changed
+   * bundles, the fast path fails and the whole region is validated as
+   * before.
+   */
+  if (NaClDfaForEachChangedRun(data_existing, data_new, size,
+                               CodeReplacementChunk, cpu_features) ||
+      CodeReplacementChunk(data_existing, data_new, size, cpu_features))
     return NaClValidationSucceeded;
   if (errno == ENOMEM)
     return NaClValidationFailedOutOfMemory;
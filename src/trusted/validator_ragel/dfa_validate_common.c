@@ -290,3 +290,31 @@ Bool NaClDfaCodeReplacementIsStubouted(const uint8_t *begin_existing,
   else
     return FALSE;
 }
+
+Bool NaClDfaForEachChangedRun(uint8_t *data_existing,
+                              uint8_t *data_new,
+                              size_t size,
+                              NaClDfaReplacementChunkFunc chunk_func,
+                              void *chunk_data) {
+  size_t begin = 0;
+
+  CHECK((size & kBundleMask) == 0);
+  while (begin < size) {
+    size_t end;
+
+    if (memcmp(data_existing + begin, data_new + begin, kBundleSize) == 0) {
+      begin += kBundleSize;
+      continue;
+    }
+    /* Changed bundles next to each other are processed together.  */
+    end = begin + kBundleSize;
+    while (end < size &&
+           memcmp(data_existing + end, data_new + end, kBundleSize) != 0)
+      end += kBundleSize;
+    if (!chunk_func(data_existing + begin, data_new + begin, end - begin,
+                    chunk_data))
+      return FALSE;
+    begin = end;
+  }
+  return TRUE;
+}
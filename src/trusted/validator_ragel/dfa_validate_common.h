@@ -79,4 +79,25 @@ Bool NaClDfaProcessCodeCopyInstruction(const uint8_t *begin_new,
 Bool NaClDfaCodeReplacementIsStubouted(const uint8_t *begin_existing,
                                        size_t instruction_length);
 
+/* Processes a bundle-aligned part of the code being replaced.  */
+typedef Bool (*NaClDfaReplacementChunkFunc)(uint8_t *data_existing,
+                                            uint8_t *data_new,
+                                            size_t size,
+                                            void *chunk_data);
+
+/*
+ * Call chunk_func on each run of consecutive bundles where data_new differs
+ * from data_existing, and skip the bundles which are unchanged.  Returns FALSE
+ * as soon as chunk_func does.
+ *
+ * Each run is validated on its own, so a direct jump out of the run is
+ * reported as DIRECT_JUMP_OUT_OF_RANGE and only accepted if it is unchanged;
+ * callers must fall back to processing the whole region when this fails.
+ */
+Bool NaClDfaForEachChangedRun(uint8_t *data_existing,
+                              uint8_t *data_new,
+                              size_t size,
+                              NaClDfaReplacementChunkFunc chunk_func,
+                              void *chunk_data);
+
 #endif /* NATIVE_CLIENT_SRC_TRUSTED_VALIDATOR_RAGEL_DFA_VALIDATE_COMMON_H_ */
@@ -22,7 +22,15 @@ Bool ProcessError(
     uint32_t validation_info, void *user_data_ptr) {
   UNREFERENCED_PARAMETER(begin);
   UNREFERENCED_PARAMETER(end);
-  UNREFERENCED_PARAMETER(user_data_ptr);
+  /*
+   * When the text is split into chunks, jumps into the middle of another
+   * chunk can't be checked; the service runtime checks those against the
+   * rest of the code, so don't count them as errors here.
+   */
+  bool chunked = user_data_ptr != NULL;
+  if (chunked &&
+      (validation_info & VALIDATION_ERRORS_MASK) == DIRECT_JUMP_OUT_OF_RANGE)
+    validation_info &= ~DIRECT_JUMP_OUT_OF_RANGE;
   if (validation_info & (VALIDATION_ERRORS_MASK | BAD_JUMP_TARGET))
     return FALSE;
   else
@@ -31,9 +39,12 @@ Bool ProcessError(
 
 
 int main(int argc, char *argv[]) {
-  if (argc != 3) {
+  if (argc != 3 && argc != 4) {
     printf("Usage:\n");
-    printf("    validator_benchmark <nexe> <number of repetitions>\n");
+    printf("    validator_benchmark <nexe> <number of repetitions> "
+           "[<chunk size>]\n");
+    printf("With a chunk size, the text segment is validated in chunks of "
+           "that many bytes,\nas dynamic code is.\n");
     exit(1);
   }
   const char *input_file = argv[1];
@@ -55,25 +66,41 @@ int main(int argc, char *argv[]) {
     exit(1);
   }
 
-  Bool result = FALSE;
+  uint32_t chunk_size = segment.size;
+  void *chunked = NULL;
+  if (argc == 4) {
+    chunk_size = atoi(argv[3]);
+    CHECK(chunk_size > 0 && chunk_size % kBundleSize == 0);
+    chunked = &chunk_size;
+  }
+
+  Bool result = TRUE;
 
   clock_t start = clock();
   for (int i = 0; i < repetitions; i++) {
-    switch (architecture) {
-      case elf_load::X86_32:
-        result = ValidateChunkIA32(
-            segment.data, segment.size,
-            0, &kFullCPUIDFeatures,
-            ProcessError, NULL);
-        break;
-      case elf_load::X86_64:
-        result = ValidateChunkAMD64(
-            segment.data, segment.size,
-            0, &kFullCPUIDFeatures,
-            ProcessError, NULL);
-        break;
-      case elf_load::ARM:
-        CHECK(false);
+    result = TRUE;
+    for (uint32_t offset = 0; offset < segment.size; offset += chunk_size) {
+      uint32_t size = segment.size - offset;
+      if (size > chunk_size)
+        size = chunk_size;
+      switch (architecture) {
+        case elf_load::X86_32:
+          if (!ValidateChunkIA32(
+                  segment.data + offset, size,
+                  0, &kFullCPUIDFeatures,
+                  ProcessError, chunked))
+            result = FALSE;
+          break;
+        case elf_load::X86_64:
+          if (!ValidateChunkAMD64(
+                  segment.data + offset, size,
+                  0, &kFullCPUIDFeatures,
+                  ProcessError, chunked))
+            result = FALSE;
+          break;
+        case elf_load::ARM:
+          CHECK(false);
+      }
     }
   }
 
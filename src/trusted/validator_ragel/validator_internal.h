@@ -17,6 +17,18 @@
 #include "native_client/src/trusted/validator_ragel/decoding.h"
 #include "native_client/src/trusted/validator_ragel/validator.h"
 
+/*
+ * SSE2 is always there on x86-64, and on x86-32 when the compiler is
+ * told it can use it.  Other hosts use the word-at-a-time loops.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define NACL_VALIDATOR_RAGEL_SSE2 1
+# include <emmintrin.h>
+#else
+# define NACL_VALIDATOR_RAGEL_SSE2 0
+#endif
+
 /* Maximum set of R-DFA allowable CPUID features.  */
 extern const NaClCPUFeaturesX86 kValidatorCPUIDFeatures;
 
@@ -194,21 +206,21 @@ static FORCEINLINE void UnmarkValidJumpTargets(size_t address,
 }
 
 /*
- * Compare valid_targets and jump_dests and call callback for any address in
- * jump_dests which is not present in valid_targets.
+ * Call callback for every address in jump_dests[first, last) (in words)
+ * which is not present in valid_targets.
  */
-static INLINE Bool ProcessInvalidJumpTargets(
+static INLINE Bool ProcessInvalidJumpTargetWords(
     const uint8_t codeblock[],
-    size_t size,
+    size_t first,
+    size_t last,
     bitmap_word *valid_targets,
     bitmap_word *jump_dests,
     ValidationCallbackFunc user_callback,
     void *callback_data) {
-  size_t elements = (size + NACL_HOST_WORDSIZE - 1) / NACL_HOST_WORDSIZE;
   size_t i, j;
   Bool result = TRUE;
 
-  for (i = 0; i < elements; i++) {
+  for (i = first; i < last; i++) {
     bitmap_word jump_dest_mask = jump_dests[i];
     bitmap_word valid_target_mask = valid_targets[i];
     if ((jump_dest_mask & ~valid_target_mask) != 0) {
@@ -226,6 +238,47 @@ static INLINE Bool ProcessInvalidJumpTargets(
   return result;
 }
 
+/*
+ * Compare valid_targets and jump_dests and call callback for any address in
+ * jump_dests which is not present in valid_targets.
+ */
+static INLINE Bool ProcessInvalidJumpTargets(
+    const uint8_t codeblock[],
+    size_t size,
+    bitmap_word *valid_targets,
+    bitmap_word *jump_dests,
+    ValidationCallbackFunc user_callback,
+    void *callback_data) {
+  size_t elements = (size + NACL_HOST_WORDSIZE - 1) / NACL_HOST_WORDSIZE;
+  size_t i = 0;
+  Bool result = TRUE;
+
+#if NACL_VALIDATOR_RAGEL_SSE2
+  /*
+   * Bad jump targets are rare, so check 128 bits at a time and only look
+   * at the words of a block which has some.
+   */
+  const size_t kBlockWords = sizeof(__m128i) / sizeof(bitmap_word);
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; i + kBlockWords <= elements; i += kBlockWords) {
+    __m128i bad = _mm_andnot_si128(
+        _mm_loadu_si128((const __m128i *) (valid_targets + i)),
+        _mm_loadu_si128((const __m128i *) (jump_dests + i)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, zero)) != 0xffff) {
+      result &= ProcessInvalidJumpTargetWords(codeblock, i, i + kBlockWords,
+                                              valid_targets, jump_dests,
+                                              user_callback, callback_data);
+    }
+  }
+#endif
+
+  result &= ProcessInvalidJumpTargetWords(codeblock, i, elements,
+                                          valid_targets, jump_dests,
+                                          user_callback, callback_data);
+  return result;
+}
+
 
 /*
  * Process rel8_operand.  Note: rip points to the beginning of the next
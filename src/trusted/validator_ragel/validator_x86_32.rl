@@ -191,11 +191,11 @@ Bool ValidateChunkIA32(const uint8_t codeblock[],
     jump_dests_small = 0;
     jump_dests = &jump_dests_small;
   } else {
-    valid_targets = BitmapAllocate(size);
-    jump_dests = BitmapAllocate(size);
+    valid_targets = BitmapAcquire(size);
+    jump_dests = BitmapAcquire(size);
     if (!valid_targets || !jump_dests) {
-      free(jump_dests);
-      free(valid_targets);
+      BitmapRelease(jump_dests);
+      BitmapRelease(valid_targets);
       errno = ENOMEM;
       return FALSE;
     }
@@ -251,9 +251,9 @@ Bool ValidateChunkIA32(const uint8_t codeblock[],
                                       user_callback,
                                       callback_data);
 
-  /* We only use malloc for a large code sequences  */
-  if (jump_dests != &jump_dests_small) free(jump_dests);
-  if (valid_targets != &valid_targets_small) free(valid_targets);
+  /* Only the larger code sequences use pooled bitmaps.  */
+  if (jump_dests != &jump_dests_small) BitmapRelease(jump_dests);
+  if (valid_targets != &valid_targets_small) BitmapRelease(valid_targets);
   if (!result) errno = EINVAL;
   return result;
 }
@@ -1215,11 +1215,11 @@ Bool ValidateChunkAMD64(const uint8_t codeblock[],
     jump_dests_small = 0;
     jump_dests = &jump_dests_small;
   } else {
-    valid_targets = BitmapAllocate(size + 1);
-    jump_dests = BitmapAllocate(size + 1);
+    valid_targets = BitmapAcquire(size + 1);
+    jump_dests = BitmapAcquire(size + 1);
     if (!valid_targets || !jump_dests) {
-      free(jump_dests);
-      free(valid_targets);
+      BitmapRelease(jump_dests);
+      BitmapRelease(valid_targets);
       errno = ENOMEM;
       return FALSE;
     }
@@ -1305,9 +1305,9 @@ Bool ValidateChunkAMD64(const uint8_t codeblock[],
                                       user_callback,
                                       callback_data);
 
-  /* We only use malloc for a large code sequences  */
-  if (jump_dests != &jump_dests_small) free(jump_dests);
-  if (valid_targets != &valid_targets_small) free(valid_targets);
+  /* Only the larger code sequences use pooled bitmaps.  */
+  if (jump_dests != &jump_dests_small) BitmapRelease(jump_dests);
+  if (valid_targets != &valid_targets_small) BitmapRelease(valid_targets);
   if (!result) errno = EINVAL;
   return result;
 }
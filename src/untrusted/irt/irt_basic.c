@@ -4,8 +4,13 @@
  * found in the LICENSE file.
  */
 
+#include <sys/time.h>
+#include <time.h>
+
 #include "native_client/src/include/nacl_macros.h"
+#include "native_client/src/trusted/service_runtime/include/sys/time.h"
 #include "native_client/src/untrusted/irt/irt.h"
+#include "native_client/src/untrusted/irt/irt_private.h"
 #include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
 
 static void nacl_irt_exit(int status) {
@@ -14,6 +19,12 @@ static void nacl_irt_exit(int status) {
 }
 
 static int nacl_irt_gettod(struct timeval *tv) {
+  struct timespec ts;
+  if (irt_clock_page_gettime(NACL_ABI_CLOCK_REALTIME, &ts) == 0) {
+    tv->tv_sec = ts.tv_sec;
+    tv->tv_usec = ts.tv_nsec / 1000;
+    return 0;
+  }
   return -NACL_SYSCALL(gettimeofday)(tv);
 }
 
@@ -4,11 +4,71 @@
  * found in the LICENSE file.
  */
 
+#include <time.h>
+
 #include "native_client/src/include/nacl_macros.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_clock_page.h"
+#include "native_client/src/trusted/service_runtime/include/sys/time.h"
 #include "native_client/src/untrusted/irt/irt.h"
 #include "native_client/src/untrusted/irt/irt_interfaces.h"
+#include "native_client/src/untrusted/irt/irt_private.h"
 #include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
 
+#if defined(__i386__) || defined(__x86_64__)
+
+static uint64_t read_timestamp_counter(void) {
+  uint32_t edx;
+  uint32_t eax;
+  __asm__ volatile("rdtsc" : "=d"(edx), "=a"(eax));
+  return (((uint64_t) edx) << 32) | eax;
+}
+
+int irt_clock_page_gettime(int clk_id, struct timespec *tp) {
+  const struct nacl_abi_clock_page *page =
+      (const struct nacl_abi_clock_page *) g_clock_page;
+  uint32_t seq;
+  uint64_t ns;
+
+  if (page == NULL ||
+      (clk_id != NACL_ABI_CLOCK_REALTIME &&
+       clk_id != NACL_ABI_CLOCK_MONOTONIC)) {
+    return -1;
+  }
+  do {
+    uint64_t delta;
+
+    seq = page->seq;
+    /* x86 does not reorder loads with other loads. */
+    __asm__ volatile("" : : : "memory");
+    if (page->version != NACL_ABI_CLOCK_PAGE_VERSION ||
+        (page->flags & NACL_ABI_CLOCK_PAGE_TSC_VALID) == 0) {
+      return -1;
+    }
+    delta = read_timestamp_counter() - page->tsc_base;
+    if (delta > page->max_tsc_delta) {
+      return -1;
+    }
+    ns = (clk_id == NACL_ABI_CLOCK_MONOTONIC ?
+          page->monotonic_ns : page->realtime_ns);
+    ns += (delta * page->tsc_mult) >> page->tsc_shift;
+    __asm__ volatile("" : : : "memory");
+  } while ((seq & 1) != 0 || seq != page->seq);
+
+  tp->tv_sec = ns / 1000000000;
+  tp->tv_nsec = ns % 1000000000;
+  return 0;
+}
+
+#else
+
+int irt_clock_page_gettime(int clk_id, struct timespec *tp) {
+  UNREFERENCED_PARAMETER(clk_id);
+  UNREFERENCED_PARAMETER(tp);
+  return -1;
+}
+
+#endif
+
 static int nacl_irt_clock_getres(nacl_irt_clockid_t clk_id,
                                  struct timespec *res) {
   return -NACL_SYSCALL(clock_getres)(clk_id, res);
@@ -16,6 +76,8 @@ static int nacl_irt_clock_getres(nacl_irt_clockid_t clk_id,
 
 static int nacl_irt_clock_gettime(nacl_irt_clockid_t clk_id,
                                   struct timespec *tp) {
+  if (irt_clock_page_gettime(clk_id, tp) == 0)
+    return 0;
   return -NACL_SYSCALL(clock_gettime)(clk_id, tp);
 }
 
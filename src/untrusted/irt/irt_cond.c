@@ -4,43 +4,84 @@
  * found in the LICENSE file.
  */
 
+#include <errno.h>
+#include <limits.h>
+
 #include "native_client/src/untrusted/irt/irt.h"
-#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+#include "native_client/src/untrusted/irt/irt_private.h"
+
+/*
+ * A condvar's state word is a sequence number that is bumped on every
+ * signal, as in libpthread's nc_condvar.c.  Unlike there, waiters are
+ * counted, so signalling a condvar nobody waits on stays in untrusted
+ * code.
+ */
 
 static int nacl_irt_cond_create(int *cond_handle) {
-  int rv = NACL_SYSCALL(cond_create)();
-  if (rv < 0)
-    return -rv;
-  *cond_handle = rv;
-  return 0;
+  return irt_sync_object_create(IRT_SYNC_COND, 0, cond_handle);
 }
 
-/*
- * Today a cond handle is just an fd and we destroy it with close.
- * But this might not always be so.
- */
 static int nacl_irt_cond_destroy(int cond_handle) {
-  return -NACL_SYSCALL(close)(cond_handle);
+  return irt_sync_object_destroy(IRT_SYNC_COND, cond_handle);
+}
+
+static int pulse(int cond_handle, int count) {
+  struct irt_sync_object *cond =
+      irt_sync_object_get(IRT_SYNC_COND, cond_handle);
+  if (cond == NULL)
+    return EBADF;
+  /*
+   * This full barrier orders the increment before the read of waiters,
+   * pairing with the one in cond_wait(), so a waiter either sees the
+   * new sequence number or is counted here.
+   */
+  __sync_fetch_and_add(&cond->state, 1);
+  if (cond->waiters != 0)
+    irt_sync_futex_wake(&cond->state, count);
+  return 0;
 }
 
 static int nacl_irt_cond_signal(int cond_handle) {
-  return -NACL_SYSCALL(cond_signal)(cond_handle);
+  return pulse(cond_handle, 1);
 }
 
 static int nacl_irt_cond_broadcast(int cond_handle) {
-  return -NACL_SYSCALL(cond_broadcast)(cond_handle);
+  return pulse(cond_handle, INT_MAX);
+}
+
+static int cond_wait(int cond_handle, int mutex_handle,
+                     const struct timespec *abstime) {
+  struct irt_sync_object *cond =
+      irt_sync_object_get(IRT_SYNC_COND, cond_handle);
+  struct irt_sync_object *mutex =
+      irt_sync_object_get(IRT_SYNC_MUTEX, mutex_handle);
+  if (cond == NULL || mutex == NULL)
+    return EBADF;
+
+  __sync_fetch_and_add(&cond->waiters, 1);
+  int old_value = cond->state;
+  int err = irt_sync_mutex_unlock(mutex);
+  if (err != 0) {
+    __sync_fetch_and_sub(&cond->waiters, 1);
+    return err;
+  }
+  int status = irt_sync_futex_wait(&cond->state, old_value, abstime);
+  __sync_fetch_and_sub(&cond->waiters, 1);
+  irt_sync_mutex_lock(mutex);
+
+  /* EWOULDBLOCK means we were signalled before we could block. */
+  if (status == ETIMEDOUT || status == EINVAL)
+    return status;
+  return 0;
 }
 
 static int nacl_irt_cond_wait(int cond_handle, int mutex_handle) {
-  return NACL_GC_WRAP_SYSCALL(-NACL_SYSCALL(cond_wait)(cond_handle,
-                                                       mutex_handle));
+  return cond_wait(cond_handle, mutex_handle, NULL);
 }
 
 static int nacl_irt_cond_timed_wait_abs(int cond_handle, int mutex_handle,
                                         const struct timespec *abstime) {
-  return NACL_GC_WRAP_SYSCALL(-NACL_SYSCALL(cond_timed_wait_abs)(cond_handle,
-                                                                 mutex_handle,
-                                                                 abstime));
+  return cond_wait(cond_handle, mutex_handle, abstime);
 }
 
 const struct nacl_irt_cond nacl_irt_cond = {
@@ -23,6 +23,7 @@
  */
 
 struct dirent;
+struct iovec;
 struct timeval;
 
 struct NaClMemMappingInfo;
@@ -68,6 +69,52 @@ struct nacl_irt_dev_fdio {
   int (*isatty)(int fd, int *result);
 };
 
+/*
+ * Scatter/gather I/O.  These have readv()/writev()/preadv() semantics,
+ * except that they return 0 or an errno value and store the number of
+ * bytes transferred in *nread or *nwrote.  iovcnt may not exceed 1024.
+ * struct iovec is { void *iov_base; size_t iov_len; } as in POSIX.
+ * Like "irt-fdio" v0.1, this interface is not available under PNaCl.
+ */
+#define NACL_IRT_DEV_FDIO_VEC_v0_1 "nacl-irt-dev-fdio-vec-0.1"
+struct nacl_irt_dev_fdio_vec {
+  int (*readv)(int fd, const struct iovec *iov, int iovcnt, size_t *nread);
+  int (*writev)(int fd, const struct iovec *iov, int iovcnt, size_t *nwrote);
+  int (*preadv)(int fd, const struct iovec *iov, int iovcnt,
+                nacl_irt_off_t offset, size_t *nread);
+};
+
+/*
+ * Asynchronous I/O through submission and completion rings in
+ * untrusted memory.  The ring layout and protocol are described in
+ * native_client/src/trusted/service_runtime/include/sys/nacl_aio.h.
+ * setup() registers a ring of |entries| SQEs and CQEs at |ring| and
+ * returns its id in *ring_id.  enter() starts up to |to_submit| queued
+ * requests, then waits for at least |min_complete| completions to be
+ * available, and stores the number of requests started in *submitted.
+ * destroy() waits for outstanding requests and releases the ring.
+ */
+#define NACL_IRT_DEV_AIO_v0_1 "nacl-irt-dev-aio-0.1"
+struct nacl_irt_dev_aio {
+  int (*setup)(void *ring, size_t entries, int *ring_id);
+  int (*enter)(int ring_id, size_t to_submit, size_t min_complete,
+               size_t *submitted);
+  int (*destroy)(int ring_id);
+};
+
+/*
+ * getdents_plus() is like getdents(), but each entry also holds the
+ * file type, size and modification time, so that a directory walk
+ * needs no stat() per entry.  The record format is described in
+ * native_client/src/trusted/service_runtime/include/sys/
+ * nacl_dirent_plus.h.  It fails with ENOSYS where the host does not
+ * support it.
+ */
+#define NACL_IRT_DEV_GETDENTS_PLUS_v0_1 "nacl-irt-dev-getdents-plus-0.1"
+struct nacl_irt_dev_getdents_plus {
+  int (*getdents_plus)(int fd, void *buf, size_t count, size_t *nread);
+};
+
 /*
  * The "irt-dev-filename" is similiar to "irt-filename" but provides
  * additional functions, including those that do directory manipulation.
@@ -107,9 +154,47 @@ struct nacl_irt_dev_filename {
 
 #define NACL_IRT_DEV_LIST_MAPPINGS_v0_1 \
   "nacl-irt-dev-list-mappings-0.1"
+struct nacl_irt_dev_list_mappings_v0_1 {
+  int (*list_mappings)(struct NaClMemMappingInfo *regions,
+                       size_t count, size_t *result_count);
+};
+
+#define NACL_IRT_DEV_LIST_MAPPINGS_v0_2 \
+  "nacl-irt-dev-list-mappings-0.2"
 struct nacl_irt_dev_list_mappings {
   int (*list_mappings)(struct NaClMemMappingInfo *regions,
                        size_t count, size_t *result_count);
+  /*
+   * list_mapping_changes() reports only the mappings in address ranges
+   * that changed since |*generation|, in the format described in
+   * nacl_list_mappings.h (see NACL_ABI_MAPPING_CHANGED_RANGE).  Passing
+   * a |*generation| of 0 returns the whole memory map.  |*result_count|
+   * is set to the number of entries needed; if it is no more than
+   * |count|, |regions| is filled in and |*generation| is advanced to
+   * the current generation, otherwise both are left untouched.
+   */
+  int (*list_mapping_changes)(uint32_t *generation,
+                              struct NaClMemMappingInfo *regions,
+                              size_t count, size_t *result_count);
+  /*
+   * mapping_generation() returns the current generation of the memory
+   * map, which changes whenever a mapping is added, removed or changed.
+   */
+  int (*mapping_generation)(uint32_t *generation);
+};
+
+/*
+ * get_dirty_pages() reports which pages of [start, start + length) were
+ * written since the previous call for those pages, one bit per page in
+ * |bitmap|, and stores the number of dirty pages in *count.  |start|
+ * must be page aligned.  The bitmap format and |flags| are described
+ * in native_client/src/trusted/service_runtime/include/sys/
+ * nacl_dirty_pages.h.
+ */
+#define NACL_IRT_DEV_DIRTY_PAGES_v0_1 "nacl-irt-dev-dirty-pages-0.1"
+struct nacl_irt_dev_dirty_pages {
+  int (*get_dirty_pages)(void *start, size_t length, uint8_t *bitmap,
+                         uint32_t flags, size_t *count);
 };
 
 #define NACL_IRT_DEV_GETPID_v0_1 "nacl-irt-dev-getpid-0.1"
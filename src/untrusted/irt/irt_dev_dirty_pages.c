@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "native_client/src/untrusted/irt/irt_dev.h"
+#include "native_client/src/untrusted/irt/irt_interfaces.h"
+#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+
+static int nacl_irt_get_dirty_pages(void *start, size_t length,
+                                    uint8_t *bitmap, uint32_t flags,
+                                    size_t *count) {
+  int rv = NACL_SYSCALL(get_dirty_pages)(start, length, bitmap, flags);
+  if (rv < 0)
+    return -rv;
+  *count = rv;
+  return 0;
+}
+
+const struct nacl_irt_dev_dirty_pages nacl_irt_dev_dirty_pages = {
+  nacl_irt_get_dirty_pages,
+};
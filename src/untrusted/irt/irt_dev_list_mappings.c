@@ -4,6 +4,7 @@
  * found in the LICENSE file.
  */
 
+#include "native_client/src/trusted/service_runtime/include/sys/unistd.h"
 #include "native_client/src/untrusted/irt/irt.h"
 #include "native_client/src/untrusted/irt/irt_dev.h"
 #include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
@@ -19,6 +20,36 @@ static int nacl_irt_list_mappings(struct NaClMemMappingInfo *regions,
   }
 }
 
+static int nacl_irt_list_mapping_changes(uint32_t *generation,
+                                         struct NaClMemMappingInfo *regions,
+                                         size_t count, size_t *result_count) {
+  int ret = NACL_SYSCALL(list_mapping_changes)(generation, regions, count);
+  if (ret < 0) {
+    return ret;
+  } else {
+    *result_count = ret;
+    return 0;
+  }
+}
+
+static int nacl_irt_mapping_generation(uint32_t *generation) {
+  int value;
+  int ret = NACL_SYSCALL(sysconf)(NACL_ABI__SC_NACL_MAPPING_GENERATION,
+                                  &value);
+  if (ret < 0) {
+    return ret;
+  }
+  *generation = (uint32_t) value;
+  return 0;
+}
+
+const struct nacl_irt_dev_list_mappings_v0_1
+    nacl_irt_dev_list_mappings_v0_1 = {
+  nacl_irt_list_mappings,
+};
+
 const struct nacl_irt_dev_list_mappings nacl_irt_dev_list_mappings = {
   nacl_irt_list_mappings,
+  nacl_irt_list_mapping_changes,
+  nacl_irt_mapping_generation,
 };
@@ -18,6 +18,7 @@
 #include "native_client/src/untrusted/nacl/tls.h"
 
 uintptr_t g_dynamic_text_start;
+uintptr_t g_clock_page;
 
 void __libc_init_array(void);
 
@@ -49,6 +50,7 @@ void nacl_irt_enter_user_code(uint32_t *info,
   Elf32_auxv_t *auxv = nacl_startup_auxv(info);
   Elf32_auxv_t *entry = NULL;
   Elf32_auxv_t *base = NULL;
+  Elf32_auxv_t *clock_page = NULL;
   for (Elf32_auxv_t *av = auxv; av->a_type != AT_NULL; ++av) {
     switch (av->a_type) {
       case AT_ENTRY:
@@ -57,9 +59,10 @@ void nacl_irt_enter_user_code(uint32_t *info,
       case AT_BASE:
         base = av;
         break;
+      case AT_NACL_CLOCK_PAGE:
+        clock_page = av;
+        break;
     }
-    if (entry != NULL && base != NULL)
-      break;
   }
   if (entry == NULL) {
     static const char fatal_msg[] =
@@ -93,6 +96,16 @@ void nacl_irt_enter_user_code(uint32_t *info,
     }
   }
 
+  if (clock_page != NULL) {
+    /*
+     * The clock page is only read by the IRT's clock functions, so it
+     * is not part of the interface offered to the user application.
+     */
+    g_clock_page = clock_page->a_un.a_val;
+    clock_page->a_type = AT_IGNORE;
+    clock_page->a_un.a_val = 0;
+  }
+
   /*
    * The user application does not need to see the AT_ENTRY item.
    * Reuse the auxv slot and overwrite it with the IRT query function.
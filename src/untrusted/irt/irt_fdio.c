@@ -67,6 +67,15 @@ static int nacl_irt_getdents(int fd, struct dirent *buf, size_t count,
   return 0;
 }
 
+static int nacl_irt_getdents_plus(int fd, void *buf, size_t count,
+                                  size_t *nread) {
+  int rv = NACL_GC_WRAP_SYSCALL(NACL_SYSCALL(getdents_plus)(fd, buf, count));
+  if (rv < 0)
+    return -rv;
+  *nread = rv;
+  return 0;
+}
+
 static int nacl_irt_fchdir(int fd) {
   return -NACL_SYSCALL(fchdir)(fd);
 }
@@ -95,6 +104,56 @@ static int nacl_irt_isatty(int fd, int *result) {
   return 0;
 }
 
+static int nacl_irt_readv(int fd, const struct iovec *iov, int iovcnt,
+                          size_t *nread) {
+  int rv = NACL_GC_WRAP_SYSCALL(NACL_SYSCALL(readv)(fd, iov, iovcnt));
+  if (rv < 0)
+    return -rv;
+  *nread = rv;
+  return 0;
+}
+
+static int nacl_irt_writev(int fd, const struct iovec *iov, int iovcnt,
+                           size_t *nwrote) {
+  int rv = NACL_GC_WRAP_SYSCALL(NACL_SYSCALL(writev)(fd, iov, iovcnt));
+  if (rv < 0)
+    return -rv;
+  *nwrote = rv;
+  return 0;
+}
+
+static int nacl_irt_preadv(int fd, const struct iovec *iov, int iovcnt,
+                           off_t offset, size_t *nread) {
+  int rv = NACL_GC_WRAP_SYSCALL(NACL_SYSCALL(preadv)(fd, iov, iovcnt,
+                                                     &offset));
+  if (rv < 0)
+    return -rv;
+  *nread = rv;
+  return 0;
+}
+
+static int nacl_irt_aio_setup(void *ring, size_t entries, int *ring_id) {
+  int rv = NACL_SYSCALL(aio_setup)(ring, entries);
+  if (rv < 0)
+    return -rv;
+  *ring_id = rv;
+  return 0;
+}
+
+static int nacl_irt_aio_enter(int ring_id, size_t to_submit,
+                              size_t min_complete, size_t *submitted) {
+  int rv = NACL_GC_WRAP_SYSCALL(NACL_SYSCALL(aio_enter)(ring_id, to_submit,
+                                                        min_complete));
+  if (rv < 0)
+    return -rv;
+  *submitted = rv;
+  return 0;
+}
+
+static int nacl_irt_aio_destroy(int ring_id) {
+  return -NACL_GC_WRAP_SYSCALL(NACL_SYSCALL(aio_destroy)(ring_id));
+}
+
 const struct nacl_irt_fdio nacl_irt_fdio = {
   nacl_irt_close,
   nacl_irt_dup,
@@ -138,3 +197,19 @@ const struct nacl_irt_dev_fdio nacl_irt_dev_fdio = {
   nacl_irt_ftruncate,
   nacl_irt_isatty
 };
+
+const struct nacl_irt_dev_fdio_vec nacl_irt_dev_fdio_vec = {
+  nacl_irt_readv,
+  nacl_irt_writev,
+  nacl_irt_preadv,
+};
+
+const struct nacl_irt_dev_aio nacl_irt_dev_aio = {
+  nacl_irt_aio_setup,
+  nacl_irt_aio_enter,
+  nacl_irt_aio_destroy,
+};
+
+const struct nacl_irt_dev_getdents_plus nacl_irt_dev_getdents_plus = {
+  nacl_irt_getdents_plus,
+};
@@ -57,6 +57,12 @@ static const struct nacl_irt_interface irt_interfaces[] = {
     sizeof(nacl_irt_dev_fdio_v0_2), file_access_filter },
   { NACL_IRT_DEV_FDIO_v0_3, &nacl_irt_dev_fdio,
     sizeof(nacl_irt_dev_fdio), file_access_filter },
+  { NACL_IRT_DEV_FDIO_VEC_v0_1, &nacl_irt_dev_fdio_vec,
+    sizeof(nacl_irt_dev_fdio_vec), non_pnacl_filter },
+  { NACL_IRT_DEV_AIO_v0_1, &nacl_irt_dev_aio,
+    sizeof(nacl_irt_dev_aio), non_pnacl_filter },
+  { NACL_IRT_DEV_GETDENTS_PLUS_v0_1, &nacl_irt_dev_getdents_plus,
+    sizeof(nacl_irt_dev_getdents_plus), file_access_filter },
   /*
    * "irt-filename" is made available to non-PNaCl NaCl apps only for
    * compatibility, because existing nexes abort on startup if
@@ -119,8 +125,12 @@ static const struct nacl_irt_interface irt_interfaces[] = {
    */
   { NACL_IRT_EXCEPTION_HANDLING_v0_1, &nacl_irt_exception_handling,
     sizeof(nacl_irt_exception_handling), non_pnacl_filter },
-  { NACL_IRT_DEV_LIST_MAPPINGS_v0_1, &nacl_irt_dev_list_mappings,
+  { NACL_IRT_DEV_LIST_MAPPINGS_v0_1, &nacl_irt_dev_list_mappings_v0_1,
+    sizeof(nacl_irt_dev_list_mappings_v0_1), list_mappings_filter },
+  { NACL_IRT_DEV_LIST_MAPPINGS_v0_2, &nacl_irt_dev_list_mappings,
     sizeof(nacl_irt_dev_list_mappings), list_mappings_filter },
+  { NACL_IRT_DEV_DIRTY_PAGES_v0_1, &nacl_irt_dev_dirty_pages,
+    sizeof(nacl_irt_dev_dirty_pages), non_pnacl_filter },
   /*
    * "irt-code-data-alloc" is not supported under PNaCl.
    */
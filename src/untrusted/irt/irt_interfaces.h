@@ -12,6 +12,9 @@ extern const struct nacl_irt_basic nacl_irt_basic;
 extern const struct nacl_irt_fdio nacl_irt_fdio;
 extern const struct nacl_irt_dev_fdio_v0_2 nacl_irt_dev_fdio_v0_2;
 extern const struct nacl_irt_dev_fdio nacl_irt_dev_fdio;
+extern const struct nacl_irt_dev_fdio_vec nacl_irt_dev_fdio_vec;
+extern const struct nacl_irt_dev_aio nacl_irt_dev_aio;
+extern const struct nacl_irt_dev_getdents_plus nacl_irt_dev_getdents_plus;
 extern const struct nacl_irt_filename nacl_irt_filename;
 extern const struct nacl_irt_dev_filename_v0_2 nacl_irt_dev_filename_v0_2;
 extern const struct nacl_irt_dev_filename nacl_irt_dev_filename;
@@ -31,7 +34,10 @@ extern const struct nacl_irt_random nacl_irt_random;
 extern const struct nacl_irt_clock nacl_irt_clock;
 extern const struct nacl_irt_dev_getpid nacl_irt_dev_getpid;
 extern const struct nacl_irt_exception_handling nacl_irt_exception_handling;
+extern const struct nacl_irt_dev_list_mappings_v0_1
+    nacl_irt_dev_list_mappings_v0_1;
 extern const struct nacl_irt_dev_list_mappings nacl_irt_dev_list_mappings;
+extern const struct nacl_irt_dev_dirty_pages nacl_irt_dev_dirty_pages;
 extern const struct nacl_irt_code_data_alloc nacl_irt_code_data_alloc;
 extern const struct nacl_irt_private_pnacl_translator_link
     nacl_irt_private_pnacl_translator_link;
@@ -4,35 +4,47 @@
  * found in the LICENSE file.
  */
 
+#include <errno.h>
+
 #include "native_client/src/untrusted/irt/irt.h"
-#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+#include "native_client/src/untrusted/irt/irt_private.h"
+
+/*
+ * A mutex handle names an irt_sync_object in IRT memory, so
+ * uncontended locking and unlocking do not enter the service runtime.
+ */
 
 static int nacl_irt_mutex_create(int *mutex_handle) {
-  int rv = NACL_SYSCALL(mutex_create)();
-  if (rv < 0)
-    return -rv;
-  *mutex_handle = rv;
-  return 0;
+  return irt_sync_object_create(IRT_SYNC_MUTEX, 0, mutex_handle);
 }
 
-/*
- * Today a mutex handle is just an fd and we destroy it with close.
- * But this might not always be so.
- */
 static int nacl_irt_mutex_destroy(int mutex_handle) {
-  return -NACL_SYSCALL(close)(mutex_handle);
+  return irt_sync_object_destroy(IRT_SYNC_MUTEX, mutex_handle);
 }
 
 static int nacl_irt_mutex_lock(int mutex_handle) {
-  return NACL_GC_WRAP_SYSCALL(-NACL_SYSCALL(mutex_lock)(mutex_handle));
+  struct irt_sync_object *mutex =
+      irt_sync_object_get(IRT_SYNC_MUTEX, mutex_handle);
+  if (mutex == NULL)
+    return EBADF;
+  irt_sync_mutex_lock(mutex);
+  return 0;
 }
 
 static int nacl_irt_mutex_unlock(int mutex_handle) {
-  return -NACL_SYSCALL(mutex_unlock)(mutex_handle);
+  struct irt_sync_object *mutex =
+      irt_sync_object_get(IRT_SYNC_MUTEX, mutex_handle);
+  if (mutex == NULL)
+    return EBADF;
+  return irt_sync_mutex_unlock(mutex);
 }
 
 static int nacl_irt_mutex_trylock(int mutex_handle) {
-  return -NACL_SYSCALL(mutex_trylock)(mutex_handle);
+  struct irt_sync_object *mutex =
+      irt_sync_object_get(IRT_SYNC_MUTEX, mutex_handle);
+  if (mutex == NULL)
+    return EBADF;
+  return irt_sync_mutex_trylock(mutex);
 }
 
 const struct nacl_irt_mutex nacl_irt_mutex = {
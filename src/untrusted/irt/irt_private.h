@@ -12,6 +12,53 @@ extern __thread int g_is_irt_internal_thread;
 
 extern uintptr_t g_dynamic_text_start;
 
+/* Untrusted address of the service runtime's clock page, or 0. */
+extern uintptr_t g_clock_page;
+
+struct timespec;
+
+/*
+ * Reads CLOCK_REALTIME or CLOCK_MONOTONIC from the clock page without
+ * entering the service runtime.  Returns 0 on success, or -1 if the
+ * caller must fall back to the clock_gettime syscall.
+ */
+int irt_clock_page_gettime(int clk_id, struct timespec *tp);
+
 void irt_reserve_code_allocation(uintptr_t code_begin, size_t code_size);
 
+/*
+ * The objects behind "irt-mutex", "irt-cond" and "irt-sem" handles (see
+ * irt_sync.c).  state is the futex word: the mutex state, the condvar's
+ * sequence number or the semaphore's count.  waiters counts threads
+ * blocked on a condvar or semaphore, so that signalling and posting can
+ * skip futex_wake() when nobody is waiting.
+ */
+enum IrtSyncType {
+  IRT_SYNC_FREE,
+  IRT_SYNC_MUTEX,
+  IRT_SYNC_COND,
+  IRT_SYNC_SEM
+};
+
+struct irt_sync_object {
+  volatile int state;
+  volatile int waiters;
+  enum IrtSyncType type;
+  int next_free;
+};
+
+int irt_sync_object_create(enum IrtSyncType type, int value, int *handle);
+int irt_sync_object_destroy(enum IrtSyncType type, int handle);
+/* Returns NULL if handle is not a live object of the given type. */
+struct irt_sync_object *irt_sync_object_get(enum IrtSyncType type,
+                                            int handle);
+
+int irt_sync_futex_wait(volatile int *addr, int value,
+                        const struct timespec *abstime);
+void irt_sync_futex_wake(volatile int *addr, int nwake);
+
+void irt_sync_mutex_lock(struct irt_sync_object *mutex);
+int irt_sync_mutex_trylock(struct irt_sync_object *mutex);
+int irt_sync_mutex_unlock(struct irt_sync_object *mutex);
+
 #endif  /* NATIVE_CLIENT_SRC_UNTRUSTED_IRT_IRT_PRIVATE_H_ */
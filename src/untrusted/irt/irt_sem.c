@@ -4,31 +4,63 @@
  * found in the LICENSE file.
  */
 
+#include <errno.h>
+#include <limits.h>
+
 #include "native_client/src/untrusted/irt/irt.h"
-#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+#include "native_client/src/untrusted/irt/irt_private.h"
+
+/*
+ * A semaphore's state word is its count.  Posting with no waiters and
+ * waiting while the count is positive stay in untrusted code.
+ */
 
 static int nacl_irt_sem_create(int *sem_handle, int32_t value) {
-  int rv = NACL_SYSCALL(sem_create)(value);
-  if (rv < 0)
-    return -rv;
-  *sem_handle = rv;
-  return 0;
+  if (value < 0)
+    return EINVAL;
+  return irt_sync_object_create(IRT_SYNC_SEM, value, sem_handle);
 }
 
-/*
- * Today a semaphore handle is just an fd and we destroy it with close.
- * But this might not always be so.
- */
 static int nacl_irt_sem_destroy(int sem_handle) {
-  return -NACL_SYSCALL(close)(sem_handle);
+  return irt_sync_object_destroy(IRT_SYNC_SEM, sem_handle);
 }
 
 static int nacl_irt_sem_post(int sem_handle) {
-  return -NACL_SYSCALL(sem_post)(sem_handle);
+  struct irt_sync_object *sem = irt_sync_object_get(IRT_SYNC_SEM, sem_handle);
+  if (sem == NULL)
+    return EBADF;
+  int value;
+  do {
+    value = sem->state;
+    if (value == INT_MAX)
+      return EOVERFLOW;
+  } while (__sync_val_compare_and_swap(&sem->state, value, value + 1)
+           != value);
+  /*
+   * The compare-and-swap is a full barrier, pairing with the increment
+   * of waiters in sem_wait(): a waiter either sees the new count in
+   * futex_wait_abs() or is counted here.
+   */
+  if (sem->waiters != 0)
+    irt_sync_futex_wake(&sem->state, 1);
+  return 0;
 }
 
 static int nacl_irt_sem_wait(int sem_handle) {
-  return NACL_GC_WRAP_SYSCALL(-NACL_SYSCALL(sem_wait)(sem_handle));
+  struct irt_sync_object *sem = irt_sync_object_get(IRT_SYNC_SEM, sem_handle);
+  if (sem == NULL)
+    return EBADF;
+  for (;;) {
+    int value = sem->state;
+    if (value > 0) {
+      if (__sync_val_compare_and_swap(&sem->state, value, value - 1) == value)
+        return 0;
+      continue;
+    }
+    __sync_fetch_and_add(&sem->waiters, 1);
+    irt_sync_futex_wait(&sem->state, 0, NULL);
+    __sync_fetch_and_sub(&sem->waiters, 1);
+  }
 }
 
 const struct nacl_irt_sem nacl_irt_sem = {
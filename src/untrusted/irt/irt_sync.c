@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Storage for the objects behind "irt-mutex", "irt-cond" and "irt-sem"
+ * handles.
+ *
+ * These interfaces used to be thin wrappers around the mutex, cond and
+ * sem syscalls, which look up a host synchronization object in the
+ * descriptor table on every call.  Instead, each object is now a state
+ * word in IRT memory that is updated with atomic instructions, so
+ * uncontended operations never leave untrusted code.  The service
+ * runtime is entered only to block (futex_wait_abs) and to wake a
+ * blocked thread (futex_wake).
+ *
+ * A handle is an index into a table that grows in chunks and never
+ * shrinks, so looking a handle up takes no lock.  Only creating and
+ * destroying objects takes g_sync_mutex.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "native_client/src/include/nacl_compiler_annotations.h"
+#include "native_client/src/untrusted/irt/irt_private.h"
+#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+
+#define IRT_SYNC_CHUNK_SIZE 1024
+#define IRT_SYNC_MAX_CHUNKS 256
+
+static struct irt_sync_object *volatile g_chunks[IRT_SYNC_MAX_CHUNKS];
+static int g_chunk_count;
+static int g_free_list = -1;
+static pthread_mutex_t g_sync_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct irt_sync_object *lookup(int handle) {
+  if (handle < 0 || handle >= IRT_SYNC_CHUNK_SIZE * IRT_SYNC_MAX_CHUNKS)
+    return NULL;
+  struct irt_sync_object *chunk = g_chunks[handle / IRT_SYNC_CHUNK_SIZE];
+  if (chunk == NULL)
+    return NULL;
+  return &chunk[handle % IRT_SYNC_CHUNK_SIZE];
+}
+
+int irt_sync_object_create(enum IrtSyncType type, int value, int *handle) {
+  int err = 0;
+  pthread_mutex_lock(&g_sync_mutex);
+  if (g_free_list < 0) {
+    struct irt_sync_object *chunk = NULL;
+    if (g_chunk_count < IRT_SYNC_MAX_CHUNKS)
+      chunk = calloc(IRT_SYNC_CHUNK_SIZE, sizeof(*chunk));
+    if (chunk == NULL) {
+      err = ENOMEM;
+      goto done;
+    }
+    int base = g_chunk_count * IRT_SYNC_CHUNK_SIZE;
+    int i;
+    for (i = IRT_SYNC_CHUNK_SIZE - 1; i >= 0; i--) {
+      chunk[i].next_free = g_free_list;
+      g_free_list = base + i;
+    }
+    /* Publish the initialized chunk to lock-free lookup(). */
+    __sync_synchronize();
+    g_chunks[g_chunk_count++] = chunk;
+  }
+  struct irt_sync_object *obj = lookup(g_free_list);
+  *handle = g_free_list;
+  g_free_list = obj->next_free;
+  obj->state = value;
+  obj->waiters = 0;
+  obj->type = type;
+ done:
+  pthread_mutex_unlock(&g_sync_mutex);
+  return err;
+}
+
+int irt_sync_object_destroy(enum IrtSyncType type, int handle) {
+  int err = 0;
+  pthread_mutex_lock(&g_sync_mutex);
+  struct irt_sync_object *obj = lookup(handle);
+  if (obj == NULL || obj->type != type) {
+    err = EBADF;
+  } else {
+    obj->type = IRT_SYNC_FREE;
+    obj->next_free = g_free_list;
+    g_free_list = handle;
+  }
+  pthread_mutex_unlock(&g_sync_mutex);
+  return err;
+}
+
+struct irt_sync_object *irt_sync_object_get(enum IrtSyncType type,
+                                            int handle) {
+  struct irt_sync_object *obj = lookup(handle);
+  if (obj == NULL || obj->type != type)
+    return NULL;
+  return obj;
+}
+
+int irt_sync_futex_wait(volatile int *addr, int value,
+                        const struct timespec *abstime) {
+  return NACL_GC_WRAP_SYSCALL(-NACL_SYSCALL(futex_wait_abs)(addr, value,
+                                                            abstime));
+}
+
+void irt_sync_futex_wake(volatile int *addr, int nwake) {
+  NACL_SYSCALL(futex_wake)(addr, nwake);
+}
+
+/*
+ * The mutex follows "Mutex, Take 2" from Ulrich Drepper's "Futexes Are
+ * Tricky", as libpthread's nc_mutex.c does.  The numeric values matter
+ * because unlocking decrements the state.
+ */
+enum MutexState {
+  UNLOCKED = 0,
+  LOCKED_WITHOUT_WAITERS = 1,
+  LOCKED_WITH_WAITERS = 2
+};
+
+void irt_sync_mutex_lock(struct irt_sync_object *mutex) {
+  int old_state = __sync_val_compare_and_swap(&mutex->state, UNLOCKED,
+                                              LOCKED_WITHOUT_WAITERS);
+  while (NACL_UNLIKELY(old_state != UNLOCKED)) {
+    if (old_state == LOCKED_WITH_WAITERS ||
+        __sync_val_compare_and_swap(&mutex->state, LOCKED_WITHOUT_WAITERS,
+                                    LOCKED_WITH_WAITERS) != UNLOCKED) {
+      irt_sync_futex_wait(&mutex->state, LOCKED_WITH_WAITERS, NULL);
+    }
+    /*
+     * We may have been woken with other threads still waiting, so we
+     * must claim the mutex as LOCKED_WITH_WAITERS.
+     */
+    old_state = __sync_val_compare_and_swap(&mutex->state, UNLOCKED,
+                                            LOCKED_WITH_WAITERS);
+  }
+}
+
+int irt_sync_mutex_trylock(struct irt_sync_object *mutex) {
+  if (__sync_val_compare_and_swap(&mutex->state, UNLOCKED,
+                                  LOCKED_WITHOUT_WAITERS) != UNLOCKED) {
+    return EBUSY;
+  }
+  return 0;
+}
+
+int irt_sync_mutex_unlock(struct irt_sync_object *mutex) {
+  /*
+   * Decrement only a locked mutex, so that unlocking an unlocked one
+   * never exposes a bogus state to threads locking it concurrently.
+   */
+  int old_state = mutex->state;
+  for (;;) {
+    if (NACL_UNLIKELY(old_state == UNLOCKED))
+      return EPERM;
+    int seen = __sync_val_compare_and_swap(&mutex->state, old_state,
+                                           old_state - 1);
+    if (seen == old_state)
+      break;
+    old_state = seen;
+  }
+  if (NACL_UNLIKELY(old_state != LOCKED_WITHOUT_WAITERS)) {
+    /*
+     * We went from LOCKED_WITH_WAITERS to LOCKED_WITHOUT_WAITERS, so
+     * release the mutex fully and wake a waiter.  The compare-and-swap
+     * was a full barrier, so a plain store suffices here.
+     */
+    mutex->state = UNLOCKED;
+    irt_sync_futex_wake(&mutex->state, 1);
+  }
+  return 0;
+}
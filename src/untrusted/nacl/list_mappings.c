@@ -14,7 +14,8 @@
  * ABI table for underyling NaCl list_mappings interface.
  * Setup on demand.
  */
-static struct nacl_irt_dev_list_mappings irt_list_mappings;
+static struct nacl_irt_dev_list_mappings_v0_1 irt_list_mappings;
+static struct nacl_irt_dev_list_mappings irt_list_mappings_v0_2;
 
 /*
  * We don't do any locking here, but simultaneous calls are harmless enough.
@@ -32,6 +33,17 @@ static int set_up_irt_list_mappings(void) {
   return 0;
 }
 
+static int set_up_irt_list_mappings_v0_2(void) {
+  if (NULL == irt_list_mappings_v0_2.list_mapping_changes) {
+    if (nacl_interface_query(
+          NACL_IRT_DEV_LIST_MAPPINGS_v0_2, &irt_list_mappings_v0_2,
+          sizeof(irt_list_mappings_v0_2)) != sizeof(irt_list_mappings_v0_2)) {
+       return 1;
+    }
+  }
+  return 0;
+}
+
 int nacl_list_mappings(struct NaClMemMappingInfo *regions, size_t count,
                        size_t *result_count) {
   if (set_up_irt_list_mappings()) {
@@ -45,3 +57,19 @@ int nacl_list_mappings(struct NaClMemMappingInfo *regions, size_t count,
   }
   return 0;
 }
+
+int nacl_list_mapping_changes(uint32_t *generation,
+                              struct NaClMemMappingInfo *regions,
+                              size_t count, size_t *result_count) {
+  if (set_up_irt_list_mappings_v0_2()) {
+    errno = ENOSYS;
+    return -1;
+  }
+  int error = irt_list_mappings_v0_2.list_mapping_changes(generation, regions,
+                                                          count, result_count);
+  if (error) {
+    errno = -error;
+    return -1;
+  }
+  return 0;
+}
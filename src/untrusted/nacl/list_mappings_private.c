@@ -20,3 +20,15 @@ int nacl_list_mappings(struct NaClMemMappingInfo *regions, size_t count,
   *result_count = error;
   return 0;
 }
+
+int nacl_list_mapping_changes(uint32_t *generation,
+                              struct NaClMemMappingInfo *regions,
+                              size_t count, size_t *result_count) {
+  int error = NACL_SYSCALL(list_mapping_changes)(generation, regions, count);
+  if (error < 0) {
+    errno = -error;
+    return -1;
+  }
+  *result_count = error;
+  return 0;
+}
@@ -8,6 +8,7 @@
 #define _NATIVE_CLIENT_SRC_UNTRUSTED_NACL_NACL_LIST_MAPPINGS_H_ 1
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,27 @@ struct NaClMemMappingInfo;
 int nacl_list_mappings(struct NaClMemMappingInfo *info, size_t count,
                        size_t *result_count);
 
+/**
+ *  @nacl
+ *  Gets the parts of the memory map that changed since a previous call.
+ *  Each changed address range is reported as an entry whose vmmap_type
+ *  is NACL_ABI_MAPPING_CHANGED_RANGE, followed by the current mappings
+ *  in that range.
+ *  @param generation Generation of the map the caller already has, or
+ *  0 to get the whole map.  Advanced to the current generation when
+ *  info is large enough to hold the result.
+ *  @param info Destination to receive info on changed memory regions.
+ *  @param count Number of regions that there are space for.
+ *  @param result_count Pointer to location to receive number of regions
+ *  needed, which is 0 if nothing changed.
+ *  @return Returns zero on success, -1 on failure.
+ *  Sets errno to EFAULT if output locations are bad.
+ *  Sets errno to ENOMEM if insufficent memory exists to gather the map.
+ */
+int nacl_list_mapping_changes(uint32_t *generation,
+                              struct NaClMemMappingInfo *info, size_t count,
+                              size_t *result_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@ extern "C" {
 struct NaClExceptionContext;
 struct NaClAbiNaClImcMsgHdr;
 struct NaClMemMappingInfo;
+struct iovec;
 struct stat;
 struct timespec;
 struct timeval;
@@ -102,6 +103,20 @@ typedef int (*TYPE_nacl_pwrite) (int fd,
 
 typedef int (*TYPE_nacl_isatty) (int fd);
 
+typedef int (*TYPE_nacl_readv) (int fd, const struct iovec *iov, int iovcnt);
+
+typedef int (*TYPE_nacl_writev) (int fd, const struct iovec *iov, int iovcnt);
+
+typedef int (*TYPE_nacl_preadv) (int fd, const struct iovec *iov, int iovcnt,
+                                 off_t *offset);
+
+typedef int (*TYPE_nacl_aio_setup) (void *ring, size_t entries);
+
+typedef int (*TYPE_nacl_aio_enter) (int ring_id, size_t to_submit,
+                                    size_t min_complete);
+
+typedef int (*TYPE_nacl_aio_destroy) (int ring_id);
+
 /* ============================================================ */
 /* imc */
 /* ============================================================ */
@@ -140,6 +155,14 @@ typedef int (*TYPE_nacl_mprotect) (void *start, size_t length, int prot);
 typedef int (*TYPE_nacl_list_mappings) (struct NaClMemMappingInfo *region,
                                         size_t count);
 
+typedef int (*TYPE_nacl_list_mapping_changes) (
+    uint32_t *generation,
+    struct NaClMemMappingInfo *region,
+    size_t count);
+
+typedef int (*TYPE_nacl_get_dirty_pages) (void *start, size_t length,
+                                          uint8_t *bitmap, uint32_t flags);
+
 /* ============================================================ */
 /* threads */
 /* ============================================================ */
@@ -186,6 +209,8 @@ typedef int (*TYPE_nacl_sem_post) (int sem);
 
 typedef int (*TYPE_nacl_getdents) (int desc, void *dirp, size_t count);
 
+typedef int (*TYPE_nacl_getdents_plus) (int desc, void *dirp, size_t count);
+
 typedef int (*TYPE_nacl_gettimeofday) (struct timeval *tv);
 
 typedef int (*TYPE_nacl_sched_yield) (void);
@@ -75,14 +75,14 @@ void *TLSBlockBase(uint32_t module_index) {
 }
 
 void *TLSVarGetter(PLLTLSVarGetter *closure) {
-  uint32_t module_index = (uint32_t) closure->arg1;
+  uint32_t module_index = (uint32_t) (uintptr_t) closure->arg1;
   uintptr_t var_offset = (uintptr_t) closure->arg2;
   uintptr_t block_base = (uintptr_t) TLSBlockBase(module_index);
   return (void *) (block_base + var_offset);
 }
 
 void *TLSBlockGetter(PLLTLSBlockGetter *closure) {
-  uint32_t module_index = (uint32_t) closure->arg;
+  uint32_t module_index = (uint32_t) (uintptr_t) closure->arg;
   return TLSBlockBase(module_index);
 }
 
@@ -119,7 +119,7 @@ bool PLLModule::GetExportedSym(const char *name, void **sym) {
   if (chain_index == -1)
     return false;
 
-  for (; chain_index < root_->export_count; chain_index++) {
+  for (; (size_t) chain_index < root_->export_count; chain_index++) {
     uint32_t chain_value = root_->hash_chains[chain_index];
     if ((hash & ~1) == (chain_value & ~1) &&
         strcmp(name, GetExportedSymbolName(chain_index)) == 0) {
@@ -161,7 +161,7 @@ void PLLModule::InitializeTLS() {
     CHECK(pthread_mutex_unlock(&g_modules_mutex) == 0);
 
     tls_block_getter->func = TLSBlockGetter;
-    tls_block_getter->arg = (void *) module_index;
+    tls_block_getter->arg = (void *) (uintptr_t) module_index;
   }
 }
 
@@ -200,8 +200,14 @@ PLLRoot *ModuleSet::AddByFilename(const char *filename) {
     NaClLog(LOG_FATAL,
             "pll_loader could not open %s: errno=%d\n", filename, err);
   }
-  PLLModule module((const PLLRoot *) pso_root);
+  AddModule((const PLLRoot *) pso_root);
+  return (PLLRoot *) pso_root;
+}
+
+void ModuleSet::AddModule(const PLLRoot *root) {
+  PLLModule module(root);
   modules_.push_back(module);
+  module_states_.push_back(kModuleAdded);
   const char *dependencies_list = module.root()->dependencies_list;
   size_t dependencies_count = module.root()->dependencies_count;
   size_t string_offset = 0;
@@ -210,62 +216,185 @@ PLLRoot *ModuleSet::AddByFilename(const char *filename) {
     string_offset += dependency_filename.length() + 1;
     AddBySoname(dependency_filename.c_str());
   }
-  return (PLLRoot *) pso_root;
 }
 
-void *ModuleSet::GetSym(const char *name) {
-  for (auto &module : modules_) {
-    void *sym;
-    if (module.GetExportedSym(name, &sym))
-      return sym;
+void ModuleSet::InsertSymbol(uint32_t hash, uint32_t module_pos,
+                             uint32_t export_index) {
+  size_t mask = symbol_index_.size() - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+    SymbolIndexEntry *entry = &symbol_index_[i];
+    if (entry->module_pos == kEmptySlot) {
+      entry->hash = hash;
+      entry->module_pos = module_pos;
+      entry->export_index = export_index;
+      symbol_index_count_++;
+      return;
+    }
+    // An earlier module's definition takes precedence.
+    if (entry->hash == hash &&
+        strcmp(modules_[entry->module_pos].GetExportedSymbolName(
+                   entry->export_index),
+               modules_[module_pos].GetExportedSymbolName(export_index))
+        == 0) {
+      return;
+    }
   }
-  return NULL;
 }
 
-bool ModuleSet::GetTlsSym(const char *name, uint32_t *module_id,
-                          uintptr_t *offset) {
-  for (auto &module : modules_) {
-    void *sym;
-    if (module.GetExportedSym(name, &sym)) {
-      *module_id = module.module_index();
-      *offset = (uintptr_t) sym;
-      return true;
+void ModuleSet::UpdateSymbolIndex() {
+  if (indexed_module_count_ == modules_.size())
+    return;
+
+  size_t needed = symbol_index_count_;
+  for (size_t pos = indexed_module_count_; pos < modules_.size(); ++pos)
+    needed += modules_[pos].root()->export_count;
+  if (needed * 2 > symbol_index_.size()) {
+    size_t size = 16;
+    while (size < needed * 2)
+      size *= 2;
+    SymbolIndexEntry empty = { 0, kEmptySlot, 0 };
+    std::vector<SymbolIndexEntry> old_index(size, empty);
+    old_index.swap(symbol_index_);
+    symbol_index_count_ = 0;
+    for (auto &entry : old_index) {
+      if (entry.module_pos != kEmptySlot)
+        InsertSymbol(entry.hash, entry.module_pos, entry.export_index);
+    }
+  }
+
+  for (; indexed_module_count_ < modules_.size(); ++indexed_module_count_) {
+    PLLModule &module = modules_[indexed_module_count_];
+    // The module's own hash table stores each symbol's hash, with the low
+    // bit used as an end-of-chain marker, so we recompute it here.
+    for (size_t index = 0, count = module.root()->export_count;
+         index < count; ++index) {
+      InsertSymbol(PLLModule::HashString(module.GetExportedSymbolName(index)),
+                   indexed_module_count_, index);
     }
   }
-  return false;
 }
 
-void ModuleSet::ResolveRefs() {
-  for (auto &module : modules_) {
+const ModuleSet::SymbolIndexEntry *ModuleSet::LookUpSymbol(const char *name) {
+  UpdateSymbolIndex();
+  if (symbol_index_count_ == 0)
+    return NULL;
+  uint32_t hash = PLLModule::HashString(name);
+  size_t mask = symbol_index_.size() - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+    const SymbolIndexEntry *entry = &symbol_index_[i];
+    if (entry->module_pos == kEmptySlot)
+      return NULL;
+    if (entry->hash == hash &&
+        strcmp(name, modules_[entry->module_pos].GetExportedSymbolName(
+                   entry->export_index)) == 0) {
+      return entry;
+    }
+  }
+}
+
+void *ModuleSet::GetSym(const char *name) {
+  const SymbolIndexEntry *entry = LookUpSymbol(name);
+  if (entry == NULL)
+    return NULL;
+  size_t module_pos = entry->module_pos;
+  void *sym = modules_[module_pos].root()->exported_ptrs[entry->export_index];
+  BindModule(module_pos);
+  return sym;
+}
+
+bool ModuleSet::GetTlsSym(const char *name, uint32_t *module_id,
+                          uintptr_t *offset) {
+  const SymbolIndexEntry *entry = LookUpSymbol(name);
+  if (entry == NULL)
+    return false;
+  size_t module_pos = entry->module_pos;
+  PLLModule &module = modules_[module_pos];
+  *module_id = module.module_index();
+  *offset = (uintptr_t) module.root()->exported_ptrs[entry->export_index];
+  // The TLS template may contain references to other modules.
+  BindModule(module_pos);
+  return true;
+}
+
+void ModuleSet::BindModule(size_t module_pos) {
+  std::vector<size_t> worklist(1, module_pos);
+  while (!worklist.empty()) {
+    size_t pos = worklist.back();
+    worklist.pop_back();
+    if (module_states_[pos] == kModuleAdded && pos != module_pos) {
+      // This can only happen in lazy mode, if a module added after
+      // ResolveRefs() defines a symbol that was previously undefined.
+      NaClLog(LOG_FATAL, "Module referenced before ResolveRefs() was "
+              "called for it\n");
+    }
+    if (module_states_[pos] != kModulePending)
+      continue;
+    module_states_[pos] = kModuleBound;
+    modules_bound_++;
+
+    PLLModule &module = modules_[pos];
     for (size_t index = 0, count = module.root()->import_count;
          index < count; ++index) {
       const char *sym_name = module.GetImportedSymbolName(index);
-      uintptr_t sym_value = (uintptr_t) GetSym(sym_name);
-      if (sym_value == 0) {
+      const SymbolIndexEntry *entry = LookUpSymbol(sym_name);
+      if (entry == NULL) {
         NaClLog(LOG_FATAL, "Undefined symbol: \"%s\"\n", sym_name);
       }
+      PLLModule &provider = modules_[entry->module_pos];
+      uintptr_t sym_value =
+          (uintptr_t) provider.root()->exported_ptrs[entry->export_index];
       *(uintptr_t *) module.root()->imported_ptrs[index] += sym_value;
+      worklist.push_back(entry->module_pos);
     }
 
-    module.InitializeTLS();
-  }
-
-  // The resolution of imported TLS variables requires that each module has an
-  // assigned "module_index". For this to be the case, all modules must have
-  // called "InitializeTLS" prior to resolving imported TLS variables.
-  for (auto &module : modules_) {
     for (size_t index = 0, count = module.root()->import_tls_count;
          index < count; ++index) {
       const char *sym_name = module.GetImportedTlsSymbolName(index);
-      uint32_t module_index;
-      uintptr_t offset;
-      if (!GetTlsSym(sym_name, &module_index, &offset)) {
+      const SymbolIndexEntry *entry = LookUpSymbol(sym_name);
+      if (entry == NULL) {
         NaClLog(LOG_FATAL, "Undefined TLS symbol: \"%s\"\n", sym_name);
       }
+      PLLModule &provider = modules_[entry->module_pos];
+      uintptr_t offset =
+          (uintptr_t) provider.root()->exported_ptrs[entry->export_index];
       PLLTLSVarGetter *var_getter = &module.root()->imported_tls_ptrs[index];
       var_getter->func = TLSVarGetter;
-      var_getter->arg1 = (void *) module_index;
+      var_getter->arg1 = (void *) (uintptr_t) provider.module_index();
       var_getter->arg2 = (void *) offset;
+      worklist.push_back(entry->module_pos);
     }
+
+    imports_resolved_ +=
+        module.root()->import_count + module.root()->import_tls_count;
+  }
+}
+
+void ModuleSet::ResolveRefs() {
+  // The resolution of imported TLS variables requires that each module has an
+  // assigned "module_index". For this to be the case, all modules must have
+  // called "InitializeTLS" prior to resolving imported TLS variables.
+  for (size_t pos = 0; pos < modules_.size(); ++pos) {
+    if (module_states_[pos] == kModuleAdded) {
+      modules_[pos].InitializeTLS();
+      module_states_[pos] = kModulePending;
+    }
+  }
+
+  if (lazy_binding_)
+    return;
+  for (size_t pos = 0; pos < modules_.size(); ++pos)
+    BindModule(pos);
+}
+
+ModuleSet::BindingStats ModuleSet::GetBindingStats() {
+  BindingStats stats;
+  stats.module_count = modules_.size();
+  stats.modules_bound = modules_bound_;
+  stats.import_count = 0;
+  for (auto &module : modules_) {
+    stats.import_count +=
+        module.root()->import_count + module.root()->import_tls_count;
   }
+  stats.imports_resolved = imports_resolved_;
+  return stats;
 }
@@ -21,7 +21,9 @@ class PLLModule {
 
   const PLLRoot *root() { return root_; }
 
-  uint32_t module_index() { return (uint32_t) root_->tls_block_getter->arg; }
+  uint32_t module_index() {
+    return (uint32_t) (uintptr_t) root_->tls_block_getter->arg;
+  }
 
   const char *GetExportedSymbolName(size_t i) {
     return root_->string_table + root_->exported_names[i];
@@ -54,11 +56,22 @@ class PLLModule {
 // ModuleSet represents a set of loaded PLLs.
 class ModuleSet {
  public:
+  ModuleSet()
+      : symbol_index_count_(0),
+        indexed_module_count_(0),
+        lazy_binding_(false),
+        modules_bound_(0),
+        imports_resolved_(0) {}
+
   // Load a PLL by filename. Does not add the filename to a known set of loaded
   // modules, and will not de-duplicate loading modules.
   // Returns a pointer to the PLL's pso_root.
   PLLRoot *AddByFilename(const char *filename);
 
+  // Add a PLL that has already been loaded, and load its dependencies by
+  // soname.  AddByFilename() uses this after loading the file.
+  void AddModule(const PLLRoot *root);
+
   // Change the search path used by the linker when looking for PLLs by soname.
   void SetSonameSearchPath(const std::vector<std::string> &dir_list);
 
@@ -66,8 +79,10 @@ class ModuleSet {
   // Returns a pointer to the PLL's pso_root if it is loaded, NULL otherwise.
   PLLRoot *AddBySoname(const char *soname);
 
-  // Looks up a symbol in the set of modules.  This does a linear search of
-  // the modules, in the order that they were added using AddByFilename().
+  // Looks up a symbol in the set of modules.  If more than one module
+  // exports the symbol, the one added first wins.  This uses a hash table
+  // of the symbols exported by all the modules, which is extended as
+  // modules are added.
   // This function is intended for non-TLS variables, though it currently won't
   // return any error if used on a TLS variable.
   // Returns NULL when symbol is not found.
@@ -82,14 +97,75 @@ class ModuleSet {
   bool GetTlsSym(const char *name, uint32_t *module_id, uintptr_t *offset);
 
   // Applies relocations to the modules, resolving references between them.
+  // Only modules added since the last call are processed.
   void ResolveRefs();
 
+  // Enables lazy binding, which must be done before ResolveRefs().  In this
+  // mode, ResolveRefs() only sets up TLS, and a module's imports are
+  // resolved when GetSym() or GetTlsSym() first returns one of its
+  // symbols, along with those of every module reachable from it.  A
+  // module's code and data can only be reached through its exports, so
+  // modules that are never reached never have their imports resolved.
+  // Undefined symbols are only reported when a module referring to them
+  // is reached.
+  void SetLazyBinding(bool lazy) { lazy_binding_ = lazy; }
+
+  struct BindingStats {
+    size_t module_count;
+    size_t modules_bound;
+    // Both of these count TLS imports too.
+    size_t import_count;
+    size_t imports_resolved;
+  };
+  BindingStats GetBindingStats();
+
  private:
   // The search path used to look for "sonames".
   std::vector<std::string> search_path_;
   // An unordered set of "sonames" (to see if a module has been loaded).
   std::unordered_set<std::string> sonames_;
   std::vector<PLLModule> modules_;
+
+  // An entry in symbol_index_, naming a module's exported symbol.
+  struct SymbolIndexEntry {
+    uint32_t hash;
+    // Index into modules_, or kEmptySlot for an unused entry.
+    uint32_t module_pos;
+    // Index into the module's exported symbols.
+    uint32_t export_index;
+  };
+  static const uint32_t kEmptySlot = ~(uint32_t) 0;
+
+  // Adds the exports of any modules added since the last call to the index.
+  void UpdateSymbolIndex();
+  void InsertSymbol(uint32_t hash, uint32_t module_pos, uint32_t export_index);
+  const SymbolIndexEntry *LookUpSymbol(const char *name);
+
+  enum ModuleState {
+    // Not yet processed by ResolveRefs().
+    kModuleAdded,
+    // TLS is set up but the imports have not been resolved.
+    kModulePending,
+    kModuleBound
+  };
+
+  // Resolves the imports of the module at modules_[module_pos], if it is
+  // pending, and of any pending modules that they refer to.
+  void BindModule(size_t module_pos);
+
+  // Open-addressed hash table, keyed by PLLModule::HashString(), with
+  // linear probing.  Its size is a power of two and it is kept at most
+  // half full.
+  std::vector<SymbolIndexEntry> symbol_index_;
+  size_t symbol_index_count_;
+  // The number of modules_ whose exports are in symbol_index_.
+  size_t indexed_module_count_;
+
+  // The state of each of modules_.
+  std::vector<ModuleState> module_states_;
+  bool lazy_binding_;
+  size_t modules_bound_;
+  size_t imports_resolved_;
 };
 
 #endif
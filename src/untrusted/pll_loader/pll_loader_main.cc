@@ -4,9 +4,11 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "native_client/src/include/elf32.h"
 #include "native_client/src/include/elf_auxv.h"
+#include "native_client/src/shared/platform/nacl_log.h"
 #include "native_client/src/untrusted/nacl/nacl_irt.h"
 #include "native_client/src/untrusted/pll_loader/pll_loader.h"
 
@@ -24,6 +26,10 @@ int main(int argc, char **argv, char **envp) {
   std::vector<std::string> search_path;
   search_path.push_back(argv[1]);
   modset.SetSonameSearchPath(search_path);
+  // Only resolve the imports of modules that are reachable from the entry
+  // point.  See ModuleSet::SetLazyBinding().
+  if (getenv("PLL_LOADER_LAZY_BINDING") != NULL)
+    modset.SetLazyBinding(true);
 
   modset.AddByFilename(argv[2]);
   modset.ResolveRefs();
@@ -40,6 +46,11 @@ int main(int argc, char **argv, char **envp) {
     fprintf(stderr, "Entry point symbol \"__libc_start\" not defined\n");
     return 1;
   }
+  ModuleSet::BindingStats stats = modset.GetBindingStats();
+  NaClLog(1, "pll_loader: resolved imports of %u of %u modules "
+          "(%u of %u imports)\n",
+          (unsigned) stats.modules_bound, (unsigned) stats.module_count,
+          (unsigned) stats.imports_resolved, (unsigned) stats.import_count);
   start_func(argc, argv, envp, auxv);
 
   return 0;
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Compares random 4k reads done one at a time with pread() and kept
+ * in flight through the "nacl-irt-dev-aio" interface.
+ *
+ *   aio_benchmark <temp_file> [file_size] [queue_depth]
+ *
+ * Reads that hit the page cache measure per-request overhead; run with
+ * a file larger than memory (or after dropping caches) to measure IOPS.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_aio.h"
+#include "native_client/src/untrusted/irt/irt_dev.h"
+
+#define BLOCK_SIZE 4096
+#define ENTRIES 64
+
+struct BenchRing {
+  struct nacl_abi_aio_ring header;
+  struct nacl_abi_aio_sqe sqe[ENTRIES];
+  struct nacl_abi_aio_cqe cqe[ENTRIES];
+};
+
+static const int kReads = 20000;
+
+static struct nacl_irt_dev_aio g_aio;
+static struct BenchRing g_ring __attribute__((aligned(8)));
+static char g_bufs[ENTRIES][BLOCK_SIZE];
+
+static double now_us(void) {
+  struct timespec ts;
+  ASSERT_EQ(0, clock_gettime(CLOCK_MONOTONIC, &ts));
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int64_t RandomBlock(uint32_t *seed, size_t blocks) {
+  *seed = *seed * 1103515245 + 12345;
+  return (int64_t) ((*seed >> 8) % blocks) * BLOCK_SIZE;
+}
+
+static double RunPread(int fd, size_t blocks) {
+  uint32_t seed = 1;
+  double start = now_us();
+  int i;
+
+  for (i = 0; i < kReads; ++i) {
+    ASSERT_EQ(pread(fd, g_bufs[0], BLOCK_SIZE, RandomBlock(&seed, blocks)),
+              BLOCK_SIZE);
+  }
+  return now_us() - start;
+}
+
+static double RunAio(int fd, size_t blocks, uint32_t depth) {
+  volatile struct nacl_abi_aio_ring *header = &g_ring.header;
+  uint32_t free_bufs[ENTRIES];
+  uint32_t num_free = 0;
+  uint32_t seed = 1;
+  int queued = 0;
+  int done = 0;
+  size_t submitted;
+  int ring_id;
+  double start;
+
+  while (num_free < depth) {
+    free_bufs[num_free] = num_free;
+    num_free++;
+  }
+  ASSERT_EQ(g_aio.setup(&g_ring, ENTRIES, &ring_id), 0);
+  start = now_us();
+  while (done < kReads) {
+    /*
+     * Top up to |depth| requests in flight.  Requests complete out of
+     * order, so each takes a buffer from the free list and names it in
+     * user_data.
+     */
+    while (queued < kReads && num_free > 0) {
+      struct nacl_abi_aio_sqe *sqe =
+          &g_ring.sqe[header->sq_tail & (ENTRIES - 1)];
+      uint32_t buf = free_bufs[--num_free];
+      sqe->opcode = NACL_ABI_AIO_PREAD;
+      sqe->desc = fd;
+      sqe->buf = (uint32_t) (uintptr_t) g_bufs[buf];
+      sqe->len = BLOCK_SIZE;
+      sqe->offset = RandomBlock(&seed, blocks);
+      sqe->user_data = buf;
+      __sync_synchronize();
+      header->sq_tail++;
+      queued++;
+    }
+    ASSERT_EQ(g_aio.enter(ring_id, header->sq_tail - header->sq_head, 1,
+                          &submitted), 0);
+    __sync_synchronize();
+    while (header->cq_head != header->cq_tail) {
+      struct nacl_abi_aio_cqe *cqe =
+          &g_ring.cqe[header->cq_head & (ENTRIES - 1)];
+      ASSERT_EQ(cqe->result, BLOCK_SIZE);
+      free_bufs[num_free++] = (uint32_t) cqe->user_data;
+      header->cq_head++;
+      done++;
+    }
+  }
+  start = now_us() - start;
+  ASSERT_EQ(g_aio.destroy(ring_id), 0);
+  return start;
+}
+
+int main(int argc, char **argv) {
+  size_t file_size = argc > 2 ? strtoul(argv[2], NULL, 0) : 64 << 20;
+  uint32_t depth = argc > 3 ? strtoul(argv[3], NULL, 0) : 32;
+  size_t blocks = file_size / BLOCK_SIZE;
+  double pread_us;
+  double aio_us;
+  size_t i;
+  int fd;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: aio_benchmark <temp_file> [size] [depth]\n");
+    return 1;
+  }
+  ASSERT_GT(blocks, 0);
+  ASSERT_GT(depth, 0);
+  ASSERT_LE(depth, ENTRIES);
+  ASSERT_EQ(nacl_interface_query(NACL_IRT_DEV_AIO_v0_1, &g_aio,
+                                 sizeof(g_aio)), sizeof(g_aio));
+
+  fd = open(argv[1], O_RDWR | O_CREAT | O_TRUNC, 0600);
+  ASSERT_GE(fd, 0);
+  memset(g_bufs[0], 0x5a, BLOCK_SIZE);
+  for (i = 0; i < blocks; ++i)
+    ASSERT_EQ(write(fd, g_bufs[0], BLOCK_SIZE), BLOCK_SIZE);
+
+  pread_us = RunPread(fd, blocks);
+  aio_us = RunAio(fd, blocks, depth);
+
+  printf("%d random %d byte reads from a %u byte file\n",
+         kReads, BLOCK_SIZE, (unsigned) file_size);
+  printf("pread:                 %10.0f IOPS\n", kReads * 1e6 / pread_us);
+  printf("aio, queue depth %3u:  %10.0f IOPS\n", (unsigned) depth,
+         kReads * 1e6 / aio_us);
+
+  ASSERT_EQ(close(fd), 0);
+  return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Tests the "nacl-irt-dev-aio" IRT interface.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_aio.h"
+#include "native_client/src/untrusted/irt/irt_dev.h"
+
+#define ENTRIES 8
+
+struct TestRing {
+  struct nacl_abi_aio_ring header;
+  struct nacl_abi_aio_sqe sqe[ENTRIES];
+  struct nacl_abi_aio_cqe cqe[ENTRIES];
+};
+
+static struct nacl_irt_dev_aio g_aio;
+static struct TestRing g_ring __attribute__((aligned(8)));
+
+static char const kData[] = "The quick brown fox jumps over the lazy dog";
+
+static void Queue(uint32_t opcode, int fd, void *buf, size_t len,
+                  int64_t offset, uint64_t user_data) {
+  struct nacl_abi_aio_sqe *sqe = &g_ring.sqe[g_ring.header.sq_tail
+                                             & (ENTRIES - 1)];
+  sqe->opcode = opcode;
+  sqe->desc = fd;
+  sqe->buf = (uint32_t) (uintptr_t) buf;
+  sqe->len = len;
+  sqe->offset = offset;
+  sqe->user_data = user_data;
+  /* The SQE must be visible before the new sq_tail. */
+  __sync_synchronize();
+  ((volatile struct nacl_abi_aio_ring *) &g_ring.header)->sq_tail++;
+}
+
+static size_t Submit(int ring_id, size_t to_submit, size_t min_complete) {
+  size_t submitted;
+  ASSERT_EQ(g_aio.enter(ring_id, to_submit, min_complete, &submitted), 0);
+  return submitted;
+}
+
+static struct nacl_abi_aio_cqe Reap(void) {
+  volatile struct nacl_abi_aio_ring *header = &g_ring.header;
+  struct nacl_abi_aio_cqe cqe;
+  ASSERT_NE(header->cq_head, header->cq_tail);
+  __sync_synchronize();
+  cqe = g_ring.cqe[header->cq_head & (ENTRIES - 1)];
+  header->cq_head++;
+  return cqe;
+}
+
+static void TestSetupErrors(void) {
+  int ring_id;
+
+  ASSERT_EQ(g_aio.setup(&g_ring, 0, &ring_id), EINVAL);
+  ASSERT_EQ(g_aio.setup(&g_ring, 3, &ring_id), EINVAL);
+  ASSERT_EQ(g_aio.setup(&g_ring, NACL_ABI_AIO_MAX_ENTRIES * 2, &ring_id),
+            EINVAL);
+  ASSERT_EQ(g_aio.setup((char *) &g_ring + 4, ENTRIES, &ring_id), EINVAL);
+  ASSERT_EQ(g_aio.setup((void *) 0xfffffff8, ENTRIES, &ring_id), EFAULT);
+  ASSERT_EQ(g_aio.destroy(NACL_ABI_AIO_MAX_RINGS), EBADF);
+}
+
+static void TestReadWrite(const char *filename) {
+  char buf[sizeof kData];
+  struct nacl_abi_aio_cqe cqe;
+  int ring_id;
+  int fd;
+
+  ASSERT_EQ(sizeof g_ring, NACL_ABI_AIO_RING_SIZE(ENTRIES));
+  ASSERT_EQ(g_aio.setup(&g_ring, ENTRIES, &ring_id), 0);
+  ASSERT_EQ(g_ring.header.entries, ENTRIES);
+  ASSERT_EQ(g_ring.header.sq_head, 0);
+  ASSERT_EQ(g_ring.header.cq_tail, 0);
+
+  fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  ASSERT_GE(fd, 0);
+
+  /* Write the data in two pieces, out of order. */
+  Queue(NACL_ABI_AIO_PWRITE, fd, (void *) (kData + 4), sizeof kData - 4, 4,
+        2);
+  Queue(NACL_ABI_AIO_PWRITE, fd, (void *) kData, 4, 0, 1);
+  ASSERT_EQ(Submit(ring_id, 2, 2), 2);
+  ASSERT_EQ(g_ring.header.sq_head, 2);
+  ASSERT_EQ(g_ring.header.cq_tail, 2);
+  cqe = Reap();
+  ASSERT_EQ(cqe.result, cqe.user_data == 1 ? 4 : (int) sizeof kData - 4);
+  cqe = Reap();
+  ASSERT_EQ(cqe.result, cqe.user_data == 1 ? 4 : (int) sizeof kData - 4);
+
+  Queue(NACL_ABI_AIO_FSYNC, fd, NULL, 0, 0, 3);
+  ASSERT_EQ(Submit(ring_id, 1, 1), 1);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 3);
+  ASSERT_EQ(cqe.result, 0);
+
+  memset(buf, 0, sizeof buf);
+  Queue(NACL_ABI_AIO_PREAD, fd, buf, sizeof buf, 0, 4);
+  ASSERT_EQ(Submit(ring_id, 1, 1), 1);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 4);
+  ASSERT_EQ(cqe.result, sizeof kData);
+  ASSERT_EQ(memcmp(buf, kData, sizeof kData), 0);
+
+  /* Reading at the end of the file returns 0. */
+  Queue(NACL_ABI_AIO_PREAD, fd, buf, sizeof buf, sizeof kData, 5);
+  ASSERT_EQ(Submit(ring_id, 1, 1), 1);
+  cqe = Reap();
+  ASSERT_EQ(cqe.result, 0);
+
+  ASSERT_EQ(close(fd), 0);
+  ASSERT_EQ(g_aio.destroy(ring_id), 0);
+  ASSERT_EQ(g_aio.destroy(ring_id), EBADF);
+}
+
+static void TestRequestErrors(const char *filename) {
+  char buf[16];
+  struct nacl_abi_aio_cqe cqe;
+  size_t submitted;
+  int ring_id;
+  int fd;
+  int i;
+
+  ASSERT_EQ(g_aio.setup(&g_ring, ENTRIES, &ring_id), 0);
+  fd = open(filename, O_RDONLY);
+  ASSERT_GE(fd, 0);
+
+  /* Bad requests are accepted and complete with an error. */
+  Queue(NACL_ABI_AIO_PREAD, -1, buf, sizeof buf, 0, 1);
+  Queue(99, fd, buf, sizeof buf, 0, 2);
+  Queue(NACL_ABI_AIO_PREAD, fd, (void *) 0xfffff000, 0x2000, 0, 3);
+  Queue(NACL_ABI_AIO_PREAD, fd, buf, sizeof buf, -1, 4);
+  ASSERT_EQ(Submit(ring_id, 4, 4), 4);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 1);
+  ASSERT_EQ(cqe.result, -EBADF);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 2);
+  ASSERT_EQ(cqe.result, -EINVAL);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 3);
+  ASSERT_EQ(cqe.result, -EFAULT);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 4);
+  ASSERT_EQ(cqe.result, -EINVAL);
+
+  /*
+   * Completions that do not fit in the CQ are held back, and count
+   * against the ENTRIES requests a ring may have outstanding.
+   */
+  for (i = 0; i < ENTRIES; ++i)
+    Queue(NACL_ABI_AIO_PREAD, fd, buf, sizeof buf, 0, i);
+  ASSERT_EQ(Submit(ring_id, ENTRIES, ENTRIES), ENTRIES);
+  for (i = 0; i < ENTRIES; ++i)
+    Queue(NACL_ABI_AIO_PREAD, fd, buf, sizeof buf, 0, ENTRIES + i);
+  ASSERT_EQ(Submit(ring_id, ENTRIES, 0), ENTRIES);
+  Queue(NACL_ABI_AIO_PREAD, fd, buf, sizeof buf, 0, 2 * ENTRIES);
+  ASSERT_EQ(Submit(ring_id, 1, 0), 0);
+  for (i = 0; i < ENTRIES; ++i) {
+    cqe = Reap();
+    ASSERT_LT(cqe.user_data, ENTRIES);
+  }
+  ASSERT_EQ(Submit(ring_id, 0, ENTRIES), 0);
+  for (i = 0; i < ENTRIES; ++i) {
+    cqe = Reap();
+    ASSERT_GE(cqe.user_data, ENTRIES);
+    ASSERT_EQ(cqe.result, sizeof buf);
+  }
+  ASSERT_EQ(Submit(ring_id, 1, 1), 1);
+  cqe = Reap();
+  ASSERT_EQ(cqe.user_data, 2 * ENTRIES);
+
+  /* sq_tail may not run more than ENTRIES ahead of sq_head. */
+  g_ring.header.sq_tail += ENTRIES + 1;
+  ASSERT_EQ(g_aio.enter(ring_id, 1, 0, &submitted), EINVAL);
+
+  ASSERT_EQ(close(fd), 0);
+  ASSERT_EQ(g_aio.destroy(ring_id), 0);
+  ASSERT_EQ(g_aio.enter(ring_id, 0, 0, &submitted), EBADF);
+}
+
+int main(int argc, char **argv) {
+  size_t size;
+
+  if (argc != 2) {
+    fprintf(stderr, "Usage: aio_test <temp_file>\n");
+    return 1;
+  }
+  size = nacl_interface_query(NACL_IRT_DEV_AIO_v0_1, &g_aio, sizeof(g_aio));
+  ASSERT_EQ(size, sizeof(g_aio));
+
+  TestSetupErrors();
+  TestReadWrite(argv[1]);
+  TestRequestErrors(argv[1]);
+
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Checks that the IRT's clock_gettime(), which reads the service
+ * runtime's clock page when it is enabled, agrees with the
+ * clock_gettime syscall and never goes backwards.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/untrusted/irt/irt.h"
+#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+
+/* Service runtime clock ids; see clock_irt_test.c. */
+#define NACL_CLOCK_REALTIME  0
+#define NACL_CLOCK_MONOTONIC 1
+
+/* Allowed disagreement between the page and the host clock. */
+static const int64_t kToleranceNs = 10 * 1000 * 1000;
+
+static struct nacl_irt_clock g_irt_clock;
+
+static int64_t TimespecToNs(const struct timespec *ts) {
+  return (int64_t) ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+static int64_t IrtNowNs(nacl_irt_clockid_t clk_id) {
+  struct timespec ts;
+  ASSERT_EQ(g_irt_clock.clock_gettime(clk_id, &ts), 0);
+  return TimespecToNs(&ts);
+}
+
+static int64_t SyscallNowNs(nacl_irt_clockid_t clk_id) {
+  struct timespec ts;
+  ASSERT_EQ(NACL_SYSCALL(clock_gettime)(clk_id, &ts), 0);
+  return TimespecToNs(&ts);
+}
+
+static void TestAgreesWithSyscall(nacl_irt_clockid_t clk_id) {
+  int i;
+  for (i = 0; i < 1000; i++) {
+    int64_t before = SyscallNowNs(clk_id);
+    int64_t now = IrtNowNs(clk_id);
+    int64_t after = SyscallNowNs(clk_id);
+    ASSERT_GE(now, before - kToleranceNs);
+    ASSERT_LE(now, after + kToleranceNs);
+  }
+}
+
+static void TestMonotonic(void) {
+  int64_t last = IrtNowNs(NACL_CLOCK_MONOTONIC);
+  int64_t deadline = last + 200 * 1000 * 1000;
+  /* Run across several updates of the clock page. */
+  while (last < deadline) {
+    int64_t now = IrtNowNs(NACL_CLOCK_MONOTONIC);
+    ASSERT_GE(now, last);
+    last = now;
+  }
+}
+
+int main(void) {
+  struct timespec delay = { 0, 50 * 1000 * 1000 };
+  size_t size = nacl_interface_query(NACL_IRT_CLOCK_v0_1, &g_irt_clock,
+                                     sizeof(g_irt_clock));
+  ASSERT_EQ(size, sizeof(g_irt_clock));
+
+  /* Give the service runtime time to calibrate the clock page. */
+  ASSERT_EQ(nanosleep(&delay, NULL), 0);
+
+  TestAgreesWithSyscall(NACL_CLOCK_REALTIME);
+  TestAgreesWithSyscall(NACL_CLOCK_MONOTONIC);
+  TestMonotonic();
+
+  printf("PASSED\n");
+  return 0;
+}
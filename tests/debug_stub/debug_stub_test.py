@@ -49,6 +49,11 @@ def EncodeHex(data):
   return ''.join('%02x' % ord(byte) for byte in data)
 
 
+def EncodeBinary(data):
+  return ''.join('}' + chr(ord(byte) ^ 0x20) if byte in '}#$*' else byte
+                 for byte in data)
+
+
 def DecodeEscaping(data):
   ret = ''
   last = None
@@ -332,11 +337,18 @@ def GetSymbols():
 
 
 def ParseThreadStopReply(reply):
-  match = re.match('T([0-9a-f]{2})thread:([0-9a-f]+);$', reply)
+  match = re.match('T([0-9a-f]{2})thread:([0-9a-f]+);'
+                   '((?:[0-9a-f]+:[0-9a-f]+;)*)$', reply)
   if match is None:
     raise AssertionError('Bad thread stop reply: %r' % reply)
+  # Expedited registers, as register number -> raw register value.
+  registers = {}
+  for pair in match.group(3).split(';')[:-1]:
+    regno, value = pair.split(':')
+    registers[int(regno, 16)] = DecodeHex(value)
   return {'signal': int(match.group(1), 16),
-          'thread_id': int(match.group(2), 16)}
+          'thread_id': int(match.group(2), 16),
+          'registers': registers}
 
 
 def AssertReplySignal(reply, signal):
@@ -349,6 +361,30 @@ def ReadMemory(connection, address, size):
   return DecodeHex(reply)
 
 
+def ReadMemoryBinary(connection, address, size):
+  reply = connection.RspRequest('x%x,%x' % (address, size))
+  assert reply.startswith('b'), reply
+  return DecodeEscaping(reply[1:])
+
+
+def GetPacketSize(connection):
+  reply = connection.RspRequest('qSupported')
+  match = re.search('PacketSize=([0-9a-f]+)', reply)
+  assert match is not None, reply
+  return int(match.group(1), 16)
+
+
+def XferRead(connection, obj, annex, chunk_size):
+  data = ''
+  while True:
+    reply = connection.RspRequest('qXfer:%s:read:%s:%x,%x'
+                                  % (obj, annex, len(data), chunk_size))
+    assert reply[0] in 'ml', reply
+    data += DecodeEscaping(reply[1:])
+    if reply[0] == 'l':
+      return data
+
+
 def ReadUint32(connection, address):
   return struct.unpack('I', ReadMemory(connection, address, 4))[0]
 
@@ -370,10 +406,12 @@ class DebugStubTest(unittest.TestCase):
       AssertReplySignal(reply, NACL_SIGTRAP)
 
   def CheckTargetXml(self, connection):
-    reply = connection.RspRequest('qXfer:features:read:target.xml:0,fff')
-    self.assertEquals(reply[0], 'l')
+    target_xml = XferRead(connection, 'features', 'target.xml', 0xfff)
     # Just check that we are given parsable XML.
-    xml.etree.ElementTree.fromstring(reply[1:])
+    xml.etree.ElementTree.fromstring(target_xml)
+    # Reading in small chunks must give the same result.
+    self.assertEquals(XferRead(connection, 'features', 'target.xml', 0x10),
+                      target_xml)
 
   # Test that we can fetch register values.
   # This check corresponds to the last instruction of debugger_test.c
@@ -623,6 +661,69 @@ class DebugStubTest(unittest.TestCase):
 
       self.CheckReadMemoryAtInvalidAddr(connection)
 
+  def test_binary_memory_transfer(self):
+    with LaunchDebugStub('test_getting_registers') as connection:
+      mem_addr = GetSymbols()['g_example_var']
+      expected_data = 'some_debug_stub_test_data\0'
+      self.assertEquals(
+          ReadMemoryBinary(connection, mem_addr, len(expected_data)),
+          expected_data)
+
+      # GDB probes for 'X' support with an empty write.
+      self.assertEquals(connection.RspRequest('X%x,0:' % mem_addr), 'OK')
+
+      # Write data that needs escaping and check it with both 'm' and 'x'.
+      new_data = 'a}b#c$d*e\0\xff'
+      assert len(new_data) < len(expected_data)
+      reply = connection.RspRequest('X%x,%x:%s' % (mem_addr, len(new_data),
+                                                   EncodeBinary(new_data)))
+      self.assertEquals(reply, 'OK')
+      self.assertEquals(ReadMemory(connection, mem_addr, len(new_data)),
+                        new_data)
+      self.assertEquals(ReadMemoryBinary(connection, mem_addr, len(new_data)),
+                        new_data)
+
+      # Truncated data is rejected.
+      reply = connection.RspRequest('X%x,%x:ab' % (mem_addr, 3))
+      self.assertTrue(reply.startswith('E'))
+
+      # Code cannot be modified through 'X' either.
+      func_addr = GetSymbols()['breakpoint_target_func']
+      reply = connection.RspRequest('X%x,1:\x00' % func_addr)
+      self.assertEquals(reply, 'E03')
+
+      reply = connection.RspRequest('x0,4')
+      self.assertTrue(reply.startswith('E'))
+
+  def test_memory_transfer_large_reads(self):
+    with LaunchDebugStub('test_getting_registers') as connection:
+      mem_addr = GetSymbols()['g_memory_transfer_buffer']
+      size = 256 * 1024
+      packet_size = GetPacketSize(connection)
+      # Bytes that compress badly and include characters needing escapes.
+      data = ''.join(chr((index * 7919 + index / 251) % 256)
+                     for index in xrange(size))
+
+      # Escaping at most doubles the size of the data.
+      chunk = packet_size / 2 - 64
+      for offset in xrange(0, size, chunk):
+        piece = data[offset:offset + chunk]
+        reply = connection.RspRequest('X%x,%x:%s' % (
+            mem_addr + offset, len(piece), EncodeBinary(piece)))
+        self.assertEquals(reply, 'OK')
+
+      def CheckRead(read_function, chunk):
+        result = ''.join(read_function(connection, mem_addr + offset,
+                                       min(chunk, size - offset))
+                         for offset in xrange(0, size, chunk))
+        self.assertEquals(result, data)
+
+      # 0x800 bytes is what GDB reads per 'm' packet with the old
+      # PacketSize of 0x1000.
+      CheckRead(ReadMemory, 0x800)
+      CheckRead(ReadMemory, chunk)
+      CheckRead(ReadMemoryBinary, chunk)
+
   def test_exit_code(self):
     with LaunchDebugStub('test_exit_code') as connection:
       reply = connection.RspRequest('c')
@@ -693,7 +794,22 @@ class DebugStubTest(unittest.TestCase):
       reply = connection.RspRequest('vCont;s:%x;c' % tid)
       # WARNING! This check is valid in single-threaded case only!
       # In multi-threaded case another thread might stop first.
-      self.assertEqual(reply, 'T05thread:%x;' % tid)
+      AssertReplySignal(reply, NACL_SIGTRAP)
+      self.assertEqual(ParseThreadStopReply(reply)['thread_id'], tid)
+
+      # The same, spelled with signals, which are ignored.
+      reply = connection.RspRequest('vCont;S00:%x;C00' % tid)
+      AssertReplySignal(reply, NACL_SIGTRAP)
+      self.assertEqual(ParseThreadStopReply(reply)['thread_id'], tid)
+
+      # The stop reply expedites the instruction pointer.
+      regs = DecodeRegs(connection.RspRequest('g'))
+      reg_names = [name for name, fmt in REG_DEFS[ARCH]]
+      ip_index = reg_names.index(IP_REG[ARCH])
+      ip_fmt = REG_DEFS[ARCH][ip_index][1]
+      expedited = ParseThreadStopReply(reply)['registers']
+      self.assertEqual(struct.unpack(ip_fmt, expedited[ip_index])[0],
+                       regs[IP_REG[ARCH]])
 
       # Try to continue the thread and to single-step all others.
       reply = connection.RspRequest('vCont;c:%x;s' % tid)
@@ -707,6 +823,10 @@ class DebugStubTest(unittest.TestCase):
       reply = connection.RspRequest('vCont;s')
       self.assertTrue(reply.startswith('E'))
 
+      # Stopping threads is not supported.
+      reply = connection.RspRequest('vCont;t')
+      self.assertTrue(reply.startswith('E'))
+
   def test_interrupt(self):
     if not SingleSteppingWorks():
       return
@@ -928,7 +1048,8 @@ class DebugStubTest(unittest.TestCase):
       SkipBreakpoint(connection, reply)
 
       reply = connection.RspRequest('vCont;s:1')
-      self.assertEquals(reply, 'T05thread:1;')
+      AssertReplySignal(reply, NACL_SIGTRAP)
+      self.assertEquals(ParseThreadStopReply(reply)['thread_id'], 1)
 
       regs = DecodeRegs(connection.RspRequest('g'))
 
@@ -984,6 +1105,44 @@ class DebugStubBreakpointTest(unittest.TestCase):
       reply = connection.RspRequest('c')
       self.assertEquals(reply, 'W00')
 
+  def test_conditional_breakpoint(self):
+    symbols = GetSymbols()
+    func_addr = symbols['conditional_breakpoint_target_func']
+    counter_addr = symbols['g_loop_counter']
+    with LaunchDebugStub('test_conditional_breakpoint') as connection:
+      reply = connection.RspRequest('qSupported')
+      self.assertTrue('ConditionalBreakpoints+' in reply.split(';'))
+
+      def SetCondition(expr):
+        return connection.RspRequest('Z0,%x,0;X%x,%s' % (
+            func_addr, len(expr), EncodeHex(expr)))
+
+      # g_loop_counter == 500, as GDB compiles it:
+      # const32 &g_loop_counter, ref32, const16 500, equal, end.
+      expr = struct.pack('>BIBBHBB', 0x24, counter_addr, 0x19,
+                         0x23, 500, 0x13, 0x27)
+      self.assertEquals(SetCondition(expr), 'OK')
+
+      # The first 500 hits are handled inside the stub.
+      reply = connection.RspRequest('c')
+      AssertReplySignal(reply, NACL_SIGTRAP)
+      self.CheckInstructionPtr(connection, func_addr)
+      self.assertEquals(ReadUint32(connection, counter_addr), 500)
+
+      # A condition that fails to evaluate (here, dividing by zero)
+      # stops the program.  Resending Z0 replaces the condition.
+      self.assertEquals(SetCondition('\x22\x01\x22\x00\x05\x27'), 'OK')
+      reply = connection.RspRequest('c')
+      AssertReplySignal(reply, NACL_SIGTRAP)
+      self.CheckInstructionPtr(connection, func_addr)
+      self.assertEquals(ReadUint32(connection, counter_addr), 500)
+
+      # With a condition that is never true, the program runs to the end,
+      # stepping over the breakpoint it is stopped at first.
+      self.assertEquals(SetCondition('\x22\x00\x27'), 'OK')
+      reply = connection.RspRequest('c')
+      self.assertEquals(reply, 'W00')
+
   def test_setting_breakpoint_on_invalid_address(self):
     with LaunchDebugStub('test_exit_code') as connection:
       # Requesting a breakpoint on an invalid address should give an error.
@@ -18,8 +18,12 @@
 /* This variable is used for testing memory accesses. */
 char g_example_var[] = "some_debug_stub_test_data";
 
+/* This buffer is used for measuring bulk memory transfer speed. */
+char g_memory_transfer_buffer[256 * 1024];
+
 volatile uint32_t g_main_thread_var = 0;
 volatile uint32_t g_child_thread_var = 0;
+volatile uint32_t g_loop_counter = 0;
 
 
 /*
@@ -167,6 +171,18 @@ void breakpoint_target_func(void) {
   __asm__("");
 }
 
+/* The test sets a conditional breakpoint on this function. */
+__attribute__((noinline))
+void conditional_breakpoint_target_func(void) {
+  __asm__("");
+}
+
+void test_conditional_breakpoint(void) {
+  for (g_loop_counter = 0; g_loop_counter < 1000; g_loop_counter++) {
+    conditional_breakpoint_target_func();
+  }
+}
+
 int non_zero_return(void) {
   return 2;
 }
@@ -324,6 +340,10 @@ int main(int argc, char **argv) {
     breakpoint_target_func();
     return 0;
   }
+  if (strcmp(argv[1], "test_conditional_breakpoint") == 0) {
+    test_conditional_breakpoint();
+    return 0;
+  }
   if (strcmp(argv[1], "test_exit_code") == 0) {
     return non_zero_return();
   }
@@ -64,7 +64,7 @@ class GdbRspConnection(object):
     reply = ''
     message_finished = re.compile('#[0-9a-fA-F]{2}')
     while True:
-      data = self._socket.recv(1024)
+      data = self._socket.recv(65536)
       if len(data) == 0:
         raise AssertionError('EOF on socket reached with '
                              'incomplete reply message: %r' % reply)
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Tests the "nacl-irt-dev-dirty-pages" IRT interface.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_dirty_pages.h"
+#include "native_client/src/untrusted/irt/irt_dev.h"
+
+#define PAGES 64
+
+static struct nacl_irt_dev_dirty_pages g_dirty;
+static uint8_t g_bitmap[PAGES / 8];
+
+static size_t GetDirty(char *start, size_t pages, uint32_t flags) {
+  size_t count;
+  memset(g_bitmap, 0, sizeof g_bitmap);
+  ASSERT_EQ(g_dirty.get_dirty_pages(start, pages * NACL_ABI_DIRTY_PAGE_SIZE,
+                                    g_bitmap, flags, &count), 0);
+  return count;
+}
+
+static int IsDirty(size_t page) {
+  return (g_bitmap[page / 8] >> (page % 8)) & 1;
+}
+
+static char *MapPages(size_t pages) {
+  void *addr = mmap(NULL, pages * NACL_ABI_DIRTY_PAGE_SIZE,
+                    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0);
+  ASSERT_NE(addr, MAP_FAILED);
+  return addr;
+}
+
+static void TestErrors(void) {
+  char *mem = MapPages(1);
+  size_t count;
+
+  ASSERT_EQ(g_dirty.get_dirty_pages(mem + 1, 1, g_bitmap, 0, &count),
+            EINVAL);
+  ASSERT_EQ(g_dirty.get_dirty_pages(mem, 0, g_bitmap, 0, &count), EINVAL);
+  ASSERT_EQ(g_dirty.get_dirty_pages(mem, 1, g_bitmap, 0x80, &count), EINVAL);
+  ASSERT_EQ(g_dirty.get_dirty_pages((void *) 0xfffff000, 0x2000, g_bitmap,
+                                    0, &count), EFAULT);
+  ASSERT_EQ(g_dirty.get_dirty_pages(mem, 1, (uint8_t *) 0xffffffff, 0,
+                                    &count), EFAULT);
+  /* Code pages are never writable, so there is nothing to track. */
+  ASSERT_EQ(g_dirty.get_dirty_pages((void *) 0x20000, 1, g_bitmap, 0,
+                                    &count), EACCES);
+  ASSERT_EQ(munmap(mem, NACL_ABI_DIRTY_PAGE_SIZE), 0);
+}
+
+static void TestTracking(const char *filename) {
+  char *mem = MapPages(PAGES);
+  size_t count;
+  size_t i;
+  int fd;
+
+  /* Pages are reported dirty the first time they are asked about. */
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), PAGES);
+  for (i = 0; i < PAGES; ++i)
+    ASSERT(IsDirty(i));
+
+  memset(g_bitmap, 0, sizeof g_bitmap);
+  if (g_dirty.get_dirty_pages(mem, PAGES * NACL_ABI_DIRTY_PAGE_SIZE,
+                              g_bitmap, NACL_ABI_DIRTY_PAGES_EXACT,
+                              &count) == ENOSYS) {
+    /* The host cannot track writes, so every page is always dirty. */
+    printf("Exact dirty page tracking is not available\n");
+    ASSERT_EQ(GetDirty(mem, PAGES, 0), PAGES);
+    ASSERT_EQ(munmap(mem, PAGES * NACL_ABI_DIRTY_PAGE_SIZE), 0);
+    return;
+  }
+
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), 0);
+  mem[3 * NACL_ABI_DIRTY_PAGE_SIZE] = 1;
+  mem[40 * NACL_ABI_DIRTY_PAGE_SIZE + 17] = 1;
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), 2);
+  ASSERT(IsDirty(3));
+  ASSERT(IsDirty(40));
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), 0);
+
+  /* Writes made by the service runtime count too. */
+  fd = open(filename, O_RDONLY);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(read(fd, mem + 10 * NACL_ABI_DIRTY_PAGE_SIZE + 100, 16), 16);
+  ASSERT_EQ(close(fd), 0);
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), 1);
+  ASSERT(IsDirty(10));
+
+  /* Scanning part of the range leaves the rest alone. */
+  mem[20 * NACL_ABI_DIRTY_PAGE_SIZE] = 1;
+  mem[30 * NACL_ABI_DIRTY_PAGE_SIZE] = 1;
+  ASSERT_EQ(GetDirty(mem + 16 * NACL_ABI_DIRTY_PAGE_SIZE, 8, 0), 1);
+  ASSERT(IsDirty(4));
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), 1);
+  ASSERT(IsDirty(30));
+
+  /* A remapped page is reported dirty. */
+  ASSERT_EQ(mmap(mem + 50 * NACL_ABI_DIRTY_PAGE_SIZE,
+                 NACL_ABI_DIRTY_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0),
+            mem + 50 * NACL_ABI_DIRTY_PAGE_SIZE);
+  ASSERT_GE(GetDirty(mem, PAGES, 0), 1);
+  ASSERT(IsDirty(50));
+  /* Tracking of the new mapping may take one more call to settle. */
+  GetDirty(mem, PAGES, 0);
+  ASSERT_EQ(GetDirty(mem, PAGES, 0), 0);
+
+  ASSERT_EQ(munmap(mem, PAGES * NACL_ABI_DIRTY_PAGE_SIZE), 0);
+}
+
+int main(int argc, char **argv) {
+  size_t size;
+
+  if (argc != 2) {
+    fprintf(stderr, "Usage: dirty_pages_test <readable_file>\n");
+    return 1;
+  }
+  size = nacl_interface_query(NACL_IRT_DEV_DIRTY_PAGES_v0_1, &g_dirty,
+                              sizeof(g_dirty));
+  ASSERT_EQ(size, sizeof(g_dirty));
+
+  TestErrors();
+  TestTracking(argv[1]);
+
+  printf("PASSED\n");
+  return 0;
+}
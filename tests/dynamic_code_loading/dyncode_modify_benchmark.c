@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Measures nacl_dyncode_modify() when a JIT patches a few immediates
+ * (e.g. inline caches) in a large region of code it has already loaded.
+ *
+ *   dyncode_modify_benchmark [region_size]
+ *
+ * Each iteration changes the immediate of one instruction and passes
+ * either the whole region or just that instruction to
+ * nacl_dyncode_modify().
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <nacl/nacl_dyncode.h>
+
+#include "native_client/tests/dynamic_code_loading/dynamic_segment.h"
+#include "native_client/tests/dynamic_code_loading/templates.h"
+
+#define NACL_BUNDLE_SIZE 32
+
+static const int kIterations = 200;
+
+static double now_us(void) {
+  struct timespec ts;
+  int rc = clock_gettime(CLOCK_MONOTONIC, &ts);
+  assert(rc == 0);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char **argv) {
+  size_t region_size = argc > 1 ? strtoul(argv[1], NULL, 0) : 0x40000;
+  uint8_t *load_area = (uint8_t *) DYNAMIC_CODE_SEGMENT_START;
+  size_t instr_size = &template_instr_end - &template_instr;
+  size_t bundles = region_size / NACL_BUNDLE_SIZE;
+  uint8_t *buf;
+  double start, whole_us, single_us;
+  size_t i;
+  int rc;
+
+  assert(region_size % DYNAMIC_CODE_PAGE_SIZE == 0);
+  assert(load_area + region_size <= (uint8_t *) DYNAMIC_CODE_SEGMENT_END);
+  assert(instr_size + 4 <= NACL_BUNDLE_SIZE);
+
+  /* One "mov $imm, %eax" per bundle, padded with NOPs. */
+  buf = malloc(region_size);
+  assert(buf != NULL);
+  memset(buf, 0x90, region_size);
+  for (i = 0; i < bundles; i++)
+    memcpy(buf + i * NACL_BUNDLE_SIZE, &template_instr, instr_size);
+  rc = nacl_dyncode_create(load_area, buf, region_size);
+  assert(rc == 0);
+
+  start = now_us();
+  for (i = 0; i < kIterations; i++) {
+    uint8_t *imm = buf + (i * 97 % bundles) * NACL_BUNDLE_SIZE + 1;
+    uint32_t value = (uint32_t) i + 1;
+    memcpy(imm, &value, sizeof(value));
+    rc = nacl_dyncode_modify(load_area, buf, region_size);
+    assert(rc == 0);
+  }
+  whole_us = (now_us() - start) / kIterations;
+
+  start = now_us();
+  for (i = 0; i < kIterations; i++) {
+    size_t offset = (i * 97 % bundles) * NACL_BUNDLE_SIZE;
+    uint32_t value = (uint32_t) i + 2;
+    memcpy(buf + offset + 1, &value, sizeof(value));
+    rc = nacl_dyncode_modify(load_area + offset, buf + offset, instr_size);
+    assert(rc == 0);
+  }
+  single_us = (now_us() - start) / kIterations;
+
+  assert(memcmp(load_area, buf, region_size) == 0);
+
+  printf("region of %u bytes\n", (unsigned) region_size);
+  printf("modify whole region:      %10.1f us\n", whole_us);
+  printf("modify one instruction:   %10.1f us\n", single_us);
+
+  free(buf);
+  return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Nexe run by fork_server_test.py under "sel_ldr --fork_server".
+ *
+ *   exit <status> [args...]  prints its arguments and exits with status.
+ *   dyncode                  loads code at the start of the dynamic code
+ *                            area.  Every child forked from one server
+ *                            must be able to do this, which fails if the
+ *                            children share the server's dynamic text.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nacl/nacl_dyncode.h>
+
+#include "native_client/tests/dynamic_code_loading/dynamic_segment.h"
+
+int main(int argc, char **argv) {
+  int i;
+
+  if (argc >= 3 && 0 == strcmp(argv[1], "exit")) {
+    for (i = 3; i < argc; ++i) {
+      printf("arg: %s\n", argv[i]);
+    }
+    return atoi(argv[2]);
+  }
+  if (argc == 2 && 0 == strcmp(argv[1], "dyncode")) {
+    /* A bundle of HLT instructions. */
+    char buf[32];
+    int rc;
+
+    memset(buf, 0xf4, sizeof buf);
+    rc = nacl_dyncode_create((void *) DYNAMIC_CODE_SEGMENT_START,
+                             buf, sizeof buf);
+    if (0 != rc) {
+      printf("nacl_dyncode_create failed: %s\n", strerror(errno));
+      return 1;
+    }
+    printf("dyncode ok\n");
+    return 0;
+  }
+  fprintf(stderr, "Usage: fork_server_test exit <status> [args...]\n"
+          "       fork_server_test dyncode\n");
+  return 2;
+}
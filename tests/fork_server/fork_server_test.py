@@ -0,0 +1,115 @@
+#!/usr/bin/python
+# Copyright (c) 2015 The Native Client Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""Tests "sel_ldr --fork_server" and measures its launch latency.
+
+Usage: fork_server_test.py <client> <nexe> <iterations> -- <sel_ldr command>
+
+The sel_ldr command is everything needed to run a nexe except the nexe
+itself, e.g. the bootstrap loader, sel_ldr and "-B irt.nexe".  After the
+functional checks, the nexe is launched <iterations> times cold, with
+sel_ldr, and through the fork server, and the latencies are printed.
+"""
+
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def Check(condition, message):
+  if not condition:
+    raise AssertionError(message)
+
+
+def WaitForSocket(path, server):
+  deadline = time.time() + 30
+  while time.time() < deadline:
+    Check(server.poll() is None,
+          'fork server exited with status %d' % server.returncode)
+    if os.path.exists(path):
+      sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+      try:
+        sock.connect(path)
+        return
+      except socket.error:
+        pass
+      finally:
+        sock.close()
+    time.sleep(0.05)
+  raise AssertionError('fork server did not start listening')
+
+
+def RunClient(client, sock_path, args):
+  proc = subprocess.Popen([client, sock_path] + args,
+                          stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  stdout, stderr = proc.communicate()
+  return proc.returncode, stdout.decode(), stderr.decode()
+
+
+def Percentiles(latencies):
+  latencies = sorted(latencies)
+  count = len(latencies)
+  return (sum(latencies) / count, latencies[count // 2],
+          latencies[count * 9 // 10])
+
+
+def TimeLaunches(command, iterations):
+  devnull = open(os.devnull, 'w')
+  latencies = []
+  for _ in range(iterations):
+    start = time.time()
+    rc = subprocess.call(command, stdout=devnull, stderr=devnull)
+    latencies.append((time.time() - start) * 1e6)
+    Check(rc == 0, '%r exited with status %d' % (command, rc))
+  devnull.close()
+  return Percentiles(latencies)
+
+
+def Main(argv):
+  index = argv.index('--')
+  client, nexe, iterations = argv[1:index]
+  iterations = int(iterations)
+  sel_ldr_command = argv[index + 1:]
+
+  tmpdir = tempfile.mkdtemp(prefix='fork_server_test')
+  sock_path = os.path.join(tmpdir, 'sock')
+  server = subprocess.Popen(sel_ldr_command +
+                            ['--fork_server', sock_path, '-f', nexe])
+  try:
+    WaitForSocket(sock_path, server)
+
+    rc, stdout, _ = RunClient(client, sock_path,
+                              ['exit', '7', 'hello', 'world'])
+    Check(rc == 7, 'exit status %d, expected 7' % rc)
+    Check(stdout == 'arg: hello\narg: world\n',
+          'unexpected output %r' % stdout)
+
+    # Each child must get its own copy of the dynamic code area.
+    for _ in range(2):
+      rc, stdout, stderr = RunClient(client, sock_path, ['dyncode'])
+      Check(rc == 0 and stdout == 'dyncode ok\n',
+            'dyncode child failed (%d): %r %r' % (rc, stdout, stderr))
+
+    cold = TimeLaunches(sel_ldr_command + ['-f', nexe, '--', 'exit', '0'],
+                        iterations)
+    warm = TimeLaunches([client, sock_path, 'exit', '0'], iterations)
+    for name, (mean, median, p90) in (('cold start', cold),
+                                      ('fork server', warm)):
+      sys.stdout.write('%-12s mean %8.0f us  median %8.0f us  p90 %8.0f us\n'
+                       % (name, mean, median, p90))
+  finally:
+    server.kill()
+    server.wait()
+    shutil.rmtree(tmpdir)
+  sys.stdout.write('PASSED\n')
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(Main(sys.argv))
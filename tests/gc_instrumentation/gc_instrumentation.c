@@ -184,9 +184,10 @@ void test_syscall_wrappers(void) {
   CHECK(irt_mutex.mutex_create(&mutex_handle) == 0);
   CHECK_SYSCALL_NOT_WRAPPED();
 
+  /* Uncontended locking does not enter the service runtime. */
   CHECK_SYSCALL_PRE();
   CHECK(irt_mutex.mutex_lock(mutex_handle) == 0);
-  CHECK_SYSCALL_WRAPPED();
+  CHECK_SYSCALL_NOT_WRAPPED();
 
   CHECK_SYSCALL_PRE();
   CHECK(irt_mutex.mutex_trylock(mutex_handle) == EBUSY);
@@ -237,9 +238,10 @@ void test_syscall_wrappers(void) {
   CHECK(irt_sem.sem_create(&sem_handle, 1) == 0);
   CHECK_SYSCALL_NOT_WRAPPED();
 
+  /* The count is positive, so this does not block. */
   CHECK_SYSCALL_PRE();
   CHECK(irt_sem.sem_wait(sem_handle) == 0);
-  CHECK_SYSCALL_WRAPPED();
+  CHECK_SYSCALL_NOT_WRAPPED();
 
   CHECK_SYSCALL_PRE();
   CHECK(irt_sem.sem_post(sem_handle) == 0);
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Tests the "irt-mutex", "irt-cond" and "irt-sem" interfaces directly,
+ * rather than through libpthread.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "native_client/src/untrusted/irt/irt.h"
+
+#define NUM_THREADS 4
+#define LOCK_ITERATIONS 20000
+
+static struct nacl_irt_mutex g_mutex;
+static struct nacl_irt_cond g_cond;
+static struct nacl_irt_sem g_sem;
+
+static int g_mutex_handle;
+static int g_cond_handle;
+static int g_sem_handle;
+
+/* Protected by g_mutex_handle. */
+static int g_counter;
+static int g_waiting;
+static int g_tickets;
+static int g_released;
+static int g_woken;
+
+static volatile int g_sem_done;
+
+static void sleep_ms(int ms) {
+  struct timespec ts;
+  ts.tv_sec = 0;
+  ts.tv_nsec = ms * 1000 * 1000;
+  assert(nanosleep(&ts, NULL) == 0);
+}
+
+static void *lock_thread(void *arg) {
+  int i;
+  for (i = 0; i < LOCK_ITERATIONS; i++) {
+    assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+    /* A non-atomic read-modify-write, so lost updates would show. */
+    int value = g_counter;
+    if (i % 64 == 0)
+      sched_yield();
+    g_counter = value + 1;
+    assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+  }
+  return arg;
+}
+
+static void test_contended_mutex(void) {
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  printf("test_contended_mutex\n");
+  g_counter = 0;
+  for (i = 0; i < NUM_THREADS; i++)
+    assert(pthread_create(&threads[i], NULL, lock_thread, NULL) == 0);
+  for (i = 0; i < NUM_THREADS; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+  assert(g_counter == NUM_THREADS * LOCK_ITERATIONS);
+}
+
+/* Waits until it takes a ticket or all waiters are released. */
+static void *cond_thread(void *arg) {
+  assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+  g_waiting++;
+  while (g_tickets == 0 && !g_released)
+    assert(g_cond.cond_wait(g_cond_handle, g_mutex_handle) == 0);
+  if (g_tickets > 0)
+    g_tickets--;
+  g_waiting--;
+  g_woken++;
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+  return arg;
+}
+
+static void wait_for_waiters(int waiting, int woken) {
+  for (;;) {
+    assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+    int done = g_waiting == waiting && g_woken == woken;
+    assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+    if (done)
+      return;
+    sched_yield();
+  }
+}
+
+static void test_cond_signal_and_broadcast(void) {
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  printf("test_cond_signal_and_broadcast\n");
+  g_waiting = 0;
+  g_tickets = 0;
+  g_released = 0;
+  g_woken = 0;
+  for (i = 0; i < NUM_THREADS; i++)
+    assert(pthread_create(&threads[i], NULL, cond_thread, NULL) == 0);
+  wait_for_waiters(NUM_THREADS, 0);
+
+  /* Each signal wakes a waiter to take the one ticket. */
+  for (i = 1; i < NUM_THREADS; i++) {
+    assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+    g_tickets++;
+    assert(g_cond.cond_signal(g_cond_handle) == 0);
+    assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+    wait_for_waiters(NUM_THREADS - i, i);
+  }
+
+  assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+  g_released = 1;
+  assert(g_cond.cond_broadcast(g_cond_handle) == 0);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+  for (i = 0; i < NUM_THREADS; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+  assert(g_woken == NUM_THREADS);
+  assert(g_waiting == 0);
+
+  /* Broadcast wakes every waiter at once. */
+  g_released = 0;
+  g_woken = 0;
+  for (i = 0; i < NUM_THREADS; i++)
+    assert(pthread_create(&threads[i], NULL, cond_thread, NULL) == 0);
+  wait_for_waiters(NUM_THREADS, 0);
+  assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+  g_released = 1;
+  assert(g_cond.cond_broadcast(g_cond_handle) == 0);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+  for (i = 0; i < NUM_THREADS; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+  assert(g_woken == NUM_THREADS);
+}
+
+static void test_cond_timed_wait_abs(void) {
+  struct timeval start;
+  struct timeval end;
+  struct timespec abstime;
+  const int timeout_ms = 50;
+
+  printf("test_cond_timed_wait_abs\n");
+  assert(gettimeofday(&start, NULL) == 0);
+  abstime.tv_sec = start.tv_sec;
+  abstime.tv_nsec = start.tv_usec * 1000 + timeout_ms * 1000 * 1000;
+  if (abstime.tv_nsec >= 1000000000) {
+    abstime.tv_sec++;
+    abstime.tv_nsec -= 1000000000;
+  }
+  assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+  assert(g_cond.cond_timed_wait_abs(g_cond_handle, g_mutex_handle,
+                                    &abstime) == ETIMEDOUT);
+  /* The mutex is held again after timing out. */
+  assert(g_mutex.mutex_trylock(g_mutex_handle) == EBUSY);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+  assert(gettimeofday(&end, NULL) == 0);
+  assert(end.tv_sec > abstime.tv_sec ||
+         (end.tv_sec == abstime.tv_sec &&
+          end.tv_usec * 1000 >= abstime.tv_nsec));
+
+  /* A deadline in the past times out at once. */
+  abstime.tv_sec = 0;
+  abstime.tv_nsec = 0;
+  assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+  assert(g_cond.cond_timed_wait_abs(g_cond_handle, g_mutex_handle,
+                                    &abstime) == ETIMEDOUT);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+}
+
+static void *sem_thread(void *arg) {
+  assert(g_sem.sem_wait(g_sem_handle) == 0);
+  g_sem_done = 1;
+  return arg;
+}
+
+static void test_sem_wait_blocks(void) {
+  pthread_t thread;
+
+  printf("test_sem_wait_blocks\n");
+  /* Waiting on a positive count does not block. */
+  assert(g_sem.sem_post(g_sem_handle) == 0);
+  assert(g_sem.sem_post(g_sem_handle) == 0);
+  assert(g_sem.sem_wait(g_sem_handle) == 0);
+  assert(g_sem.sem_wait(g_sem_handle) == 0);
+
+  g_sem_done = 0;
+  assert(pthread_create(&thread, NULL, sem_thread, NULL) == 0);
+  sleep_ms(50);
+  assert(g_sem_done == 0);
+  assert(g_sem.sem_post(g_sem_handle) == 0);
+  assert(pthread_join(thread, NULL) == 0);
+  assert(g_sem_done == 1);
+}
+
+static void test_errors(void) {
+  int handle;
+
+  printf("test_errors\n");
+  /* Unlocking an unlocked mutex fails and leaves it usable. */
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == EPERM);
+  assert(g_mutex.mutex_trylock(g_mutex_handle) == 0);
+  assert(g_mutex.mutex_trylock(g_mutex_handle) == EBUSY);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == EPERM);
+  assert(g_mutex.mutex_lock(g_mutex_handle) == 0);
+  assert(g_mutex.mutex_unlock(g_mutex_handle) == 0);
+
+  /* Waiting requires holding the mutex. */
+  assert(g_cond.cond_wait(g_cond_handle, g_mutex_handle) == EPERM);
+
+  assert(g_sem.sem_create(&handle, -1) == EINVAL);
+
+  /* Bad, mismatched and destroyed handles. */
+  assert(g_mutex.mutex_lock(-1) == EBADF);
+  assert(g_mutex.mutex_lock(g_cond_handle) == EBADF);
+  assert(g_cond.cond_signal(g_mutex_handle) == EBADF);
+  assert(g_sem.sem_post(g_mutex_handle) == EBADF);
+  assert(g_mutex.mutex_create(&handle) == 0);
+  assert(g_mutex.mutex_destroy(handle) == 0);
+  assert(g_mutex.mutex_lock(handle) == EBADF);
+  assert(g_mutex.mutex_destroy(handle) == EBADF);
+}
+
+int main(void) {
+  assert(nacl_interface_query(NACL_IRT_MUTEX_v0_1, &g_mutex,
+                              sizeof(g_mutex)) == sizeof(g_mutex));
+  assert(nacl_interface_query(NACL_IRT_COND_v0_1, &g_cond,
+                              sizeof(g_cond)) == sizeof(g_cond));
+  assert(nacl_interface_query(NACL_IRT_SEM_v0_1, &g_sem,
+                              sizeof(g_sem)) == sizeof(g_sem));
+  assert(g_mutex.mutex_create(&g_mutex_handle) == 0);
+  assert(g_cond.cond_create(&g_cond_handle) == 0);
+  assert(g_sem.sem_create(&g_sem_handle, 0) == 0);
+
+  test_contended_mutex();
+  test_cond_signal_and_broadcast();
+  test_cond_timed_wait_abs();
+  test_sem_wait_blocks();
+  test_errors();
+
+  assert(g_sem.sem_destroy(g_sem_handle) == 0);
+  assert(g_cond.cond_destroy(g_cond_handle) == 0);
+  assert(g_mutex.mutex_destroy(g_mutex_handle) == 0);
+  printf("PASSED\n");
+  return 0;
+}
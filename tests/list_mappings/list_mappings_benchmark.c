@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Compares the cost of keeping a copy of the memory map up to date with
+ * list_mappings and with list_mapping_changes, in a process holding
+ * many mappings.
+ *
+ *   list_mappings_benchmark [mapping_count]
+ *
+ * Mappings are made by mapping a large block and changing the
+ * protection of every other 64k page of it.
+ */
+
+#include <errno.h>
+#include <nacl/nacl_list_mappings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/trusted/service_runtime/include/sys/nacl_list_mappings.h"
+#include "native_client/src/trusted/service_runtime/nacl_config.h"
+
+static const int kIterations = 100;
+
+static double now_us(void) {
+  struct timespec ts;
+  ASSERT_EQ(0, clock_gettime(CLOCK_MONOTONIC, &ts));
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char **argv) {
+  size_t mapping_count = argc > 1 ? strtoul(argv[1], NULL, 0) : 4096;
+  size_t npages = mapping_count;
+  size_t capacity = mapping_count + 1024;
+  struct NaClMemMappingInfo *map = malloc(capacity * sizeof(*map));
+  ASSERT_NE(NULL, map);
+
+  char *blk = mmap(NULL, npages * NACL_MAP_PAGESIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(MAP_FAILED, blk);
+  for (size_t i = 0; i < npages; i += 2) {
+    ASSERT_EQ(0, mprotect(blk + i * NACL_MAP_PAGESIZE, NACL_MAP_PAGESIZE,
+                          PROT_READ));
+  }
+
+  size_t size;
+  ASSERT_EQ(0, nacl_list_mappings(map, capacity, &size));
+  ASSERT_LE(size, capacity);
+  ASSERT_GE(size, mapping_count);
+  printf("%zu mappings\n", size);
+
+  double start = now_us();
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(0, nacl_list_mappings(map, capacity, &size));
+  }
+  double full_us = (now_us() - start) / kIterations;
+
+  uint32_t generation = 0;
+  ASSERT_EQ(0, nacl_list_mapping_changes(&generation, map, capacity, &size));
+
+  start = now_us();
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(0, nacl_list_mapping_changes(&generation, map, capacity,
+                                           &size));
+    ASSERT_EQ(0, size);
+  }
+  double unchanged_us = (now_us() - start) / kIterations;
+
+  double changed_us = 0;
+  for (int i = 0; i < kIterations; ++i) {
+    char *page = blk + (i % npages) * NACL_MAP_PAGESIZE;
+    ASSERT_EQ(0, mprotect(page, NACL_MAP_PAGESIZE,
+                          i & 1 ? PROT_READ : PROT_NONE));
+    start = now_us();
+    ASSERT_EQ(0, nacl_list_mapping_changes(&generation, map, capacity,
+                                           &size));
+    changed_us += now_us() - start;
+    ASSERT_LE(size, 4);
+    ASSERT_EQ(NACL_ABI_MAPPING_CHANGED_RANGE, map[0].vmmap_type);
+  }
+  changed_us /= kIterations;
+
+  printf("list_mappings:                      %10.1f us\n", full_us);
+  printf("list_mapping_changes, one change:   %10.1f us\n", changed_us);
+  printf("list_mapping_changes, no change:    %10.1f us\n", unchanged_us);
+
+  ASSERT_EQ(0, munmap(blk, npages * NACL_MAP_PAGESIZE));
+  free(map);
+  return 0;
+}
@@ -239,6 +239,99 @@ static void test_list_mappings_order_and_overlap(void) {
   }
 }
 
+/* A changed range with a size of 0 covers the whole address space. */
+static bool range_covers(const struct NaClMemMappingInfo *range,
+                         uint32_t start, uint32_t size) {
+  return range->size == 0 ||
+         (range->start <= start &&
+          range->start + range->size >= start + size);
+}
+
+static void test_list_mapping_changes(void) {
+  printf("Testing list_mapping_changes.\n");
+
+  static struct NaClMemMappingInfo map[0x10000];
+  size_t capacity = sizeof(map) / sizeof(*map);
+  size_t size;
+  uint32_t generation = 0;
+
+  /* Generation 0 gets the whole address space. */
+  int result = nacl_list_mapping_changes(&generation, map, capacity, &size);
+  ASSERT_EQ(0, result);
+  ASSERT_LE(size, capacity);
+  ASSERT_GE(size, 1);
+  ASSERT_EQ(NACL_ABI_MAPPING_CHANGED_RANGE, map[0].vmmap_type);
+  ASSERT_EQ(0, map[0].start);
+  ASSERT_NE(0, generation);
+
+  /* Nothing changed, so nothing is reported. */
+  uint32_t unchanged = generation;
+  result = nacl_list_mapping_changes(&generation, map, capacity, &size);
+  ASSERT_EQ(0, result);
+  ASSERT_EQ(0, size);
+  ASSERT_EQ(unchanged, generation);
+
+  void *blk = mmap(NULL, 0x20000, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
+  ASSERT_NE(blk, MAP_FAILED);
+  ASSERT_EQ(0, mprotect(blk, 0x10000, PROT_READ));
+
+  /* Too small a buffer leaves the generation alone. */
+  result = nacl_list_mapping_changes(&generation, map, 1, &size);
+  ASSERT_EQ(0, result);
+  ASSERT_GT(size, 1);
+  ASSERT_EQ(unchanged, generation);
+
+  result = nacl_list_mapping_changes(&generation, map, capacity, &size);
+  ASSERT_EQ(0, result);
+  ASSERT_LE(size, capacity);
+  ASSERT_NE(unchanged, generation);
+
+  /*
+   * The new mapping must be inside a changed range, as two entries
+   * with different protections.
+   */
+  bool in_range = false;
+  bool found_ro = false;
+  bool found_rw = false;
+  for (size_t i = 0; i < size; ++i) {
+    if (map[i].vmmap_type == NACL_ABI_MAPPING_CHANGED_RANGE) {
+      in_range = range_covers(&map[i], (uint32_t) blk, 0x20000);
+      continue;
+    }
+    if (!in_range)
+      continue;
+    if (map[i].start == (uint32_t) blk && map[i].size == 0x10000 &&
+        map[i].prot == PROT_READ)
+      found_ro = true;
+    if (map[i].start == (uint32_t) blk + 0x10000 && map[i].size == 0x10000 &&
+        map[i].prot == (PROT_READ | PROT_WRITE))
+      found_rw = true;
+  }
+  ASSERT(found_ro);
+  ASSERT(found_rw);
+
+  /* Once unmapped, the range is reported again without the mapping. */
+  ASSERT_EQ(0, munmap(blk, 0x20000));
+  result = nacl_list_mapping_changes(&generation, map, capacity, &size);
+  ASSERT_EQ(0, result);
+  ASSERT_GE(size, 1);
+  in_range = false;
+  bool reported = false;
+  for (size_t i = 0; i < size; ++i) {
+    if (map[i].vmmap_type == NACL_ABI_MAPPING_CHANGED_RANGE) {
+      in_range = range_covers(&map[i], (uint32_t) blk, 0x20000);
+      reported |= in_range;
+      continue;
+    }
+    if (in_range) {
+      ASSERT(map[i].start + map[i].size <= (uint32_t) blk ||
+             map[i].start >= (uint32_t) blk + 0x20000);
+    }
+  }
+  ASSERT(reported);
+}
+
 int main(void) {
   test_list_mappings_read_write();
   test_list_mappings_bad_destination();
@@ -246,5 +339,6 @@ int main(void) {
   test_list_mappings_phdrs();
 #endif
   test_list_mappings_order_and_overlap();
+  test_list_mapping_changes();
   return 0;
 }
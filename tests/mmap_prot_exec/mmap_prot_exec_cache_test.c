@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Maps the same file PROT_EXEC twice.  The second mapping should be
+ * found in sel_ldr's validation cache; nacl.scons checks the cache
+ * counters that sel_ldr logs at exit.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "native_client/src/shared/platform/nacl_check.h"
+
+/* Get NACL_HALT_WORD. */
+#include "native_client/src/trusted/service_runtime/nacl_config.h"
+
+#define NUM_FILE_BYTES 0x10000  /* one NaCl page */
+
+/* See mmap_prot_exec.c: the dynamic code area starts after etext. */
+extern char etext;
+
+static void CreateHaltFile(char const *pathname) {
+  static int buffer[NUM_FILE_BYTES / sizeof(int)];
+  size_t ix;
+  int d;
+
+  for (ix = 0; ix < sizeof buffer / sizeof buffer[0]; ++ix) {
+    buffer[ix] = NACL_HALT_WORD;
+  }
+  d = open(pathname, O_WRONLY | O_CREAT | O_TRUNC, 0777);
+  if (-1 == d) {
+    fprintf(stderr, "Could not create %s: errno %d\n", pathname, errno);
+    exit(1);
+  }
+  CHECK(sizeof buffer == write(d, buffer, sizeof buffer));
+  CHECK(0 == close(d));
+}
+
+static void MapExec(int d, uintptr_t target_addr) {
+  void *addr = mmap((void *) target_addr, NUM_FILE_BYTES,
+                    PROT_READ | PROT_EXEC, MAP_SHARED | MAP_FIXED, d, 0);
+  if ((void *) target_addr != addr) {
+    fprintf(stderr, "mmap at 0x%08x failed: got %p, errno %d\n",
+            (unsigned) target_addr, addr, errno);
+    exit(1);
+  }
+  CHECK(NACL_HALT_WORD == *(int *) addr);
+}
+
+int main(int argc, char **argv) {
+  uintptr_t target_addr;
+  int d;
+
+  if (argc != 2) {
+    fprintf(stderr, "Usage: mmap_prot_exec_cache_test <temp_file>\n");
+    return 1;
+  }
+  CreateHaltFile(argv[1]);
+  d = open(argv[1], O_RDONLY);
+  CHECK(-1 != d);
+
+  target_addr = ((uintptr_t) &etext + 0xffff) & ~(uintptr_t) 0xffff;
+  printf("Mapping %s at 0x%08x\n", argv[1], (unsigned) target_addr);
+  MapExec(d, target_addr);
+  printf("Mapping %s again at 0x%08x\n", argv[1],
+         (unsigned) (target_addr + NUM_FILE_BYTES));
+  MapExec(d, target_addr + NUM_FILE_BYTES);
+
+  CHECK(0 == close(d));
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * A deliberately large nexe for loader_startup_test.py, which times how
+ * long nonsfi_loader takes to reach main() under each prefault policy.
+ * It has 16MB of read-only data, 4MB of initialized data and 16MB of
+ * BSS, and checks that all three were loaded correctly.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "native_client/src/include/nacl_assert.h"
+
+#define RODATA_SIZE (16 << 20)
+#define DATA_SIZE (4 << 20)
+#define BSS_SIZE (16 << 20)
+
+/* Non-zero contents at both ends keep these out of the BSS. */
+const char g_rodata[RODATA_SIZE] = { 1, [RODATA_SIZE - 1] = 2 };
+char g_data[DATA_SIZE] = { 3, [DATA_SIZE - 1] = 4 };
+char g_bss[BSS_SIZE];
+
+int main(int argc, char **argv) {
+  struct timespec now;
+  ASSERT_EQ(0, clock_gettime(CLOCK_MONOTONIC, &now));
+
+  ASSERT_EQ(1, g_rodata[0]);
+  ASSERT_EQ(2, g_rodata[RODATA_SIZE - 1]);
+  ASSERT_EQ(3, g_data[0]);
+  ASSERT_EQ(4, g_data[DATA_SIZE - 1]);
+  ASSERT_EQ(0, g_bss[0]);
+  ASSERT_EQ(0, g_bss[BSS_SIZE - 1]);
+
+  /* Read by loader_startup_test.py. */
+  printf("main_ns %lld\n",
+         (long long) now.tv_sec * 1000000000 + now.tv_nsec);
+  return 0;
+}
@@ -0,0 +1,90 @@
+#!/usr/bin/python
+# Copyright (c) 2015 The Native Client Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""Measures nonsfi_loader's time to main() under each prefault policy.
+
+Usage: loader_startup_test.py <nonsfi_loader> <nexe> <iterations>
+
+The nexe prints the CLOCK_MONOTONIC time at which main() was entered.
+Each NACL_NONSFI_PREFAULT policy is timed with a cold page cache (the
+loader's and nexe's pages evicted with POSIX_FADV_DONTNEED before each
+run) and with a warm one.
+"""
+
+import ctypes
+import os
+import subprocess
+import sys
+
+
+POSIX_FADV_DONTNEED = 4
+CLOCK_MONOTONIC = 1
+
+POLICIES = ['none', 'willneed', 'populate',
+            'text=populate,data=willneed,bss=none']
+
+libc = ctypes.CDLL(None, use_errno=True)
+
+
+class Timespec(ctypes.Structure):
+  _fields_ = [('tv_sec', ctypes.c_long), ('tv_nsec', ctypes.c_long)]
+
+
+def MonotonicNs():
+  ts = Timespec()
+  if libc.clock_gettime(CLOCK_MONOTONIC, ctypes.byref(ts)) != 0:
+    raise OSError(ctypes.get_errno(), 'clock_gettime failed')
+  return ts.tv_sec * 1000000000 + ts.tv_nsec
+
+
+def EvictFromPageCache(path):
+  # Only drops clean pages that are not mapped, which is all we need
+  # here, and unlike /proc/sys/vm/drop_caches it needs no privileges.
+  fd = os.open(path, os.O_RDONLY)
+  try:
+    libc.posix_fadvise(fd, ctypes.c_longlong(0), ctypes.c_longlong(0),
+                       POSIX_FADV_DONTNEED)
+  finally:
+    os.close(fd)
+
+
+def TimeToMain(loader, nexe, policy):
+  env = dict(os.environ)
+  env['NACL_NONSFI_PREFAULT'] = policy
+  start = MonotonicNs()
+  proc = subprocess.Popen([loader, nexe], stdout=subprocess.PIPE, env=env)
+  stdout = proc.communicate()[0]
+  if proc.returncode != 0:
+    raise AssertionError('%s exited with status %d under policy %r'
+                         % (nexe, proc.returncode, policy))
+  for line in stdout.splitlines():
+    if line.startswith('main_ns '):
+      return (int(line.split()[1]) - start) / 1000.0
+  raise AssertionError('no main_ns line in output %r' % stdout)
+
+
+def Median(values):
+  return sorted(values)[len(values) // 2]
+
+
+def Main(argv):
+  loader, nexe, iterations = argv[1:]
+  iterations = int(iterations)
+  for policy in POLICIES:
+    cold = []
+    warm = []
+    for _ in range(iterations):
+      EvictFromPageCache(loader)
+      EvictFromPageCache(nexe)
+      cold.append(TimeToMain(loader, nexe, policy))
+      warm.append(TimeToMain(loader, nexe, policy))
+    sys.stdout.write('%-38s cold median %8.0f us  warm median %8.0f us\n'
+                     % (policy, Median(cold), Median(warm)))
+  sys.stdout.write('PASSED\n')
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(Main(sys.argv))
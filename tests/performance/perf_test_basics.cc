@@ -5,13 +5,18 @@
  */
 
 #include <setjmp.h>
+#include <stdint.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "native_client/src/include/build_config.h"
 
 #if NACL_LINUX
+# include <signal.h>
+# include <string.h>
 # include <sys/syscall.h>
 # include <time.h>
+# include <ucontext.h>
 #endif
 
 #include "native_client/src/include/nacl_assert.h"
@@ -39,6 +44,51 @@ class TestNaClSyscall : public PerfTest {
   }
 };
 PERF_TEST_DECLARE(TestNaClSyscall)
+
+// The following syscalls are dispatched by the service runtime's
+// syscall fast path (see NaClSyscallFastPath), so they can be
+// compared against TestNaClSyscall, which takes the generic path.
+class TestNaClTlsGetSyscall : public PerfTest {
+ public:
+  virtual void run() {
+    NACL_SYSCALL(tls_get)();
+  }
+};
+PERF_TEST_DECLARE(TestNaClTlsGetSyscall)
+
+class TestNaClClockGetTimeSyscall : public PerfTest {
+ public:
+  virtual void run() {
+    struct timespec time;
+    ASSERT_EQ(NACL_SYSCALL(clock_gettime)(CLOCK_MONOTONIC, &time), 0);
+  }
+};
+PERF_TEST_DECLARE(TestNaClClockGetTimeSyscall)
+
+class TestNaClFutexWakeSyscall : public PerfTest {
+ public:
+  TestNaClFutexWakeSyscall() : futex_(0) {}
+
+  virtual void run() {
+    // There are no waiters, so this wakes nobody.
+    ASSERT_EQ(NACL_SYSCALL(futex_wake)(&futex_, 1), 0);
+  }
+
+ private:
+  volatile int futex_;
+};
+PERF_TEST_DECLARE(TestNaClFutexWakeSyscall)
+
+// This syscall looks up a descriptor, so it takes and drops a
+// reference on it.
+class TestNaClFstatSyscall : public PerfTest {
+ public:
+  virtual void run() {
+    struct stat st;
+    ASSERT_EQ(NACL_SYSCALL(fstat)(1, &st), 0);
+  }
+};
+PERF_TEST_DECLARE(TestNaClFstatSyscall)
 #endif
 
 #if NACL_LINUX || NACL_OSX
@@ -58,6 +108,77 @@ class TestHostSyscall : public PerfTest {
 PERF_TEST_DECLARE(TestHostSyscall)
 #endif
 
+#if NACL_LINUX
+// Measure a fault round trip handled by a host signal handler on a
+// signal stack, redirecting the faulting thread as the service runtime
+// does for untrusted exception handlers.  This is the floor for
+// TestCatchingFault, which adds the service runtime's dispatch, the
+// exception_clear_flag syscall and a longjmp().
+class TestHostFaultRoundTrip : public PerfTest {
+ public:
+  TestHostFaultRoundTrip() {
+    stack_t st;
+    st.ss_sp = signal_stack_;
+    st.ss_size = sizeof(signal_stack_);
+    st.ss_flags = 0;
+    ASSERT_EQ(sigaltstack(&st, &old_stack_), 0);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = Handler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    ASSERT_EQ(sigemptyset(&action.sa_mask), 0);
+    ASSERT_EQ(sigaction(SIGSEGV, &action, &old_action_), 0);
+  }
+
+  ~TestHostFaultRoundTrip() {
+    ASSERT_EQ(sigaction(SIGSEGV, &old_action_, NULL), 0);
+    ASSERT_EQ(sigaltstack(&old_stack_, NULL), 0);
+  }
+
+  virtual void run() {
+    if (!setjmp(return_jmp_buf_)) {
+      for (;;)
+        *(volatile int *) 0 = 0;
+    }
+  }
+
+ private:
+  static void Handler(int sig, siginfo_t *info, void *raw_ctx) {
+    ucontext_t *uctx = (ucontext_t *) raw_ctx;
+#if defined(__x86_64__)
+    // Skip the red zone and align the stack as for a call.
+    greg_t *regs = uctx->uc_mcontext.gregs;
+    regs[REG_RSP] = ((regs[REG_RSP] - 128) & ~15) - 8;
+    regs[REG_RIP] = (uintptr_t) Resume;
+#elif defined(__i386__)
+    uctx->uc_mcontext.gregs[REG_EIP] = (uintptr_t) Resume;
+#elif defined(__arm__)
+    uctx->uc_mcontext.arm_pc = (uintptr_t) Resume;
+#elif defined(__mips__)
+    uctx->uc_mcontext.pc = (uintptr_t) Resume;
+#else
+# error Unsupported architecture
+#endif
+  }
+
+  // Runs on the faulting thread's own stack, like an untrusted
+  // exception handler without an exception stack.
+  static void Resume() {
+    longjmp(return_jmp_buf_, 1);
+  }
+
+  static char signal_stack_[0x10000];
+  static jmp_buf return_jmp_buf_;
+  stack_t old_stack_;
+  struct sigaction old_action_;
+};
+PERF_TEST_DECLARE(TestHostFaultRoundTrip)
+
+char TestHostFaultRoundTrip::signal_stack_[0x10000];
+jmp_buf TestHostFaultRoundTrip::return_jmp_buf_;
+#endif
+
 // Measure the speed of saving and restoring all callee-saved
 // registers, assuming the compiler does not optimize the setjmp() and
 // longjmp() calls away.  This is likely to be slower than TestNull
@@ -111,3 +232,43 @@ class TestMmapAnonymous : public PerfTest {
   }
 };
 PERF_TEST_DECLARE(TestMmapAnonymous)
+
+// Touch pages of a large heap-like buffer in a pseudo-random order.
+// With 4k pages almost every access misses in the TLB, so this
+// measures the benefit of backing anonymous memory with huge pages
+// (see NACL_ENABLE_HUGE_PAGES in the service runtime).
+class TestRandomPageTouch : public PerfTest {
+ public:
+  TestRandomPageTouch() : seed_(1) {
+    addr_ = (volatile char *) mmap(NULL, kSize, PROT_READ | PROT_WRITE,
+                                   MAP_ANON | MAP_PRIVATE, -1, 0);
+    ASSERT_NE(addr_, MAP_FAILED);
+    // Fault everything in up front so that run() does not measure
+    // page faults.
+    for (size_t offset = 0; offset < kSize; offset += kPageSize)
+      addr_[offset] = 1;
+  }
+
+  ~TestRandomPageTouch() {
+    ASSERT_EQ(munmap((void *) addr_, kSize), 0);
+  }
+
+  virtual void run() {
+    for (int i = 0; i < kTouchesPerRun; i++) {
+      // Linear congruential generator; the low bits are discarded
+      // because they have short periods.
+      seed_ = seed_ * 1103515245 + 12345;
+      size_t page = (seed_ >> 8) % (kSize / kPageSize);
+      addr_[page * kPageSize]++;
+    }
+  }
+
+ private:
+  static const size_t kSize = 256 << 20;
+  static const size_t kPageSize = 0x1000;
+  static const int kTouchesPerRun = 1000;
+
+  volatile char *addr_;
+  uint32_t seed_;
+};
+PERF_TEST_DECLARE(TestRandomPageTouch)
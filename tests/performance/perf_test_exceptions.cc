@@ -5,6 +5,7 @@
  */
 
 #include <setjmp.h>
+#include <stdlib.h>
 
 #include "native_client/src/include/nacl_assert.h"
 #include "native_client/src/include/nacl/nacl_exception.h"
@@ -42,3 +43,55 @@ class TestCatchingFault : public PerfTest {
 PERF_TEST_DECLARE(TestCatchingFault)
 
 jmp_buf TestCatchingFault::return_jmp_buf_;
+
+// The following measure the stages of TestCatchingFault separately.
+// The remainder, after subtracting these and TestSetjmpLongjmp, is
+// the cost of the host OS delivering the fault (compare
+// TestHostFaultRoundTrip in the trusted performance_test) plus the
+// service runtime's dispatch to the untrusted handler.
+
+class TestExceptionClearFlag : public PerfTest {
+ public:
+  virtual void run() {
+    ASSERT_EQ(nacl_exception_clear_flag(), 0);
+  }
+};
+PERF_TEST_DECLARE(TestExceptionClearFlag)
+
+// Like TestCatchingFault, but with the exception frame written to a
+// separate exception stack, as a language runtime would register.
+class TestCatchingFaultOnExceptionStack : public PerfTest {
+ public:
+  TestCatchingFaultOnExceptionStack() {
+    stack_ = malloc(kStackSize);
+    ASSERT(stack_ != NULL);
+    ASSERT_EQ(nacl_exception_set_stack(stack_, kStackSize), 0);
+    ASSERT_EQ(nacl_exception_set_handler(Handler), 0);
+  }
+
+  ~TestCatchingFaultOnExceptionStack() {
+    ASSERT_EQ(nacl_exception_set_handler(NULL), 0);
+    ASSERT_EQ(nacl_exception_set_stack(NULL, 0), 0);
+    free(stack_);
+  }
+
+  virtual void run() {
+    if (!setjmp(return_jmp_buf_)) {
+      for (;;)
+        *(volatile int *) 0 = 0;
+    }
+  }
+
+ private:
+  static void Handler(struct NaClExceptionContext *context) {
+    ASSERT_EQ(nacl_exception_clear_flag(), 0);
+    longjmp(return_jmp_buf_, 1);
+  }
+
+  static const size_t kStackSize = 0x10000;
+  static jmp_buf return_jmp_buf_;
+  void *stack_;
+};
+PERF_TEST_DECLARE(TestCatchingFaultOnExceptionStack)
+
+jmp_buf TestCatchingFaultOnExceptionStack::return_jmp_buf_;
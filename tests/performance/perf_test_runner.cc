@@ -12,6 +12,9 @@
 #include "native_client/src/include/build_config.h"
 #include "native_client/src/include/nacl_assert.h"
 #include "native_client/src/include/nacl_macros.h"
+#if defined(__native_client__)
+#include "native_client/src/untrusted/irt/irt.h"
+#endif
 #include "native_client/tests/performance/perf_test_compat_osx.h"
 #include "native_client/tests/performance/perf_test_runner.h"
 
@@ -174,6 +177,19 @@ void RunPerfTest(const char *description_string, const char *test_name,
   delete test;
 }
 
+#if defined(__native_client__)
+// The deprecated "irt-mutex" and "irt-sem" interfaces are not available
+// under PNaCl or without the IRT.
+static bool HaveIrtSyncInterfaces() {
+  struct nacl_irt_mutex irt_mutex;
+  struct nacl_irt_sem irt_sem;
+  return nacl_interface_query(NACL_IRT_MUTEX_v0_1, &irt_mutex,
+                              sizeof(irt_mutex)) == sizeof(irt_mutex) &&
+         nacl_interface_query(NACL_IRT_SEM_v0_1, &irt_sem,
+                              sizeof(irt_sem)) == sizeof(irt_sem);
+}
+#endif
+
 int main(int argc, char **argv) {
   const char *description_string = argc >= 2 ? argv[1] : "time";
 
@@ -187,9 +203,16 @@ int main(int argc, char **argv) {
   RUN_TEST(TestNull);
 #if defined(__native_client__)
   RUN_TEST(TestNaClSyscall);
+  RUN_TEST(TestNaClTlsGetSyscall);
+  RUN_TEST(TestNaClClockGetTimeSyscall);
+  RUN_TEST(TestNaClFutexWakeSyscall);
+  RUN_TEST(TestNaClFstatSyscall);
 #endif
 #if NACL_LINUX || NACL_OSX
   RUN_TEST(TestHostSyscall);
+#endif
+#if NACL_LINUX
+  RUN_TEST(TestHostFaultRoundTrip);
 #endif
   RUN_TEST(TestSetjmpLongjmp);
   RUN_TEST(TestClockGetTime);
@@ -197,8 +220,16 @@ int main(int argc, char **argv) {
   RUN_TEST(TestTlsVariable);
 #endif
   RUN_TEST(TestMmapAnonymous);
+  RUN_TEST(TestRandomPageTouch);
   RUN_TEST(TestAtomicIncrement);
   RUN_TEST(TestUncontendedMutexLock);
+#if defined(__native_client__)
+  RUN_TEST(TestNaClMutexSyscallLock);
+  if (HaveIrtSyncInterfaces()) {
+    RUN_TEST(TestIrtMutexLock);
+    RUN_TEST(TestIrtSemPostWait);
+  }
+#endif
   RUN_TEST(TestCondvarSignalNoOp);
   RUN_TEST(TestThreadCreateAndJoin);
   RUN_TEST(TestThreadWakeup);
@@ -210,7 +241,9 @@ int main(int argc, char **argv) {
   // exception handler is attached to sel_ldr as a debugger, Windows
   // suspends the whole sel_ldr process every time a thread is created
   // or exits.
+  RUN_TEST(TestExceptionClearFlag);
   RUN_TEST(TestCatchingFault);
+  RUN_TEST(TestCatchingFaultOnExceptionStack);
   // Measure that overhead by running MakeTestThreadCreateAndJoin again.
   RunPerfTest(description_string,
               "TestThreadCreateAndJoinAfterSettingFaultHandler",
@@ -7,6 +7,10 @@
 #include <pthread.h>
 
 #include "native_client/src/include/nacl_assert.h"
+#if defined(__native_client__)
+#include "native_client/src/untrusted/irt/irt.h"
+#include "native_client/src/untrusted/nacl/syscall_bindings_trampoline.h"
+#endif
 #include "native_client/tests/performance/perf_test_runner.h"
 
 
@@ -49,6 +53,77 @@ class TestUncontendedMutexLock : public PerfTest {
 };
 PERF_TEST_DECLARE(TestUncontendedMutexLock)
 
+#if defined(__native_client__)
+// The mutex syscalls take a host lock on every call.  Compare this with
+// TestIrtMutexLock, whose uncontended path stays in untrusted code.
+class TestNaClMutexSyscallLock : public PerfTest {
+ public:
+  TestNaClMutexSyscallLock() {
+    handle_ = NACL_SYSCALL(mutex_create)();
+    ASSERT_GE(handle_, 0);
+  }
+
+  ~TestNaClMutexSyscallLock() {
+    ASSERT_EQ(NACL_SYSCALL(close)(handle_), 0);
+  }
+
+  virtual void run() {
+    ASSERT_EQ(NACL_SYSCALL(mutex_lock)(handle_), 0);
+    ASSERT_EQ(NACL_SYSCALL(mutex_unlock)(handle_), 0);
+  }
+
+ private:
+  int handle_;
+};
+PERF_TEST_DECLARE(TestNaClMutexSyscallLock)
+
+class TestIrtMutexLock : public PerfTest {
+ public:
+  TestIrtMutexLock() {
+    ASSERT_EQ(nacl_interface_query(NACL_IRT_MUTEX_v0_1, &irt_mutex_,
+                                   sizeof(irt_mutex_)), sizeof(irt_mutex_));
+    ASSERT_EQ(irt_mutex_.mutex_create(&handle_), 0);
+  }
+
+  ~TestIrtMutexLock() {
+    ASSERT_EQ(irt_mutex_.mutex_destroy(handle_), 0);
+  }
+
+  virtual void run() {
+    ASSERT_EQ(irt_mutex_.mutex_lock(handle_), 0);
+    ASSERT_EQ(irt_mutex_.mutex_unlock(handle_), 0);
+  }
+
+ private:
+  struct nacl_irt_mutex irt_mutex_;
+  int handle_;
+};
+PERF_TEST_DECLARE(TestIrtMutexLock)
+
+class TestIrtSemPostWait : public PerfTest {
+ public:
+  TestIrtSemPostWait() {
+    ASSERT_EQ(nacl_interface_query(NACL_IRT_SEM_v0_1, &irt_sem_,
+                                   sizeof(irt_sem_)), sizeof(irt_sem_));
+    ASSERT_EQ(irt_sem_.sem_create(&handle_, 0), 0);
+  }
+
+  ~TestIrtSemPostWait() {
+    ASSERT_EQ(irt_sem_.sem_destroy(handle_), 0);
+  }
+
+  virtual void run() {
+    ASSERT_EQ(irt_sem_.sem_post(handle_), 0);
+    ASSERT_EQ(irt_sem_.sem_wait(handle_), 0);
+  }
+
+ private:
+  struct nacl_irt_sem irt_sem_;
+  int handle_;
+};
+PERF_TEST_DECLARE(TestIrtSemPostWait)
+#endif
+
 // Test the overhead of pthread_cond_signal() on a condvar that no
 // thread is waiting on.
 class TestCondvarSignalNoOp : public PerfTest {
@@ -0,0 +1,347 @@
+// Copyright 2016 The Native Client Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures symbol resolution in the PLL loader on synthetic sets of
+// hundreds of modules.  The modules are built in memory, with the same
+// per-module hash tables and bloom filters that the ConvertToPSO pass
+// generates, so this runs on the host as well as under NaCl.
+//
+// Usage: pll_loader_benchmark [modules] [exports] [imports] [iterations]
+//                             [reachable]
+//
+// "exports" and "imports" are per module.  Each import names a symbol
+// exported by a pseudo-randomly chosen module.  The time taken by
+// ModuleSet::ResolveRefs() is compared against resolving the same
+// imports with a linear search of the modules, which is how the loader
+// used to resolve them.
+//
+// The first "reachable" modules (10% by default) only import from each
+// other, as an application would that only uses a small part of the
+// libraries it links against.  Lazy binding is measured by looking up a
+// symbol in module 0 after ResolveRefs(), which should only resolve the
+// imports of those modules.
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/untrusted/pll_loader/pll_loader.h"
+#include "native_client/src/untrusted/pll_loader/pll_root.h"
+#include "native_client/src/untrusted/pnacl_dynloader/dynloader.h"
+
+// The modules are registered with ModuleSet::AddModule(), so nothing is
+// loaded from a file.  This stands in for the pnacl_dynloader library.
+int pnacl_load_elf_file(const char *, void **) {
+  return ENOSYS;
+}
+
+namespace {
+
+uint32_t g_random_state = 1;
+
+uint32_t Random() {
+  g_random_state = g_random_state * 1103515245 + 12345;
+  return g_random_state >> 16;
+}
+
+double NowSeconds() {
+  struct timespec ts;
+  ASSERT_EQ(clock_gettime(CLOCK_MONOTONIC, &ts), 0);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+class SyntheticModule {
+ public:
+  // Unless shared_names is set, export names are unique to the module.
+  SyntheticModule(size_t module_num, size_t export_count,
+                  bool shared_names = false) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < export_count; i++) {
+      char name[64];
+      if (shared_names) {
+        snprintf(name, sizeof(name), "shared_symbol%u", (unsigned) i);
+      } else {
+        snprintf(name, sizeof(name), "module%u_symbol%u",
+                 (unsigned) module_num, (unsigned) i);
+      }
+      names.push_back(name);
+    }
+
+    // As in ConvertToPSO, exports are sorted by hash bucket so that each
+    // bucket's chain is contiguous.
+    size_t bucket_count = std::max<size_t>(1, export_count);
+    std::vector<std::pair<uint32_t, std::string> > sorted;
+    for (size_t i = 0; i < export_count; i++) {
+      uint32_t hash = PLLModule::HashString(names[i].c_str());
+      sorted.push_back(std::make_pair(hash, names[i]));
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [bucket_count](const std::pair<uint32_t, std::string> &a,
+                                    const std::pair<uint32_t, std::string> &b) {
+                       return a.first % bucket_count < b.first % bucket_count;
+                     });
+
+    hash_buckets_.assign(bucket_count, -1);
+    size_t maskwords = 1;
+    while (maskwords * 32 < export_count * 2)
+      maskwords *= 2;
+    bloom_filter_.assign(maskwords, 0);
+    const size_t kShift2 = 6;
+    for (size_t i = 0; i < sorted.size(); i++) {
+      uint32_t hash = sorted[i].first;
+      exported_names_.push_back(string_table_.size());
+      string_table_.append(sorted[i].second);
+      string_table_.push_back('\0');
+      // Each export's value identifies it, for checking the results.
+      exported_ptrs_.push_back((void *) ExportValue(module_num, i));
+      export_names_by_value_.push_back(sorted[i].second);
+
+      size_t bucket = hash % bucket_count;
+      if (hash_buckets_[bucket] == -1)
+        hash_buckets_[bucket] = i;
+      bool last = i + 1 == sorted.size() ||
+                  sorted[i + 1].first % bucket_count != bucket;
+      hash_chains_.push_back((hash & ~1) | (last ? 1 : 0));
+
+      uint32_t hash2 = hash >> kShift2;
+      bloom_filter_[(hash / 32) & (maskwords - 1)] |=
+          (1 << (hash % 32)) | (1 << (hash2 % 32));
+    }
+
+    memset(&root_, 0, sizeof(root_));
+    root_.export_count = export_count;
+    root_.bucket_count = bucket_count;
+    root_.bloom_filter_maskwords_bitmask = maskwords - 1;
+    root_.bloom_filter_shift2 = kShift2;
+  }
+
+  static uintptr_t ExportValue(size_t module_num, size_t index) {
+    return (module_num << 16) | (index << 2) | 0x40000000;
+  }
+
+  const std::string &ExportName(size_t index) {
+    return export_names_by_value_[index];
+  }
+
+  void AddImport(const std::string &name, uintptr_t expected) {
+    imported_names_.push_back(string_table_.size());
+    string_table_.append(name);
+    string_table_.push_back('\0');
+    expected_.push_back(expected);
+  }
+
+  // Fills in the pointers in root_, which must not move afterwards.
+  const PLLRoot *Finish() {
+    import_slots_.assign(imported_names_.size(), 0);
+    for (size_t i = 0; i < import_slots_.size(); i++)
+      imported_ptrs_.push_back(&import_slots_[i]);
+    root_.string_table = string_table_.data();
+    root_.exported_ptrs = exported_ptrs_.data();
+    root_.exported_names = exported_names_.data();
+    root_.imported_ptrs = imported_ptrs_.data();
+    root_.imported_names = imported_names_.data();
+    root_.import_count = imported_names_.size();
+    root_.hash_buckets = hash_buckets_.data();
+    root_.hash_chains = hash_chains_.data();
+    root_.bloom_filter_data = bloom_filter_.data();
+    return &root_;
+  }
+
+  void ResetImports() {
+    std::fill(import_slots_.begin(), import_slots_.end(), 0);
+  }
+
+  void CheckImports() {
+    for (size_t i = 0; i < import_slots_.size(); i++)
+      ASSERT_EQ(import_slots_[i], expected_[i]);
+  }
+
+  void CheckImportsUnresolved() {
+    for (size_t i = 0; i < import_slots_.size(); i++)
+      ASSERT_EQ(import_slots_[i], 0);
+  }
+
+ private:
+  PLLRoot root_;
+  std::string string_table_;
+  std::vector<void *> exported_ptrs_;
+  std::vector<size_t> exported_names_;
+  std::vector<std::string> export_names_by_value_;
+  std::vector<int32_t> hash_buckets_;
+  std::vector<uint32_t> hash_chains_;
+  std::vector<uint32_t> bloom_filter_;
+  std::vector<size_t> imported_names_;
+  std::vector<void *> imported_ptrs_;
+  std::vector<uintptr_t> import_slots_;
+  std::vector<uintptr_t> expected_;
+};
+
+// Resolves imports the way ModuleSet::ResolveRefs() used to, by asking
+// each module in turn.
+void ResolveLinear(std::vector<const PLLRoot *> &roots) {
+  std::vector<PLLModule> modules;
+  for (auto root : roots)
+    modules.push_back(PLLModule(root));
+  for (auto &module : modules) {
+    for (size_t index = 0; index < module.root()->import_count; ++index) {
+      const char *name = module.GetImportedSymbolName(index);
+      void *sym = NULL;
+      for (auto &other : modules) {
+        if (other.GetExportedSym(name, &sym))
+          break;
+      }
+      ASSERT_NE(sym, NULL);
+      *(uintptr_t *) module.root()->imported_ptrs[index] += (uintptr_t) sym;
+    }
+  }
+}
+
+// Checks that when two modules export the same names, lookups return
+// the exports of the module added first, including when the second is
+// added after the index has been built.
+void CheckDuplicateExports() {
+  const size_t kExportCount = 8;
+  SyntheticModule first(1, kExportCount, true);
+  SyntheticModule second(2, kExportCount, true);
+  const PLLRoot *first_root = first.Finish();
+  const PLLRoot *second_root = second.Finish();
+
+  for (int order = 0; order < 2; order++) {
+    size_t winner = order == 0 ? 1 : 2;
+    ModuleSet modset;
+    modset.AddModule(order == 0 ? first_root : second_root);
+    modset.AddModule(order == 0 ? second_root : first_root);
+    for (size_t i = 0; i < kExportCount; i++) {
+      ASSERT_EQ(modset.GetSym(first.ExportName(i).c_str()),
+                (void *) SyntheticModule::ExportValue(winner, i));
+    }
+  }
+
+  ModuleSet modset;
+  modset.AddModule(first_root);
+  ASSERT_EQ(modset.GetSym(first.ExportName(0).c_str()),
+            (void *) SyntheticModule::ExportValue(1, 0));
+  modset.AddModule(second_root);
+  for (size_t i = 0; i < kExportCount; i++) {
+    ASSERT_EQ(modset.GetSym(first.ExportName(i).c_str()),
+              (void *) SyntheticModule::ExportValue(1, i));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t module_count = argc > 1 ? atoi(argv[1]) : 300;
+  size_t export_count = argc > 2 ? atoi(argv[2]) : 200;
+  size_t import_count = argc > 3 ? atoi(argv[3]) : 200;
+  int iterations = argc > 4 ? atoi(argv[4]) : 5;
+  size_t reachable_count = argc > 5 ? atoi(argv[5]) : module_count / 10;
+  ASSERT_GT(module_count, 0);
+  ASSERT_GT(export_count, 0);
+  reachable_count = std::min(std::max<size_t>(reachable_count, 1),
+                             module_count);
+
+  std::vector<SyntheticModule *> modules;
+  for (size_t i = 0; i < module_count; i++)
+    modules.push_back(new SyntheticModule(i, export_count));
+  for (size_t i = 0; i < module_count; i++) {
+    for (size_t j = 0; j < import_count; j++) {
+      size_t target = Random() % (i < reachable_count ? reachable_count
+                                                      : module_count);
+      size_t index = Random() % export_count;
+      modules[i]->AddImport(modules[target]->ExportName(index),
+                            SyntheticModule::ExportValue(target, index));
+    }
+  }
+  std::vector<const PLLRoot *> roots;
+  for (auto module : modules)
+    roots.push_back(module->Finish());
+
+  double linear_time = 0;
+  double indexed_time = 0;
+  double lazy_time = 0;
+  ModuleSet::BindingStats stats = ModuleSet::BindingStats();
+  for (int iter = 0; iter < iterations; iter++) {
+    for (auto module : modules)
+      module->ResetImports();
+    double start = NowSeconds();
+    ResolveLinear(roots);
+    linear_time += NowSeconds() - start;
+    for (auto module : modules)
+      module->CheckImports();
+
+    for (auto module : modules)
+      module->ResetImports();
+    start = NowSeconds();
+    ModuleSet modset;
+    for (auto root : roots)
+      modset.AddModule(root);
+    modset.ResolveRefs();
+    indexed_time += NowSeconds() - start;
+    for (auto module : modules)
+      module->CheckImports();
+
+    for (auto module : modules)
+      module->ResetImports();
+    start = NowSeconds();
+    ModuleSet lazy_modset;
+    lazy_modset.SetLazyBinding(true);
+    for (auto root : roots)
+      lazy_modset.AddModule(root);
+    lazy_modset.ResolveRefs();
+    void *entry = lazy_modset.GetSym(modules[0]->ExportName(0).c_str());
+    lazy_time += NowSeconds() - start;
+    ASSERT_EQ(entry, (void *) SyntheticModule::ExportValue(0, 0));
+    stats = lazy_modset.GetBindingStats();
+    ASSERT_EQ(stats.module_count, module_count);
+    ASSERT_LE(stats.modules_bound, reachable_count);
+    ASSERT_EQ(stats.imports_resolved, stats.modules_bound * import_count);
+    for (size_t i = 0; i < module_count; i++) {
+      if (i < reachable_count && import_count != 0) {
+        modules[i]->CheckImports();
+      } else {
+        modules[i]->CheckImportsUnresolved();
+      }
+    }
+    if (import_count == 0)
+      continue;
+    for (size_t i = reachable_count; i < module_count; i++)
+      lazy_modset.GetSym(modules[i]->ExportName(0).c_str());
+    ASSERT_EQ(lazy_modset.GetBindingStats().modules_bound, module_count);
+    for (auto module : modules)
+      module->CheckImports();
+  }
+
+  ModuleSet modset;
+  for (auto root : roots)
+    modset.AddModule(root);
+  ASSERT_EQ(modset.GetSym("no_such_symbol"), NULL);
+  CheckDuplicateExports();
+
+  double total_imports = (double) module_count * import_count * iterations;
+  printf("%u modules, %u exports and %u imports per module\n",
+         (unsigned) module_count, (unsigned) export_count,
+         (unsigned) import_count);
+  printf("linear search: %.3f ms per load, %.1f ns per import\n",
+         linear_time * 1e3 / iterations, linear_time * 1e9 / total_imports);
+  printf("symbol index:  %.3f ms per load, %.1f ns per import\n",
+         indexed_time * 1e3 / iterations, indexed_time * 1e9 / total_imports);
+  printf("lazy binding:  %.3f ms per load, %u of %u modules and "
+         "%u of %u imports resolved\n",
+         lazy_time * 1e3 / iterations,
+         (unsigned) stats.modules_bound, (unsigned) stats.module_count,
+         (unsigned) stats.imports_resolved, (unsigned) stats.import_count);
+
+  for (auto module : modules)
+    delete module;
+  return 0;
+}
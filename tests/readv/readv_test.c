@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2015 The Native Client Authors. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Tests the readv, writev and preadv functions of the
+ * "nacl-irt-dev-fdio-vec" IRT interface.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+# include <sys/uio.h>
+#else
+/* newlib does not provide <sys/uio.h>. */
+struct iovec {
+  void *iov_base;
+  size_t iov_len;
+};
+#endif
+
+#include "native_client/src/include/nacl_assert.h"
+#include "native_client/src/untrusted/irt/irt_dev.h"
+
+static struct nacl_irt_dev_fdio_vec g_fdio_vec;
+
+static char const kData[] = "The quick brown fox jumps over the lazy dog";
+
+static void TestWritevAndReadv(const char *filename) {
+  char buf1[10];
+  char buf2[1];
+  char buf3[100];
+  struct iovec out[3];
+  struct iovec in[4];
+  size_t nwrote;
+  size_t nread;
+  int fd;
+
+  fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  ASSERT_GE(fd, 0);
+
+  /* Split the data unevenly, with an empty segment in the middle. */
+  out[0].iov_base = (void *) kData;
+  out[0].iov_len = 4;
+  out[1].iov_base = NULL;
+  out[1].iov_len = 0;
+  out[2].iov_base = (void *) (kData + 4);
+  out[2].iov_len = sizeof kData - 1 - 4;
+  ASSERT_EQ(g_fdio_vec.writev(fd, out, 3, &nwrote), 0);
+  ASSERT_EQ(nwrote, sizeof kData - 1);
+
+  ASSERT_EQ(lseek(fd, 0, SEEK_SET), 0);
+  memset(buf3, 0, sizeof buf3);
+  in[0].iov_base = buf1;
+  in[0].iov_len = sizeof buf1;
+  in[1].iov_base = buf2;
+  in[1].iov_len = sizeof buf2;
+  in[2].iov_base = NULL;
+  in[2].iov_len = 0;
+  in[3].iov_base = buf3;
+  in[3].iov_len = sizeof buf3;
+  /* A short read at end of file returns what was available. */
+  ASSERT_EQ(g_fdio_vec.readv(fd, in, 4, &nread), 0);
+  ASSERT_EQ(nread, sizeof kData - 1);
+  ASSERT_EQ(memcmp(buf1, kData, sizeof buf1), 0);
+  ASSERT_EQ(memcmp(buf2, kData + sizeof buf1, sizeof buf2), 0);
+  ASSERT_EQ(strcmp(buf3, kData + sizeof buf1 + sizeof buf2), 0);
+
+  /* At end of file. */
+  ASSERT_EQ(g_fdio_vec.readv(fd, in, 4, &nread), 0);
+  ASSERT_EQ(nread, 0);
+
+  ASSERT_EQ(close(fd), 0);
+}
+
+static void TestPreadv(const char *filename) {
+  char buf1[5];
+  char buf2[6];
+  struct iovec in[2];
+  size_t nread;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  ASSERT_GE(fd, 0);
+  in[0].iov_base = buf1;
+  in[0].iov_len = sizeof buf1;
+  in[1].iov_base = buf2;
+  in[1].iov_len = sizeof buf2;
+  ASSERT_EQ(g_fdio_vec.preadv(fd, in, 2, 4, &nread), 0);
+  ASSERT_EQ(nread, sizeof buf1 + sizeof buf2);
+  ASSERT_EQ(memcmp(buf1, kData + 4, sizeof buf1), 0);
+  ASSERT_EQ(memcmp(buf2, kData + 4 + sizeof buf1, sizeof buf2), 0);
+  /* preadv does not move the file position. */
+  ASSERT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+
+  ASSERT_EQ(g_fdio_vec.preadv(fd, in, 2, -1, &nread), EINVAL);
+  ASSERT_EQ(close(fd), 0);
+}
+
+static void TestErrors(const char *filename) {
+  static struct iovec many[1025];
+  struct iovec bad;
+  size_t count;
+  int fd;
+
+  fd = open(filename, O_RDWR);
+  ASSERT_GE(fd, 0);
+
+  ASSERT_EQ(g_fdio_vec.readv(-1, many, 1, &count), EBADF);
+  ASSERT_EQ(g_fdio_vec.readv(fd, many, 1025, &count), EINVAL);
+  ASSERT_EQ(g_fdio_vec.readv(fd, many, 1024, &count), 0);
+  ASSERT_EQ(count, 0);
+  ASSERT_EQ(g_fdio_vec.writev(fd, (struct iovec *) 0x1000, 1, &count),
+            EFAULT);
+  bad.iov_base = (void *) ~(uintptr_t) 0xfff;
+  bad.iov_len = 0x1000;
+  ASSERT_EQ(g_fdio_vec.writev(fd, &bad, 1, &count), EFAULT);
+
+  ASSERT_EQ(close(fd), 0);
+}
+
+int main(int argc, char **argv) {
+  size_t size;
+
+  if (argc != 2) {
+    fprintf(stderr, "Usage: readv_test <temp_file>\n");
+    return 1;
+  }
+  size = nacl_interface_query(NACL_IRT_DEV_FDIO_VEC_v0_1, &g_fdio_vec,
+                              sizeof(g_fdio_vec));
+  ASSERT_EQ(size, sizeof(g_fdio_vec));
+
+  TestWritevAndReadv(argv[1]);
+  TestPreadv(argv[1]);
+  TestErrors(argv[1]);
+
+  printf("PASSED\n");
+  return 0;
+}